@@ -77,6 +77,19 @@ public:
   virtual std::string format(const Http::HeaderMap& request_headers,
                              const Http::HeaderMap& response_headers,
                              const RequestInfo::RequestInfo& request_info) const PURE;
+
+  /**
+   * Append the formatted value to a string. This allows a caller that formats many values to
+   * reuse a single string rather than allocate one per value.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies additional information about the request.
+   * @param output supplies the string to append to.
+   */
+  virtual void formatInto(const Http::HeaderMap& request_headers,
+                          const Http::HeaderMap& response_headers,
+                          const RequestInfo::RequestInfo& request_info,
+                          std::string& output) const PURE;
 };
 
 typedef std::unique_ptr<Formatter> FormatterPtr;
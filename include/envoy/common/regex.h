@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * A compiled regular expression that is matched against the whole of a value.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() {}
+
+  /**
+   * @param value supplies the value to match.
+   * @return bool true if the regex matches all of the value.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcher> CompiledMatcherPtr;
+
+/**
+ * A set of compiled regular expressions that are all matched against a value in a single pass.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() {}
+
+  /**
+   * Find the regexes that match the whole of a value.
+   * @param value supplies the value to match.
+   * @param matches supplies the vector to fill with the positions, in ascending order, of the
+   *        regexes that match the value. It is cleared first.
+   */
+  virtual void match(absl::string_view value, std::vector<uint32_t>& matches) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcherSet> CompiledMatcherSetPtr;
+
+} // namespace Regex
+} // namespace Envoy
@@ -23,6 +23,13 @@ public:
   virtual void onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                               const std::string& version_info) PURE;
 
+  /**
+   * Called instead of onConfigUpdate() when a configuration update is received that does not
+   * change any of the resources of the watch, so that the watch can track the accepted version.
+   * @param version_info update version.
+   */
+  virtual void onConfigUpdateUnchanged(const std::string& version_info) PURE;
+
   /**
    * Called when either the subscription is unable to fetch a config update or when onConfigUpdate
    * invokes an exception.
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -72,5 +78,34 @@ enum class Code {
   // clang-format on
 };
 
+/**
+ * Response code counters and response time histograms within a stats scope, such as the
+ * "upstream_rq_2xx", "canary.upstream_rq_503" and "internal.upstream_rq_time" stats that are
+ * charged for every upstream response. Implementations resolve each stat once so that charging a
+ * response does not require building and looking up a stat name.
+ */
+class CodeStats {
+public:
+  virtual ~CodeStats() {}
+
+  /**
+   * The stat name prefixes that response stats are charged under.
+   */
+  enum class Prefix { None, Canary, Internal, External, Retry };
+
+  /**
+   * Charge a response code to both its class and code specific counters, e.g.
+   * "<prefix>upstream_rq_5xx" and "<prefix>upstream_rq_503".
+   */
+  virtual void chargeResponseCode(Prefix prefix, uint64_t response_code) PURE;
+
+  /**
+   * Record a response time in "<prefix>upstream_rq_time".
+   */
+  virtual void chargeResponseTime(Prefix prefix, std::chrono::milliseconds response_time) PURE;
+};
+
+typedef std::unique_ptr<CodeStats> CodeStatsPtr;
+
 } // namespace Http
 } // namespace Envoy
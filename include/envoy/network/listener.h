@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -96,6 +97,14 @@ public:
    * @param new_connection supplies the new connection that is moved into the callee.
    */
   virtual void onNewConnection(ConnectionPtr&& new_connection) PURE;
+
+  /**
+   * Called after the listener accepted the connections that were ready when it was woken up, up
+   * to its per wakeup limit. onAccept() has already been called for each of them.
+   * @param accepted supplies the number of connections accepted.
+   * @param duration supplies the time it took to accept the connections and hand them off.
+   */
+  virtual void onAcceptBatch(uint32_t accepted, std::chrono::microseconds duration) PURE;
 };
 
 /**
@@ -91,6 +91,20 @@ public:
    * passive healthcheck operations.
    */
   virtual bool disableOutlierEvents() const PURE;
+
+  /**
+   * @return uint32_t the maximum number of connections that each worker opens to an upstream host.
+   *         Requests are spread over the connections by hash key, so that requests for the same
+   *         key use the same connection and run in order.
+   */
+  virtual uint32_t maxConnectionsPerHost() const PURE;
+
+  /**
+   * @return bool whether requests made during a dispatcher loop iteration are buffered and written
+   *         to the connection together at the start of the next iteration, rather than written one
+   *         at a time.
+   */
+  virtual bool enableCommandBatching() const PURE;
 };
 
 /**
@@ -129,6 +143,38 @@ public:
    */
   virtual PoolRequest* makeRequest(const std::string& hash_key, const RespValue& request,
                                    PoolCallbacks& callbacks) PURE;
+
+  /**
+   * Chooses the upstream host that a key hashes to, as makeRequest() would. This allows multi key
+   * commands to group their keys by host and make a single request to each host.
+   * @param hash_key supplies the key to use for consistent hashing.
+   * @return Upstream::HostConstSharedPtr the host or nullptr if there is no host to use.
+   */
+  virtual Upstream::HostConstSharedPtr chooseHost(const std::string& hash_key) PURE;
+
+  /**
+   * Chooses the connection to a host that a key uses, as makeRequest() would. Requests for the
+   * same key always use the same connection, so that they run in order. Multi key commands must
+   * only batch keys that use the same connection.
+   * @param hash_key supplies the key to use for consistent hashing.
+   * @return uint32_t the index of the connection among the connections to a host.
+   */
+  virtual uint32_t chooseConnection(const std::string& hash_key) PURE;
+
+  /**
+   * Makes a redis request to a specific upstream host.
+   * @param host supplies the host, which must have been returned by chooseHost() during the
+   *        current dispatcher iteration.
+   * @param connection supplies the connection to use, which must have been returned by
+   *        chooseConnection() for the keys of the request.
+   * @param request supplies the request to make.
+   * @param callbacks supplies the request completion callbacks.
+   * @return PoolRequest* a handle to the active request or nullptr if the request could not be made
+   *         for some reason.
+   */
+  virtual PoolRequest* makeRequestToHost(const Upstream::HostConstSharedPtr& host,
+                                         uint32_t connection, const RespValue& request,
+                                         PoolCallbacks& callbacks) PURE;
 };
 
 typedef std::unique_ptr<Instance> InstancePtr;
@@ -39,9 +39,17 @@ public:
    * Retrieve a listening socket on the specified address from the parent process. The socket will
    * be duplicated across process boundaries.
    * @param address supplies the address of the socket to duplicate, e.g. tcp://127.0.0.1:5000.
+   * @param worker_index supplies the index of the worker whose socket to duplicate when listeners
+   *        have a socket per worker (see Options::reusePort()). Otherwise it is 0.
+   * @param num_worker_sockets supplies the number of per worker sockets that the caller listens
+   *        on for the address, or 0 if all workers share a single socket.
    * @return int the fd or -1 if there is no bound listen port in the parent.
+   * @throw EnvoyException if the parent listens on the address with a different number of per
+   *        worker sockets. The parent's leftover SO_REUSEPORT sockets would otherwise keep being
+   *        handed new connections, which are dropped once the parent exits.
    */
-  virtual int duplicateParentListenSocket(const std::string& address) PURE;
+  virtual int duplicateParentListenSocket(const std::string& address, uint32_t worker_index,
+                                          uint32_t num_worker_sockets) PURE;
 
   /**
    * Retrieve stats from our parent process.
@@ -29,6 +29,17 @@ public:
   virtual Network::ListenSocketSharedPtr
   createListenSocket(Network::Address::InstanceConstSharedPtr address, bool bind_to_port) PURE;
 
+  /**
+   * Creates a bound SO_REUSEPORT socket for each worker, all on the same address.
+   * @param address supplies the sockets' address. If the port is 0, the first socket is bound to
+   *        a free port and the others are bound to the same one.
+   * @param num_workers supplies the number of workers.
+   * @return std::vector<Network::ListenSocketSharedPtr> the sockets, indexed by worker.
+   */
+  virtual std::vector<Network::ListenSocketSharedPtr>
+  createWorkerListenSockets(Network::Address::InstanceConstSharedPtr address,
+                            uint32_t num_workers) PURE;
+
   /**
    * Creates a list of filter factories.
    * @param filters supplies the proto configuration.
@@ -92,6 +103,25 @@ public:
    */
   virtual std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners() PURE;
 
+  /**
+   * Find the socket that a worker listens on for an active listener. This is used to hand sockets
+   * to a child process during hot restart.
+   * @param address supplies the socket's local address.
+   * @param worker_index supplies the index of the worker. Listeners that share a single socket
+   *        across all workers return it for every index.
+   * @return Network::ListenSocket* the socket, or nullptr if there is no listener on the address
+   *         or it has no socket for the worker.
+   */
+  virtual Network::ListenSocket* findListenSocket(const Network::Address::Instance& address,
+                                                  uint32_t worker_index) PURE;
+
+  /**
+   * @param address supplies the socket's local address.
+   * @return uint32_t the number of per worker sockets of the active listener on the address, or 0
+   *         if there is no such listener or its workers share a single socket.
+   */
+  virtual uint32_t numWorkerListenSockets(const Network::Address::Instance& address) PURE;
+
   /**
    * @return uint64_t the total number of connections owned by all listeners across all workers.
    */
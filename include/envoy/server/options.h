@@ -54,6 +54,12 @@ public:
    */
   virtual uint32_t concurrency() PURE;
 
+  /**
+   * @return bool whether each worker thread listens on its own SO_REUSEPORT socket, so that the
+   *         kernel distributes new connections across the workers.
+   */
+  virtual bool reusePort() PURE;
+
   /**
    * @return the number of seconds that envoy will perform draining during a hot restart.
    */
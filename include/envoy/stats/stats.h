@@ -41,19 +41,19 @@ public:
   virtual std::string name() const PURE;
 
   /**
-   * Returns a modified name with the tag removed and added to the tags vector. If the tag is not
-   * represented in the name, the tags vector will remain unmodified and the return value will be a
-   * copy of name. The portion removed from the name may be different than the value put into
-   * the tag vector for readability purposes. Note: The extraction process is expected to be run
-   * iteratively. For a list of TagExtractors, the original name is expected to be passed into
-   * extractTag for the first, and then each iteration after the modified name returned from the
-   * previous iteration should be passed in. The same vector should be passed into each successive
-   * call for updating.
-   * @param name name from which the tag will be extracted if found to exist.
+   * Removes the tag from a name and adds it to the tags vector. If the tag is not represented in
+   * the name, neither the name nor the tags vector are modified. The portion removed from the name
+   * may be different than the value put into the tag vector for readability purposes. Note: The
+   * extraction process is expected to be run iteratively. For a list of TagExtractors, the
+   * original name is expected to be passed into extractTag for the first, and then the same name,
+   * as modified by each iteration, should be passed into the next. The same vector should be
+   * passed into each successive call for updating.
+   * @param name name from which the tag will be extracted if found to exist. The tag is removed
+   *        from it in place.
    * @param tags list of tags updated with the tag name and value if found in the name.
-   * @return std::string modified name with the tag removed.
+   * @return bool true if the tag was found in the name.
    */
-  virtual std::string extractTag(const std::string& name, std::vector<Tag>& tags) const PURE;
+  virtual bool extractTag(std::string& name, std::vector<Tag>& tags) const PURE;
 };
 
 typedef std::unique_ptr<const TagExtractor> TagExtractorPtr;
@@ -151,6 +151,72 @@ public:
 
 typedef std::shared_ptr<Histogram> HistogramSharedPtr;
 
+/**
+ * Statistics computed for a histogram over some window of recorded values.
+ */
+class HistogramStatistics {
+public:
+  virtual ~HistogramStatistics() {}
+
+  /**
+   * @return a human readable summary of the computed quantiles.
+   */
+  virtual std::string summary() const PURE;
+
+  /**
+   * @return the quantiles (in the range [0, 1]) that are computed, in ascending order.
+   */
+  virtual const std::vector<double>& supportedQuantiles() const PURE;
+
+  /**
+   * @return the value of each quantile in supportedQuantiles(), in the same order. Values are NaN
+   *         if no samples were recorded.
+   */
+  virtual const std::vector<double>& computedQuantiles() const PURE;
+
+  /**
+   * @return the number of samples recorded.
+   */
+  virtual uint64_t sampleCount() const PURE;
+
+  /**
+   * @return the sum of all samples recorded.
+   */
+  virtual uint64_t sampleSum() const PURE;
+};
+
+/**
+ * A histogram that is aggregated in process. Values recorded from any thread are accumulated into
+ * per-thread buckets which are merged on the main thread when stats are flushed.
+ */
+class ParentHistogram : public virtual Histogram {
+public:
+  virtual ~ParentHistogram() {}
+
+  /**
+   * Merge the values recorded by all threads since the last merge. This must be called on the main
+   * thread.
+   */
+  virtual void merge() PURE;
+
+  /**
+   * @return statistics for the values recorded between the last two calls to merge().
+   */
+  virtual const HistogramStatistics& intervalStatistics() const PURE;
+
+  /**
+   * @return statistics for all values recorded up to the last call to merge().
+   */
+  virtual const HistogramStatistics& cumulativeStatistics() const PURE;
+
+  /**
+   * @return whether any value has been recorded up to the last call to merge().
+   */
+  virtual bool used() const PURE;
+};
+
+typedef std::shared_ptr<ParentHistogram> ParentHistogramSharedPtr;
+
 /**
  * A sink for stats. Each sink is responsible for writing stats to a backing store.
  */
@@ -159,8 +225,8 @@ public:
   virtual ~Sink() {}
 
   /**
-   * This will be called before a sequence of flushCounter() and flushGauge() calls. Sinks can
-   * choose to optimize writing if desired with a paired endFlush() call.
+   * This will be called before a sequence of flushCounter(), flushGauge() and flushHistogram()
+   * calls. Sinks can choose to optimize writing if desired with a paired endFlush() call.
    */
   virtual void beginFlush() PURE;
 
@@ -175,13 +241,22 @@ public:
   virtual void flushGauge(const Gauge& gauge, uint64_t value) PURE;
 
   /**
-   * This will be called after beginFlush(), some number of flushCounter(), and some number of
-   * flushGauge(). Sinks can use this to optimize writing if desired.
+   * Flush the statistics of an in process aggregated histogram. The histogram has been merged
+   * immediately before this call.
+   */
+  virtual void flushHistogram(const ParentHistogram& histogram) PURE;
+
+  /**
+   * This will be called after beginFlush(), some number of flushCounter(), some number of
+   * flushGauge() and some number of flushHistogram(). Sinks can use this to optimize writing if
+   * desired.
    */
   virtual void endFlush() PURE;
 
   /**
-   * Flush a histogram value.
+   * Flush an individual histogram value. This is only called for values delivered explicitly via
+   * Scope::deliverHistogramToSinks(); histograms aggregated in process are flushed via
+   * flushHistogram().
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
 };
@@ -242,6 +317,11 @@ public:
    * @return a list of all known gauges.
    */
   virtual std::list<GaugeSharedPtr> gauges() const PURE;
+
+  /**
+   * @return a list of all known histograms that are aggregated in process.
+   */
+  virtual std::list<ParentHistogramSharedPtr> histograms() const PURE;
 };
 
 typedef std::unique_ptr<Store> StorePtr;
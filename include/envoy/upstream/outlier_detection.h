@@ -81,6 +81,14 @@ public:
    *         or the cluster did not have enough hosts to run through success rate outlier ejection.
    */
   virtual double successRate() const PURE;
+
+  /**
+   * @return the response time quantile of the host in the last calculated interval, in
+   *         milliseconds. -1 means that the host did not have enough request volume to calculate
+   *         the quantile or the cluster did not have enough hosts to run through latency outlier
+   *         ejection.
+   */
+  virtual double latencyQuantile() const PURE;
 };
 
 typedef std::unique_ptr<DetectorHostMonitor> DetectorHostMonitorPtr;
@@ -119,11 +127,27 @@ public:
    *         proceed with success rate based outlier ejection.
    */
   virtual double successRateEjectionThreshold() const PURE;
+
+  /**
+   * Returns the typical response time quantile of the hosts in the Detector for the last
+   * aggregation interval, which is the median of the hosts' quantiles.
+   * @return the quantile in milliseconds, or -1 if there were not enough hosts with enough request
+   *         volume to proceed with latency based outlier ejection.
+   */
+  virtual double latencyClusterQuantile() const PURE;
+
+  /**
+   * Returns the response time quantile threshold used in the last interval. The threshold is used
+   * to eject hosts based on their response time quantile.
+   * @return the threshold in milliseconds, or -1 if there were not enough hosts with enough request
+   *         volume to proceed with latency based outlier ejection.
+   */
+  virtual double latencyEjectionThreshold() const PURE;
 };
 
 typedef std::shared_ptr<Detector> DetectorSharedPtr;
 
-enum class EjectionType { Consecutive5xx, SuccessRate, ConsecutiveGatewayFailure };
+enum class EjectionType { Consecutive5xx, SuccessRate, ConsecutiveGatewayFailure, Latency };
 
 /**
  * Sink for outlier detection event logs.
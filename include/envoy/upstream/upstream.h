@@ -12,6 +12,7 @@
 #include "envoy/common/callback.h"
 #include "envoy/common/optional.h"
 #include "envoy/http/codec.h"
+#include "envoy/http/codes.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
@@ -424,6 +425,11 @@ public:
    */
   virtual ClusterLoadReportStats& loadReportStats() const PURE;
 
+  /**
+   * @return Http::CodeStats& the response code and response time stats within statsScope().
+   */
+  virtual Http::CodeStats& codeStats() const PURE;
+
   /**
    * Returns an optional source address for upstream connections to bind to.
    *
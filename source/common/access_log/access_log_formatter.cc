@@ -1,5 +1,6 @@
 #include "common/access_log/access_log_formatter.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -9,6 +10,8 @@
 #include "common/common/utility.h"
 #include "common/request_info/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace AccessLog {
 
@@ -47,21 +50,101 @@ AccessLogFormatUtils::protocolToString(const Optional<Http::Protocol>& protocol)
   NOT_REACHED;
 }
 
+std::string FormatterBase::format(const Http::HeaderMap& request_headers,
+                                  const Http::HeaderMap& response_headers,
+                                  const RequestInfo::RequestInfo& request_info) const {
+  std::string output;
+  output.reserve(256);
+  formatInto(request_headers, response_headers, request_info, output);
+  return output;
+}
+
 FormatterImpl::FormatterImpl(const std::string& format) {
   formatters_ = AccessLogFormatParser::parse(format);
 }
 
-std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
-                                  const Http::HeaderMap& response_headers,
-                                  const RequestInfo::RequestInfo& request_info) const {
-  std::string log_line;
-  log_line.reserve(256);
-
+void FormatterImpl::formatInto(const Http::HeaderMap& request_headers,
+                               const Http::HeaderMap& response_headers,
+                               const RequestInfo::RequestInfo& request_info,
+                               std::string& output) const {
   for (const FormatterPtr& formatter : formatters_) {
-    log_line += formatter->format(request_headers, response_headers, request_info);
+    formatter->formatInto(request_headers, response_headers, request_info, output);
   }
+}
 
-  return log_line;
+JsonFormatterImpl::JsonFormatterImpl(const std::map<std::string, std::string>& format_mapping) {
+  for (const auto& key_and_format : format_mapping) {
+    Field field;
+    field.prefix_ = fields_.empty() ? "{\"" : "\",\"";
+    escapeInto(key_and_format.first, field.prefix_);
+    field.prefix_ += "\":\"";
+    field.formatters_ = AccessLogFormatParser::parse(key_and_format.second);
+    fields_.push_back(std::move(field));
+  }
+}
+
+void JsonFormatterImpl::formatInto(const Http::HeaderMap& request_headers,
+                                   const Http::HeaderMap& response_headers,
+                                   const RequestInfo::RequestInfo& request_info,
+                                   std::string& output) const {
+  if (fields_.empty()) {
+    output += "{}\n";
+    return;
+  }
+
+  for (const Field& field : fields_) {
+    output += field.prefix_;
+    const size_t value_start = output.size();
+    for (const FormatterPtr& formatter : field.formatters_) {
+      formatter->formatInto(request_headers, response_headers, request_info, output);
+    }
+
+    // Values rarely need escaping, so they are written in place and only rewritten if they do.
+    const absl::string_view value(output.data() + value_start, output.size() - value_start);
+    const auto needs_escape = [](char c) -> bool {
+      return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    };
+    if (std::any_of(value.begin(), value.end(), needs_escape)) {
+      const std::string unescaped(value);
+      output.resize(value_start);
+      escapeInto(unescaped, output);
+    }
+  }
+  output += "\"}\n";
+}
+
+void JsonFormatterImpl::escapeInto(absl::string_view value, std::string& output) {
+  for (const char c : value) {
+    switch (c) {
+    case '"':
+      output += "\\\"";
+      break;
+    case '\\':
+      output += "\\\\";
+      break;
+    case '\b':
+      output += "\\b";
+      break;
+    case '\f':
+      output += "\\f";
+      break;
+    case '\n':
+      output += "\\n";
+      break;
+    case '\r':
+      output += "\\r";
+      break;
+    case '\t':
+      output += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        output += fmt::format("\\u{:04x}", static_cast<unsigned char>(c));
+      } else {
+        output += c;
+      }
+    }
+  }
 }
 
 void AccessLogFormatParser::parseCommand(const std::string& token, const size_t start,
@@ -158,97 +241,103 @@ std::vector<FormatterPtr> AccessLogFormatParser::parse(const std::string& format
 
 RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
   if (field_name == "START_TIME") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogDateTimeFormatter::fromTime(request_info.startTime());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += AccessLogDateTimeFormatter::fromTime(request_info.startTime());
     };
   } else if (field_name == "REQUEST_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
       Optional<std::chrono::microseconds> duration = request_info.requestReceivedDuration();
       if (duration.valid()) {
-        return std::to_string(
+        absl::StrAppend(
+            &output,
             std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
       } else {
-        return UnspecifiedValueString;
+        output += UnspecifiedValueString;
       }
     };
   } else if (field_name == "RESPONSE_DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
       Optional<std::chrono::microseconds> duration = request_info.responseReceivedDuration();
       if (duration.valid()) {
-        return std::to_string(
+        absl::StrAppend(
+            &output,
             std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
       } else {
-        return UnspecifiedValueString;
+        output += UnspecifiedValueString;
       }
     };
   } else if (field_name == "BYTES_RECEIVED") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesReceived());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      absl::StrAppend(&output, request_info.bytesReceived());
     };
   } else if (field_name == "PROTOCOL") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return AccessLogFormatUtils::protocolToString(request_info.protocol());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += AccessLogFormatUtils::protocolToString(request_info.protocol());
     };
   } else if (field_name == "RESPONSE_CODE") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.responseCode().valid()
-                 ? std::to_string(request_info.responseCode().value())
-                 : "0";
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (request_info.responseCode().valid()) {
+        absl::StrAppend(&output, request_info.responseCode().value());
+      } else {
+        output += "0";
+      }
     };
   } else if (field_name == "BYTES_SENT") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(request_info.bytesSent());
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      absl::StrAppend(&output, request_info.bytesSent());
     };
   } else if (field_name == "DURATION") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return std::to_string(
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      absl::StrAppend(
+          &output,
           std::chrono::duration_cast<std::chrono::milliseconds>(request_info.duration()).count());
     };
   } else if (field_name == "RESPONSE_FLAGS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::ResponseFlagUtils::toShortString(request_info);
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += RequestInfo::ResponseFlagUtils::toShortString(request_info);
     };
   } else if (field_name == "UPSTREAM_HOST") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
       if (request_info.upstreamHost()) {
-        return request_info.upstreamHost()->address()->asString();
+        output += request_info.upstreamHost()->address()->asString();
       } else {
-        return UnspecifiedValueString;
+        output += UnspecifiedValueString;
       }
     };
   } else if (field_name == "UPSTREAM_CLUSTER") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      std::string upstream_cluster_name;
-      if (nullptr != request_info.upstreamHost()) {
-        upstream_cluster_name = request_info.upstreamHost()->cluster().name();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      if (nullptr != request_info.upstreamHost() &&
+          !request_info.upstreamHost()->cluster().name().empty()) {
+        output += request_info.upstreamHost()->cluster().name();
+      } else {
+        output += UnspecifiedValueString;
       }
-
-      return upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
     };
   } else if (field_name == "UPSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.upstreamLocalAddress() != nullptr
-                 ? request_info.upstreamLocalAddress()->asString()
-                 : UnspecifiedValueString;
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += request_info.upstreamLocalAddress() != nullptr
+                    ? request_info.upstreamLocalAddress()->asString()
+                    : UnspecifiedValueString;
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamLocalAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += request_info.downstreamLocalAddress()->asString();
     };
   } else if (field_name == "DOWNSTREAM_LOCAL_ADDRESS_WITHOUT_PORT") {
-    field_extractor_ = [](const Envoy::RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
+    field_extractor_ = [](const Envoy::RequestInfo::RequestInfo& request_info,
+                          std::string& output) {
+      output += RequestInfo::Utility::formatDownstreamAddressNoPort(
           *request_info.downstreamLocalAddress());
     };
   } else if (field_name == "DOWNSTREAM_REMOTE_ADDRESS") {
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return request_info.downstreamRemoteAddress()->asString();
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += request_info.downstreamRemoteAddress()->asString();
     };
   } else if (field_name == "DOWNSTREAM_ADDRESS" ||
              field_name == "DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT") {
     // DEPRECATED: "DOWNSTREAM_ADDRESS" will be removed post 1.6.0.
-    field_extractor_ = [](const RequestInfo::RequestInfo& request_info) {
-      return RequestInfo::Utility::formatDownstreamAddressNoPort(
+    field_extractor_ = [](const RequestInfo::RequestInfo& request_info, std::string& output) {
+      output += RequestInfo::Utility::formatDownstreamAddressNoPort(
           *request_info.downstreamRemoteAddress());
     };
   } else {
@@ -256,16 +345,17 @@ RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
   }
 }
 
-std::string RequestInfoFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                         const RequestInfo::RequestInfo& request_info) const {
-  return field_extractor_(request_info);
+void RequestInfoFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const RequestInfo::RequestInfo& request_info,
+                                      std::string& output) const {
+  field_extractor_(request_info, output);
 }
 
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
 
-std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
-                                         const RequestInfo::RequestInfo&) const {
-  return str_;
+void PlainStringFormatter::formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                                      const RequestInfo::RequestInfo&, std::string& output) const {
+  output += str_;
 }
 
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
@@ -273,25 +363,25 @@ HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const Optional<size_t>& max_length)
     : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
 
-std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
+void HeaderFormatter::formatInto(const Http::HeaderMap& headers, std::string& output) const {
   const Http::HeaderEntry* header = headers.get(main_header_);
 
   if (!header && !alternative_header_.get().empty()) {
     header = headers.get(alternative_header_);
   }
 
-  std::string header_value_string;
+  absl::string_view header_value;
   if (!header) {
-    header_value_string = UnspecifiedValueString;
+    header_value = UnspecifiedValueString;
   } else {
-    header_value_string = header->value().c_str();
+    header_value = absl::string_view(header->value().c_str(), header->value().size());
   }
 
-  if (max_length_.valid() && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
+  if (max_length_.valid() && header_value.length() > max_length_.value()) {
+    header_value = header_value.substr(0, max_length_.value());
   }
 
-  return header_value_string;
+  output.append(header_value.data(), header_value.size());
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -299,10 +389,11 @@ ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  const Optional<size_t>& max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
-                                            const Http::HeaderMap& response_headers,
-                                            const RequestInfo::RequestInfo&) const {
-  return HeaderFormatter::format(response_headers);
+void ResponseHeaderFormatter::formatInto(const Http::HeaderMap&,
+                                         const Http::HeaderMap& response_headers,
+                                         const RequestInfo::RequestInfo&,
+                                         std::string& output) const {
+  HeaderFormatter::formatInto(response_headers, output);
 }
 
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
@@ -310,10 +401,10 @@ RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const Optional<size_t>& max_length)
     : HeaderFormatter(main_header, alternative_header, max_length) {}
 
-std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_headers,
-                                           const Http::HeaderMap&,
-                                           const RequestInfo::RequestInfo&) const {
-  return HeaderFormatter::format(request_headers);
+void RequestHeaderFormatter::formatInto(const Http::HeaderMap& request_headers,
+                                        const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                                        std::string& output) const {
+  HeaderFormatter::formatInto(request_headers, output);
 }
 
 } // namespace AccessLog
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/request_info/request_info.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace AccessLog {
 
@@ -37,32 +40,72 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Base class for formatters that produce their value by appending it to an empty string.
  */
-class FormatterImpl : public Formatter {
+class FormatterBase : public Formatter {
 public:
-  FormatterImpl(const std::string& format);
-
   // Formatter::format
   std::string format(const Http::HeaderMap& request_headers,
                      const Http::HeaderMap& response_headers,
                      const RequestInfo::RequestInfo& request_info) const override;
+};
+
+/**
+ * Composite formatter implementation.
+ */
+class FormatterImpl : public FormatterBase {
+public:
+  FormatterImpl(const std::string& format);
+
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                  const RequestInfo::RequestInfo& request_info, std::string& output) const override;
 
 private:
   std::vector<FormatterPtr> formatters_;
 };
 
+/**
+ * Formatter that writes a JSON object per line. Each key of the object is mapped to a format
+ * string, as accepted by FormatterImpl, whose value is escaped as it is appended. Keys are written
+ * in sorted order.
+ */
+class JsonFormatterImpl : public FormatterBase {
+public:
+  JsonFormatterImpl(const std::map<std::string, std::string>& format_mapping);
+
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                  const RequestInfo::RequestInfo& request_info, std::string& output) const override;
+
+  /**
+   * Append a value to a string, escaped for use within a JSON string.
+   * @param value supplies the value to escape.
+   * @param output supplies the string to append to.
+   */
+  static void escapeInto(absl::string_view value, std::string& output);
+
+private:
+  struct Field {
+    // The key of the field, and the separator from the previous field if there is one.
+    std::string prefix_;
+    std::vector<FormatterPtr> formatters_;
+  };
+
+  std::vector<Field> fields_;
+};
+
 /**
  * Formatter for string literal. It ignores headers and request info and returns string by which it
  * was initialized.
  */
-class PlainStringFormatter : public Formatter {
+class PlainStringFormatter : public FormatterBase {
 public:
   PlainStringFormatter(const std::string& str);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&, const RequestInfo::RequestInfo&,
+                  std::string& output) const override;
 
 private:
   std::string str_;
@@ -73,7 +116,7 @@ public:
   HeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                   const Optional<size_t>& max_length);
 
-  std::string format(const Http::HeaderMap& headers) const;
+  void formatInto(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   Http::LowerCaseString main_header_;
@@ -84,42 +127,43 @@ private:
 /**
  * Formatter based on request header.
  */
-class RequestHeaderFormatter : public Formatter, HeaderFormatter {
+class RequestHeaderFormatter : public FormatterBase, HeaderFormatter {
 public:
   RequestHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                          const Optional<size_t>& max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                  const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
  * Formatter based on the response header.
  */
-class ResponseHeaderFormatter : public Formatter, HeaderFormatter {
+class ResponseHeaderFormatter : public FormatterBase, HeaderFormatter {
 public:
   ResponseHeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                           const Optional<size_t>& max_length);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
-                     const RequestInfo::RequestInfo&) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
+                  const RequestInfo::RequestInfo&, std::string& output) const override;
 };
 
 /**
  * Formatter based on the RequestInfo field.
  */
-class RequestInfoFormatter : public Formatter {
+class RequestInfoFormatter : public FormatterBase {
 public:
   RequestInfoFormatter(const std::string& field_name);
 
-  // Formatter::format
-  std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
-                     const RequestInfo::RequestInfo& request_info) const override;
+  // Formatter::formatInto
+  void formatInto(const Http::HeaderMap&, const Http::HeaderMap&,
+                  const RequestInfo::RequestInfo& request_info,
+                  std::string& output) const override;
 
 private:
-  std::function<std::string(const RequestInfo::RequestInfo&)> field_extractor_;
+  std::function<void(const RequestInfo::RequestInfo&, std::string&)> field_extractor_;
 };
 
 } // namespace AccessLog
@@ -6,55 +6,86 @@
 namespace Envoy {
 namespace AccessLog {
 
-GrpcAccessLogStreamerImpl::GrpcAccessLogStreamerImpl(Grpc::AsyncClientFactoryPtr&& factory,
-                                                     ThreadLocal::SlotAllocator& tls,
-                                                     const LocalInfo::LocalInfo& local_info)
+GrpcAccessLogStreamerImpl::GrpcAccessLogStreamerImpl(
+    Grpc::AsyncClientFactoryPtr&& factory, ThreadLocal::SlotAllocator& tls,
+    const LocalInfo::LocalInfo& local_info, Stats::Scope& scope, uint64_t buffer_size_bytes,
+    std::chrono::milliseconds buffer_flush_interval)
     : tls_slot_(tls.allocateSlot()) {
-  SharedStateSharedPtr shared_state = std::make_shared<SharedState>(std::move(factory), local_info);
-  tls_slot_->set([shared_state](Event::Dispatcher&) {
-    return ThreadLocal::ThreadLocalObjectSharedPtr{new ThreadLocalStreamer(shared_state)};
+  SharedStateSharedPtr shared_state = std::make_shared<SharedState>(
+      std::move(factory), local_info, scope, buffer_size_bytes, buffer_flush_interval);
+  tls_slot_->set([shared_state](Event::Dispatcher& dispatcher) {
+    return ThreadLocal::ThreadLocalObjectSharedPtr{
+        new ThreadLocalStreamer(shared_state, dispatcher)};
   });
 }
 
 void GrpcAccessLogStreamerImpl::ThreadLocalStream::onRemoteClose(Grpc::Status::GrpcStatus,
                                                                  const std::string&) {
-  auto it = parent_.stream_map_.find(log_name_);
-  ASSERT(it != parent_.stream_map_.end());
-  if (it->second.stream_ != nullptr) {
-    // Only erase if we have a stream. Otherwise we had an inline failure and we will clear the
-    // stream data in send().
-    parent_.stream_map_.erase(it);
+  // Buffered entries are kept, and a new stream is started for them on the next flush. If the
+  // stream failed inline in flush() there is no stream to clear.
+  stream_ = nullptr;
+}
+
+void GrpcAccessLogStreamerImpl::ThreadLocalStream::flush() {
+  const int entries = message_.http_logs().log_entry_size();
+  if (entries == 0) {
+    return;
+  }
+
+  GrpcAccessLogStats& stats = parent_.shared_state_->stats_;
+  if (stream_ == nullptr) {
+    stream_ = parent_.client_->start(
+        *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+            "envoy.service.accesslog.v2.AccessLogService.StreamAccessLogs"),
+        *this);
+
+    // Only the first message of a stream identifies the log.
+    if (stream_ != nullptr) {
+      auto* identifier = message_.mutable_identifier();
+      *identifier->mutable_node() = parent_.shared_state_->local_info_.node();
+      identifier->set_log_name(log_name_);
+    }
   }
+
+  if (stream_ != nullptr) {
+    stream_->sendMessage(message_, false);
+    stats.logs_written_.add(entries);
+  } else {
+    stats.logs_dropped_.add(entries);
+  }
+
+  message_.Clear();
+  approximate_message_size_bytes_ = 0;
 }
 
 GrpcAccessLogStreamerImpl::ThreadLocalStreamer::ThreadLocalStreamer(
-    const SharedStateSharedPtr& shared_state)
-    : client_(shared_state->factory_->create()), shared_state_(shared_state) {}
+    const SharedStateSharedPtr& shared_state, Event::Dispatcher& dispatcher)
+    : client_(shared_state->factory_->create()), shared_state_(shared_state) {
+  flush_timer_ = dispatcher.createTimer([this]() -> void {
+    flush();
+    flush_timer_->enableTimer(shared_state_->buffer_flush_interval_);
+  });
+  flush_timer_->enableTimer(shared_state_->buffer_flush_interval_);
+}
 
-void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::send(
-    envoy::service::accesslog::v2::StreamAccessLogsMessage& message, const std::string& log_name) {
+void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::log(
+    envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry, const std::string& log_name) {
   auto stream_it = stream_map_.find(log_name);
   if (stream_it == stream_map_.end()) {
     stream_it = stream_map_.emplace(log_name, ThreadLocalStream(*this, log_name)).first;
   }
 
   auto& stream_entry = stream_it->second;
-  if (stream_entry.stream_ == nullptr) {
-    stream_entry.stream_ =
-        client_->start(*Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
-                           "envoy.service.accesslog.v2.AccessLogService.StreamAccessLogs"),
-                       stream_entry);
-
-    auto* identifier = message.mutable_identifier();
-    *identifier->mutable_node() = shared_state_->local_info_.node();
-    identifier->set_log_name(log_name);
+  stream_entry.approximate_message_size_bytes_ += entry.ByteSize();
+  stream_entry.message_.mutable_http_logs()->add_log_entry()->Swap(&entry);
+  if (stream_entry.approximate_message_size_bytes_ >= shared_state_->buffer_size_bytes_) {
+    stream_entry.flush();
   }
+}
 
-  if (stream_entry.stream_ != nullptr) {
-    stream_entry.stream_->sendMessage(message, false);
-  } else {
-    // Clear out the stream data due to stream creation failure.
-    stream_map_.erase(stream_it);
+void GrpcAccessLogStreamerImpl::ThreadLocalStreamer::flush() {
+  for (auto& stream : stream_map_) {
+    stream.second.flush();
   }
 }
 
@@ -149,8 +180,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message;
-  auto* log_entry = message.mutable_http_logs()->add_log_entry();
+  envoy::api::v2::filter::accesslog::HTTPAccessLogEntry log_entry;
 
   // Common log properties.
   // TODO(mattklein123): Populate sample_rate field.
@@ -160,7 +190,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   // TODO(mattklein123): Populate time_to_last_upstream_rx_byte field.
   // TODO(mattklein123): Populate time_to_first_downstream_tx_byte field.
   // TODO(mattklein123): Populate metadata field and wire up to filters.
-  auto* common_properties = log_entry->mutable_common_properties();
+  auto* common_properties = log_entry.mutable_common_properties();
   addressToAccessLogAddress(*common_properties->mutable_downstream_remote_address(),
                             *request_info.downstreamRemoteAddress());
   addressToAccessLogAddress(*common_properties->mutable_downstream_local_address(),
@@ -196,15 +226,13 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   if (request_info.protocol().valid()) {
     switch (request_info.protocol().value()) {
     case Http::Protocol::Http10:
-      log_entry->set_protocol_version(
-          envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP10);
+      log_entry.set_protocol_version(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP10);
       break;
     case Http::Protocol::Http11:
-      log_entry->set_protocol_version(
-          envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP11);
+      log_entry.set_protocol_version(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP11);
       break;
     case Http::Protocol::Http2:
-      log_entry->set_protocol_version(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP2);
+      log_entry.set_protocol_version(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry::HTTP2);
       break;
     }
   }
@@ -212,7 +240,7 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
   // HTTP request properities.
   // TODO(mattklein123): Populate port field.
   // TODO(mattklein123): Populate custom request headers.
-  auto* request_properties = log_entry->mutable_request();
+  auto* request_properties = log_entry.mutable_request();
   if (request_headers->Scheme() != nullptr) {
     request_properties->set_scheme(request_headers->Scheme()->value().c_str());
   }
@@ -242,15 +270,14 @@ void HttpGrpcAccessLog::log(const Http::HeaderMap* request_headers,
 
   // HTTP response properties.
   // TODO(mattklein123): Populate custom response headers.
-  auto* response_properties = log_entry->mutable_response();
+  auto* response_properties = log_entry.mutable_response();
   if (request_info.responseCode().valid()) {
     response_properties->mutable_response_code()->set_value(request_info.responseCode().value());
   }
   response_properties->set_response_headers_bytes(response_headers->byteSize());
   response_properties->set_response_body_bytes(request_info.bytesSent());
 
-  // TODO(mattklein123): Consider batching multiple logs and flushing.
-  grpc_access_log_streamer_->send(message, config_.common_config().log_name());
+  grpc_access_log_streamer_->log(log_entry, config_.common_config().log_name());
 }
 
 } // namespace AccessLog
@@ -5,17 +5,34 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/filter/accesslog/accesslog.pb.h"
 #include "envoy/config/accesslog/v2/als.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
 #include "envoy/grpc/async_client.h"
 #include "envoy/grpc/async_client_manager.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v2/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 namespace Envoy {
 namespace AccessLog {
 
-// TODO(mattklein123): Stats
+/**
+ * All gRPC access log stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_GRPC_ACCESS_LOG_STATS(COUNTER)                                                         \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(logs_dropped)
+// clang-format on
+
+/**
+ * Struct definition for all gRPC access log stats. @see stats_macros.h
+ */
+struct GrpcAccessLogStats {
+  ALL_GRPC_ACCESS_LOG_STATS(GENERATE_COUNTER_STRUCT)
+};
 
 /**
  * Interface for an access log streamer. The streamer deals with threading and sends access logs
@@ -26,29 +43,41 @@ public:
   virtual ~GrpcAccessLogStreamer() {}
 
   /**
-   * Send an access log.
-   * @param message supplies the access log to send.
+   * Log an HTTP access log entry. Entries may be buffered and sent later, together with other
+   * entries for the same log.
+   * @param entry supplies the entry to log. Its contents are moved into the buffer, leaving it
+   *        empty.
    * @param log_name supplies the name of the log stream to send on.
    */
-  virtual void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                    const std::string& log_name) PURE;
+  virtual void log(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry,
+                   const std::string& log_name) PURE;
 };
 
 typedef std::shared_ptr<GrpcAccessLogStreamer> GrpcAccessLogStreamerSharedPtr;
 
 /**
  * Production implementation of GrpcAccessLogStreamer that supports per-thread and per-log
- * streams.
+ * streams. Each thread buffers the entries of each log and sends them in a single message once
+ * the buffer reaches a size limit, or when the flush interval elapses. Entries are dropped if no
+ * stream can be established when they are flushed.
  */
 class GrpcAccessLogStreamerImpl : public Singleton::Instance, public GrpcAccessLogStreamer {
 public:
+  /**
+   * @param buffer_size_bytes supplies the approximate size of the entries of a log at which they
+   *        are flushed. Zero sends every entry as soon as it is logged.
+   * @param buffer_flush_interval supplies the interval at which the buffered entries are flushed
+   *        regardless of their size.
+   */
   GrpcAccessLogStreamerImpl(Grpc::AsyncClientFactoryPtr&& factory, ThreadLocal::SlotAllocator& tls,
-                            const LocalInfo::LocalInfo& local_info);
+                            const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
+                            uint64_t buffer_size_bytes,
+                            std::chrono::milliseconds buffer_flush_interval);
 
   // GrpcAccessLogStreamer
-  void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-            const std::string& log_name) override {
-    tls_slot_->getTyped<ThreadLocalStreamer>().send(message, log_name);
+  void log(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry,
+           const std::string& log_name) override {
+    tls_slot_->getTyped<ThreadLocalStreamer>().log(entry, log_name);
   }
 
 private:
@@ -57,11 +86,22 @@ private:
    * slot to be destroyed while the streamers hold onto the shared state.
    */
   struct SharedState {
-    SharedState(Grpc::AsyncClientFactoryPtr&& factory, const LocalInfo::LocalInfo& local_info)
-        : factory_(std::move(factory)), local_info_(local_info) {}
+    SharedState(Grpc::AsyncClientFactoryPtr&& factory, const LocalInfo::LocalInfo& local_info,
+                Stats::Scope& scope, uint64_t buffer_size_bytes,
+                std::chrono::milliseconds buffer_flush_interval)
+        : factory_(std::move(factory)), local_info_(local_info),
+          scope_(scope.createScope("access_logs.grpc_access_log.")),
+          stats_{ALL_GRPC_ACCESS_LOG_STATS(POOL_COUNTER(*scope_))},
+          buffer_size_bytes_(buffer_size_bytes), buffer_flush_interval_(buffer_flush_interval) {}
 
     Grpc::AsyncClientFactoryPtr factory_;
     const LocalInfo::LocalInfo& local_info_;
+    // The streamer is shared by the access logs of all listeners, so it owns its scope rather than
+    // using the scope of the listener that happened to create it.
+    Stats::ScopePtr scope_;
+    GrpcAccessLogStats stats_;
+    const uint64_t buffer_size_bytes_;
+    const std::chrono::milliseconds buffer_flush_interval_;
   };
 
   typedef std::shared_ptr<SharedState> SharedStateSharedPtr;
@@ -84,20 +124,27 @@ private:
     void onReceiveTrailingMetadata(Http::HeaderMapPtr&&) override {}
     void onRemoteClose(Grpc::Status::GrpcStatus status, const std::string& message) override;
 
+    void flush();
+
     ThreadLocalStreamer& parent_;
     const std::string log_name_;
     Grpc::AsyncStream* stream_{};
+    // Entries waiting to be sent.
+    envoy::service::accesslog::v2::StreamAccessLogsMessage message_;
+    uint64_t approximate_message_size_bytes_{};
   };
 
   /**
    * Per-thread multi-stream state.
    */
   struct ThreadLocalStreamer : public ThreadLocal::ThreadLocalObject {
-    ThreadLocalStreamer(const SharedStateSharedPtr& shared_state);
-    void send(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-              const std::string& log_name);
+    ThreadLocalStreamer(const SharedStateSharedPtr& shared_state, Event::Dispatcher& dispatcher);
+    void log(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry,
+             const std::string& log_name);
+    void flush();
 
     Grpc::AsyncClientPtr client_;
+    Event::TimerPtr flush_timer_;
     std::unordered_map<std::string, ThreadLocalStream> stream_map_;
     SharedStateSharedPtr shared_state_;
   };
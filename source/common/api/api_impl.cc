@@ -18,7 +18,7 @@ Impl::Impl(std::chrono::milliseconds file_flush_interval_msec)
 
 Filesystem::FileSharedPtr Impl::createFile(const std::string& path, Event::Dispatcher& dispatcher,
                                            Thread::BasicLockable& lock, Stats::Store& stats_store) {
-  return std::make_shared<Filesystem::FileImpl>(path, dispatcher, lock, stats_store,
+  return std::make_shared<Filesystem::FileImpl>(path, dispatcher, lock, file_flusher_, stats_store,
                                                 file_flush_interval_msec_);
 }
 
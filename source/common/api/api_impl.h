@@ -6,6 +6,8 @@
 #include "envoy/api/api.h"
 #include "envoy/filesystem/filesystem.h"
 
+#include "common/filesystem/filesystem_impl.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -26,6 +28,8 @@ public:
 
 private:
   std::chrono::milliseconds file_flush_interval_msec_;
+  // Flushes all of the files created by this Api, which must be destroyed before it.
+  Filesystem::FileFlusher file_flusher_;
 };
 
 } // namespace Api
@@ -21,6 +21,10 @@ ssize_t OsSysCallsImpl::write(int fd, const void* buffer, size_t num_bytes) {
   return ::write(fd, buffer, num_bytes);
 }
 
+ssize_t OsSysCallsImpl::writev(int fd, const iovec* iovec, int num_iovec) {
+  return ::writev(fd, iovec, num_iovec);
+}
+
 int OsSysCallsImpl::shmOpen(const char* name, int oflag, mode_t mode) {
   return ::shm_open(name, oflag, mode);
 }
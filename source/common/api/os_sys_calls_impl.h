@@ -13,6 +13,7 @@ public:
   int bind(int sockfd, const sockaddr* addr, socklen_t addrlen) override;
   int open(const std::string& full_path, int flags, int mode) override;
   ssize_t write(int fd, const void* buffer, size_t num_bytes) override;
+  ssize_t writev(int fd, const iovec* iovec, int num_iovec) override;
   int close(int fd) override;
   int shmOpen(const char* name, int oflag, mode_t mode) override;
   int shmUnlink(const char* name) override;
@@ -1,36 +1,150 @@
 #include "common/buffer/buffer_impl.h"
 
+#include <sys/uio.h>
+
 #include <cstdint>
 #include <string>
 
 #include "common/common/assert.h"
 
-#include "event2/buffer.h"
-
 namespace Envoy {
 namespace Buffer {
 
-// RawSlice is the same structure as evbuffer_iovec. This was put into place to avoid leaking
-// libevent into most code since we will likely replace evbuffer with our own implementation at
-// some point. However, we can avoid a bunch of copies since the structure is the same.
-static_assert(sizeof(RawSlice) == sizeof(evbuffer_iovec), "RawSlice != evbuffer_iovec");
-static_assert(offsetof(RawSlice, mem_) == offsetof(evbuffer_iovec, iov_base),
-              "RawSlice != evbuffer_iovec");
-static_assert(offsetof(RawSlice, len_) == offsetof(evbuffer_iovec, iov_len),
-              "RawSlice != evbuffer_iovec");
+namespace {
 
-void OwnedImpl::add(const void* data, uint64_t size) { evbuffer_add(buffer_.get(), data, size); }
+// Maximum number of slices handed to a single readv()/writev() call.
+constexpr uint64_t MaxIoSlices = 16;
 
-void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
-  evbuffer_add_reference(
-      buffer_.get(), fragment.data(), fragment.size(),
-      [](const void*, size_t, void* arg) { static_cast<BufferFragment*>(arg)->done(); }, &fragment);
+// Maximum number of free slabs cached per thread (4MB with 16KB slabs). Slabs released beyond
+// this are returned to the allocator so that a traffic burst does not pin memory forever.
+constexpr uint32_t MaxFreeSlabsPerThread = 256;
+
+/**
+ * Per-thread free list of slab memory. The list is intrusive: a free slab's first bytes hold the
+ * pointer to the next free slab.
+ */
+struct SlabFreeList {
+  struct FreeSlab {
+    FreeSlab* next_;
+  };
+
+  ~SlabFreeList();
+
+  FreeSlab* head_{nullptr};
+  uint32_t size_{0};
+};
+
+thread_local SlabFreeList slab_free_list_;
+// Slices may be destroyed after the thread's free list during thread or process teardown (e.g.
+// buffers owned by static objects). This is trivially destructible so it remains readable then.
+thread_local bool slab_free_list_destroyed_ = false;
+
+SlabFreeList::~SlabFreeList() {
+  slab_free_list_destroyed_ = true;
+  while (head_ != nullptr) {
+    FreeSlab* slab = head_;
+    head_ = slab->next_;
+    ::operator delete(slab);
+  }
+  size_ = 0;
 }
 
-void OwnedImpl::add(const std::string& data) {
-  evbuffer_add(buffer_.get(), data.c_str(), data.size());
+/**
+ * An OwnedSlice whose header and SlabSize bytes of storage are a single allocation recycled through
+ * the per-thread free list.
+ */
+class SlabSlice : public OwnedSlice {
+public:
+  SlabSlice() : OwnedSlice(storage_, 0, SlabSize) {}
+
+  static void* operator new(size_t size) {
+    ASSERT(size == sizeof(SlabSlice));
+    if (!slab_free_list_destroyed_ && slab_free_list_.head_ != nullptr) {
+      SlabFreeList::FreeSlab* slab = slab_free_list_.head_;
+      slab_free_list_.head_ = slab->next_;
+      slab_free_list_.size_--;
+      return slab;
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* p) {
+    if (slab_free_list_destroyed_ || slab_free_list_.size_ >= MaxFreeSlabsPerThread) {
+      ::operator delete(p);
+      return;
+    }
+    SlabFreeList::FreeSlab* slab = static_cast<SlabFreeList::FreeSlab*>(p);
+    slab->next_ = slab_free_list_.head_;
+    slab_free_list_.head_ = slab;
+    slab_free_list_.size_++;
+  }
+
+private:
+  uint8_t storage_[SlabSize];
+};
+
+/**
+ * An OwnedSlice for reservations larger than a slab. The capacity is rounded up to a multiple of
+ * the slab size.
+ */
+class HeapSlice : public OwnedSlice {
+public:
+  HeapSlice(uint64_t capacity)
+      : OwnedSlice(nullptr, 0, capacity), storage_(new uint8_t[capacity]) {
+    base_ = storage_.get();
+  }
+
+private:
+  std::unique_ptr<uint8_t[]> storage_;
+};
+
+} // namespace
+
+constexpr uint64_t OwnedSlice::SlabSize;
+constexpr size_t SliceDeque::InlineRingCapacity;
+
+SlicePtr OwnedSlice::create(uint64_t min_capacity) {
+  if (min_capacity <= SlabSize) {
+    return SlicePtr{new SlabSlice()};
+  }
+  return SlicePtr{new HeapSlice((min_capacity + SlabSize - 1) / SlabSize * SlabSize)};
+}
+
+void SliceDeque::growRing() {
+  if (size_ < capacity_) {
+    return;
+  }
+  const size_t new_capacity = capacity_ * 2;
+  std::unique_ptr<SlicePtr[]> new_ring(new SlicePtr[new_capacity]);
+  for (size_t i = 0; i < size_; i++) {
+    new_ring[i] = std::move(ring_[internalIndex(i)]);
+  }
+  external_ring_ = std::move(new_ring);
+  ring_ = external_ring_.get();
+  start_ = 0;
+  capacity_ = new_capacity;
+}
+
+void OwnedImpl::add(const void* data, uint64_t size) {
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  while (size != 0) {
+    if (slices_.empty() || slices_.back()->reservableSize() == 0) {
+      slices_.emplace_back(OwnedSlice::create(std::min(size, OwnedSlice::SlabSize)));
+    }
+    const uint64_t copy_size = slices_.back()->append(src, size);
+    src += copy_size;
+    size -= copy_size;
+    length_ += copy_size;
+  }
 }
 
+void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
+  length_ += fragment.size();
+  slices_.emplace_back(SlicePtr{new UnownedSlice(fragment)});
+}
+
+void OwnedImpl::add(const std::string& data) { add(data.data(), data.size()); }
+
 void OwnedImpl::add(const Instance& data) {
   uint64_t num_slices = data.getRawSlices(nullptr, 0);
   RawSlice slices[num_slices];
@@ -41,89 +155,317 @@ void OwnedImpl::add(const Instance& data) {
 }
 
 void OwnedImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
-  int rc =
-      evbuffer_commit_space(buffer_.get(), reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
-  ASSERT(rc == 0);
-  UNREFERENCED_PARAMETER(rc);
+  if (num_iovecs == 0 || slices_.empty()) {
+    return;
+  }
+
+  // Reservations are always made from the back of the buffer, so skip back over trailing empty
+  // slices to the last slice holding data (whose tail may hold the first reservation) and then
+  // match the iovecs against slices going forward.
+  size_t slice_index = slices_.size() - 1;
+  while (slice_index > 0 && slices_[slice_index]->dataSize() == 0) {
+    slice_index--;
+  }
+
+  uint64_t num_committed = 0;
+  while (num_committed < num_iovecs && slice_index < slices_.size()) {
+    const RawSlice& iovec = iovecs[num_committed];
+    if (iovec.len_ == 0) {
+      // Nothing was written into this reservation.
+      num_committed++;
+    } else if (slices_[slice_index]->commit(iovec)) {
+      length_ += iovec.len_;
+      num_committed++;
+      slice_index++;
+    } else {
+      slice_index++;
+    }
+  }
+  ASSERT(num_committed == num_iovecs);
 }
 
 void OwnedImpl::copyOut(size_t start, uint64_t size, void* data) const {
   ASSERT(start + size <= length());
 
-  evbuffer_ptr start_ptr;
-  int rc = evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET);
-  ASSERT(rc != -1);
-  UNREFERENCED_PARAMETER(rc);
-
-  ev_ssize_t copied = evbuffer_copyout_from(buffer_.get(), &start_ptr, data, size);
-  ASSERT(static_cast<uint64_t>(copied) == size);
-  UNREFERENCED_PARAMETER(copied);
+  uint8_t* dest = static_cast<uint8_t*>(data);
+  for (size_t i = 0; i < slices_.size() && size != 0; i++) {
+    const Slice& slice = *slices_[i];
+    const uint64_t slice_size = slice.dataSize();
+    if (start >= slice_size) {
+      start -= slice_size;
+      continue;
+    }
+    const uint64_t copy_size = std::min(slice_size - start, size);
+    memcpy(dest, slice.data() + start, copy_size);
+    dest += copy_size;
+    size -= copy_size;
+    start = 0;
+  }
 }
 
 void OwnedImpl::drain(uint64_t size) {
   ASSERT(size <= length());
-  int rc = evbuffer_drain(buffer_.get(), size);
-  ASSERT(rc == 0);
-  UNREFERENCED_PARAMETER(rc);
+  length_ -= size;
+  while (size != 0) {
+    Slice& slice = *slices_.front();
+    const uint64_t slice_size = slice.dataSize();
+    if (slice_size <= size) {
+      slices_.pop_front();
+      size -= slice_size;
+    } else {
+      slice.drain(size);
+      size = 0;
+    }
+  }
+
+  // Release any empty slices left at the front, such as zero-length fragments. A lone empty slice
+  // is kept as it may hold an outstanding reservation.
+  while (slices_.size() > 1 && slices_.front()->dataSize() == 0) {
+    slices_.pop_front();
+  }
 }
 
 uint64_t OwnedImpl::getRawSlices(RawSlice* out, uint64_t out_size) const {
-  return evbuffer_peek(buffer_.get(), -1, nullptr, reinterpret_cast<evbuffer_iovec*>(out),
-                       out_size);
+  uint64_t num_slices = 0;
+  for (size_t i = 0; i < slices_.size(); i++) {
+    const Slice& slice = *slices_[i];
+    if (slice.dataSize() == 0) {
+      continue;
+    }
+    if (num_slices < out_size) {
+      out[num_slices].mem_ = const_cast<uint8_t*>(slice.data());
+      out[num_slices].len_ = slice.dataSize();
+    }
+    num_slices++;
+  }
+  return num_slices;
 }
 
-uint64_t OwnedImpl::length() const { return evbuffer_get_length(buffer_.get()); }
-
 void* OwnedImpl::linearize(uint32_t size) {
   ASSERT(size <= length());
-  return evbuffer_pullup(buffer_.get(), size);
+  if (size == 0) {
+    return slices_.empty() ? nullptr : slices_.front()->data();
+  }
+  if (slices_.front()->dataSize() >= size) {
+    return slices_.front()->data();
+  }
+
+  // Copy the first size bytes into a new slice and put it in place of the data it replaces.
+  SlicePtr linear = OwnedSlice::create(size);
+  uint64_t remaining = size;
+  while (remaining != 0) {
+    Slice& slice = *slices_.front();
+    const uint64_t copy_size = std::min(slice.dataSize(), remaining);
+    linear->append(slice.data(), copy_size);
+    remaining -= copy_size;
+    if (copy_size == slice.dataSize()) {
+      slices_.pop_front();
+    } else {
+      slice.drain(copy_size);
+    }
+  }
+  slices_.emplace_front(std::move(linear));
+  return slices_.front()->data();
 }
 
 void OwnedImpl::move(Instance& rhs) {
   // We do the static cast here because in practice we only have one buffer implementation right
-  // now and this is safe. Using the evbuffer move routines require having access to both evbuffers.
-  // This is a reasonable compromise in a high performance path where we want to maintain an
-  // abstraction in case we get rid of evbuffer later.
-  int rc = evbuffer_add_buffer(buffer_.get(), static_cast<LibEventInstance&>(rhs).buffer().get());
-  ASSERT(rc == 0);
-  UNREFERENCED_PARAMETER(rc);
-  static_cast<LibEventInstance&>(rhs).postProcess();
+  // now and this is safe. Moving slices requires access to the other buffer's slice ring. This is
+  // a reasonable compromise in a high performance path where we want to maintain an abstraction.
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  while (!other.slices_.empty()) {
+    if (other.slices_.front()->dataSize() > 0) {
+      slices_.emplace_back(std::move(other.slices_.front()));
+    }
+    other.slices_.pop_front();
+  }
+  length_ += other.length_;
+  other.length_ = 0;
+  other.postProcess();
 }
 
 void OwnedImpl::move(Instance& rhs, uint64_t length) {
   // See move() above for why we do the static cast.
-  int rc = evbuffer_remove_buffer(static_cast<LibEventInstance&>(rhs).buffer().get(), buffer_.get(),
-                                  length);
-  ASSERT(static_cast<uint64_t>(rc) == length);
-  UNREFERENCED_PARAMETER(rc);
-  static_cast<LibEventInstance&>(rhs).postProcess();
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  ASSERT(length <= other.length());
+  while (length != 0) {
+    SlicePtr& slice = other.slices_.front();
+    const uint64_t slice_size = slice->dataSize();
+    if (slice_size == 0) {
+      other.slices_.pop_front();
+    } else if (slice_size <= length) {
+      // Transfer ownership of the whole slice.
+      length_ += slice_size;
+      other.length_ -= slice_size;
+      length -= slice_size;
+      slices_.emplace_back(std::move(slice));
+      other.slices_.pop_front();
+    } else {
+      // Copy the front of a slice that is only partially moved.
+      add(slice->data(), length);
+      other.drain(length);
+      length = 0;
+    }
+  }
+  other.postProcess();
 }
 
 int OwnedImpl::read(int fd, uint64_t max_length) {
-  return evbuffer_read(buffer_.get(), fd, max_length);
+  if (max_length == 0) {
+    return 0;
+  }
+
+  RawSlice slices[MaxIoSlices];
+  const uint64_t num_slices = reserve(max_length, slices, MaxIoSlices);
+  iovec iov[MaxIoSlices];
+  uint64_t num_bytes_to_read = 0;
+  uint64_t num_slices_to_read = 0;
+  for (; num_slices_to_read < num_slices && num_bytes_to_read < max_length;
+       num_slices_to_read++) {
+    const uint64_t slice_length =
+        std::min<uint64_t>(slices[num_slices_to_read].len_, max_length - num_bytes_to_read);
+    iov[num_slices_to_read].iov_base = slices[num_slices_to_read].mem_;
+    iov[num_slices_to_read].iov_len = slice_length;
+    num_bytes_to_read += slice_length;
+  }
+
+  const ssize_t rc = ::readv(fd, iov, static_cast<int>(num_slices_to_read));
+  if (rc <= 0) {
+    releaseEmptyTail();
+    return rc;
+  }
+
+  uint64_t bytes_to_commit = rc;
+  uint64_t num_slices_to_commit = 0;
+  while (bytes_to_commit != 0) {
+    slices[num_slices_to_commit].len_ =
+        std::min<uint64_t>(slices[num_slices_to_commit].len_, bytes_to_commit);
+    bytes_to_commit -= slices[num_slices_to_commit].len_;
+    num_slices_to_commit++;
+  }
+  commit(slices, num_slices_to_commit);
+  releaseEmptyTail();
+  return rc;
 }
 
 uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) {
-  uint64_t ret = evbuffer_reserve_space(buffer_.get(), length,
-                                        reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
-  ASSERT(ret >= 1);
-  return ret;
+  ASSERT(num_iovecs > 0);
+  if (length == 0) {
+    iovecs[0] = {nullptr, 0};
+    return 1;
+  }
+
+  // Use the reservable tail of the last slice first, then whole slabs, and finally a single
+  // slice for whatever remains when only one iovec is left.
+  uint64_t num_used = 0;
+  uint64_t remaining = length;
+  if (!slices_.empty() && slices_.back()->reservableSize() > 0 &&
+      (num_iovecs > 1 || slices_.back()->reservableSize() >= length)) {
+    iovecs[num_used] = slices_.back()->reserve(remaining);
+    remaining -= iovecs[num_used].len_;
+    num_used++;
+  }
+  while (remaining != 0) {
+    ASSERT(num_used < num_iovecs);
+    const bool last_iovec = num_used + 1 == num_iovecs;
+    slices_.emplace_back(
+        OwnedSlice::create(last_iovec ? remaining : std::min(remaining, OwnedSlice::SlabSize)));
+    iovecs[num_used] = slices_.back()->reserve(remaining);
+    remaining -= iovecs[num_used].len_;
+    num_used++;
+  }
+
+  // Hand out the full reservable space of the last slice, as evbuffer did. Callers such as the
+  // HTTP/1 codec rely on getting at least, but possibly more than, the requested length.
+  RawSlice& last = iovecs[num_used - 1];
+  last = slices_.back()->reserve(slices_.back()->reservableSize());
+  return num_used;
 }
 
 ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start) const {
-  evbuffer_ptr start_ptr;
-  if (-1 == evbuffer_ptr_set(buffer_.get(), &start_ptr, start, EVBUFFER_PTR_SET)) {
+  if (start > length_) {
     return -1;
   }
+  if (size == 0) {
+    return start;
+  }
+
+  // This is the same naive scan that evbuffer_search() uses: find the first byte of the needle,
+  // then compare the remainder, which may span several slices.
+  const uint8_t* needle = static_cast<const uint8_t*>(data);
+  uint64_t offset = 0;
+  for (size_t slice_index = 0; slice_index < slices_.size(); slice_index++) {
+    const Slice& slice = *slices_[slice_index];
+    const uint64_t slice_size = slice.dataSize();
+    if (start >= slice_size) {
+      start -= slice_size;
+      offset += slice_size;
+      continue;
+    }
+
+    const uint8_t* haystack = slice.data() + start;
+    const uint8_t* haystack_end = slice.data() + slice_size;
+    while (haystack < haystack_end) {
+      const uint8_t* first_byte =
+          static_cast<const uint8_t*>(memchr(haystack, needle[0], haystack_end - haystack));
+      if (first_byte == nullptr) {
+        break;
+      }
+
+      uint64_t i = 1;
+      size_t match_index = slice_index;
+      const uint8_t* match_next = first_byte + 1;
+      const uint8_t* match_end = haystack_end;
+      while (i < size) {
+        if (match_next == match_end) {
+          if (++match_index == slices_.size()) {
+            // The needle runs off the end of the buffer.
+            return -1;
+          }
+          match_next = slices_[match_index]->data();
+          match_end = match_next + slices_[match_index]->dataSize();
+          continue;
+        }
+        if (*match_next++ != needle[i]) {
+          break;
+        }
+        i++;
+      }
+      if (i == size) {
+        return offset + (first_byte - slice.data());
+      }
+      haystack = first_byte + 1;
+    }
+
+    start = 0;
+    offset += slice_size;
+  }
+  return -1;
+}
 
-  evbuffer_ptr result_ptr =
-      evbuffer_search(buffer_.get(), static_cast<const char*>(data), size, &start_ptr);
-  return result_ptr.pos;
+int OwnedImpl::write(int fd) {
+  RawSlice slices[MaxIoSlices];
+  const uint64_t num_slices = std::min(getRawSlices(slices, MaxIoSlices), MaxIoSlices);
+  iovec iov[MaxIoSlices];
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
+
+  const ssize_t rc = ::writev(fd, iov, static_cast<int>(num_slices));
+  if (rc > 0) {
+    drain(static_cast<uint64_t>(rc));
+  }
+  return rc;
 }
 
-int OwnedImpl::write(int fd) { return evbuffer_write(buffer_.get(), fd); }
+void OwnedImpl::releaseEmptyTail() {
+  while (!slices_.empty() && slices_.back()->dataSize() == 0) {
+    slices_.pop_back();
+  }
+}
 
-OwnedImpl::OwnedImpl() : buffer_(evbuffer_new()) {}
+OwnedImpl::OwnedImpl() {}
 
 OwnedImpl::OwnedImpl(const std::string& data) : OwnedImpl() { add(data); }
 
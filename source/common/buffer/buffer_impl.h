@@ -1,16 +1,214 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
 
+#include "common/common/assert.h"
 #include "common/common/non_copyable.h"
-#include "common/event/libevent.h"
 
 namespace Envoy {
 namespace Buffer {
 
+/**
+ * A contiguous region of memory that holds a portion of a buffer's data. The region is laid out
+ * as:
+ *
+ *   base_                data_               reservable_           capacity_
+ *   |  drained           |  data             |  reservable         |
+ *
+ * Data is drained from the front and appended (or reserved and later committed) at the back.
+ */
+class Slice {
+public:
+  virtual ~Slice() {}
+
+  /**
+   * @return a pointer to the start of the readable data in the slice.
+   */
+  const uint8_t* data() const { return base_ + data_; }
+  uint8_t* data() { return base_ + data_; }
+
+  /**
+   * @return the number of readable bytes in the slice.
+   */
+  uint64_t dataSize() const { return reservable_ - data_; }
+
+  /**
+   * Remove data from the front of the slice.
+   * @param size supplies the number of bytes to remove. Must be <= dataSize().
+   */
+  void drain(uint64_t size) {
+    ASSERT(data_ + size <= reservable_);
+    data_ += size;
+  }
+
+  /**
+   * @return the number of bytes that can be appended or reserved at the back of the slice.
+   */
+  uint64_t reservableSize() const { return capacity_ - reservable_; }
+
+  /**
+   * Hand out up to size bytes of the reservable region. The region does not become part of the
+   * slice's data until commit() is called.
+   * @param size supplies the desired reservation size.
+   * @return a slice describing the reservation, which may be smaller than size or empty.
+   */
+  RawSlice reserve(uint64_t size) {
+    const uint64_t reservation_size = std::min(size, reservableSize());
+    if (reservation_size == 0) {
+      return {nullptr, 0};
+    }
+    return {base_ + reservable_, static_cast<size_t>(reservation_size)};
+  }
+
+  /**
+   * Commit a reservation previously obtained from reserve().
+   * @param reservation supplies the reservation, with len_ possibly shrunk to the bytes written.
+   * @return true if the reservation belongs to this slice and was committed, false otherwise.
+   */
+  bool commit(const RawSlice& reservation) {
+    if (static_cast<const uint8_t*>(reservation.mem_) != base_ + reservable_ ||
+        reservation.len_ > reservableSize()) {
+      return false;
+    }
+    reservable_ += reservation.len_;
+    return true;
+  }
+
+  /**
+   * Copy as much of the supplied data as fits into the reservable region.
+   * @param data supplies the data to copy.
+   * @param size supplies the data size.
+   * @return the number of bytes copied.
+   */
+  uint64_t append(const void* data, uint64_t size) {
+    const uint64_t copy_size = std::min(size, reservableSize());
+    if (copy_size > 0) {
+      memcpy(base_ + reservable_, data, copy_size);
+      reservable_ += copy_size;
+    }
+    return copy_size;
+  }
+
+protected:
+  Slice(uint8_t* base, uint64_t reservable, uint64_t capacity)
+      : base_(base), reservable_(reservable), capacity_(capacity) {}
+
+  uint8_t* base_;
+  uint64_t data_{0};
+  uint64_t reservable_;
+  uint64_t capacity_;
+};
+
+typedef std::unique_ptr<Slice> SlicePtr;
+
+/**
+ * A slice that owns its memory. Slices up to SlabSize bytes are carved from fixed-size slabs that
+ * are recycled through a per-thread free list, so steady-state buffer traffic does not touch the
+ * allocator. Larger slices are allocated directly.
+ */
+class OwnedSlice : public Slice {
+public:
+  // Size of a pooled slab. This matches the largest TLS record and the default socket read size.
+  static constexpr uint64_t SlabSize = 16384;
+
+  /**
+   * Create an empty slice with at least min_capacity bytes of reservable space.
+   */
+  static SlicePtr create(uint64_t min_capacity);
+
+protected:
+  using Slice::Slice;
+};
+
+/**
+ * A slice that references externally owned data. BufferFragment::done() is called when the slice
+ * is destroyed, i.e. once the last byte of the fragment has been drained or moved out and drained.
+ */
+class UnownedSlice : public Slice {
+public:
+  UnownedSlice(BufferFragment& fragment)
+      : Slice(static_cast<uint8_t*>(const_cast<void*>(fragment.data())), fragment.size(),
+              fragment.size()),
+        fragment_(fragment) {}
+
+  ~UnownedSlice() override { fragment_.done(); }
+
+private:
+  BufferFragment& fragment_;
+};
+
+/**
+ * A double-ended ring of slices. The first InlineRingCapacity entries are stored inline so that
+ * small buffers never allocate ring storage; the ring grows by doubling beyond that.
+ */
+class SliceDeque : NonCopyable {
+public:
+  SliceDeque() : ring_(inline_ring_), capacity_(InlineRingCapacity) {}
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  SlicePtr& operator[](size_t i) { return ring_[internalIndex(i)]; }
+  const SlicePtr& operator[](size_t i) const { return ring_[internalIndex(i)]; }
+  SlicePtr& front() { return ring_[start_]; }
+  const SlicePtr& front() const { return ring_[start_]; }
+  SlicePtr& back() { return ring_[internalIndex(size_ - 1)]; }
+  const SlicePtr& back() const { return ring_[internalIndex(size_ - 1)]; }
+
+  void emplace_back(SlicePtr&& slice) {
+    growRing();
+    ring_[internalIndex(size_)] = std::move(slice);
+    size_++;
+  }
+
+  void emplace_front(SlicePtr&& slice) {
+    growRing();
+    start_ = (start_ == 0) ? capacity_ - 1 : start_ - 1;
+    ring_[start_] = std::move(slice);
+    size_++;
+  }
+
+  void pop_front() {
+    ASSERT(size_ > 0);
+    ring_[start_].reset();
+    start_ = (start_ + 1 == capacity_) ? 0 : start_ + 1;
+    size_--;
+  }
+
+  void pop_back() {
+    ASSERT(size_ > 0);
+    back().reset();
+    size_--;
+  }
+
+private:
+  static constexpr size_t InlineRingCapacity = 8;
+
+  size_t internalIndex(size_t index) const {
+    size_t internal_index = start_ + index;
+    if (internal_index >= capacity_) {
+      internal_index -= capacity_;
+    }
+    return internal_index;
+  }
+
+  void growRing();
+
+  SlicePtr inline_ring_[InlineRingCapacity];
+  std::unique_ptr<SlicePtr[]> external_ring_;
+  SlicePtr* ring_;
+  size_t start_{0};
+  size_t size_{0};
+  size_t capacity_;
+};
+
 /**
  * An implementation of BufferFragment where a releasor callback is called when the data is
  * no longer needed.
@@ -46,28 +244,22 @@ private:
   const std::function<void(const void*, size_t, const BufferFragmentImpl*)> releasor_;
 };
 
-class LibEventInstance : public Instance {
-public:
-  // Allows access into the underlying buffer for move() optimizations.
-  virtual Event::Libevent::BufferPtr& buffer() PURE;
-  // Called after accessing the memory in buffer() directly to allow any post-processing.
-  virtual void postProcess() PURE;
-};
-
 /**
- * Wraps an allocated and owned evbuffer.
+ * A native buffer built from a ring of slices. Whole slices are handed between buffers on move(),
+ * so moving data does not copy it.
  *
- * Note that due to the internals of move() accessing buffer(), OwnedImpl is not
- * compatible with non-LibEventInstance buffers.
+ * Note that move() requires the source buffer to also be an OwnedImpl (or a subclass). This is the
+ * only buffer implementation, and the restriction keeps the move path free of virtual dispatch
+ * per slice.
  */
-class OwnedImpl : public LibEventInstance {
+class OwnedImpl : public Instance {
 public:
   OwnedImpl();
   OwnedImpl(const std::string& data);
   OwnedImpl(const Instance& data);
   OwnedImpl(const void* data, uint64_t size);
 
-  // LibEventInstance
+  // Buffer::Instance
   void add(const void* data, uint64_t size) override;
   void addBufferFragment(BufferFragment& fragment) override;
   void add(const std::string& data) override;
@@ -76,7 +268,7 @@ public:
   void copyOut(size_t start, uint64_t size, void* data) const override;
   void drain(uint64_t size) override;
   uint64_t getRawSlices(RawSlice* out, uint64_t out_size) const override;
-  uint64_t length() const override;
+  uint64_t length() const override { return length_; }
   void* linearize(uint32_t size) override;
   void move(Instance& rhs) override;
   void move(Instance& rhs, uint64_t length) override;
@@ -84,12 +276,17 @@ public:
   uint64_t reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) override;
   ssize_t search(const void* data, uint64_t size, size_t start) const override;
   int write(int fd) override;
-  void postProcess() override {}
 
-  Event::Libevent::BufferPtr& buffer() override { return buffer_; }
+  // Called on the source buffer after data has been moved out of it to allow any post-processing.
+  virtual void postProcess() {}
 
 private:
-  Event::Libevent::BufferPtr buffer_;
+  // Remove any empty slices from the back of the buffer. Only valid when there is no outstanding
+  // reservation.
+  void releaseEmptyTail();
+
+  SliceDeque slices_;
+  uint64_t length_{0};
 };
 
 } // namespace Buffer
@@ -0,0 +1,127 @@
+#include "common/common/regex.h"
+
+#include <algorithm>
+#include <regex>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/utility.h"
+
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+RE2::Options regexOptions() {
+  RE2::Options options;
+  // Regexes that RE2 rejects are retried with std::regex, which reports its own errors.
+  options.set_log_errors(false);
+  return options;
+}
+
+class CompiledRe2Matcher : public CompiledMatcher {
+public:
+  CompiledRe2Matcher(const std::string& regex) : regex_(regex, regexOptions()) {}
+
+  bool ok() const { return regex_.ok(); }
+
+  // Regex::CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+  }
+
+private:
+  const RE2 regex_;
+};
+
+class CompiledStdMatcher : public CompiledMatcher {
+public:
+  CompiledStdMatcher(const std::string& regex) : regex_(RegexUtil::parseRegex(regex)) {}
+
+  // Regex::CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return std::regex_match(value.begin(), value.end(), regex_);
+  }
+
+private:
+  const std::regex regex_;
+};
+
+class CompiledRe2MatcherSet : public CompiledMatcherSet {
+public:
+  CompiledRe2MatcherSet(const std::vector<std::string>& regexes)
+      : set_(regexOptions(), RE2::ANCHOR_BOTH) {
+    for (uint32_t i = 0; i < regexes.size(); i++) {
+      matchers_.push_back(Utility::parseRegex(regexes[i]));
+      if (set_.Add(regexes[i], nullptr) >= 0) {
+        set_regexes_.push_back(i);
+      } else {
+        std_regexes_.push_back(i);
+      }
+    }
+    // Compile() only fails when the set runs out of memory.
+    if (!set_.Compile()) {
+      throw EnvoyException("Unable to compile regex set");
+    }
+  }
+
+  // Regex::CompiledMatcherSet
+  void match(absl::string_view value, std::vector<uint32_t>& matches) const override {
+    matches.clear();
+    if (!set_regexes_.empty()) {
+      // RE2::Set reports matches as ints. Reuse a per thread buffer for them so that matching
+      // does not allocate once the buffer has grown.
+      static thread_local std::vector<int> set_matches;
+      set_matches.clear();
+      RE2::Set::ErrorInfo error_info;
+      if (!set_.Match(re2::StringPiece(value.data(), value.size()), &set_matches, &error_info) &&
+          error_info.kind != RE2::Set::kNoError) {
+        // The DFA that matches the whole set ran out of memory. Each regex on its own can still
+        // fall back to RE2's NFA, so try them one at a time.
+        for (uint32_t i = 0; i < matchers_.size(); i++) {
+          if (matchers_[i]->match(value)) {
+            matches.push_back(i);
+          }
+        }
+        return;
+      }
+      for (int set_match : set_matches) {
+        matches.push_back(set_regexes_[set_match]);
+      }
+    }
+    for (uint32_t i : std_regexes_) {
+      if (matchers_[i]->match(value)) {
+        matches.push_back(i);
+      }
+    }
+    std::sort(matches.begin(), matches.end());
+  }
+
+private:
+  RE2::Set set_;
+  // One matcher per regex, for the regexes RE2 rejects and for when the set runs out of memory.
+  std::vector<CompiledMatcherPtr> matchers_;
+  // The position of each regex in the set, indexed by its index in the set.
+  std::vector<uint32_t> set_regexes_;
+  // The positions of the regexes that RE2 rejects.
+  std::vector<uint32_t> std_regexes_;
+};
+
+} // namespace
+
+CompiledMatcherPtr Utility::parseRegex(const std::string& regex) {
+  std::unique_ptr<CompiledRe2Matcher> matcher(new CompiledRe2Matcher(regex));
+  if (matcher->ok()) {
+    return std::move(matcher);
+  }
+  return CompiledMatcherPtr{new CompiledStdMatcher(regex)};
+}
+
+CompiledMatcherSetPtr Utility::parseRegexSet(const std::vector<std::string>& regexes) {
+  return CompiledMatcherSetPtr{new CompiledRe2MatcherSet(regexes)};
+}
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Utilities for compiling regular expressions with RE2 (https://github.com/google/re2/wiki/Syntax).
+ * RE2 matches in time linear in the size of the input and does not recurse, so unlike std::regex
+ * it is safe to use on untrusted input such as request paths and headers. It does not support
+ * backreferences or lookaround assertions, so regexes that RE2 rejects are compiled with
+ * std::regex (ECMAScript syntax) instead.
+ */
+class Utility {
+public:
+  /**
+   * Compile a regex.
+   * @param regex supplies the regex.
+   * @return CompiledMatcherPtr the compiled regex.
+   * @throw EnvoyException if the regex is invalid.
+   */
+  static CompiledMatcherPtr parseRegex(const std::string& regex);
+
+  /**
+   * Compile a set of regexes that are matched together.
+   * @param regexes supplies the regexes. A regex's position in the vector identifies it in the
+   *        matches of the set.
+   * @return CompiledMatcherSetPtr the compiled set.
+   * @throw EnvoyException if any of the regexes is invalid.
+   */
+  static CompiledMatcherSetPtr parseRegexSet(const std::vector<std::string>& regexes);
+};
+
+} // namespace Regex
+} // namespace Envoy
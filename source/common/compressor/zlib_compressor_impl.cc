@@ -35,6 +35,10 @@ void ZlibCompressorImpl::flush(Buffer::Instance& output_buffer) {
   process(output_buffer, Z_SYNC_FLUSH);
 }
 
+void ZlibCompressorImpl::finish(Buffer::Instance& output_buffer) {
+  process(output_buffer, Z_FINISH);
+}
+
 uint64_t ZlibCompressorImpl::checksum() { return zstream_ptr_->adler; }
 
 void ZlibCompressorImpl::compress(const Buffer::Instance& input_buffer,
@@ -55,6 +59,9 @@ bool ZlibCompressorImpl::deflateNext(int64_t flush_state) {
   if (result == Z_BUF_ERROR && zstream_ptr_->avail_in == 0) {
     return false; // This means that zlib needs more input, so stop here.
   }
+  if (result == Z_STREAM_END) {
+    return false; // The stream has been finished and all of its output produced.
+  }
 
   RELEASE_ASSERT(result == Z_OK);
   return true;
@@ -67,7 +74,7 @@ void ZlibCompressorImpl::process(Buffer::Instance& output_buffer, int64_t flush_
     }
   }
 
-  if (flush_state == Z_SYNC_FLUSH) {
+  if (flush_state != Z_NO_FLUSH) {
     updateOutput(output_buffer);
   }
 }
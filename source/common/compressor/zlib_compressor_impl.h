@@ -72,6 +72,14 @@ public:
    */
   void flush(Buffer::Instance& output_buffer);
 
+  /**
+   * Finish should be called once, after the last input has been compressed. It compresses any
+   * remaining input and writes the end of the stream, e.g. the gzip trailer, to the output buffer.
+   * No more data can be compressed afterwards.
+   * @param output_buffer supplies the buffer to output compressed data.
+   */
+  void finish(Buffer::Instance& output_buffer);
+
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of the
    * stream has to match decompressor's checksum produced at the end of the decompression.
@@ -1,7 +1,9 @@
 #include "common/config/grpc_mux_impl.h"
 
+#include <algorithm>
 #include <unordered_set>
 
+#include "common/common/hash.h"
 #include "common/config/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -151,17 +153,45 @@ void GrpcMuxImpl::onReceiveMessage(std::unique_ptr<envoy::api::v2::DiscoveryResp
     // We have to walk all watches (and need an efficient map as a result) to
     // ensure we deliver empty config updates when a resource is dropped.
     std::unordered_map<std::string, ProtobufWkt::Any> resources;
+    std::unordered_map<std::string, uint64_t> resource_versions;
+    // The resources that were added, changed or removed since the last accepted response. The
+    // protocol resends every resource on each update, so this is what keeps an update to one
+    // resource from being reprocessed by the watches on all the others.
+    std::unordered_set<std::string> changed_resources;
+    ApiState& api_state = api_state_[type_url];
     for (const auto& resource : message->resources()) {
       if (type_url != resource.type_url()) {
         throw EnvoyException(fmt::format("{} does not match {} type URL is DiscoveryResponse {}",
                                          resource.type_url(), type_url, message->DebugString()));
       }
       const std::string resource_name = Utility::resourceName(resource);
+      const uint64_t resource_version = HashUtil::xxHash64(resource.value());
+      auto previous_version = api_state.resource_versions_.find(resource_name);
+      if (previous_version == api_state.resource_versions_.end() ||
+          previous_version->second != resource_version) {
+        changed_resources.insert(resource_name);
+      }
       resources.emplace(resource_name, resource);
+      resource_versions.emplace(resource_name, resource_version);
     }
-    for (auto watch : api_state_[type_url].watches_) {
+    for (const auto& previous_version : api_state.resource_versions_) {
+      if (resource_versions.count(previous_version.first) == 0) {
+        changed_resources.insert(previous_version.first);
+      }
+    }
+    for (auto watch : api_state.watches_) {
       if (watch->resources_.empty()) {
         watch->callbacks_.onConfigUpdate(message->resources(), message->version_info());
+        watch->updated_ = true;
+        continue;
+      }
+      // A watch that already has the current version of all of its resources keeps its config,
+      // and only learns the new version.
+      if (watch->updated_ && std::none_of(watch->resources_.begin(), watch->resources_.end(),
+                                          [&changed_resources](const std::string& name) {
+                                            return changed_resources.count(name) > 0;
+                                          })) {
+        watch->callbacks_.onConfigUpdateUnchanged(message->version_info());
         continue;
       }
       Protobuf::RepeatedPtrField<ProtobufWkt::Any> found_resources;
@@ -172,8 +202,10 @@ void GrpcMuxImpl::onReceiveMessage(std::unique_ptr<envoy::api::v2::DiscoveryResp
         }
       }
       watch->callbacks_.onConfigUpdate(found_resources, message->version_info());
+      watch->updated_ = true;
     }
-    api_state_[type_url].request_.set_version_info(message->version_info());
+    api_state.resource_versions_ = std::move(resource_versions);
+    api_state.request_.set_version_info(message->version_info());
   } catch (const EnvoyException& e) {
     ENVOY_LOG(warn, "gRPC config for {} update rejected: {}", message->type_url(), e.what());
     for (auto watch : api_state_[type_url].watches_) {
@@ -70,6 +70,8 @@ private:
     GrpcMuxImpl& parent_;
     std::list<GrpcMuxWatchImpl*>::iterator entry_;
     bool inserted_;
+    // Has an update been delivered to the watch?
+    bool updated_{};
   };
 
   // Per muxed API state.
@@ -84,6 +86,9 @@ private:
     bool pending_{};
     // Has this API been tracked in subscriptions_?
     bool subscribed_{};
+    // Hash of each resource in the last accepted DiscoveryResponse, keyed by resource name. Used
+    // to skip watches whose resources are unchanged.
+    std::unordered_map<std::string, uint64_t> resource_versions_;
   };
 
   envoy::api::v2::Node node_;
@@ -51,14 +51,16 @@ public:
                    Protobuf::RepeatedPtrFieldBackInserter(&typed_resources),
                    MessageUtil::anyConvert<ResourceType>);
     callbacks_->onConfigUpdate(typed_resources);
-    stats_.update_success_.inc();
-    stats_.update_attempt_.inc();
-    version_info_ = version_info;
-    stats_.version_.set(HashUtil::xxHash64(version_info_));
+    onConfigAccepted(version_info);
     ENVOY_LOG(debug, "gRPC config for {} accepted with {} resources: {}", type_url_,
               resources.size(), RepeatedPtrUtil::debugString(typed_resources));
   }
 
+  void onConfigUpdateUnchanged(const std::string& version_info) override {
+    onConfigAccepted(version_info);
+    ENVOY_LOG(debug, "gRPC config for {} accepted with no changes to its resources", type_url_);
+  }
+
   void onConfigUpdateFailed(const EnvoyException* e) override {
     // TODO(htuch): Less fragile signal that this is failure vs. reject.
     if (e == nullptr) {
@@ -73,6 +75,13 @@ public:
   }
 
 private:
+  void onConfigAccepted(const std::string& version_info) {
+    stats_.update_success_.inc();
+    stats_.update_attempt_.inc();
+    version_info_ = version_info;
+    stats_.version_.set(HashUtil::xxHash64(version_info_));
+  }
+
   GrpcMux& grpc_mux_;
   SubscriptionStats stats_;
   const std::string type_url_;
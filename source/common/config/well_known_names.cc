@@ -3,111 +3,122 @@
 namespace Envoy {
 namespace Config {
 
-std::vector<std::pair<std::string, std::string>> TagNameValues::getRegexMapping() {
-  std::vector<std::pair<std::string, std::string>> name_regex_pairs;
+std::vector<TagNameValues::Descriptor> TagNameValues::getDescriptors() {
+  std::vector<Descriptor> descriptors;
 
-  // Note: the default regexes are defined below in the order that they will typically be matched
+  // Note: the default tags are defined below in the order that they will typically be matched
   // (see the TagExtractor class definition for an explanation of the iterative matching process).
   // This ordering is roughly from most specific to least specific. Despite the fact that these
-  // regexes are defined with a particular ordering in mind, users can customize the ordering of the
-  // processing of the default tag extraction regexes and include custom tags with regexes via the
-  // bootstrap configuration. Because of this flexibility, these regexes are designed to not
-  // interfere with one another no matter the ordering. They are tested in forward and reverse
-  // ordering to ensure they will be safe in most ordering configurations.
-
-  // To give a more user-friendly explanation of the intended behavior of each regex, each is
-  // preceded by a comment with a simplified notation to explain what the regex is designed to
+  // patterns are defined with a particular ordering in mind, users can customize the ordering of
+  // the processing of the default tags and include custom tags with regexes via the bootstrap
+  // configuration. Because of this flexibility, these patterns are designed to not interfere with
+  // one another no matter the ordering. They are tested in forward and reverse ordering to ensure
+  // they will be safe in most ordering configurations.
+
+  // Tags are extracted for every stat that is created, so wherever the tag value is a whole token
+  // of the name it is matched with a token pattern rather than a regex. In a token pattern, a
+  // literal matches the same token, * matches any single token, ** matches any number of tokens,
+  // and $ matches the token that is the tag value. The few tags that need a regex also list a
+  // substring that names must contain for the regex to match.
+
+  // To give a more user-friendly explanation of the intended behavior of each pattern, each is
+  // preceded by a comment with a simplified notation to explain what the pattern is designed to
   // match:
-  // - The text that the regex is intended to capture will be enclosed in ().
+  // - The text that the pattern is intended to capture will be enclosed in ().
   // - Other default tags that are expected to exist in the name (and may or may not have been
-  // removed before this regex has been applied) are enclosed in [].
+  // removed before this pattern has been applied) are enclosed in [].
   // - Stand-ins for a variable segment of the name (including inside capture groups) will be
   // enclosed in <>.
   // - Typical * notation will be used to denote an arbitrary set of characters.
 
   // *_rq(_<response_code>)
-  name_regex_pairs.push_back({RESPONSE_CODE, "_rq(_(\\d{3}))$"});
+  descriptors.push_back({RESPONSE_CODE, {}, "_rq(_(\\d{3}))$", "_rq_"});
 
   // *_rq_(<response_code_class>)xx
-  name_regex_pairs.push_back({RESPONSE_CODE_CLASS, "_rq_(\\d)xx$"});
+  descriptors.push_back({RESPONSE_CODE_CLASS, {}, "_rq_(\\d)xx$", "_rq_"});
 
   // http.[<stat_prefix>.]dynamodb.table.[<table_name>.]capacity.[<operation_name>.](__partition_id=<last_seven_characters_from_partition_id>)
-  name_regex_pairs.push_back({DYNAMO_PARTITION_ID, "^http(?=\\.).*?\\.dynamodb\\.table(?=\\.).*?\\."
-                                                   "capacity(?=\\.).*?(\\.__partition_id=(\\w{7}))"
-                                                   "$"});
+  descriptors.push_back({DYNAMO_PARTITION_ID,
+                         {},
+                         "^http(?=\\.).*?\\.dynamodb\\.table(?=\\.).*?\\."
+                         "capacity(?=\\.).*?(\\.__partition_id=(\\w{7}))$",
+                         ".__partition_id="});
 
   // http.[<stat_prefix>.]dynamodb.operation.(<operation_name>.)<base_stat> or
   // http.[<stat_prefix>.]dynamodb.table.[<table_name>.]capacity.(<operation_name>.)[<partition_id>]
-  name_regex_pairs.push_back({DYNAMO_OPERATION, "^http(?=\\.).*?\\.dynamodb.(?:operation|table(?="
-                                                "\\.).*?\\.capacity)(\\.(.*?))(?:\\.|$)"});
+  descriptors.push_back(
+      {DYNAMO_OPERATION,
+       {"http.**.dynamodb.operation.$.**", "http.**.dynamodb.table.**.capacity.$.**"},
+       "",
+       ""});
 
   // mongo.[<stat_prefix>.]collection.[<collection>.]callsite.(<callsite>.)query.<base_stat>
-  name_regex_pairs.push_back(
-      {MONGO_CALLSITE,
-       "^mongo(?=\\.).*?\\.collection(?=\\.).*?\\.callsite\\.((.*?)\\.).*?query.\\w+?$"});
+  descriptors.push_back(
+      {MONGO_CALLSITE, {"mongo.**.collection.**.callsite.$.**.query.*"}, "", ""});
 
   // http.[<stat_prefix>.]dynamodb.table.(<table_name>.) or
   // http.[<stat_prefix>.]dynamodb.error.(<table_name>.)*
-  name_regex_pairs.push_back(
-      {DYNAMO_TABLE, "^http(?=\\.).*?\\.dynamodb.(?:table|error)\\.((.*?)\\.)"});
+  descriptors.push_back(
+      {DYNAMO_TABLE, {"http.**.dynamodb.table.$.**", "http.**.dynamodb.error.$.**"}, "", ""});
 
   // mongo.[<stat_prefix>.]collection.(<collection>.)query.<base_stat>
-  name_regex_pairs.push_back(
-      {MONGO_COLLECTION, "^mongo(?=\\.).*?\\.collection\\.((.*?)\\.).*?query.\\w+?$"});
+  descriptors.push_back({MONGO_COLLECTION, {"mongo.**.collection.$.**.query.*"}, "", ""});
 
   // mongo.[<stat_prefix>.]cmd.(<cmd>.)<base_stat>
-  name_regex_pairs.push_back({MONGO_CMD, "^mongo(?=\\.).*?\\.cmd\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({MONGO_CMD, {"mongo.**.cmd.$.*"}, "", ""});
 
   // cluster.[<route_target_cluster>.]grpc.[<grpc_service>.](<grpc_method>.)<base_stat>
-  name_regex_pairs.push_back(
-      {GRPC_BRIDGE_METHOD, "^cluster(?=\\.).*?\\.grpc(?=\\.).*\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({GRPC_BRIDGE_METHOD, {"cluster.**.grpc.**.$.*"}, "", ""});
 
   // http.[<stat_prefix>.]user_agent.(<user_agent>.)<base_stat>
-  name_regex_pairs.push_back({HTTP_USER_AGENT, "^http(?=\\.).*?\\.user_agent\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({HTTP_USER_AGENT, {"http.**.user_agent.$.*"}, "", ""});
 
   // vhost.[<virtual host name>.]vcluster.(<virtual_cluster_name>.)<base_stat>
-  name_regex_pairs.push_back({VIRTUAL_CLUSTER, "^vhost(?=\\.).*?\\.vcluster\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({VIRTUAL_CLUSTER, {"vhost.**.vcluster.$.*"}, "", ""});
 
   // http.[<stat_prefix>.]fault.(<downstream_cluster>.)<base_stat>
-  name_regex_pairs.push_back(
-      {FAULT_DOWNSTREAM_CLUSTER, "^http(?=\\.).*?\\.fault\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({FAULT_DOWNSTREAM_CLUSTER, {"http.**.fault.$.*"}, "", ""});
 
   // listener.[<address>.]ssl.cipher.(<cipher>)
-  name_regex_pairs.push_back({SSL_CIPHER, "^listener(?=\\.).*?\\.ssl\\.cipher(\\.(.*?))$"});
+  descriptors.push_back(
+      {SSL_CIPHER, {}, "^listener(?=\\.).*?\\.ssl\\.cipher(\\.(.*?))$", ".ssl.cipher."});
 
   // cluster.[<cluster_name>.]ssl.ciphers.(<cipher>)
-  name_regex_pairs.push_back({SSL_CIPHER_SUITE, "^cluster(?=\\.).*?\\.ssl\\.ciphers(\\.(.*?))$"});
+  descriptors.push_back(
+      {SSL_CIPHER_SUITE, {}, "^cluster(?=\\.).*?\\.ssl\\.ciphers(\\.(.*?))$", ".ssl.ciphers."});
 
   // cluster.[<route_target_cluster>.]grpc.(<grpc_service>.)*
-  name_regex_pairs.push_back({GRPC_BRIDGE_SERVICE, "^cluster(?=\\.).*?\\.grpc\\.((.*?)\\.)"});
+  descriptors.push_back({GRPC_BRIDGE_SERVICE, {"cluster.**.grpc.$.**"}, "", ""});
 
   // tcp.(<stat_prefix>.)<base_stat>
-  name_regex_pairs.push_back({TCP_PREFIX, "^tcp\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({TCP_PREFIX, {"tcp.$.*"}, "", ""});
 
   // auth.clientssl.(<stat_prefix>.)<base_stat>
-  name_regex_pairs.push_back({CLIENTSSL_PREFIX, "^auth\\.clientssl\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({CLIENTSSL_PREFIX, {"auth.clientssl.$.*"}, "", ""});
 
   // ratelimit.(<stat_prefix>.)<base_stat>
-  name_regex_pairs.push_back({RATELIMIT_PREFIX, "^ratelimit\\.((.*?)\\.)\\w+?$"});
+  descriptors.push_back({RATELIMIT_PREFIX, {"ratelimit.$.*"}, "", ""});
 
   // cluster.(<cluster_name>.)*
-  name_regex_pairs.push_back({CLUSTER_NAME, "^cluster\\.((.*?)\\.)"});
+  descriptors.push_back({CLUSTER_NAME, {"cluster.$.**"}, "", ""});
 
   // http.(<stat_prefix>.)* or listener.[<address>.]http.(<stat_prefix>.)*
-  name_regex_pairs.push_back(
-      {HTTP_CONN_MANAGER_PREFIX, "^(?:|listener(?=\\.).*?\\.)http\\.((.*?)\\.)"});
+  descriptors.push_back({HTTP_CONN_MANAGER_PREFIX, {"http.$.**", "listener.**.http.$.**"}, "", ""});
 
   // listener.(<address>.)*
-  name_regex_pairs.push_back(
-      {LISTENER_ADDRESS, "^listener\\.(((?:[_.[:digit:]]*|[_\\[\\]aAbBcCdDeEfF[:digit:]]*))\\.)"});
+  descriptors.push_back(
+      {LISTENER_ADDRESS,
+       {},
+       "^listener\\.(((?:[_.[:digit:]]*|[_\\[\\]aAbBcCdDeEfF[:digit:]]*))\\.)",
+       "listener."});
 
   // vhost.(<virtual host name>.)*
-  name_regex_pairs.push_back({VIRTUAL_HOST, "^vhost\\.((.*?)\\.)"});
+  descriptors.push_back({VIRTUAL_HOST, {"vhost.$.**"}, "", ""});
 
   // mongo.(<stat_prefix>.)*
-  name_regex_pairs.push_back({MONGO_PREFIX, "^mongo\\.((.*?)\\.)"});
+  descriptors.push_back({MONGO_PREFIX, {"mongo.$.**"}, "", ""});
 
-  return name_regex_pairs;
+  return descriptors;
 }
 
 } // namespace Config
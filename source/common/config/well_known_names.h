@@ -119,6 +119,8 @@ public:
   const std::string GRPC_JSON_TRANSCODER = "envoy.grpc_json_transcoder";
   // GRPC web filter
   const std::string GRPC_WEB = "envoy.grpc_web";
+  // Gzip filter
+  const std::string GZIP = "envoy.gzip";
   // IP tagging filter
   const std::string IP_TAGGING = "envoy.ip_tagging";
   // Rate limit filter
@@ -206,12 +208,28 @@ public:
 typedef ConstSingleton<MetadataEnvoyLbKeyValues> MetadataEnvoyLbKeys;
 
 /**
- * Well known tags values and a mapping from these names to the regexes they
- * represent. Note: when names are added to the list, they also must be added to
- * the regex map by adding an entry in the getRegexMapping function.
+ * Well known tags values and a mapping from these names to the patterns that extract them. Note:
+ * when names are added to the list, they also must be added to the descriptors by adding an entry
+ * in the getDescriptors function.
  */
 class TagNameValues {
 public:
+  /**
+   * Describes how a well known tag is extracted from stat names.
+   */
+  struct Descriptor {
+    // The tag name.
+    std::string name_;
+    // Alternative token patterns that match the tag, see Stats::TagExtractorTokensImpl. Tags whose
+    // value is a whole token of the name are extracted this way, without a regex.
+    std::vector<std::string> token_patterns_;
+    // The regex that matches the tag, used when its value is only part of a token or spans several
+    // tokens. Empty when token_patterns_ is set.
+    std::string regex_;
+    // A string that names must contain for regex_ to match, so that the regex only runs on them.
+    std::string substr_;
+  };
+
   // Cluster name tag
   const std::string CLUSTER_NAME = "envoy.cluster_name";
   // Listener port tag
@@ -259,15 +277,15 @@ public:
   // Request response code class
   const std::string RESPONSE_CODE_CLASS = "envoy.response_code_class";
 
-  // Mapping from the names above to their respective regex strings.
-  const std::vector<std::pair<std::string, std::string>> name_regex_pairs_;
+  // Descriptors for all of the names above.
+  const std::vector<Descriptor> descriptors_;
 
-  // Constructor to fill map.
-  TagNameValues() : name_regex_pairs_(getRegexMapping()) {}
+  // Constructor to fill the descriptors.
+  TagNameValues() : descriptors_(getDescriptors()) {}
 
 private:
-  // Creates a regex mapping for all tag names.
-  std::vector<std::pair<std::string, std::string>> getRegexMapping();
+  // Creates the descriptors for all tag names.
+  std::vector<Descriptor> getDescriptors();
 };
 
 typedef ConstSingleton<TagNameValues> TagNames;
@@ -62,6 +62,9 @@ bool ZlibDecompressorImpl::inflateNext() {
   if (result == Z_BUF_ERROR && zstream_ptr_->avail_in == 0) {
     return false; // This means that zlib needs more input, so stop here.
   }
+  if (result == Z_STREAM_END) {
+    return false; // The end of the compressed stream has been reached.
+  }
 
   RELEASE_ASSERT(result == Z_OK);
   return true;
@@ -11,6 +11,7 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/utility.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/signal_impl.h"
 #include "common/event/timer_impl.h"
@@ -112,7 +113,8 @@ DispatcherImpl::createListener(Network::ListenSocket& socket, Network::ListenerC
                                bool bind_to_port, bool hand_off_restored_destination_connections) {
   ASSERT(isThreadSafe());
   return Network::ListenerPtr{new Network::ListenerImpl(*this, socket, cb, bind_to_port,
-                                                        hand_off_restored_destination_connections)};
+                                                        hand_off_restored_destination_connections,
+                                                        ProdMonotonicTimeSource::instance_)};
 }
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
@@ -140,8 +142,10 @@ void DispatcherImpl::post(std::function<void()> callback) {
   bool do_post;
   {
     std::unique_lock<std::mutex> lock(post_lock_);
+    // Only the first callback of a batch wakes up the dispatcher. The ones posted before it runs
+    // are picked up by the same wakeup.
     do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+    post_callbacks_.push_back(std::move(callback));
   }
 
   if (do_post) {
@@ -162,14 +166,25 @@ void DispatcherImpl::run(RunType type) {
 }
 
 void DispatcherImpl::runPostCallbacks() {
-  std::unique_lock<std::mutex> lock(post_lock_);
-  while (!post_callbacks_.empty()) {
-    std::function<void()> callback = post_callbacks_.front();
-    post_callbacks_.pop_front();
-
-    lock.unlock();
-    callback();
-    lock.lock();
+  // Take all of the pending callbacks at once, so that the lock is taken once per batch rather than
+  // once per callback. Callbacks posted while a batch runs, including by the batch itself, are run
+  // by the next pass of the loop.
+  std::vector<std::function<void()>> callbacks;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(post_lock_);
+      if (post_callbacks_.empty()) {
+        // Hand back the storage of the last batch, so that the next batch does not allocate it.
+        post_callbacks_.swap(callbacks);
+        return;
+      }
+      callbacks.swap(post_callbacks_);
+    }
+
+    for (std::function<void()>& callback : callbacks) {
+      callback();
+    }
+    callbacks.clear();
   }
 }
 
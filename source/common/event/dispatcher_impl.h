@@ -2,7 +2,6 @@
 
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <mutex>
 #include <vector>
 
@@ -77,7 +76,9 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
   std::mutex post_lock_;
-  std::list<std::function<void()>> post_callbacks_;
+  // Callbacks posted since the last time they were run. The lock is only held to append to the
+  // vector or to take all of it, never while callbacks run.
+  std::vector<std::function<void()>> post_callbacks_;
   bool deferred_deleting_{};
 };
 
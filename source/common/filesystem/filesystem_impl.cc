@@ -2,12 +2,16 @@
 
 #include <dirent.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
+#include <algorithm>
 #include <chrono>
+#include <climits>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -61,12 +65,77 @@ std::string fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+FileFlusher::~FileFlusher() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    flush_thread_exit_ = true;
+    flush_event_.notify_one();
+  }
+
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+  }
+}
+
+void FileFlusher::requestFlush(FileImpl& file) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (flush_thread_ == nullptr) {
+    flush_thread_.reset(new Thread::Thread([this]() -> void { flushThreadFunc(); }));
+  }
+
+  // There are few files, so a linear search of the pending ones is cheap.
+  if (std::find(pending_files_.begin(), pending_files_.end(), &file) == pending_files_.end()) {
+    pending_files_.push_back(&file);
+    flush_event_.notify_one();
+  }
+}
+
+void FileFlusher::remove(FileImpl& file) {
+  std::unique_lock<std::mutex> lock(lock_);
+  pending_files_.remove(&file);
+  while (flushing_file_ == &file) {
+    flushed_event_.wait(lock);
+  }
+}
+
+void FileFlusher::flushThreadFunc() {
+  while (true) {
+    FileImpl* file;
+
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      while (pending_files_.empty() && !flush_thread_exit_) {
+        flush_event_.wait(lock);
+      }
+
+      if (flush_thread_exit_) {
+        return;
+      }
+
+      file = pending_files_.front();
+      pending_files_.pop_front();
+      flushing_file_ = file;
+    }
+
+    // The file is flushed without holding lock_, so that writes to other files can still request
+    // flushes while this one blocks on the disk.
+    file->flushFromThread();
+
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      flushing_file_ = nullptr;
+      flushed_event_.notify_all();
+    }
+  }
+}
+
 FileImpl::FileImpl(const std::string& path, Event::Dispatcher& dispatcher,
-                   Thread::BasicLockable& lock, Stats::Store& stats_store,
+                   Thread::BasicLockable& lock, FileFlusher& flusher, Stats::Store& stats_store,
                    std::chrono::milliseconds flush_interval_msec)
-    : path_(path), file_lock_(lock), flush_timer_(dispatcher.createTimer([this]() -> void {
+    : path_(path), file_lock_(lock), flusher_(flusher),
+      flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notify_one();
+        flusher_.requestFlush(*this);
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
       os_sys_calls_(Api::OsSysCallsSingleton::get()), flush_interval_msec_(flush_interval_msec),
@@ -87,15 +156,7 @@ void FileImpl::open() {
 void FileImpl::reopen() { reopen_file_ = true; }
 
 FileImpl::~FileImpl() {
-  {
-    std::unique_lock<std::mutex> lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notify_one();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flusher_.remove(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (fd_ != -1) {
@@ -111,6 +172,11 @@ void FileImpl::doWrite(Buffer::Instance& buffer) {
   uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
   Buffer::RawSlice slices[num_slices];
   buffer.getRawSlices(slices, num_slices);
+  iovec iov[num_slices];
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
 
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
   // different FileImpl pointing to the same underlying file. This can happen either via hot
@@ -122,9 +188,14 @@ void FileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     std::lock_guard<Thread::BasicLockable> lock(file_lock_);
-    for (Buffer::RawSlice& slice : slices) {
-      ssize_t rc = os_sys_calls_.write(fd_, slice.mem_, slice.len_);
-      ASSERT(rc == static_cast<ssize_t>(slice.len_));
+    // Write as many slices as possible with each system call.
+    for (uint64_t i = 0; i < num_slices; i += IOV_MAX) {
+      const int num_iovec = std::min<uint64_t>(num_slices - i, IOV_MAX);
+      ssize_t rc = os_sys_calls_.writev(fd_, &iov[i], num_iovec);
+      ASSERT(rc == std::accumulate(&iov[i], &iov[i] + num_iovec, ssize_t(0),
+                                   [](ssize_t length, const iovec& v) -> ssize_t {
+                                     return length + v.iov_len;
+                                   }));
       UNREFERENCED_PARAMETER(rc);
       stats_.write_completed_.inc();
     }
@@ -134,44 +205,42 @@ void FileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void FileImpl::flushThreadFunc() {
+void FileImpl::flushFromThread() {
+  std::unique_lock<std::mutex> flush_lock;
 
-  while (true) {
-    std::unique_lock<std::mutex> flush_lock;
+  {
+    std::lock_guard<std::mutex> write_lock(write_lock_);
 
-    {
-      std::unique_lock<std::mutex> write_lock(write_lock_);
+    // A flush can be requested by the timer when there is nothing to write, and the data that
+    // triggered a request can have been written by flush() since.
+    if (flush_buffer_.length() == 0) {
+      return;
+    }
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
-        flush_event_.wait(write_lock);
-      }
+    flush_lock = std::unique_lock<std::mutex>(flush_lock_);
+    about_to_write_buffer_.move(flush_buffer_);
+    ASSERT(flush_buffer_.length() == 0);
+  }
 
-      if (flush_thread_exit_) {
-        return;
+  // if we failed to open file before (-1 == fd_), then simply ignore
+  if (fd_ != -1) {
+    try {
+      if (reopen_file_) {
+        reopen_file_ = false;
+        os_sys_calls_.close(fd_);
+        open();
       }
 
-      flush_lock = std::unique_lock<std::mutex>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+      doWrite(about_to_write_buffer_);
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
     }
+  }
 
-    // if we failed to open file before (-1 == fd_), then simply ignore
-    if (fd_ != -1) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          os_sys_calls_.close(fd_);
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
-    }
+  // Data that could not be written is discarded so that it does not accumulate.
+  if (about_to_write_buffer_.length() > 0) {
+    stats_.write_total_buffered_.sub(about_to_write_buffer_.length());
+    about_to_write_buffer_.drain(about_to_write_buffer_.length());
   }
 }
 
@@ -200,23 +269,34 @@ void FileImpl::flush() {
 }
 
 void FileImpl::write(const std::string& data) {
-  std::lock_guard<std::mutex> lock(write_lock_);
+  bool request_flush = false;
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
-  }
+  {
+    std::lock_guard<std::mutex> lock(write_lock_);
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data);
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notify_one();
+    // The first write is flushed right away rather than waiting for the timer.
+    if (!flush_timer_enabled_) {
+      flush_timer_->enableTimer(flush_interval_msec_);
+      flush_timer_enabled_ = true;
+      request_flush = true;
+    }
+
+    // If the disk can't keep up, drop writes rather than buffer without bound.
+    if (flush_buffer_.length() + data.length() > MAX_BUFFER_SIZE) {
+      stats_.write_dropped_.inc();
+      return;
+    }
+
+    stats_.write_buffered_.inc();
+    stats_.write_total_buffered_.add(data.length());
+    flush_buffer_.add(data);
+    request_flush |= flush_buffer_.length() > MIN_FLUSH_SIZE;
   }
-}
 
-void FileImpl::createFlushStructures() {
-  flush_thread_.reset(new Thread::Thread([this]() -> void { flushThreadFunc(); }));
-  flush_timer_->enableTimer(flush_interval_msec_);
+  // Requested after releasing write_lock_, so that other writers don't wait on the flusher's lock.
+  if (request_flush) {
+    flusher_.requestFlush(*this);
+  }
 }
 
 } // namespace Filesystem
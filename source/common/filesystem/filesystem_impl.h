@@ -5,6 +5,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
+#include <list>
 #include <mutex>
 #include <string>
 
@@ -23,6 +24,7 @@ namespace Envoy {
   COUNTER(write_completed)                                                                         \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_dropped)                                                                           \
   GAUGE  (write_total_buffered)
 // clang-format on
 
@@ -56,17 +58,54 @@ ssize_t fileSize(const std::string& path);
  */
 std::string fileReadToEnd(const std::string& path);
 
+class FileImpl;
+
+/**
+ * A thread that flushes the buffered data of any number of FileImpls to disk, so that each file
+ * does not need a thread of its own. Files are flushed one at a time, in the order in which their
+ * flushes were requested. The thread is started when the first flush is requested.
+ */
+class FileFlusher {
+public:
+  ~FileFlusher();
+
+  /**
+   * Ask the flush thread to flush a file. Does nothing if the file is already waiting to be
+   * flushed.
+   * @param file supplies the file to flush.
+   */
+  void requestFlush(FileImpl& file);
+
+  /**
+   * Stop flushing a file. If the flush thread is flushing the file, wait for it to finish. Must be
+   * called before the file is destroyed.
+   * @param file supplies the file to remove.
+   */
+  void remove(FileImpl& file);
+
+private:
+  void flushThreadFunc();
+
+  std::mutex lock_;
+  std::condition_variable_any flush_event_;   // Signaled when a file is queued or on exit.
+  std::condition_variable_any flushed_event_; // Signaled when the thread finishes flushing a file.
+  std::list<FileImpl*> pending_files_;
+  FileImpl* flushing_file_{};
+  bool flush_thread_exit_{};
+  Thread::ThreadPtr flush_thread_;
+};
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are buffered in memory and written to disk by a FileFlusher, which is shared by all of
+ * the files of the process. The buffer is bounded, and writes that do not fit are dropped.
  */
 class FileImpl : public File {
 public:
   FileImpl(const std::string& path, Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-           Stats::Store& stats_store, std::chrono::milliseconds flush_interval_msec);
+           FileFlusher& flusher, Stats::Store& stats_store,
+           std::chrono::milliseconds flush_interval_msec);
   ~FileImpl();
 
   // Filesystem::File
@@ -85,12 +124,13 @@ public:
 
 private:
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  void flushFromThread();
   void open();
-  void createFlushStructures();
 
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Maximum size of the data waiting to be flushed. Writes beyond this are dropped.
+  static const uint64_t MAX_BUFFER_SIZE = 1024 * 1024 * 16;
 
   int fd_;
   std::string path_;
@@ -99,6 +139,7 @@ private:
   //    1) write_lock_
   //    2) flush_lock_
   //    3) file_lock_
+  // The FileFlusher's lock is never held while acquiring any of them.
   Thread::BasicLockable& file_lock_; // This lock is used only by the flush thread when writing
                                      // to disk. This is used to make sure that file blocks do
                                      // not get interleaved by multiple processes writing to
@@ -111,14 +152,13 @@ private:
   std::mutex write_lock_;            // The lock is used when filling the flush buffer. It allows
                                      // multiple threads to write to the same file at relatively
                                      // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  std::condition_variable_any flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  FileFlusher& flusher_;
+  bool flush_timer_enabled_{}; // Protected by write_lock_.
   std::atomic<bool> reopen_file_{};
   Buffer::OwnedImpl flush_buffer_; // This buffer is used by multiple threads. It gets filled and
                                    // then flushed either when max size is reached or when a timer
                                    // fires.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
+  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only while flushing. Data
                                             // is moved from flush_buffer_ under lock, and then
                                             // the lock is released so that flush_buffer_ can
                                             // continue to fill. This buffer is then used for the
@@ -129,6 +169,8 @@ private:
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   FileSystemStats stats_;
+
+  friend class FileFlusher;
 };
 
 } // namespace Filesystem
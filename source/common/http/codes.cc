@@ -1,13 +1,17 @@
 #include "common/http/codes.h"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 #include "envoy/stats/stats.h"
 
+#include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
@@ -23,37 +27,129 @@ void CodeUtility::chargeBasicResponseStat(Stats::Scope& scope, const std::string
   scope.counter(fmt::format("{}upstream_rq_{}", prefix, enumToInt(response_code))).inc();
 }
 
-void CodeUtility::chargeResponseStat(const ResponseStatInfo& info) {
-  const uint64_t response_code = info.response_status_code_;
-  chargeBasicResponseStat(info.cluster_scope_, info.prefix_, static_cast<Code>(response_code));
+namespace {
 
-  std::string group_string = groupStringForResponseCode(static_cast<Code>(response_code));
+/**
+ * Maps each response code known to Code, and each class of response codes, to a slot in a
+ * CodeStatsImpl counter table.
+ */
+class CodeSlots {
+public:
+  // Response codes at or above this are not cached.
+  static constexpr uint64_t MaxCode = 600;
+  static constexpr uint32_t NoSlot = UINT32_MAX;
 
-  // If the response is from a canary, also create canary stats.
-  if (info.upstream_canary_) {
-    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+  CodeSlots() {
+    // The classes (1xx to 5xx) take the first slots.
+    num_slots_ = MaxCode / 100 - 1;
+    for (uint64_t code = 0; code < MaxCode; code++) {
+      const bool known = strcmp(CodeUtility::toString(static_cast<Code>(code)), "Unknown") != 0;
+      code_slots_[code] = known ? num_slots_++ : NoSlot;
+    }
   }
 
-  // Split stats into external vs. internal.
-  if (info.internal_request_) {
-    info.cluster_scope_
-        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_
-        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+  uint32_t codeSlot(uint64_t response_code) const {
+    return response_code < MaxCode ? code_slots_[response_code] : NoSlot;
+  }
+  static uint32_t classSlot(uint64_t response_code) { return response_code / 100 - 1; }
+  uint32_t numSlots() const { return num_slots_; }
+
+private:
+  uint32_t code_slots_[MaxCode];
+  uint32_t num_slots_;
+};
+
+const CodeSlots& codeSlots() { CONSTRUCT_ON_FIRST_USE(CodeSlots); }
+
+// Indexed by CodeStats::Prefix.
+const std::vector<std::string>& prefixStrings() {
+  CONSTRUCT_ON_FIRST_USE(std::vector<std::string>, "", "canary.", "internal.", "external.",
+                         "retry.");
+}
+
+} // namespace
+
+constexpr uint32_t CodeStatsImpl::NumPrefixes;
+
+CodeStatsImpl::CodeStatsImpl(Stats::Scope& scope)
+    : scope_(scope), num_slots_(codeSlots().numSlots()),
+      counters_(new std::atomic<Stats::Counter*>[NumPrefixes * num_slots_]) {
+  for (uint32_t i = 0; i < NumPrefixes * num_slots_; i++) {
+    counters_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  for (std::atomic<Stats::Histogram*>& histogram : histograms_) {
+    histogram.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+const std::string& CodeStatsImpl::prefixString(Prefix prefix) {
+  ASSERT(prefixStrings().size() == NumPrefixes);
+  return prefixStrings()[static_cast<uint32_t>(prefix)];
+}
+
+Stats::Counter& CodeStatsImpl::counter(Prefix prefix, uint32_t slot, uint64_t response_code,
+                                       bool response_class) {
+  // Counters are resolved by whichever thread first charges them. Racing threads get the same
+  // counter from the scope, so it does not matter which one publishes it. The stat name is only
+  // built on a miss, so that charging a cached counter does not allocate.
+  std::atomic<Stats::Counter*>& cached =
+      counters_[static_cast<uint32_t>(prefix) * num_slots_ + slot];
+  Stats::Counter* counter = cached.load(std::memory_order_acquire);
+  if (counter == nullptr) {
+    const std::string name_suffix =
+        response_class
+            ? CodeUtility::groupStringForResponseCode(static_cast<Code>(response_code))
+            : std::to_string(response_code);
+    counter = &scope_.counter(prefixString(prefix) + "upstream_rq_" + name_suffix);
+    cached.store(counter, std::memory_order_release);
+  }
+  return *counter;
+}
+
+void CodeStatsImpl::chargeResponseCode(Prefix prefix, uint64_t response_code) {
+  const uint32_t code_slot = codeSlots().codeSlot(response_code);
+  if (code_slot == CodeSlots::NoSlot) {
+    CodeUtility::chargeBasicResponseStat(scope_, prefixString(prefix),
+                                         static_cast<Code>(response_code));
+    return;
+  }
+
+  counter(prefix, CodeSlots::classSlot(response_code), response_code, true).inc();
+  counter(prefix, code_slot, response_code, false).inc();
+}
+
+void CodeStatsImpl::chargeResponseTime(Prefix prefix, std::chrono::milliseconds response_time) {
+  std::atomic<Stats::Histogram*>& cached = histograms_[static_cast<uint32_t>(prefix)];
+  Stats::Histogram* histogram = cached.load(std::memory_order_acquire);
+  if (histogram == nullptr) {
+    histogram = &scope_.histogram(prefixString(prefix) + "upstream_rq_time");
+    cached.store(histogram, std::memory_order_release);
+  }
+  histogram->recordValue(response_time.count());
+}
+
+void CodeUtility::chargeResponseStat(const ResponseStatInfo& info) {
+  const uint64_t response_code = info.response_status_code_;
+  if (info.cluster_code_stats_ != nullptr) {
+    ASSERT(info.prefix_.empty());
+    CodeStats& code_stats = *info.cluster_code_stats_;
+    code_stats.chargeResponseCode(CodeStats::Prefix::None, response_code);
+    if (info.upstream_canary_) {
+      code_stats.chargeResponseCode(CodeStats::Prefix::Canary, response_code);
+    }
+    code_stats.chargeResponseCode(info.internal_request_ ? CodeStats::Prefix::Internal
+                                                         : CodeStats::Prefix::External,
+                                  response_code);
   } else {
-    info.cluster_scope_
-        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_
-        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+    chargeScopeResponseStat(info);
+  }
+
+  if (info.request_vcluster_name_.empty() && (info.from_zone_.empty() || info.to_zone_.empty())) {
+    return;
   }
 
+  std::string group_string = groupStringForResponseCode(static_cast<Code>(response_code));
+
   // Handle request virtual cluster.
   if (!info.request_vcluster_name_.empty()) {
     info.global_scope_
@@ -79,20 +175,64 @@ void CodeUtility::chargeResponseStat(const ResponseStatInfo& info) {
   }
 }
 
-void CodeUtility::chargeResponseTiming(const ResponseTimingInfo& info) {
-  info.cluster_scope_.histogram(info.prefix_ + "upstream_rq_time")
-      .recordValue(info.response_time_.count());
+void CodeUtility::chargeScopeResponseStat(const ResponseStatInfo& info) {
+  const uint64_t response_code = info.response_status_code_;
+  chargeBasicResponseStat(info.cluster_scope_, info.prefix_, static_cast<Code>(response_code));
+
+  std::string group_string = groupStringForResponseCode(static_cast<Code>(response_code));
+
+  // If the response is from a canary, also create canary stats.
   if (info.upstream_canary_) {
-    info.cluster_scope_.histogram(info.prefix_ + "canary.upstream_rq_time")
-        .recordValue(info.response_time_.count());
+    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, group_string))
+        .inc();
+    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, response_code))
+        .inc();
   }
 
+  // Split stats into external vs. internal.
   if (info.internal_request_) {
-    info.cluster_scope_.histogram(info.prefix_ + "internal.upstream_rq_time")
-        .recordValue(info.response_time_.count());
+    info.cluster_scope_
+        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, group_string))
+        .inc();
+    info.cluster_scope_
+        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, response_code))
+        .inc();
   } else {
-    info.cluster_scope_.histogram(info.prefix_ + "external.upstream_rq_time")
+    info.cluster_scope_
+        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, group_string))
+        .inc();
+    info.cluster_scope_
+        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, response_code))
+        .inc();
+  }
+}
+
+void CodeUtility::chargeResponseTiming(const ResponseTimingInfo& info) {
+  if (info.cluster_code_stats_ != nullptr) {
+    ASSERT(info.prefix_.empty());
+    CodeStats& code_stats = *info.cluster_code_stats_;
+    code_stats.chargeResponseTime(CodeStats::Prefix::None, info.response_time_);
+    if (info.upstream_canary_) {
+      code_stats.chargeResponseTime(CodeStats::Prefix::Canary, info.response_time_);
+    }
+    code_stats.chargeResponseTime(info.internal_request_ ? CodeStats::Prefix::Internal
+                                                         : CodeStats::Prefix::External,
+                                  info.response_time_);
+  } else {
+    info.cluster_scope_.histogram(info.prefix_ + "upstream_rq_time")
         .recordValue(info.response_time_.count());
+    if (info.upstream_canary_) {
+      info.cluster_scope_.histogram(info.prefix_ + "canary.upstream_rq_time")
+          .recordValue(info.response_time_.count());
+    }
+
+    if (info.internal_request_) {
+      info.cluster_scope_.histogram(info.prefix_ + "internal.upstream_rq_time")
+          .recordValue(info.response_time_.count());
+    } else {
+      info.cluster_scope_.histogram(info.prefix_ + "external.upstream_rq_time")
+          .recordValue(info.response_time_.count());
+    }
   }
 
   if (!info.request_vcluster_name_.empty()) {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/http/codes.h"
@@ -11,6 +13,42 @@
 namespace Envoy {
 namespace Http {
 
+/**
+ * CodeStats implementation that resolves each counter and histogram the first time it is charged
+ * and caches it in a fixed table. Response codes that are not known to Code are charged by name.
+ * The stats are only created once charged so that unused response codes do not show up as stats.
+ */
+class CodeStatsImpl : public CodeStats {
+public:
+  CodeStatsImpl(Stats::Scope& scope);
+
+  // Http::CodeStats
+  void chargeResponseCode(Prefix prefix, uint64_t response_code) override;
+  void chargeResponseTime(Prefix prefix, std::chrono::milliseconds response_time) override;
+
+  /**
+   * @return the stat name prefix for a prefix, e.g. "canary.".
+   */
+  static const std::string& prefixString(Prefix prefix);
+
+private:
+  static constexpr uint32_t NumPrefixes = static_cast<uint32_t>(Prefix::Retry) + 1;
+
+  /**
+   * @return the cached counter in a slot, resolving it by name on first use.
+   * @param response_class supplies whether the slot holds the class (e.g. 2xx) counter of
+   *        response_code rather than its own counter.
+   */
+  Stats::Counter& counter(Prefix prefix, uint32_t slot, uint64_t response_code,
+                          bool response_class);
+
+  Stats::Scope& scope_;
+  const uint32_t num_slots_;
+  // NumPrefixes rows of num_slots_ counters each.
+  std::unique_ptr<std::atomic<Stats::Counter*>[]> counters_;
+  std::atomic<Stats::Histogram*> histograms_[NumPrefixes];
+};
+
 /**
  * General utility routines for HTTP codes.
  */
@@ -33,6 +71,9 @@ public:
     const std::string& from_zone_;
     const std::string& to_zone_;
     bool upstream_canary_;
+    // Pre-resolved stats for cluster_scope_, which may only be used if prefix_ is empty. If null,
+    // stats are charged by name.
+    CodeStats* cluster_code_stats_;
   };
 
   /**
@@ -53,6 +94,8 @@ public:
     const std::string& request_vcluster_name_;
     const std::string& from_zone_;
     const std::string& to_zone_;
+    // See ResponseStatInfo.
+    CodeStats* cluster_code_stats_;
   };
 
   /**
@@ -76,6 +119,12 @@ public:
   static bool isGatewayError(uint64_t code) { return code >= 502 && code < 505; }
 
   static std::string groupStringForResponseCode(Code response_code);
+
+private:
+  /**
+   * Charge the cluster scope stats of chargeResponseStat() by name.
+   */
+  static void chargeScopeResponseStat(const ResponseStatInfo& info);
 };
 
 } // namespace Http
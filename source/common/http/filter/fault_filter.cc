@@ -49,7 +49,7 @@ FaultFilterConfig::FaultFilterConfig(const envoy::api::v2::filter::http::HTTPFau
     fixed_duration_ms_ = PROTOBUF_GET_MS_OR_DEFAULT(delay, fixed_delay, 0);
   }
 
-  for (const Router::ConfigUtility::HeaderData& header_map : fault.headers()) {
+  for (const auto& header_map : fault.headers()) {
     fault_filter_headers_.push_back(header_map);
   }
 
@@ -0,0 +1,300 @@
+#include "common/http/filter/gzip_filter.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+#include "common/http/headers.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// Window bits above 15 make zlib write a gzip header and trailer instead of a zlib one.
+const int64_t GzipHeaderWindowBitsOffset = 16;
+
+const std::vector<std::string>& defaultContentTypes() {
+  static const std::vector<std::string>* types = new std::vector<std::string>{
+      "application/javascript", "application/json", "application/xhtml+xml", "image/svg+xml",
+      "text/css",               "text/html",        "text/plain",            "text/xml"};
+  return *types;
+}
+
+// Repeated lines of a list header mean the same as one comma separated line, so their values are
+// joined before they are parsed.
+std::string joinHeaderValues(const HeaderMap& headers, const LowerCaseString& key) {
+  std::pair<const LowerCaseString*, std::string> context(&key, "");
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        auto* joined = static_cast<std::pair<const LowerCaseString*, std::string>*>(context);
+        if (header.key() == joined->first->get().c_str()) {
+          if (!joined->second.empty()) {
+            joined->second += ",";
+          }
+          joined->second += header.value().c_str();
+        }
+        return HeaderMap::Iterate::Continue;
+      },
+      &context);
+  return context.second;
+}
+
+} // namespace
+
+GzipFilterConfig::GzipFilterConfig(const Json::Object& json_config,
+                                   const std::string& stats_prefix, Stats::Scope& scope,
+                                   MonotonicTimeSource& time_source)
+    : Json::Validator(json_config, Json::Schema::GZIP_HTTP_FILTER_SCHEMA),
+      compression_level_(
+          compressionLevelEnum(json_config.getString("compression_level", "default"))),
+      compression_strategy_(
+          compressionStrategyEnum(json_config.getString("compression_strategy", "default"))),
+      memory_level_(json_config.getInteger("memory_level", 5)),
+      window_bits_(json_config.getInteger("window_bits", 12)),
+      minimum_length_(json_config.getInteger("content_length", 30)),
+      disable_on_etag_header_(json_config.getBoolean("disable_on_etag_header", false)),
+      remove_accept_encoding_header_(
+          json_config.getBoolean("remove_accept_encoding_header", false)),
+      stats_(generateStats(stats_prefix, scope)), time_source_(time_source) {
+  const std::vector<std::string> content_types = json_config.getStringArray("content_type", true);
+  for (const std::string& content_type :
+       content_types.empty() ? defaultContentTypes() : content_types) {
+    content_types_.insert(content_type);
+  }
+}
+
+Compressor::ZlibCompressorImpl::CompressionLevel
+GzipFilterConfig::compressionLevelEnum(const std::string& compression_level) {
+  if (compression_level == "best") {
+    return Compressor::ZlibCompressorImpl::CompressionLevel::Best;
+  } else if (compression_level == "speed") {
+    return Compressor::ZlibCompressorImpl::CompressionLevel::Speed;
+  } else {
+    ASSERT(compression_level == "default");
+    return Compressor::ZlibCompressorImpl::CompressionLevel::Standard;
+  }
+}
+
+Compressor::ZlibCompressorImpl::CompressionStrategy
+GzipFilterConfig::compressionStrategyEnum(const std::string& compression_strategy) {
+  if (compression_strategy == "filtered") {
+    return Compressor::ZlibCompressorImpl::CompressionStrategy::Filtered;
+  } else if (compression_strategy == "huffman") {
+    return Compressor::ZlibCompressorImpl::CompressionStrategy::Huffman;
+  } else if (compression_strategy == "rle") {
+    return Compressor::ZlibCompressorImpl::CompressionStrategy::Rle;
+  } else {
+    ASSERT(compression_strategy == "default");
+    return Compressor::ZlibCompressorImpl::CompressionStrategy::Standard;
+  }
+}
+
+GzipFilterStats GzipFilterConfig::generateStats(const std::string& prefix, Stats::Scope& scope) {
+  std::string final_prefix = prefix + "gzip.";
+  return {ALL_GZIP_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
+}
+
+GzipFilter::GzipFilter(GzipFilterConfigSharedPtr config) : config_(config) {}
+
+ContentCoding GzipFilter::chooseContentCoding(absl::string_view accept_encoding) {
+  // A negative quality means that the coding is not listed.
+  double gzip_quality = -1;
+  double deflate_quality = -1;
+  double wildcard_quality = -1;
+  for (absl::string_view coding : StringUtil::splitToken(accept_encoding, ",")) {
+    const std::vector<absl::string_view> params = StringUtil::splitToken(coding, ";");
+    if (params.empty()) {
+      continue;
+    }
+
+    double quality = 1;
+    for (size_t i = 1; i < params.size(); i++) {
+      const absl::string_view param = StringUtil::trim(params[i]);
+      if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+        quality = std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+      }
+    }
+
+    const std::string name = absl::AsciiStrToLower(StringUtil::trim(params[0]));
+    if (name == Headers::get().AcceptEncodingValues.Gzip) {
+      gzip_quality = quality;
+    } else if (name == Headers::get().AcceptEncodingValues.Deflate) {
+      deflate_quality = quality;
+    } else if (name == Headers::get().AcceptEncodingValues.Wildcard) {
+      wildcard_quality = quality;
+    }
+  }
+
+  // Codings that are not listed get the quality of the wildcard, if there is one.
+  if (gzip_quality < 0) {
+    gzip_quality = wildcard_quality;
+  }
+  if (deflate_quality < 0) {
+    deflate_quality = wildcard_quality;
+  }
+
+  if (gzip_quality <= 0 && deflate_quality <= 0) {
+    return ContentCoding::Identity;
+  }
+  return gzip_quality >= deflate_quality ? ContentCoding::Gzip : ContentCoding::Deflate;
+}
+
+FilterHeadersStatus GzipFilter::decodeHeaders(HeaderMap& headers, bool) {
+  if (headers.get(Headers::get().AcceptEncoding) == nullptr) {
+    config_->stats().no_accept_header_.inc();
+    return FilterHeadersStatus::Continue;
+  }
+
+  content_coding_ = chooseContentCoding(joinHeaderValues(headers, Headers::get().AcceptEncoding));
+  switch (content_coding_) {
+  case ContentCoding::Gzip:
+    config_->stats().header_gzip_.inc();
+    break;
+  case ContentCoding::Deflate:
+    config_->stats().header_deflate_.inc();
+    break;
+  case ContentCoding::Identity:
+    config_->stats().header_identity_.inc();
+    break;
+  }
+
+  // Keep upstreams from compressing responses themselves, so that compression is done once, here.
+  if (config_->removeAcceptEncodingHeader()) {
+    headers.remove(Headers::get().AcceptEncoding);
+  }
+  return FilterHeadersStatus::Continue;
+}
+
+bool GzipFilter::isCompressible(const HeaderMap& headers) const {
+  const HeaderEntry* content_encoding = headers.get(Headers::get().ContentEncoding);
+  if (content_encoding != nullptr &&
+      content_encoding->value() != Headers::get().ContentEncodingValues.Identity.c_str()) {
+    return false;
+  }
+
+  const HeaderEntry* cache_control = headers.CacheControl();
+  if (cache_control != nullptr &&
+      StringUtil::findToken(cache_control->value().c_str(), ",",
+                            Headers::get().CacheControlValues.NoTransform)) {
+    return false;
+  }
+
+  if (config_->disableOnEtagHeader() && headers.get(Headers::get().Etag) != nullptr) {
+    return false;
+  }
+
+  // Responses without a content length are streamed, and are compressed whatever their size.
+  const HeaderEntry* content_length = headers.ContentLength();
+  uint64_t length;
+  if (content_length != nullptr && StringUtil::atoul(content_length->value().c_str(), length) &&
+      length < config_->minimumLength()) {
+    return false;
+  }
+
+  const HeaderEntry* content_type = headers.ContentType();
+  if (content_type == nullptr) {
+    return false;
+  }
+  const std::string type(StringUtil::cropRight(content_type->value().c_str(), ";"));
+  return config_->contentTypes().count(type) > 0;
+}
+
+FilterHeadersStatus GzipFilter::encodeHeaders(HeaderMap& headers, bool end_stream) {
+  if (content_coding_ == ContentCoding::Identity || end_stream) {
+    return FilterHeadersStatus::Continue;
+  }
+
+  if (!isCompressible(headers)) {
+    config_->stats().not_compressed_.inc();
+    return FilterHeadersStatus::Continue;
+  }
+
+  int64_t window_bits = config_->windowBits();
+  if (content_coding_ == ContentCoding::Gzip) {
+    window_bits += GzipHeaderWindowBitsOffset;
+    headers.setReference(Headers::get().ContentEncoding, Headers::get().ContentEncodingValues.Gzip);
+  } else {
+    headers.setReference(Headers::get().ContentEncoding,
+                         Headers::get().ContentEncodingValues.Deflate);
+  }
+  compressor_.reset(new Compressor::ZlibCompressorImpl());
+  compressor_->init(config_->compressionLevel(), config_->compressionStrategy(), window_bits,
+                    config_->memoryLevel());
+
+  // The compressed length is not known up front, so the body is sent chunked.
+  headers.removeContentLength();
+
+  // A strong ETag identifies the uncompressed bytes, which are no longer what is being sent.
+  HeaderEntry* etag = headers.get(Headers::get().Etag);
+  if (etag != nullptr && !StringUtil::startsWith(etag->value().c_str(), "W/")) {
+    const std::string weak_etag = std::string("W/") + etag->value().c_str();
+    etag->value(weak_etag);
+  }
+
+  HeaderEntry* vary = headers.get(Headers::get().Vary);
+  if (vary == nullptr) {
+    headers.addReference(Headers::get().Vary, Headers::get().VaryValues.AcceptEncoding);
+  } else if (!StringUtil::findToken(joinHeaderValues(headers, Headers::get().Vary), ",",
+                                    Headers::get().VaryValues.AcceptEncoding)) {
+    // Build the new value from a copy, since appending to a value that references a static string
+    // would discard it.
+    const std::string new_vary =
+        std::string(vary->value().c_str()) + ", " + Headers::get().VaryValues.AcceptEncoding;
+    vary->value(new_vary);
+  }
+
+  config_->stats().compressed_.inc();
+  return FilterHeadersStatus::Continue;
+}
+
+FilterDataStatus GzipFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (!compressor_) {
+    return FilterDataStatus::Continue;
+  }
+
+  Buffer::OwnedImpl compressed;
+  compress(data, compressed, end_stream);
+  data.drain(data.length());
+  data.move(compressed);
+  return FilterDataStatus::Continue;
+}
+
+FilterTrailersStatus GzipFilter::encodeTrailers(HeaderMap&) {
+  if (compressor_) {
+    Buffer::OwnedImpl empty;
+    Buffer::OwnedImpl compressed;
+    compress(empty, compressed, true);
+    encoder_callbacks_->addEncodedData(compressed, true);
+  }
+  return FilterTrailersStatus::Continue;
+}
+
+void GzipFilter::compress(const Buffer::Instance& input, Buffer::Instance& output,
+                          bool end_stream) {
+  const MonotonicTime start = config_->timeSource().currentTime();
+  compressor_->compress(input, output);
+  if (end_stream) {
+    compressor_->finish(output);
+  }
+  compression_time_ += std::chrono::duration_cast<std::chrono::microseconds>(
+      config_->timeSource().currentTime() - start);
+
+  config_->stats().total_uncompressed_bytes_.add(input.length());
+  config_->stats().total_compressed_bytes_.add(output.length());
+  if (end_stream) {
+    config_->stats().compression_time_us_.recordValue(compression_time_.count());
+    compressor_.reset();
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
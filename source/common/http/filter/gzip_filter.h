@@ -0,0 +1,145 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/json/json_object.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/json/config_schemas.h"
+#include "common/json/json_validator.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * All stats for the gzip filter. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_GZIP_FILTER_STATS(COUNTER, HISTOGRAM)                                                  \
+  COUNTER(compressed)                                                                              \
+  COUNTER(not_compressed)                                                                          \
+  COUNTER(no_accept_header)                                                                        \
+  COUNTER(header_gzip)                                                                             \
+  COUNTER(header_deflate)                                                                          \
+  COUNTER(header_identity)                                                                         \
+  COUNTER(total_uncompressed_bytes)                                                                \
+  COUNTER(total_compressed_bytes)                                                                  \
+  HISTOGRAM(compression_time_us)
+// clang-format on
+
+/**
+ * Wrapper struct for gzip filter stats. @see stats_macros.h
+ */
+struct GzipFilterStats {
+  ALL_GZIP_FILTER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Content codings the filter can respond with.
+ */
+enum class ContentCoding { Identity, Gzip, Deflate };
+
+/**
+ * Configuration for the gzip filter.
+ */
+class GzipFilterConfig : Json::Validator {
+public:
+  GzipFilterConfig(const Json::Object& json_config, const std::string& stats_prefix,
+                   Stats::Scope& scope, MonotonicTimeSource& time_source);
+
+  Compressor::ZlibCompressorImpl::CompressionLevel compressionLevel() const {
+    return compression_level_;
+  }
+  Compressor::ZlibCompressorImpl::CompressionStrategy compressionStrategy() const {
+    return compression_strategy_;
+  }
+  uint64_t memoryLevel() const { return memory_level_; }
+  int64_t windowBits() const { return window_bits_; }
+  uint64_t minimumLength() const { return minimum_length_; }
+  const std::unordered_set<std::string>& contentTypes() const { return content_types_; }
+  bool disableOnEtagHeader() const { return disable_on_etag_header_; }
+  bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+  GzipFilterStats& stats() { return stats_; }
+  MonotonicTimeSource& timeSource() { return time_source_; }
+
+private:
+  static Compressor::ZlibCompressorImpl::CompressionLevel
+  compressionLevelEnum(const std::string& compression_level);
+  static Compressor::ZlibCompressorImpl::CompressionStrategy
+  compressionStrategyEnum(const std::string& compression_strategy);
+  static GzipFilterStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
+  const Compressor::ZlibCompressorImpl::CompressionLevel compression_level_;
+  const Compressor::ZlibCompressorImpl::CompressionStrategy compression_strategy_;
+  const uint64_t memory_level_;
+  const int64_t window_bits_;
+  const uint64_t minimum_length_;
+  std::unordered_set<std::string> content_types_;
+  const bool disable_on_etag_header_;
+  const bool remove_accept_encoding_header_;
+  GzipFilterStats stats_;
+  MonotonicTimeSource& time_source_;
+};
+
+typedef std::shared_ptr<GzipFilterConfig> GzipFilterConfigSharedPtr;
+
+/**
+ * A filter that compresses response bodies with gzip or deflate, when the request's
+ * Accept-Encoding header allows it. The body is compressed as it streams through the filter and is
+ * never buffered in full.
+ */
+class GzipFilter : public StreamFilter {
+public:
+  GzipFilter(GzipFilterConfigSharedPtr config);
+
+  /**
+   * Picks the content coding to respond with from the value of an Accept-Encoding header. Codings
+   * are chosen by their quality value, and codings with a quality of zero are never chosen.
+   * @param accept_encoding supplies the header value.
+   * @return ContentCoding Gzip or Deflate, or Identity if the client accepts neither.
+   */
+  static ContentCoding chooseContentCoding(absl::string_view accept_encoding);
+
+  // Http::StreamFilterBase
+  void onDestroy() override {}
+
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(HeaderMap& headers, bool end_stream) override;
+  FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return FilterDataStatus::Continue;
+  }
+  FilterTrailersStatus decodeTrailers(HeaderMap&) override {
+    return FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(StreamDecoderFilterCallbacks&) override {}
+
+  // Http::StreamEncoderFilter
+  FilterHeadersStatus encodeHeaders(HeaderMap& headers, bool end_stream) override;
+  FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  FilterTrailersStatus encodeTrailers(HeaderMap& trailers) override;
+  void setEncoderFilterCallbacks(StreamEncoderFilterCallbacks& callbacks) override {
+    encoder_callbacks_ = &callbacks;
+  }
+
+private:
+  bool isCompressible(const HeaderMap& headers) const;
+  void compress(const Buffer::Instance& input, Buffer::Instance& output, bool end_stream);
+
+  GzipFilterConfigSharedPtr config_;
+  StreamEncoderFilterCallbacks* encoder_callbacks_{};
+  ContentCoding content_coding_{ContentCoding::Identity};
+  std::unique_ptr<Compressor::ZlibCompressorImpl> compressor_;
+  std::chrono::microseconds compression_time_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -1,7 +1,6 @@
 #include "common/http/header_map_impl.h"
 
 #include <cstdint>
-#include <list>
 #include <string>
 
 #include "common/common/assert.h"
@@ -212,6 +211,66 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
   value(header.value().c_str(), header.value().size());
 }
 
+HeaderMapImpl::HeaderList::~HeaderList() {
+  Block* block = head_;
+  while (block != nullptr) {
+    for (uint32_t i = 0; i < block->used_; i++) {
+      if (block->live()[i]) {
+        block->entry(i)->~HeaderEntryImpl();
+      }
+    }
+    Block* next = block->next_;
+    block->~Block();
+    ::operator delete(block);
+    block = next;
+  }
+}
+
+template <class... Args>
+HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::HeaderList::emplace_back(Args&&... args) {
+  if (tail_ == nullptr || tail_->used_ == tail_->capacity_) {
+    const uint32_t capacity = tail_ == nullptr ? first_block_capacity_ : tail_->capacity_ * 2;
+    void* memory = ::operator new(sizeof(Block) + capacity * (sizeof(HeaderEntryImpl) + 1));
+    Block* block = new (memory) Block(capacity, tail_);
+    if (tail_ == nullptr) {
+      head_ = block;
+    } else {
+      tail_->next_ = block;
+    }
+    tail_ = block;
+  }
+
+  HeaderEntryImpl* entry =
+      new (tail_->entry(tail_->used_)) HeaderEntryImpl(std::forward<Args>(args)...);
+  tail_->live()[tail_->used_] = true;
+  tail_->used_++;
+  size_++;
+  return *entry;
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderEntryImpl& entry) {
+  // There are only a handful of blocks, so find the owner by address.
+  Block* block = tail_;
+  while (&entry < block->entry(0) || &entry >= block->entry(block->used_)) {
+    block = block->prev_;
+    ASSERT(block != nullptr);
+  }
+
+  const uint32_t index = &entry - block->entry(0);
+  ASSERT(block->live()[index]);
+  entry.~HeaderEntryImpl();
+  block->live()[index] = false;
+  size_--;
+
+  // Reclaim trailing slots so that remove-then-add patterns (e.g. setReference()) do not leave
+  // holes at the end of the map.
+  if (block == tail_) {
+    while (tail_->used_ > 0 && !tail_->live()[tail_->used_ - 1]) {
+      tail_->used_--;
+    }
+  }
+}
+
 #define INLINE_HEADER_STATIC_MAP_ENTRY(name)                                                       \
   add(Headers::get().name.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {            \
     return {&h.inline_headers_.name##_, &Headers::get().name};                                     \
@@ -224,50 +283,90 @@ HeaderMapImpl::StaticLookupTable::StaticLookupTable() {
   add(Headers::get().HostLegacy.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {
     return {&h.inline_headers_.Host_, &Headers::get().Host};
   });
+
+  build();
 }
 
-void HeaderMapImpl::StaticLookupTable::add(const char* key, StaticLookupEntry::EntryCb cb) {
-  StaticLookupEntry* current = &root_;
-  while (uint8_t c = *key) {
-    if (!current->entries_[c]) {
-      current->entries_[c].reset(new StaticLookupEntry());
-    }
+void HeaderMapImpl::StaticLookupTable::add(const char* key, EntryCb cb) {
+  Entry entry;
+  entry.key_ = key;
+  entry.size_ = strlen(key);
+  entry.cb_ = cb;
+  entries_.push_back(entry);
+}
 
-    current = current->entries_[c].get();
-    key++;
+uint64_t HeaderMapImpl::StaticLookupTable::hash(const char* key, uint64_t seed, size_t* size) {
+  // FNV-1a with a seeded offset basis, finished with a fold of the high bits into the low bits
+  // since the table is indexed by the low bits.
+  uint64_t hash = 14695981039346656037UL ^ seed;
+  const char* current = key;
+  while (uint8_t c = *current++) {
+    hash = (hash ^ c) * 1099511628211UL;
   }
+  *size = current - key - 1;
+  return hash ^ (hash >> 29) ^ (hash >> 47);
+}
 
-  current->cb_ = cb;
+void HeaderMapImpl::StaticLookupTable::build() {
+  // A table 8x the number of keys makes a collision free seed likely within a few dozen tries.
+  uint64_t table_size = 1;
+  while (table_size < entries_.size() * 8) {
+    table_size <<= 1;
+  }
+  mask_ = table_size - 1;
+
+  for (seed_ = 0;; seed_++) {
+    table_.assign(table_size, Entry());
+    bool collision = false;
+    for (const Entry& entry : entries_) {
+      size_t size;
+      Entry& slot = table_[hash(entry.key_, seed_, &size) & mask_];
+      if (slot.key_ != nullptr) {
+        collision = true;
+        break;
+      }
+      slot = entry;
+    }
+    if (!collision) {
+      return;
+    }
+    RELEASE_ASSERT(seed_ < 1000000);
+  }
 }
 
-HeaderMapImpl::StaticLookupEntry::EntryCb
+HeaderMapImpl::StaticLookupTable::EntryCb
 HeaderMapImpl::StaticLookupTable::find(const char* key) const {
-  const StaticLookupEntry* current = &root_;
-  while (uint8_t c = *key) {
-    current = current->entries_[c].get();
-    if (current) {
-      key++;
-    } else {
-      return nullptr;
-    }
+  size_t size;
+  const Entry& slot = table_[hash(key, seed_, &size) & mask_];
+  if (slot.key_ != nullptr && slot.size_ == size && memcmp(slot.key_, key, size) == 0) {
+    return slot.cb_;
   }
 
-  return current->cb_;
+  return nullptr;
 }
 
 HeaderMapImpl::HeaderMapImpl() { memset(&inline_headers_, 0, sizeof(inline_headers_)); }
 
 HeaderMapImpl::HeaderMapImpl(const HeaderMap& rhs) : HeaderMapImpl() {
+  headers_.reserve(rhs.size());
   rhs.iterate(
       [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
-        // TODO(mattklein123) PERF: Avoid copying here is not necessary.
-        HeaderString key_string;
-        key_string.setCopy(header.key().c_str(), header.key().size());
+        HeaderMapImpl& map = *static_cast<HeaderMapImpl*>(context);
         HeaderString value_string;
         value_string.setCopy(header.value().c_str(), header.value().size());
 
-        static_cast<HeaderMapImpl*>(context)->addViaMove(std::move(key_string),
-                                                         std::move(value_string));
+        // Inline headers use a static reference key, so only copy the key of other headers.
+        StaticLookupTable::EntryCb cb =
+            ConstSingleton<StaticLookupTable>::get().find(header.key().c_str());
+        if (cb) {
+          StaticLookupResponse ref_lookup_response = cb(map);
+          map.maybeCreateInline(ref_lookup_response.entry_, *ref_lookup_response.key_,
+                                std::move(value_string));
+        } else {
+          HeaderString key_string;
+          key_string.setCopy(header.key().c_str(), header.key().size());
+          map.headers_.emplace_back(std::move(key_string), std::move(value_string));
+        }
         return HeaderMap::Iterate::Continue;
       },
       this);
@@ -300,7 +399,7 @@ bool HeaderMapImpl::operator==(const HeaderMapImpl& rhs) const {
 }
 
 void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.c_str());
+  StaticLookupTable::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.c_str());
   if (cb) {
     // TODO(mattklein123): Currently, for all of the inline headers, we don't support appending. The
     // only inline header where we should be converting multiple headers into a comma delimited
@@ -311,9 +410,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     maybeCreateInline(ref_lookup_response.entry_, *ref_lookup_response.key_, std::move(value));
   } else {
-    std::list<HeaderEntryImpl>::iterator i =
-        headers_.emplace(headers_.end(), std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.emplace_back(std::move(key), std::move(value));
   }
 }
 
@@ -418,16 +515,14 @@ void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
 }
 
 void HeaderMapImpl::iterateReverse(ConstIterateCb cb, void* context) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it, context) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.reverseForEach([cb, context](const HeaderEntryImpl& header) -> bool {
+    return cb(header, context) == HeaderMap::Iterate::Continue;
+  });
 }
 
 HeaderMap::Lookup HeaderMapImpl::lookup(const LowerCaseString& key,
                                         const HeaderEntry** entry) const {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
+  StaticLookupTable::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
   if (cb) {
     // The accessor callbacks for predefined inline headers take a HeaderMapImpl& as an argument;
     // even though we don't make any modifications, we need to cast_cast in order to use the
@@ -449,16 +544,16 @@ HeaderMap::Lookup HeaderMapImpl::lookup(const LowerCaseString& key,
 }
 
 void HeaderMapImpl::remove(const LowerCaseString& key) {
-  StaticLookupEntry::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
+  StaticLookupTable::EntryCb cb = ConstSingleton<StaticLookupTable>::get().find(key.get().c_str());
   if (cb) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
     for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key.get().c_str()) {
-        i = headers_.erase(i);
-      } else {
-        ++i;
+      HeaderEntryImpl& header = *i;
+      ++i;
+      if (header.key() == key.get().c_str()) {
+        headers_.erase(header);
       }
     }
   }
@@ -470,9 +565,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplace_back(key);
   return **entry;
 }
 
@@ -484,9 +577,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplace_back(key, std::move(value));
   return **entry;
 }
 
@@ -497,7 +588,7 @@ void HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
 
   HeaderEntryImpl* entry = *ptr_to_entry;
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_);
+  headers_.erase(*entry);
 }
 
 } // namespace Http
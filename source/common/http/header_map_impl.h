@@ -1,10 +1,10 @@
 #pragma once
 
-#include <array>
+#include <algorithm>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -40,6 +40,7 @@ public:
   HeaderMapImpl();
   HeaderMapImpl(const std::initializer_list<std::pair<LowerCaseString, std::string>>& values);
   HeaderMapImpl(const HeaderMap& rhs);
+  HeaderMapImpl(const HeaderMapImpl& rhs) : HeaderMapImpl(static_cast<const HeaderMap&>(rhs)) {}
 
   /**
    * Add a header via full move. This is the expected high performance paths for codecs populating
@@ -87,7 +88,118 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+  };
+
+  /**
+   * Append-only storage for the entries of a header map. Entries are constructed in place inside
+   * blocks that never move, so HeaderEntry pointers stay valid while iteration, byteSize() and
+   * copying walk contiguous memory. The first block is sized for the expected number of headers
+   * and each further block doubles the capacity, so a typical request or response header map
+   * needs a single allocation. Removed entries are destroyed in place and skipped by iteration.
+   */
+  class HeaderList : NonCopyable {
+  private:
+    struct Block {
+      Block(uint32_t capacity, Block* prev) : prev_(prev), capacity_(capacity) {}
+
+      HeaderEntryImpl* entry(uint32_t index) {
+        return reinterpret_cast<HeaderEntryImpl*>(this + 1) + index;
+      }
+      bool* live() { return reinterpret_cast<bool*>(entry(capacity_)); }
+
+      Block* next_{};
+      Block* prev_;
+      const uint32_t capacity_;
+      uint32_t used_{};
+    };
+
+  public:
+    template <class EntryType> class IteratorBase {
+    public:
+      IteratorBase(Block* block, uint32_t index) : block_(block), index_(index) { skipRemoved(); }
+
+      EntryType& operator*() const { return *block_->entry(index_); }
+      EntryType* operator->() const { return block_->entry(index_); }
+      bool operator==(const IteratorBase& rhs) const {
+        return block_ == rhs.block_ && index_ == rhs.index_;
+      }
+      bool operator!=(const IteratorBase& rhs) const { return !(*this == rhs); }
+      IteratorBase& operator++() {
+        index_++;
+        skipRemoved();
+        return *this;
+      }
+
+    private:
+      void skipRemoved() {
+        while (block_ != nullptr) {
+          while (index_ < block_->used_ && !block_->live()[index_]) {
+            index_++;
+          }
+          if (index_ < block_->used_) {
+            return;
+          }
+          block_ = block_->next_;
+          index_ = 0;
+        }
+      }
+
+      Block* block_;
+      uint32_t index_;
+    };
+
+    typedef IteratorBase<HeaderEntryImpl> iterator;
+    typedef IteratorBase<const HeaderEntryImpl> const_iterator;
+
+    HeaderList() {}
+    ~HeaderList();
+
+    /**
+     * Size the first block for at least capacity entries. Only has an effect before the first
+     * entry is added.
+     */
+    void reserve(uint32_t capacity) {
+      if (head_ == nullptr) {
+        first_block_capacity_ = std::max(first_block_capacity_, capacity);
+      }
+    }
+
+    template <class... Args> HeaderEntryImpl& emplace_back(Args&&... args);
+    void erase(HeaderEntryImpl& entry);
+
+    /**
+     * Iterate over the live entries from the last added to the first.
+     * @return false if the callback stopped the iteration, true otherwise.
+     */
+    template <class Callback> bool reverseForEach(Callback cb) const {
+      for (Block* block = tail_; block != nullptr; block = block->prev_) {
+        for (uint32_t i = block->used_; i > 0; i--) {
+          if (block->live()[i - 1] && !cb(*block->entry(i - 1))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    iterator begin() { return {head_, 0}; }
+    iterator end() { return {nullptr, 0}; }
+    const_iterator begin() const { return {head_, 0}; }
+    const_iterator end() const { return {nullptr, 0}; }
+    size_t size() const { return size_; }
+
+  private:
+    static_assert(sizeof(Block) % alignof(HeaderEntryImpl) == 0,
+                  "HeaderEntryImpl storage following a Block header must be aligned");
+
+    // Capacity of the first block unless reserve() asks for more. Most requests and responses
+    // carry fewer headers than this.
+    static const uint32_t DefaultFirstBlockCapacity = 16;
+
+    Block* head_{};
+    Block* tail_{};
+    size_t size_{};
+    uint32_t first_block_capacity_{DefaultFirstBlockCapacity};
   };
 
   struct StaticLookupResponse {
@@ -95,23 +207,33 @@ protected:
     const LowerCaseString* key_;
   };
 
-  struct StaticLookupEntry {
-    typedef StaticLookupResponse (*EntryCb)(HeaderMapImpl&);
-
-    EntryCb cb_{};
-    std::array<std::unique_ptr<StaticLookupEntry>, 256> entries_;
-  };
-
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. It is a flat open table indexed by a seeded hash of the key, with the seed chosen at
+   * construction so that no two known keys share a slot. A lookup is therefore one pass over the
+   * key to hash it followed by a single comparison.
    */
   struct StaticLookupTable {
+    typedef StaticLookupResponse (*EntryCb)(HeaderMapImpl&);
+
     StaticLookupTable();
-    void add(const char* key, StaticLookupEntry::EntryCb cb);
-    StaticLookupEntry::EntryCb find(const char* key) const;
+    void add(const char* key, EntryCb cb);
+    EntryCb find(const char* key) const;
+
+  private:
+    struct Entry {
+      const char* key_{};
+      size_t size_{};
+      EntryCb cb_{};
+    };
+
+    static uint64_t hash(const char* key, uint64_t seed, size_t* size);
+    void build();
 
-    StaticLookupEntry root_;
+    std::vector<Entry> entries_;
+    std::vector<Entry> table_;
+    uint64_t seed_{};
+    uint64_t mask_{};
   };
 
   struct AllInlineHeaders {
@@ -125,7 +247,7 @@ protected:
   void removeInline(HeaderEntryImpl** entry);
 
   AllInlineHeaders inline_headers_;
-  std::list<HeaderEntryImpl> headers_;
+  HeaderList headers_;
 
   ALL_INLINE_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
 };
@@ -15,6 +15,7 @@ namespace Http {
 class HeaderValues {
 public:
   const LowerCaseString Accept{"accept"};
+  const LowerCaseString AcceptEncoding{"accept-encoding"};
   const LowerCaseString AccessControlRequestHeaders{"access-control-request-headers"};
   const LowerCaseString AccessControlRequestMethod{"access-control-request-method"};
   const LowerCaseString AccessControlAllowOrigin{"access-control-allow-origin"};
@@ -27,10 +28,12 @@ public:
   const LowerCaseString CacheControl{"cache-control"};
   const LowerCaseString ClientTraceId{"x-client-trace-id"};
   const LowerCaseString Connection{"connection"};
+  const LowerCaseString ContentEncoding{"content-encoding"};
   const LowerCaseString ContentLength{"content-length"};
   const LowerCaseString ContentType{"content-type"};
   const LowerCaseString Cookie{"cookie"};
   const LowerCaseString Date{"date"};
+  const LowerCaseString Etag{"etag"};
   const LowerCaseString EnvoyDownstreamServiceCluster{"x-envoy-downstream-service-cluster"};
   const LowerCaseString EnvoyDownstreamServiceNode{"x-envoy-downstream-service-node"};
   const LowerCaseString EnvoyExternalAddress{"x-envoy-external-address"};
@@ -79,6 +82,7 @@ public:
   const LowerCaseString TE{"te"};
   const LowerCaseString Upgrade{"upgrade"};
   const LowerCaseString UserAgent{"user-agent"};
+  const LowerCaseString Vary{"vary"};
   const LowerCaseString XB3TraceId{"x-b3-traceid"};
   const LowerCaseString XB3SpanId{"x-b3-spanid"};
   const LowerCaseString XB3ParentSpanId{"x-b3-parentspanid"};
@@ -98,8 +102,22 @@ public:
 
   struct {
     const std::string NoCacheMaxAge0{"no-cache, max-age=0"};
+    const std::string NoTransform{"no-transform"};
   } CacheControlValues;
 
+  struct {
+    const std::string Deflate{"deflate"};
+    const std::string Gzip{"gzip"};
+    const std::string Identity{"identity"};
+    const std::string Wildcard{"*"};
+  } AcceptEncodingValues;
+
+  struct {
+    const std::string Deflate{"deflate"};
+    const std::string Gzip{"gzip"};
+    const std::string Identity{"identity"};
+  } ContentEncodingValues;
+
   struct {
     const std::string Text{"text/plain"};
     const std::string TextUtf8{"text/plain; charset=UTF-8"}; // TODO(jmarantz): fold this into Text
@@ -110,6 +128,7 @@ public:
     const std::string GrpcWebText{"application/grpc-web-text"};
     const std::string GrpcWebTextProto{"application/grpc-web-text+proto"};
     const std::string Json{"application/json"};
+    const std::string Thrift{"application/x-thrift"};
   } ContentTypeValues;
 
   struct {
@@ -162,6 +181,10 @@ public:
     const std::string EnvoyHealthChecker{"Envoy/HC"};
   } UserAgentValues;
 
+  struct {
+    const std::string AcceptEncoding{"Accept-Encoding"};
+  } VaryValues;
+
   struct {
     const std::string Default{"identity,deflate,gzip"};
   } GrpcAcceptEncodingValues;
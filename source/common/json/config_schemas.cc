@@ -1075,6 +1075,45 @@ const std::string Json::Schema::GRPC_JSON_TRANSCODER_FILTER_SCHEMA(R"EOF(
   }
   )EOF");
 
+const std::string Json::Schema::GZIP_HTTP_FILTER_SCHEMA(R"EOF(
+  {
+    "$schema": "http://json-schema.org/schema#",
+    "type" : "object",
+    "properties" : {
+      "memory_level" : {
+        "type" : "integer",
+        "minimum" : 1,
+        "maximum" : 9
+      },
+      "window_bits" : {
+        "type" : "integer",
+        "minimum" : 9,
+        "maximum" : 15
+      },
+      "compression_level" : {
+        "type" : "string",
+        "enum" : ["best", "speed", "default"]
+      },
+      "compression_strategy" : {
+        "type" : "string",
+        "enum" : ["default", "filtered", "huffman", "rle"]
+      },
+      "content_length" : {
+        "type" : "integer",
+        "minimum" : 0
+      },
+      "content_type" : {
+        "type" : "array",
+        "uniqueItems" : true,
+        "items" : { "type" : "string" }
+      },
+      "disable_on_etag_header" : {"type" : "boolean"},
+      "remove_accept_encoding_header" : {"type" : "boolean"}
+    },
+    "additionalProperties" : false
+  }
+  )EOF");
+
 const std::string Json::Schema::IP_TAGGING_HTTP_FILTER_SCHEMA(R"EOF(
   {
     "$schema": "http://json-schema.org/schema#",
@@ -1286,7 +1325,15 @@ const std::string Json::Schema::TOP_LEVEL_CONFIG_SCHEMA(R"EOF(
             "type" : "object",
             "properties" : {
               "collector_cluster" : {"type" : "string"},
-              "collector_endpoint": {"type": "string"}
+              "collector_endpoint": {"type": "string"},
+              "collector_encoding" : {
+                "type" : "string",
+                "enum" : ["json", "thrift"]
+              },
+              "collector_compression" : {
+                "type" : "string",
+                "enum" : ["none", "gzip"]
+              }
             },
             "required": ["collector_cluster"],
             "additionalProperties" : false
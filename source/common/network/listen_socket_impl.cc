@@ -29,7 +29,8 @@ void ListenSocketImpl::doBind() {
   }
 }
 
-TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port) {
+TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port,
+                                 bool reuse_port) {
   local_address_ = address;
   fd_ = local_address_->socket(Address::SocketType::Stream);
   RELEASE_ASSERT(fd_ != -1);
@@ -38,6 +39,16 @@ TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool b
   int rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
   RELEASE_ASSERT(rc != -1);
 
+  if (reuse_port) {
+    // This has to be set before binding, on every socket that binds to the address.
+    rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    if (rc == -1) {
+      close();
+      throw EnvoyException(fmt::format("cannot set SO_REUSEPORT on '{}': {}",
+                                       local_address_->asString(), strerror(errno)));
+    }
+  }
+
   if (bind_to_port) {
     doBind();
   }
@@ -41,7 +41,14 @@ protected:
  */
 class TcpListenSocket : public ListenSocketImpl {
 public:
-  TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port);
+  TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port)
+      : TcpListenSocket(address, bind_to_port, false) {}
+
+  /**
+   * @param reuse_port supplies whether to set SO_REUSEPORT, which allows several sockets to bind
+   *        to the same address. The kernel then balances new connections across the sockets.
+   */
+  TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port, bool reuse_port);
   TcpListenSocket(int fd, Address::InstanceConstSharedPtr address);
 };
 
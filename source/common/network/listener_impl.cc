@@ -1,8 +1,14 @@
 #include "common/network/listener_impl.h"
 
+#include <fcntl.h>
+#include <netinet/in.h>
 #include <sys/un.h>
 
+#include <chrono>
+#include <cstring>
+
 #include "envoy/common/exception.h"
+#include "envoy/common/time.h"
 
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
@@ -11,40 +17,111 @@
 #include "common/event/file_event_impl.h"
 #include "common/network/address_impl.h"
 
-#include "event2/listener.h"
-
 namespace Envoy {
 namespace Network {
 
+namespace {
+// Listeners on the all hosts address normally see only a handful of local addresses. Anything past
+// this is looked up without being cached.
+const size_t MAX_CACHED_LOCAL_ADDRESSES = 16;
+} // namespace
+
+const uint32_t ListenerImpl::MAX_ACCEPTS_PER_WAKEUP = 64;
+
 Address::InstanceConstSharedPtr ListenerImpl::getLocalAddress(int fd) {
-  return Address::addressFromFd(fd);
+  sockaddr_storage ss;
+  socklen_t ss_len = sizeof(ss);
+  const int rc = ::getsockname(fd, reinterpret_cast<sockaddr*>(&ss), &ss_len);
+  if (rc != 0) {
+    throw EnvoyException(
+        fmt::format("getsockname failed for '{}': ({}) {}", fd, errno, strerror(errno)));
+  }
+
+  for (const CachedLocalAddress& cached : local_address_cache_) {
+    if (cached.len_ == ss_len && memcmp(&cached.sockaddr_, &ss, ss_len) == 0) {
+      return cached.address_;
+    }
+  }
+
+  // Accepted sockets inherit IPV6_V6ONLY from the listen socket, so the cached address is right
+  // for every later socket with the same local address.
+  int v6only = 0;
+  if (ss.ss_family == AF_INET6) {
+    socklen_t size_int = sizeof(v6only);
+    RELEASE_ASSERT(::getsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, &size_int) == 0);
+  }
+  Address::InstanceConstSharedPtr address = Address::addressFromSockAddr(ss, ss_len, v6only);
+  if (local_address_cache_.size() < MAX_CACHED_LOCAL_ADDRESSES) {
+    local_address_cache_.push_back({ss, ss_len, address});
+  }
+  return address;
 }
 
-void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                                  int remote_addr_len, void* arg) {
-  ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
-  ConnectionSocketPtr socket(new AcceptedSocketImpl(
-      fd,
-      // Get the local address from the new socket if the listener is listening on IP ANY
-      // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
-      !listener->local_address_ ? listener->getLocalAddress(fd) : listener->local_address_,
-      // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
-      // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
-      // sockaddr_un associated with the client socket when starting from the server socket.
-      // We work around this by using our own name for the socket in this case.
-      (remote_addr->sa_family == AF_UNIX)
-          ? Address::peerAddressFromFd(fd)
-          : Address::addressFromSockAddr(*reinterpret_cast<const sockaddr_storage*>(remote_addr),
-                                         remote_addr_len)));
-  listener->cb_.onAccept(std::move(socket), listener->hand_off_restored_destination_connections_);
+int ListenerImpl::acceptSocket(sockaddr_storage& remote_addr, socklen_t& remote_addr_len) {
+  sockaddr* addr = reinterpret_cast<sockaddr*>(&remote_addr);
+#ifdef __APPLE__
+  // There is no accept4(), so set the flags on the accepted socket instead.
+  const int fd = ::accept(socket_.fd(), addr, &remote_addr_len);
+  if (fd != -1) {
+    RELEASE_ASSERT(fcntl(fd, F_SETFL, O_NONBLOCK) != -1);
+    RELEASE_ASSERT(fcntl(fd, F_SETFD, FD_CLOEXEC) != -1);
+  }
+  return fd;
+#else
+  return ::accept4(socket_.fd(), addr, &remote_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#endif
+}
+
+void ListenerImpl::onSocketReadable() {
+  const MonotonicTime start = time_source_.currentTime();
+  uint32_t accepted = 0;
+  while (accepted < MAX_ACCEPTS_PER_WAKEUP) {
+    sockaddr_storage remote_addr;
+    socklen_t remote_addr_len = sizeof(remote_addr);
+    const int fd = acceptSocket(remote_addr, remote_addr_len);
+    if (fd == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // The backlog is empty.
+        break;
+      }
+      if (errno == EINTR || errno == ECONNABORTED) {
+        // The peer reset the connection before we got to it. Move on to the next one.
+        continue;
+      }
+      // We should never get any other error. This can happen if we run out of FDs or memory. In
+      // those cases just crash.
+      PANIC(fmt::format("listener accept failure: {}", strerror(errno)));
+    }
+
+    accepted++;
+    ConnectionSocketPtr socket(new AcceptedSocketImpl(
+        fd,
+        // Get the local address from the new socket if the listener is listening on IP ANY
+        // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
+        !local_address_ ? getLocalAddress(fd) : local_address_,
+        // The accept() call that filled in remote_addr doesn't fill in more than the sa_family
+        // field for Unix domain sockets; apparently there isn't a mechanism in the kernel to get
+        // the sockaddr_un associated with the client socket when starting from the server socket.
+        // We work around this by using our own name for the socket in this case.
+        (remote_addr.ss_family == AF_UNIX)
+            ? Address::peerAddressFromFd(fd)
+            : Address::addressFromSockAddr(remote_addr, remote_addr_len)));
+    cb_.onAccept(std::move(socket), hand_off_restored_destination_connections_);
+  }
+
+  if (accepted > 0) {
+    cb_.onAcceptBatch(accepted, std::chrono::duration_cast<std::chrono::microseconds>(
+                                    time_source_.currentTime() - start));
+  }
 }
 
 ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, ListenSocket& socket,
                            ListenerCallbacks& cb, bool bind_to_port,
-                           bool hand_off_restored_destination_connections)
+                           bool hand_off_restored_destination_connections,
+                           MonotonicTimeSource& time_source)
     : local_address_(nullptr), cb_(cb),
       hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
-      listener_(nullptr) {
+      socket_(socket), time_source_(time_source) {
   const auto ip = socket.localAddress()->ip();
 
   // Only use the listen socket's local address for new connections if it is not the all hosts
@@ -54,23 +131,20 @@ ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, ListenSocket& sock
   }
 
   if (bind_to_port) {
-    listener_.reset(
-        evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1, socket.fd()));
-
-    if (!listener_) {
+    // The listen socket must not block. When workers share a socket, all of them are woken up for
+    // a new connection but only one of them gets it.
+    const int flags = fcntl(socket.fd(), F_GETFL, 0);
+    if (flags == -1 || fcntl(socket.fd(), F_SETFL, flags | O_NONBLOCK) == -1 ||
+        ::listen(socket.fd(), 128) == -1) {
       throw CreateListenerException(
           fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
     }
 
-    evconnlistener_set_error_cb(listener_.get(), errorCallback);
+    file_event_ = dispatcher.createFileEvent(
+        socket.fd(), [this](uint32_t) -> void { onSocketReadable(); },
+        Event::FileTriggerType::Level, Event::FileReadyType::Read);
   }
 }
 
-void ListenerImpl::errorCallback(evconnlistener*, void*) {
-  // We should never get an error callback. This can happen if we run out of FDs or memory. In those
-  // cases just crash.
-  PANIC(fmt::format("listener accept failure: {}", strerror(errno)));
-}
-
 } // namespace Network
 } // namespace Envoy
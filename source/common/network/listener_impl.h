@@ -1,25 +1,41 @@
 #pragma once
 
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/file_event.h"
 #include "envoy/network/listener.h"
 
 #include "common/event/dispatcher_impl.h"
-#include "common/event/libevent.h"
 #include "common/network/listen_socket_impl.h"
 
-#include "event2/event.h"
-
 namespace Envoy {
 namespace Network {
 
 /**
- * libevent implementation of Network::Listener.
+ * libevent implementation of Network::Listener. Each time the listen socket becomes readable the
+ * listener accepts up to MAX_ACCEPTS_PER_WAKEUP connections before going back to the event loop,
+ * so that a burst of connections does not starve the other events of the dispatcher. Connections
+ * still queued in the backlog are accepted on the next wakeup.
  */
 class ListenerImpl : public Listener {
 public:
   ListenerImpl(Event::DispatcherImpl& dispatcher, ListenSocket& socket, ListenerCallbacks& cb,
-               bool bind_to_port, bool hand_off_restored_destination_connections);
+               bool bind_to_port, bool hand_off_restored_destination_connections,
+               MonotonicTimeSource& time_source);
+
+  static const uint32_t MAX_ACCEPTS_PER_WAKEUP;
 
 protected:
+  /**
+   * Get the local address of a socket accepted by a listener on the all hosts address (e.g.,
+   * 0.0.0.0 for IPv4). Sockets with the same local address share a cached address instance.
+   * @param fd supplies the accepted socket.
+   * @return Address::InstanceConstSharedPtr the local address.
+   */
   virtual Address::InstanceConstSharedPtr getLocalAddress(int fd);
 
   Address::InstanceConstSharedPtr local_address_;
@@ -27,11 +43,19 @@ protected:
   const bool hand_off_restored_destination_connections_;
 
 private:
-  static void errorCallback(evconnlistener* listener, void* context);
-  static void listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                             int remote_addr_len, void* arg);
-
-  Event::Libevent::ListenerPtr listener_;
+  struct CachedLocalAddress {
+    sockaddr_storage sockaddr_;
+    socklen_t len_;
+    Address::InstanceConstSharedPtr address_;
+  };
+
+  void onSocketReadable();
+  int acceptSocket(sockaddr_storage& remote_addr, socklen_t& remote_addr_len);
+
+  ListenSocket& socket_;
+  MonotonicTimeSource& time_source_;
+  Event::FileEventPtr file_event_;
+  std::vector<CachedLocalAddress> local_address_cache_;
 };
 
 } // namespace Network
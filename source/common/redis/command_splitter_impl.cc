@@ -1,6 +1,7 @@
 #include "common/redis/command_splitter_impl.h"
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -100,52 +101,88 @@ void FragmentedRequest::onChildFailure(uint32_t index) {
   onChildResponse(Utility::makeError("upstream failure"), index);
 }
 
+void BatchedKeysRequest::makeBatchedRequests(ConnPool::Instance& conn_pool,
+                                             const RespValue& incoming_request,
+                                             uint32_t args_per_key) {
+  const std::vector<RespValue>& args = incoming_request.asArray();
+
+  // Keys are batched by the server and the connection to it that they hash to, so that each key
+  // uses the same connection as a single key command for it would, and stays in order with it.
+  // Batches are ordered by their first key. Keys without a server are batched under nullptr and
+  // fail together.
+  std::map<std::pair<Upstream::HostConstSharedPtr, uint32_t>, uint32_t> batch_for_connection;
+  std::vector<std::pair<Upstream::HostConstSharedPtr, uint32_t>> batch_connections;
+  for (uint64_t i = 1; i < args.size(); i += args_per_key) {
+    Upstream::HostConstSharedPtr host = conn_pool.chooseHost(args[i].asString());
+    const uint32_t connection = host ? conn_pool.chooseConnection(args[i].asString()) : 0;
+    auto batch = batch_for_connection.emplace(std::make_pair(host, connection),
+                                              batch_connections.size());
+    if (batch.second) {
+      batch_connections.push_back(batch.first->first);
+      batch_key_indexes_.emplace_back();
+    }
+    batch_key_indexes_[batch.first->second].push_back((i - 1) / args_per_key);
+  }
+
+  // RespValue can't be copied, so each batch's arguments are sized up front and filled in.
+  std::vector<RespValue> batch_requests(batch_connections.size());
+  for (uint32_t i = 0; i < batch_requests.size(); i++) {
+    std::vector<RespValue> batch_args(1 + batch_key_indexes_[i].size() * args_per_key);
+    batch_args[0].type(RespType::BulkString);
+    batch_args[0].asString() = args[0].asString();
+    uint64_t batch_arg = 1;
+    for (uint32_t key_index : batch_key_indexes_[i]) {
+      for (uint64_t j = 0; j < args_per_key; j++) {
+        batch_args[batch_arg].type(RespType::BulkString);
+        batch_args[batch_arg++].asString() = args[1 + key_index * args_per_key + j].asString();
+      }
+    }
+    batch_requests[i].type(RespType::Array);
+    batch_requests[i].asArray().swap(batch_args);
+  }
+
+  num_pending_responses_ = batch_requests.size();
+  pending_requests_.reserve(num_pending_responses_);
+  for (uint32_t i = 0; i < batch_requests.size(); i++) {
+    pending_requests_.emplace_back(*this, i);
+    PendingRequest& pending_request = pending_requests_.back();
+
+    if (batch_connections[i].first) {
+      ENVOY_LOG(debug, "redis: parallel {}: '{}'", args[0].asString(),
+                batch_requests[i].toString());
+      pending_request.handle_ =
+          conn_pool.makeRequestToHost(batch_connections[i].first, batch_connections[i].second,
+                                      batch_requests[i], pending_request);
+    }
+    if (!pending_request.handle_) {
+      pending_request.onResponse(Utility::makeError("no upstream host"));
+    }
+  }
+}
+
 SplitRequestPtr MGETRequest::create(ConnPool::Instance& conn_pool,
                                     const RespValue& incoming_request, SplitCallbacks& callbacks) {
   std::unique_ptr<MGETRequest> request_ptr{new MGETRequest(callbacks)};
 
-  request_ptr->num_pending_responses_ = incoming_request.asArray().size() - 1;
-  request_ptr->pending_requests_.reserve(request_ptr->num_pending_responses_);
-
   request_ptr->pending_response_.reset(new RespValue());
   request_ptr->pending_response_->type(RespType::Array);
-  std::vector<RespValue> responses(request_ptr->num_pending_responses_);
+  std::vector<RespValue> responses(incoming_request.asArray().size() - 1);
   request_ptr->pending_response_->asArray().swap(responses);
 
-  std::vector<RespValue> values(2);
-  values[0].type(RespType::BulkString);
-  values[0].asString() = "get";
-  values[1].type(RespType::BulkString);
-  RespValue single_mget;
-  single_mget.type(RespType::Array);
-  single_mget.asArray().swap(values);
-
-  for (uint64_t i = 1; i < incoming_request.asArray().size(); i++) {
-    request_ptr->pending_requests_.emplace_back(*request_ptr, i - 1);
-    PendingRequest& pending_request = request_ptr->pending_requests_.back();
-
-    single_mget.asArray()[1].asString() = incoming_request.asArray()[i].asString();
-    ENVOY_LOG(debug, "redis: parallel get: '{}'", single_mget.toString());
-    pending_request.handle_ = conn_pool.makeRequest(incoming_request.asArray()[i].asString(),
-                                                    single_mget, pending_request);
-    if (!pending_request.handle_) {
-      pending_request.onResponse(Utility::makeError("no upstream host"));
-    }
-  }
+  request_ptr->makeBatchedRequests(conn_pool, incoming_request, 1);
 
   return request_ptr->num_pending_responses_ > 0 ? std::move(request_ptr) : nullptr;
 }
 
-void MGETRequest::onChildResponse(RespValuePtr&& value, uint32_t index) {
-  pending_requests_[index].handle_ = nullptr;
-
-  pending_response_->asArray()[index].type(value->type());
-  switch (value->type()) {
+void MGETRequest::onKeyResponse(RespValue& value, uint32_t key_index) {
+  RespValue& key_response = pending_response_->asArray()[key_index];
+  key_response.type(value.type());
+  switch (value.type()) {
   case RespType::Array:
   case RespType::Integer:
   case RespType::SimpleString: {
-    pending_response_->asArray()[index].type(RespType::Error);
-    pending_response_->asArray()[index].asString() = "upstream protocol error";
+    key_response.type(RespType::Error);
+    key_response.asString() = "upstream protocol error";
     error_count_++;
     break;
   }
@@ -154,12 +191,32 @@ void MGETRequest::onChildResponse(RespValuePtr&& value, uint32_t index) {
     FALLTHRU;
   }
   case RespType::BulkString: {
-    pending_response_->asArray()[index].asString().swap(value->asString());
+    key_response.asString().swap(value.asString());
     break;
   }
   case RespType::Null:
     break;
   }
+}
+
+void MGETRequest::onChildResponse(RespValuePtr&& value, uint32_t index) {
+  pending_requests_[index].handle_ = nullptr;
+
+  const std::vector<uint32_t>& key_indexes = batch_key_indexes_[index];
+  if (value->type() == RespType::Array && value->asArray().size() == key_indexes.size()) {
+    for (uint64_t i = 0; i < key_indexes.size(); i++) {
+      onKeyResponse(value->asArray()[i], key_indexes[i]);
+    }
+  } else {
+    // An error applies to every key of the batch. Anything else is not a valid MGET response.
+    for (uint32_t key_index : key_indexes) {
+      RespValue& key_response = pending_response_->asArray()[key_index];
+      key_response.type(RespType::Error);
+      key_response.asString() =
+          value->type() == RespType::Error ? value->asString() : "upstream protocol error";
+      error_count_++;
+    }
+  }
 
   ASSERT(num_pending_responses_ > 0);
   if (--num_pending_responses_ == 0) {
@@ -177,36 +234,10 @@ SplitRequestPtr MSETRequest::create(ConnPool::Instance& conn_pool,
 
   std::unique_ptr<MSETRequest> request_ptr{new MSETRequest(callbacks)};
 
-  request_ptr->num_pending_responses_ = (incoming_request.asArray().size() - 1) / 2;
-  request_ptr->pending_requests_.reserve(request_ptr->num_pending_responses_);
-
   request_ptr->pending_response_.reset(new RespValue());
   request_ptr->pending_response_->type(RespType::SimpleString);
 
-  std::vector<RespValue> values(3);
-  values[0].type(RespType::BulkString);
-  values[0].asString() = "set";
-  values[1].type(RespType::BulkString);
-  values[2].type(RespType::BulkString);
-  RespValue single_mset;
-  single_mset.type(RespType::Array);
-  single_mset.asArray().swap(values);
-
-  uint64_t fragment_index = 0;
-  for (uint64_t i = 1; i < incoming_request.asArray().size(); i += 2) {
-    request_ptr->pending_requests_.emplace_back(*request_ptr, fragment_index++);
-    PendingRequest& pending_request = request_ptr->pending_requests_.back();
-
-    single_mset.asArray()[1].asString() = incoming_request.asArray()[i].asString();
-    single_mset.asArray()[2].asString() = incoming_request.asArray()[i + 1].asString();
-
-    ENVOY_LOG(debug, "redis: parallel set: '{}'", single_mset.toString());
-    pending_request.handle_ = conn_pool.makeRequest(incoming_request.asArray()[i].asString(),
-                                                    single_mset, pending_request);
-    if (!pending_request.handle_) {
-      pending_request.onResponse(Utility::makeError("no upstream host"));
-    }
-  }
+  request_ptr->makeBatchedRequests(conn_pool, incoming_request, 2);
 
   return request_ptr->num_pending_responses_ > 0 ? std::move(request_ptr) : nullptr;
 }
@@ -222,7 +253,8 @@ void MSETRequest::onChildResponse(RespValuePtr&& value, uint32_t index) {
     FALLTHRU;
   }
   default: {
-    error_count_++;
+    // Errors are counted per key, as if each key had been set on its own.
+    error_count_ += batch_key_indexes_[index].size();
     break;
   }
   }
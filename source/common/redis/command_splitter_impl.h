@@ -124,16 +124,44 @@ protected:
 };
 
 /**
- * MGETRequest takes each key from the command and sends a GET for each to the appropriate Redis
- * server. The response contains the result from each command.
+ * BatchedKeysRequest is a base class for multi key commands that Redis can run on any subset of
+ * their keys. Keys that hash to the same server are sent to it together as one command with the
+ * same name as the incoming command, so that a command with N keys costs one upstream request per
+ * server rather than N.
  */
-class MGETRequest : public FragmentedRequest, Logger::Loggable<Logger::Id::redis> {
+class BatchedKeysRequest : public FragmentedRequest, protected Logger::Loggable<Logger::Id::redis> {
+protected:
+  BatchedKeysRequest(SplitCallbacks& callbacks) : FragmentedRequest(callbacks) {}
+
+  /**
+   * Groups the keys of the incoming request by server and makes one request per server. The index
+   * of each child request is the index of its batch in batch_key_indexes_.
+   * @param conn_pool supplies the connection pool to choose servers from and make requests to.
+   * @param incoming_request supplies the incoming command.
+   * @param args_per_key supplies the number of arguments that make up each key, including the key
+   *        itself. For example, MSET has a key and a value.
+   */
+  void makeBatchedRequests(ConnPool::Instance& conn_pool, const RespValue& incoming_request,
+                           uint32_t args_per_key);
+
+  // For each batch, the index of each of its keys among the keys of the incoming request.
+  std::vector<std::vector<uint32_t>> batch_key_indexes_;
+};
+
+/**
+ * MGETRequest groups the keys from the command by server and sends an MGET for each group to the
+ * appropriate Redis server. The response contains the result for each key in the order of the
+ * incoming command.
+ */
+class MGETRequest : public BatchedKeysRequest {
 public:
   static SplitRequestPtr create(ConnPool::Instance& conn_pool, const RespValue& incoming_request,
                                 SplitCallbacks& callbacks);
 
 private:
-  MGETRequest(SplitCallbacks& callbacks) : FragmentedRequest(callbacks) {}
+  MGETRequest(SplitCallbacks& callbacks) : BatchedKeysRequest(callbacks) {}
+
+  void onKeyResponse(RespValue& value, uint32_t key_index);
 
   // Redis::CommandSplitter::FragmentedRequest
   void onChildResponse(RespValuePtr&& value, uint32_t index) override;
@@ -160,17 +188,17 @@ private:
 };
 
 /**
- * MSETRequest takes each key and value pair from the command and sends a SET for each to the
- * appropriate Redis server. The response is an OK if all commands succeeded or an ERR if any
- * failed.
+ * MSETRequest groups the key and value pairs from the command by server and sends an MSET for each
+ * group to the appropriate Redis server. The response is an OK if all commands succeeded or an ERR
+ * if any failed.
  */
-class MSETRequest : public FragmentedRequest, Logger::Loggable<Logger::Id::redis> {
+class MSETRequest : public BatchedKeysRequest {
 public:
   static SplitRequestPtr create(ConnPool::Instance& conn_pool, const RespValue& incoming_request,
                                 SplitCallbacks& callbacks);
 
 private:
-  MSETRequest(SplitCallbacks& callbacks) : FragmentedRequest(callbacks) {}
+  MSETRequest(SplitCallbacks& callbacks) : BatchedKeysRequest(callbacks) {}
 
   // Redis::CommandSplitter::FragmentedRequest
   void onChildResponse(RespValuePtr&& value, uint32_t index) override;
@@ -1,5 +1,6 @@
 #include "common/redis/conn_pool_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -11,8 +12,17 @@ namespace Envoy {
 namespace Redis {
 namespace ConnPool {
 
-ConfigImpl::ConfigImpl(const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config)
-    : op_timeout_(PROTOBUF_GET_MS_REQUIRED(config, op_timeout)) {}
+constexpr uint64_t ConfigImpl::MaxConnectionsPerHost;
+
+ConfigImpl::ConfigImpl(const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config,
+                       Runtime::Loader& runtime)
+    : op_timeout_(PROTOBUF_GET_MS_REQUIRED(config, op_timeout)),
+      max_connections_per_host_(std::min<uint64_t>(
+          MaxConnectionsPerHost,
+          std::max<uint64_t>(
+              1, runtime.snapshot().getInteger("redis.max_connections_per_host", 1)))),
+      enable_command_batching_(
+          runtime.snapshot().getInteger("redis.enable_command_batching", 0) != 0) {}
 
 ClientPtr ClientImpl::create(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
                              EncoderPtr&& encoder, DecoderFactory& decoder_factory,
@@ -30,8 +40,8 @@ ClientPtr ClientImpl::create(Upstream::HostConstSharedPtr host, Event::Dispatche
 
 ClientImpl::ClientImpl(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
                        EncoderPtr&& encoder, DecoderFactory& decoder_factory, const Config& config)
-    : host_(host), encoder_(std::move(encoder)), decoder_(decoder_factory.create(*this)),
-      config_(config),
+    : host_(host), dispatcher_(dispatcher), encoder_(std::move(encoder)),
+      decoder_(decoder_factory.create(*this)), config_(config),
       connect_or_op_timer_(dispatcher.createTimer([this]() -> void { onConnectOrOpTimeout(); })) {
   host->cluster().stats().upstream_cx_total_.inc();
   host->cluster().stats().upstream_cx_active_.inc();
@@ -54,7 +64,19 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, PoolCallbacks& ca
 
   pending_requests_.emplace_back(*this, callbacks);
   encoder_->encode(request, encoder_buffer_);
-  connection_->write(encoder_buffer_);
+  if (config_.enableCommandBatching()) {
+    // Requests made while handling the same dispatcher events are written with a single write once
+    // those events are done. A zero timeout timer runs on the next loop iteration.
+    if (!flush_pending_) {
+      if (!flush_timer_) {
+        flush_timer_ = dispatcher_.createTimer([this]() -> void { flushEncoderBuffer(); });
+      }
+      flush_timer_->enableTimer(std::chrono::milliseconds(0));
+      flush_pending_ = true;
+    }
+  } else {
+    connection_->write(encoder_buffer_);
+  }
 
   // Only boost the op timeout if:
   // - We are not already connected. Otherwise, we are governed by the connect timeout and the timer
@@ -69,6 +91,13 @@ PoolRequest* ClientImpl::makeRequest(const RespValue& request, PoolCallbacks& ca
   return &pending_requests_.back();
 }
 
+void ClientImpl::flushEncoderBuffer() {
+  flush_pending_ = false;
+  if (encoder_buffer_.length() > 0) {
+    connection_->write(encoder_buffer_);
+  }
+}
+
 void ClientImpl::onConnectOrOpTimeout() {
   putOutlierEvent(Upstream::Outlier::Result::TIMEOUT);
   if (connected_) {
@@ -121,6 +150,11 @@ void ClientImpl::onEvent(Network::ConnectionEvent event) {
     }
 
     connect_or_op_timer_->disableTimer();
+    if (flush_pending_) {
+      flush_timer_->disableTimer();
+      flush_pending_ = false;
+    }
+    encoder_buffer_.drain(encoder_buffer_.length());
   } else if (event == Network::ConnectionEvent::Connected) {
     connected_ = true;
     ASSERT(!pending_requests_.empty());
@@ -185,8 +219,10 @@ ClientPtr ClientFactoryImpl::create(Upstream::HostConstSharedPtr host,
 InstanceImpl::InstanceImpl(
     const std::string& cluster_name, Upstream::ClusterManager& cm, ClientFactory& client_factory,
     ThreadLocal::SlotAllocator& tls,
-    const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config)
-    : cm_(cm), client_factory_(client_factory), tls_(tls.allocateSlot()), config_(config) {
+    const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config,
+    Runtime::Loader& runtime)
+    : cm_(cm), client_factory_(client_factory), tls_(tls.allocateSlot()),
+      config_(config, runtime) {
   tls_->set([this, cluster_name](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<ThreadLocalPool>(*this, dispatcher, cluster_name);
@@ -198,6 +234,21 @@ PoolRequest* InstanceImpl::makeRequest(const std::string& hash_key, const RespVa
   return tls_->getTyped<ThreadLocalPool>().makeRequest(hash_key, value, callbacks);
 }
 
+Upstream::HostConstSharedPtr InstanceImpl::chooseHost(const std::string& hash_key) {
+  return tls_->getTyped<ThreadLocalPool>().chooseHost(hash_key);
+}
+
+uint32_t InstanceImpl::chooseConnection(const std::string& hash_key) {
+  const uint32_t max_connections = config_.maxConnectionsPerHost();
+  return max_connections == 1 ? 0 : std::hash<std::string>()(hash_key) % max_connections;
+}
+
+PoolRequest* InstanceImpl::makeRequestToHost(const Upstream::HostConstSharedPtr& host,
+                                             uint32_t connection, const RespValue& value,
+                                             PoolCallbacks& callbacks) {
+  return tls_->getTyped<ThreadLocalPool>().makeRequestToHost(host, connection, value, callbacks);
+}
+
 InstanceImpl::ThreadLocalPool::ThreadLocalPool(InstanceImpl& parent, Event::Dispatcher& dispatcher,
                                                const std::string& cluster_name)
     : parent_(parent), dispatcher_(dispatcher), cluster_(parent_.cm_.get(cluster_name)) {
@@ -216,34 +267,64 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(InstanceImpl& parent, Event::Disp
 InstanceImpl::ThreadLocalPool::~ThreadLocalPool() {
   local_host_set_member_update_cb_handle_->remove();
   while (!client_map_.empty()) {
-    client_map_.begin()->second->redis_client_->close();
+    closeHostClients(client_map_.begin()->first);
   }
 }
 
 void InstanceImpl::ThreadLocalPool::onHostsRemoved(
     const std::vector<Upstream::HostSharedPtr>& hosts_removed) {
   for (const auto& host : hosts_removed) {
-    auto it = client_map_.find(host);
-    if (it != client_map_.end()) {
-      // We don't currently support any type of draining for redis connections. If a host is gone,
-      // we just close the connection. This will fail any pending requests.
-      it->second->redis_client_->close();
+    // We don't currently support any type of draining for redis connections. If a host is gone,
+    // we just close the connections. This will fail any pending requests.
+    closeHostClients(host);
+  }
+}
+
+void InstanceImpl::ThreadLocalPool::closeHostClients(Upstream::HostConstSharedPtr host) {
+  // Closing a client removes it from client_map_, and removes the host once it has no clients
+  // left. Look the host up again after each close.
+  auto it = client_map_.find(host);
+  while (it != client_map_.end()) {
+    for (const ThreadLocalActiveClientPtr& client : it->second) {
+      if (client) {
+        client->redis_client_->close();
+        break;
+      }
     }
+    it = client_map_.find(host);
   }
 }
 
 PoolRequest* InstanceImpl::ThreadLocalPool::makeRequest(const std::string& hash_key,
                                                         const RespValue& request,
                                                         PoolCallbacks& callbacks) {
-  LbContextImpl lb_context(hash_key);
-  Upstream::HostConstSharedPtr host = cluster_->loadBalancer().chooseHost(&lb_context);
+  Upstream::HostConstSharedPtr host = chooseHost(hash_key);
   if (!host) {
     return nullptr;
   }
 
-  ThreadLocalActiveClientPtr& client = client_map_[host];
+  return makeRequestToHost(host, parent_.chooseConnection(hash_key), request, callbacks);
+}
+
+Upstream::HostConstSharedPtr
+InstanceImpl::ThreadLocalPool::chooseHost(const std::string& hash_key) {
+  LbContextImpl lb_context(hash_key);
+  return cluster_->loadBalancer().chooseHost(&lb_context);
+}
+
+PoolRequest*
+InstanceImpl::ThreadLocalPool::makeRequestToHost(const Upstream::HostConstSharedPtr& host,
+                                                 uint32_t connection, const RespValue& request,
+                                                 PoolCallbacks& callbacks) {
+  std::vector<ThreadLocalActiveClientPtr>& clients = client_map_[host];
+  if (clients.empty()) {
+    clients.resize(parent_.config_.maxConnectionsPerHost());
+  }
+
+  ASSERT(connection < clients.size());
+  ThreadLocalActiveClientPtr& client = clients[connection];
   if (!client) {
-    client.reset(new ThreadLocalActiveClient(*this));
+    client.reset(new ThreadLocalActiveClient(*this, connection));
     client->host_ = host;
     client->redis_client_ = parent_.client_factory_.create(host, dispatcher_, parent_.config_);
     client->redis_client_->addConnectionCallbacks(*client);
@@ -255,10 +336,18 @@ PoolRequest* InstanceImpl::ThreadLocalPool::makeRequest(const std::string& hash_
 void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
-    auto client_to_delete = parent_.client_map_.find(host_);
-    ASSERT(client_to_delete != parent_.client_map_.end());
-    parent_.dispatcher_.deferredDelete(std::move(client_to_delete->second->redis_client_));
-    parent_.client_map_.erase(client_to_delete);
+    ThreadLocalPool& parent = parent_;
+    auto host_clients = parent.client_map_.find(host_);
+    ASSERT(host_clients != parent.client_map_.end());
+    std::vector<ThreadLocalActiveClientPtr>& clients = host_clients->second;
+    ASSERT(clients[index_].get() == this);
+    parent.dispatcher_.deferredDelete(std::move(redis_client_));
+    // This destroys the active client, so no members can be used after it.
+    clients[index_].reset();
+    if (std::all_of(clients.begin(), clients.end(),
+                    [](const ThreadLocalActiveClientPtr& client) { return !client; })) {
+      parent.client_map_.erase(host_clients);
+    }
   }
 }
 
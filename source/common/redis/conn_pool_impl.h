@@ -10,6 +10,7 @@
 
 #include "envoy/api/v2/filter/network/redis_proxy.pb.h"
 #include "envoy/redis/conn_pool.h"
+#include "envoy/runtime/runtime.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
@@ -27,13 +28,24 @@ namespace ConnPool {
 
 class ConfigImpl : public Config {
 public:
-  ConfigImpl(const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config);
+  ConfigImpl(const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config,
+             Runtime::Loader& runtime);
 
   bool disableOutlierEvents() const override { return false; }
   std::chrono::milliseconds opTimeout() const override { return op_timeout_; }
+  uint32_t maxConnectionsPerHost() const override { return max_connections_per_host_; }
+  bool enableCommandBatching() const override { return enable_command_batching_; }
+
+  // Upper bound on redis.max_connections_per_host. Each worker opens its own connections to each
+  // host, so larger values could exhaust upstream connection limits.
+  static constexpr uint64_t MaxConnectionsPerHost = 64;
 
 private:
   const std::chrono::milliseconds op_timeout_;
+  // Read from runtime when the pool is created. Changing them for a running pool would move keys
+  // to other connections while requests for them are in flight.
+  const uint32_t max_connections_per_host_;
+  const bool enable_command_batching_;
 };
 
 class ClientImpl : public Client, public DecoderCallbacks, public Network::ConnectionCallbacks {
@@ -80,6 +92,7 @@ private:
              DecoderFactory& decoder_factory, const Config& config);
   void onConnectOrOpTimeout();
   void onData(Buffer::Instance& data);
+  void flushEncoderBuffer();
   void putOutlierEvent(Upstream::Outlier::Result result);
 
   // Redis::DecoderCallbacks
@@ -91,6 +104,7 @@ private:
   void onBelowWriteBufferLowWatermark() override {}
 
   Upstream::HostConstSharedPtr host_;
+  Event::Dispatcher& dispatcher_;
   Network::ClientConnectionPtr connection_;
   EncoderPtr encoder_;
   Buffer::OwnedImpl encoder_buffer_;
@@ -98,6 +112,9 @@ private:
   const Config& config_;
   std::list<PendingRequest> pending_requests_;
   Event::TimerPtr connect_or_op_timer_;
+  // Created on the first request made with command batching enabled.
+  Event::TimerPtr flush_timer_;
+  bool flush_pending_{};
   bool connected_{};
 };
 
@@ -117,17 +134,23 @@ class InstanceImpl : public Instance {
 public:
   InstanceImpl(const std::string& cluster_name, Upstream::ClusterManager& cm,
                ClientFactory& client_factory, ThreadLocal::SlotAllocator& tls,
-               const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config);
+               const envoy::api::v2::filter::network::RedisProxy::ConnPoolSettings& config,
+               Runtime::Loader& runtime);
 
   // Redis::ConnPool::Instance
   PoolRequest* makeRequest(const std::string& hash_key, const RespValue& request,
                            PoolCallbacks& callbacks) override;
+  Upstream::HostConstSharedPtr chooseHost(const std::string& hash_key) override;
+  uint32_t chooseConnection(const std::string& hash_key) override;
+  PoolRequest* makeRequestToHost(const Upstream::HostConstSharedPtr& host, uint32_t connection,
+                                 const RespValue& request, PoolCallbacks& callbacks) override;
 
 private:
   struct ThreadLocalPool;
 
   struct ThreadLocalActiveClient : public Network::ConnectionCallbacks {
-    ThreadLocalActiveClient(ThreadLocalPool& parent) : parent_(parent) {}
+    ThreadLocalActiveClient(ThreadLocalPool& parent, uint32_t index)
+        : parent_(parent), index_(index) {}
 
     // Network::ConnectionCallbacks
     void onEvent(Network::ConnectionEvent event) override;
@@ -136,6 +159,8 @@ private:
 
     ThreadLocalPool& parent_;
     Upstream::HostConstSharedPtr host_;
+    // The index of the client among the clients of its host.
+    const uint32_t index_;
     ClientPtr redis_client_;
   };
 
@@ -147,12 +172,19 @@ private:
     ~ThreadLocalPool();
     PoolRequest* makeRequest(const std::string& hash_key, const RespValue& request,
                              PoolCallbacks& callbacks);
+    Upstream::HostConstSharedPtr chooseHost(const std::string& hash_key);
+    PoolRequest* makeRequestToHost(const Upstream::HostConstSharedPtr& host, uint32_t connection,
+                                   const RespValue& request, PoolCallbacks& callbacks);
     void onHostsRemoved(const std::vector<Upstream::HostSharedPtr>& hosts_removed);
+    void closeHostClients(Upstream::HostConstSharedPtr host);
 
     InstanceImpl& parent_;
     Event::Dispatcher& dispatcher_;
     Upstream::ThreadLocalCluster* cluster_;
-    std::unordered_map<Upstream::HostConstSharedPtr, ThreadLocalActiveClientPtr> client_map_;
+    // The clients of each host, indexed by connection. Closed connections leave an empty slot, and
+    // a host is removed once all of its slots are empty.
+    std::unordered_map<Upstream::HostConstSharedPtr, std::vector<ThreadLocalActiveClientPtr>>
+        client_map_;
     Common::CallbackHandle* local_host_set_member_update_cb_handle_;
   };
 
@@ -5,7 +5,6 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -592,7 +591,7 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Runtime::Loader& loader)
     : RouteEntryImplBase(vhost, route, loader),
-      regex_(RegexUtil::parseRegex(route.match().regex().c_str())) {}
+      regex_(Regex::Utility::parseRegex(route.match().regex())) {}
 
 void RegexRouteEntryImpl::finalizeRequestHeaders(
     Http::HeaderMap& headers, const RequestInfo::RequestInfo& request_info) const {
@@ -600,7 +599,7 @@ void RegexRouteEntryImpl::finalizeRequestHeaders(
 
   const Http::HeaderString& path = headers.Path()->value();
   const char* query_string_start = Http::Utility::findQueryStringStart(path);
-  ASSERT(std::regex_match(path.c_str(), query_string_start, regex_));
+  ASSERT(regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str())));
   std::string matched_path(path.c_str(), query_string_start);
   finalizePathHeader(headers, matched_path);
 }
@@ -610,7 +609,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const char* query_string_start = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.c_str(), query_string_start, regex_)) {
+    if (regex_->match(absl::string_view(path.c_str(), query_string_start - path.c_str()))) {
       return clusterEntry(headers, random_value);
     }
   }
@@ -646,14 +645,19 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, runtime));
+      route_index_.addPrefix(route.match().prefix(), case_sensitive);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, runtime));
+      route_index_.addPath(route.match().path(), case_sensitive);
     } else {
       ASSERT(has_regex);
       UNREFERENCED_PARAMETER(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, runtime));
+      route_index_.addRegex(route.match().regex());
     }
 
     if (validate_clusters) {
@@ -667,6 +671,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     }
   }
 
+  route_index_.compileRegexes();
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster));
   }
@@ -682,8 +688,7 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     method_ = envoy::api::v2::RequestMethod_Name(virtual_cluster.method());
   }
 
-  const std::string pattern = virtual_cluster.pattern();
-  pattern_ = RegexUtil::parseRegex(pattern);
+  pattern_ = Regex::Utility::parseRegex(virtual_cluster.pattern());
   name_ = virtual_cluster.name();
 }
 
@@ -744,9 +749,23 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+  // Check for a route that matches the request. For small route tables, checking every route is
+  // cheaper than looking up the index.
+  if (routes_.size() < MIN_ROUTES_FOR_INDEX) {
+    for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
+      RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+      if (nullptr != route_entry) {
+        return route_entry;
+      }
+    }
+    return nullptr;
+  }
+
+  const Http::HeaderString& path = headers.Path()->value();
+  std::vector<uint32_t> candidates;
+  route_index_.findCandidates(absl::string_view(path.c_str(), path.size()), candidates);
+  for (uint32_t candidate : candidates) {
+    RouteConstSharedPtr route_entry = routes_[candidate]->matches(headers, random_value);
     if (nullptr != route_entry) {
       return route_entry;
     }
@@ -798,7 +817,8 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
     bool method_matches =
         !entry.method_.valid() || headers.Method()->value().c_str() == entry.method_.value();
 
-    if (method_matches && std::regex_match(headers.Path()->value().c_str(), entry.pattern_)) {
+    const Http::HeaderString& path = headers.Path()->value();
+    if (method_matches && entry.pattern_->match(absl::string_view(path.c_str(), path.size()))) {
       return &entry;
     }
   }
@@ -5,7 +5,6 @@
 #include <list>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -20,6 +19,7 @@
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
+#include "common/router/route_index.h"
 #include "common/router/router_ratelimit.h"
 
 namespace Envoy {
@@ -126,7 +126,7 @@ private:
     // Router::VirtualCluster
     const std::string& name() const override { return name_; }
 
-    std::regex pattern_;
+    Regex::CompiledMatcherPtr pattern_;
     Optional<std::string> method_;
     std::string name_;
   };
@@ -140,9 +140,12 @@ private:
 
   static const CatchAllVirtualCluster VIRTUAL_CLUSTER_CATCH_ALL;
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
+  // The number of routes from which route_index_ is used to find the matching route.
+  static const size_t MIN_ROUTES_FOR_INDEX = 8;
 
   const std::string name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  RouteIndex route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -554,7 +557,7 @@ public:
   RouteConstSharedPtr matches(const Http::HeaderMap& headers, uint64_t random_value) const override;
 
 private:
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
 };
 
 /**
@@ -1,6 +1,5 @@
 #include "common/router/config_utility.h"
 
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -16,7 +15,7 @@ bool ConfigUtility::QueryParameterMatcher::matches(
   if (query_param == request_query_params.end()) {
     return false;
   } else if (is_regex_) {
-    return std::regex_match(query_param->second, regex_pattern_);
+    return regex_pattern_->match(query_param->second);
   } else if (value_.length() == 0) {
     return true;
   } else {
@@ -49,7 +48,8 @@ bool ConfigUtility::matchHeaders(const Http::HeaderMap& request_headers,
         matches &= (header != nullptr) && (header->value() == cfg_header_data.value_.c_str());
       } else {
         matches &= (header != nullptr) &&
-                   std::regex_match(header->value().c_str(), cfg_header_data.regex_pattern_);
+                   cfg_header_data.regex_pattern_->match(
+                       absl::string_view(header->value().c_str(), header->value().size()));
       }
       if (!matches) {
         break;
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -11,6 +10,7 @@
 #include "envoy/upstream/resource_manager.h"
 
 #include "common/common/empty_string.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/rds_json.h"
 #include "common/http/headers.h"
@@ -32,7 +32,7 @@ public:
     HeaderData(const envoy::api::v2::route::HeaderMatcher& config)
         : name_(config.name()), value_(config.value()),
           is_regex_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, regex, false)),
-          regex_pattern_(is_regex_ ? RegexUtil::parseRegex(value_) : std::regex()) {}
+          regex_pattern_(is_regex_ ? Regex::Utility::parseRegex(value_) : nullptr) {}
     HeaderData(const Json::Object& config)
         : HeaderData([&config] {
             envoy::api::v2::route::HeaderMatcher header_matcher;
@@ -43,7 +43,7 @@ public:
     const Http::LowerCaseString name_;
     const std::string value_;
     const bool is_regex_;
-    const std::regex regex_pattern_;
+    Regex::CompiledMatcherPtr regex_pattern_;
   };
 
   // A QueryParameterMatcher specifies one "name" or "name=value" element
@@ -54,7 +54,7 @@ public:
     QueryParameterMatcher(const envoy::api::v2::route::QueryParameterMatcher& config)
         : name_(config.name()), value_(config.value()),
           is_regex_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, regex, false)),
-          regex_pattern_(is_regex_ ? RegexUtil::parseRegex(value_) : std::regex()) {}
+          regex_pattern_(is_regex_ ? Regex::Utility::parseRegex(value_) : nullptr) {}
 
     /**
      * Check if the query parameters for a request contain a match for this
@@ -68,7 +68,7 @@ public:
     const std::string name_;
     const std::string value_;
     const bool is_regex_;
-    const std::regex regex_pattern_;
+    Regex::CompiledMatcherPtr regex_pattern_;
   };
 
   /**
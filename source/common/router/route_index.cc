@@ -0,0 +1,133 @@
+#include "common/router/route_index.h"
+
+#include <algorithm>
+
+#include "common/common/regex.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+RouteIndex::RouteIndex()
+    : case_sensitive_root_(new Node(absl::string_view())),
+      case_insensitive_root_(new Node(absl::string_view())) {}
+
+RouteIndex::~RouteIndex() {}
+
+void RouteIndex::addPrefix(const std::string& prefix, bool case_sensitive) {
+  insert(prefix, case_sensitive).prefix_routes_.push_back(size_++);
+}
+
+void RouteIndex::addPath(const std::string& path, bool case_sensitive) {
+  insert(path, case_sensitive).path_routes_.push_back(size_++);
+}
+
+void RouteIndex::addRegex(const std::string& regex) {
+  regexes_.push_back(regex);
+  regex_routes_.push_back(size_++);
+}
+
+void RouteIndex::compileRegexes() {
+  if (!regexes_.empty()) {
+    regex_set_ = Regex::Utility::parseRegexSet(regexes_);
+  }
+}
+
+void RouteIndex::findCandidates(absl::string_view path, std::vector<uint32_t>& candidates) const {
+  candidates.clear();
+
+  // Exact paths and regexes are compared with the path up to the query string.
+  const size_t path_end = std::min(path.find('?'), path.size());
+  if (regex_set_) {
+    regex_set_->match(path.substr(0, path_end), candidates);
+    for (uint32_t& candidate : candidates) {
+      candidate = regex_routes_[candidate];
+    }
+  }
+
+  find(*case_sensitive_root_, path, path_end, true, candidates);
+  if (has_case_insensitive_routes_) {
+    find(*case_insensitive_root_, path, path_end, false, candidates);
+  }
+
+  // Each trie node keeps its routes in order, but routes from different nodes interleave.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+RouteIndex::Node& RouteIndex::insert(const std::string& key, bool case_sensitive) {
+  if (case_sensitive) {
+    return insert(*case_sensitive_root_, key);
+  }
+  // Case insensitive keys are stored, and looked up, in lower case.
+  has_case_insensitive_routes_ = true;
+  return insert(*case_insensitive_root_, absl::AsciiStrToLower(key));
+}
+
+RouteIndex::Node& RouteIndex::insert(Node& root, absl::string_view key) {
+  Node* node = &root;
+  while (!key.empty()) {
+    auto child = std::lower_bound(
+        node->children_.begin(), node->children_.end(), key[0],
+        [](const NodePtr& lhs, char c) -> bool { return lhs->label_[0] < c; });
+    if (child == node->children_.end() || (*child)->label_[0] != key[0]) {
+      child = node->children_.emplace(child, new Node(key));
+      return **child;
+    }
+
+    // Find how much of the child's label the key shares, and split the child if it is not all of
+    // it, so that the key ends on a node.
+    const absl::string_view label = (*child)->label_;
+    const size_t common = std::mismatch(label.begin(), label.end(), key.begin(), key.end()).first -
+                          label.begin();
+    if (common < label.size()) {
+      NodePtr split(new Node(label.substr(0, common)));
+      (*child)->label_.erase(0, common);
+      split->children_.push_back(std::move(*child));
+      *child = std::move(split);
+    }
+    node = child->get();
+    key.remove_prefix(common);
+  }
+  return *node;
+}
+
+void RouteIndex::find(const Node& root, absl::string_view path, size_t path_end,
+                      bool case_sensitive, std::vector<uint32_t>& candidates) {
+  // Case insensitive labels are stored in lower case, so the path is lowered as it is compared.
+  const auto path_char = [path, case_sensitive](size_t i) -> char {
+    return case_sensitive ? path[i] : absl::ascii_tolower(path[i]);
+  };
+  const Node* node = &root;
+  size_t position = 0;
+  while (true) {
+    candidates.insert(candidates.end(), node->prefix_routes_.begin(), node->prefix_routes_.end());
+    if (position == path_end) {
+      candidates.insert(candidates.end(), node->path_routes_.begin(), node->path_routes_.end());
+    }
+    if (position == path.size()) {
+      return;
+    }
+
+    auto child = std::lower_bound(
+        node->children_.begin(), node->children_.end(), path_char(position),
+        [](const NodePtr& lhs, char c) -> bool { return lhs->label_[0] < c; });
+    if (child == node->children_.end()) {
+      return;
+    }
+    const std::string& label = (*child)->label_;
+    if (path.size() - position < label.size()) {
+      return;
+    }
+    for (size_t i = 0; i < label.size(); i++) {
+      if (path_char(position + i) != label[i]) {
+        return;
+      }
+    }
+    node = child->get();
+    position += node->label_.size();
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index over the path matches of a virtual host's routes, used to narrow down the routes that
+ * need to be checked for a request. Routes are added in order and are identified by their position,
+ * starting at zero. Prefix and exact path matches are stored in compressed prefix tries, one for
+ * case sensitive and one for case insensitive matches, so that a lookup only visits the trie nodes
+ * along the request path. Regex matches are compiled into a single set, so that all of them are
+ * checked in one pass over the path.
+ *
+ * The index only looks at the path. Candidates must still be checked with their full match
+ * criteria, in order, to preserve first match semantics.
+ */
+class RouteIndex {
+public:
+  RouteIndex();
+  ~RouteIndex();
+
+  /**
+   * Add a route that matches paths starting with a prefix.
+   * @param prefix supplies the prefix.
+   * @param case_sensitive supplies whether the prefix is compared case sensitively.
+   */
+  void addPrefix(const std::string& prefix, bool case_sensitive);
+
+  /**
+   * Add a route that matches a path, excluding any query string, exactly.
+   * @param path supplies the path.
+   * @param case_sensitive supplies whether the path is compared case sensitively.
+   */
+  void addPath(const std::string& path, bool case_sensitive);
+
+  /**
+   * Add a route that matches a path, excluding any query string, against a regex.
+   * @param regex supplies the regex.
+   */
+  void addRegex(const std::string& regex);
+
+  /**
+   * Compile the regexes of the routes added so far. Must be called after the last route is added
+   * and before looking up candidates.
+   * @throw EnvoyException if a regex is invalid.
+   */
+  void compileRegexes();
+
+  /**
+   * Find the routes that can match a path.
+   * @param path supplies the request path, including any query string.
+   * @param candidates supplies the vector to fill with the positions of the routes that can match
+   *        the path, in ascending order. It is cleared first.
+   */
+  void findCandidates(absl::string_view path, std::vector<uint32_t>& candidates) const;
+
+  /**
+   * @return uint32_t the number of routes added to the index.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  struct Node;
+  typedef std::unique_ptr<Node> NodePtr;
+
+  struct Node {
+    Node(absl::string_view label) : label_(label) {}
+
+    // The part of the key between the parent node and this one.
+    std::string label_;
+    // Children sorted by the first character of their label, which is unique among siblings.
+    std::vector<NodePtr> children_;
+    // Routes whose prefix ends at this node.
+    std::vector<uint32_t> prefix_routes_;
+    // Routes whose exact path ends at this node.
+    std::vector<uint32_t> path_routes_;
+  };
+
+  Node& insert(const std::string& key, bool case_sensitive);
+  static Node& insert(Node& root, absl::string_view key);
+  static void find(const Node& root, absl::string_view path, size_t path_end, bool case_sensitive,
+                   std::vector<uint32_t>& candidates);
+
+  NodePtr case_sensitive_root_;
+  NodePtr case_insensitive_root_;
+  bool has_case_insensitive_routes_{};
+  std::vector<std::string> regexes_;
+  // The position of the route for each regex in regexes_.
+  std::vector<uint32_t> regex_routes_;
+  Regex::CompiledMatcherSetPtr regex_set_;
+  uint32_t size_{};
+};
+
+} // namespace Router
+} // namespace Envoy
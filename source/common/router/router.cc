@@ -140,7 +140,8 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
                                                                : EMPTY_STRING,
                                              zone_name,
                                              upstream_zone,
-                                             is_canary};
+                                             is_canary,
+                                             &cluster_->codeStats()};
 
     Http::CodeUtility::chargeResponseStat(info);
 
@@ -149,7 +150,8 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
                                                alt_stat_prefix_, response_status_code,
                                                internal_request, EMPTY_STRING,
                                                EMPTY_STRING,     zone_name,
-                                               upstream_zone,    is_canary};
+                                               upstream_zone,    is_canary,
+                                               nullptr};
 
       Http::CodeUtility::chargeResponseStat(info);
     }
@@ -594,8 +596,7 @@ void Filter::onUpstreamHeaders(const uint64_t response_code, Http::HeaderMapPtr&
     // upstream_request_.
     const auto upstream_host = upstream_request_->upstream_host_;
     if (retry_status == RetryStatus::Yes && setupRetry(end_stream)) {
-      Http::CodeUtility::chargeBasicResponseStat(cluster_->statsScope(), "retry.",
-                                                 static_cast<Http::Code>(response_code));
+      cluster_->codeStats().chargeResponseCode(Http::CodeStats::Prefix::Retry, response_code);
       upstream_host->stats().rq_error_.inc();
       return;
     } else if (retry_status == RetryStatus::NoOverflow) {
@@ -699,7 +700,8 @@ void Filter::onUpstreamComplete() {
                                                request_vcluster_ ? request_vcluster_->name()
                                                                  : EMPTY_STRING,
                                                zone_name,
-                                               upstreamZone(upstream_request_->upstream_host_)};
+                                               upstreamZone(upstream_request_->upstream_host_),
+                                               &cluster_->codeStats()};
 
     Http::CodeUtility::chargeResponseTiming(info);
 
@@ -713,7 +715,8 @@ void Filter::onUpstreamComplete() {
                                                  EMPTY_STRING,
                                                  EMPTY_STRING,
                                                  zone_name,
-                                                 upstreamZone(upstream_request_->upstream_host_)};
+                                                 upstreamZone(upstream_request_->upstream_host_),
+                                                 nullptr};
 
       Http::CodeUtility::chargeResponseTiming(info);
     }
@@ -31,7 +31,9 @@ namespace Ssl {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  HISTOGRAM(write_record_size)                                                                     \
+  HISTOGRAM(records_per_write)
 // clang-format on
 
 /**
@@ -1,5 +1,7 @@
 #include "common/ssl/ssl_socket.h"
 
+#include <algorithm>
+
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
@@ -14,6 +16,9 @@ using Envoy::Network::PostIoAction;
 namespace Envoy {
 namespace Ssl {
 
+const uint64_t SslSocket::SMALL_RECORD_SIZE;
+const uint64_t SslSocket::MAX_RECORD_SIZE;
+
 SslSocket::SslSocket(Context& ctx, InitialState state)
     : ctx_(dynamic_cast<Ssl::ContextImpl&>(ctx)), ssl_(ctx_.newSsl()) {
   SSL_set_mode(ssl_.get(), SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
@@ -146,59 +151,72 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer) {
     }
   }
 
-  uint64_t original_buffer_length = write_buffer.length();
+  // Small slices are coalesced into a single SSL_write() so that each TLS record, and the header
+  // and MAC that come with it, carries as much data as the current record size allows.
+  uint8_t record[MAX_RECORD_SIZE];
+  const uint64_t original_buffer_length = write_buffer.length();
   uint64_t total_bytes_written = 0;
-  bool keep_writing = true;
-  while ((original_buffer_length != total_bytes_written) && keep_writing) {
-    // Protect against stack overflow if the buffer has a very large buffer chain.
-    // TODO(mattklein123): See the comment on getRawSlices() for why we have to also check
-    // original_buffer_length != total_bytes_written during loop iteration.
+  uint64_t records = 0;
+  while (original_buffer_length != total_bytes_written) {
     // TODO(mattklein123): As it relates to our fairness efforts, we might want to limit the number
     // of iterations of this loop, either by pure iterations, bytes written, etc.
-    const uint64_t MAX_SLICES = 32;
-    Buffer::RawSlice slices[MAX_SLICES];
-    uint64_t num_slices = write_buffer.getRawSlices(slices, MAX_SLICES);
-
-    uint64_t inner_bytes_written = 0;
-    for (uint64_t i = 0; (i < num_slices) && (original_buffer_length != total_bytes_written); i++) {
-      // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
-      // it again with the same parameters. Most implementations keep track of the last write size.
-      // In our case we don't need to do that because: a) SSL_write() will not write partial
-      // buffers. b) We only move() into the write buffer, which means that it's impossible for a
-      // particular chain to increase in size. So as long as we start writing where we left off we
-      // are guaranteed to call SSL_write() with the same parameters.
-      int rc = SSL_write(ssl_.get(), slices[i].mem_, slices[i].len_);
-      ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
-      if (rc > 0) {
-        inner_bytes_written += rc;
-        total_bytes_written += rc;
-      } else {
-        int err = SSL_get_error(ssl_.get(), rc);
-        switch (err) {
-        case SSL_ERROR_WANT_WRITE:
-          keep_writing = false;
-          break;
-        case SSL_ERROR_WANT_READ:
-        // Renegotiation has started. We don't handle renegotiation so just fall through.
-        default:
-          drainErrorQueue();
-          return {PostIoAction::Close, total_bytes_written};
-        }
+    // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
+    // it again with the same parameters. SSL_write() will not write partial buffers and nothing
+    // is drained until it succeeds, so the same bytes are still at the front of the buffer and
+    // only the length needs to be remembered. SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER allows the
+    // bytes to be passed from a different address.
+    uint64_t write_size = pending_write_size_;
+    if (write_size == 0) {
+      write_size = std::min(original_buffer_length - total_bytes_written, recordSize());
+    }
+    ASSERT(write_size <= write_buffer.length());
+
+    Buffer::RawSlice slice;
+    write_buffer.getRawSlices(&slice, 1);
+    const void* data = slice.mem_;
+    if (slice.len_ < write_size) {
+      write_buffer.copyOut(0, write_size, record);
+      data = record;
+    }
 
+    int rc = SSL_write(ssl_.get(), data, write_size);
+    ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
+    if (rc <= 0) {
+      int err = SSL_get_error(ssl_.get(), rc);
+      switch (err) {
+      case SSL_ERROR_WANT_WRITE:
+        pending_write_size_ = write_size;
         break;
+      case SSL_ERROR_WANT_READ:
+      // Renegotiation has started. We don't handle renegotiation so just fall through.
+      default:
+        drainErrorQueue();
+        return {PostIoAction::Close, total_bytes_written};
       }
-    }
 
-    // Draining must be done within the inner loop, otherwise we will keep getting the same slices
-    // at the beginning of the buffer.
-    if (inner_bytes_written > 0) {
-      write_buffer.drain(inner_bytes_written);
+      break;
     }
+
+    ASSERT(static_cast<uint64_t>(rc) == write_size);
+    pending_write_size_ = 0;
+    write_buffer.drain(rc);
+    total_bytes_written += rc;
+    records++;
+    records_written_++;
+  }
+
+  if (records > 0) {
+    ctx_.stats().records_per_write_.recordValue(records);
+    ctx_.stats().write_record_size_.recordValue(total_bytes_written / records);
   }
 
   return {PostIoAction::KeepOpen, total_bytes_written};
 }
 
+uint64_t SslSocket::recordSize() const {
+  return std::min(MAX_RECORD_SIZE, SMALL_RECORD_SIZE * (records_written_ + 1));
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 bool SslSocket::peerCertificatePresented() const {
@@ -48,11 +48,22 @@ private:
   void drainErrorQueue();
   std::string getUriSanFromCertificate(X509* cert);
   std::string getSubjectFromCertificate(X509* cert) const;
+  uint64_t recordSize() const;
+
+  // Records start out small enough to fit in a single TCP segment, so that the peer can decrypt
+  // the first bytes of a response as soon as they arrive, and grow by SMALL_RECORD_SIZE with each
+  // record written until they reach the TLS maximum.
+  static const uint64_t SMALL_RECORD_SIZE = 1400;
+  static const uint64_t MAX_RECORD_SIZE = 16384;
 
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImpl& ctx_;
   bssl::UniquePtr<SSL> ssl_;
   bool handshake_complete_{};
+  uint64_t records_written_{};
+  // The size of the last SSL_write() if it returned SSL_ERROR_WANT_WRITE, which must be retried
+  // with the same length.
+  uint64_t pending_write_size_{};
 };
 
 class ClientSslSocketFactory : public Network::TransportSocketFactory {
@@ -135,6 +135,24 @@ public:
     gauage_metric->set_value(value);
   }
 
+  void flushHistogram(const ParentHistogram& histogram) override {
+    // Prometheus summaries are cumulative.
+    const HistogramStatistics& statistics = histogram.cumulativeStatistics();
+    io::prometheus::client::MetricFamily* metrics_family = message_.add_envoy_metrics();
+    metrics_family->set_type(io::prometheus::client::MetricType::SUMMARY);
+    metrics_family->set_name(histogram.name());
+    auto* metric = metrics_family->add_metric();
+    metric->set_timestamp_ms(std::chrono::system_clock::now().time_since_epoch().count());
+    auto* summary_metric = metric->mutable_summary();
+    summary_metric->set_sample_count(statistics.sampleCount());
+    summary_metric->set_sample_sum(statistics.sampleSum());
+    for (size_t i = 0; i < statistics.supportedQuantiles().size(); i++) {
+      auto* quantile = summary_metric->add_quantile();
+      quantile->set_quantile(statistics.supportedQuantiles()[i]);
+      quantile->set_value(statistics.computedQuantiles()[i]);
+    }
+  }
+
   void endFlush() override {
     grpc_metrics_streamer_->send(message_);
     // for perf reasons, clear the identifer after the first flush.
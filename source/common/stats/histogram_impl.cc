@@ -0,0 +1,140 @@
+#include "common/stats/histogram_impl.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+// Quantiles reported for every histogram, together with their display names.
+const std::vector<double>& supportedQuantilesList() {
+  static const std::vector<double> quantiles{0.5, 0.9, 0.99, 0.999};
+  return quantiles;
+}
+
+const std::vector<std::string>& quantileNames() {
+  static const std::vector<std::string> names{"P50", "P90", "P99", "P99.9"};
+  return names;
+}
+
+} // namespace
+
+constexpr uint32_t LogLinearBuckets::SubBucketBits;
+constexpr uint32_t LogLinearBuckets::SubBucketCount;
+constexpr uint32_t LogLinearBuckets::NumGroups;
+constexpr uint32_t LogLinearBuckets::NumBuckets;
+
+ThreadLocalHistogram::ThreadLocalHistogram() {
+  for (std::atomic<BucketGroup*>& group : groups_) {
+    group.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ThreadLocalHistogram::~ThreadLocalHistogram() {
+  for (std::atomic<BucketGroup*>& group : groups_) {
+    delete[] group.load(std::memory_order_relaxed);
+  }
+}
+
+ThreadLocalHistogram::BucketGroup& ThreadLocalHistogram::group(uint32_t group_index) {
+  BucketGroup* group = groups_[group_index].load(std::memory_order_acquire);
+  if (group == nullptr) {
+    // A compare and swap keeps this safe (if wasteful) should two threads race to allocate.
+    BucketGroup* new_group = new BucketGroup[1];
+    for (std::atomic<uint64_t>& count : *new_group) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    if (groups_[group_index].compare_exchange_strong(group, new_group,
+                                                     std::memory_order_acq_rel)) {
+      group = new_group;
+    } else {
+      delete[] new_group;
+    }
+  }
+  return *group;
+}
+
+void ThreadLocalHistogram::recordValue(uint64_t value) {
+  const uint32_t index = LogLinearBuckets::index(value);
+  std::atomic<uint64_t>& count =
+      group(index / LogLinearBuckets::SubBucketCount)[index % LogLinearBuckets::SubBucketCount];
+  // There is a single writer so there is no need for a locked read-modify-write.
+  count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void ThreadLocalHistogram::addTo(std::vector<uint64_t>& counts, uint64_t& sum) const {
+  ASSERT(counts.size() == LogLinearBuckets::NumBuckets);
+  for (uint32_t group_index = 0; group_index < LogLinearBuckets::NumGroups; group_index++) {
+    const BucketGroup* group = groups_[group_index].load(std::memory_order_acquire);
+    if (group == nullptr) {
+      continue;
+    }
+    uint64_t* group_counts = &counts[group_index * LogLinearBuckets::SubBucketCount];
+    for (uint32_t i = 0; i < LogLinearBuckets::SubBucketCount; i++) {
+      group_counts[i] += (*group)[i].load(std::memory_order_relaxed);
+    }
+  }
+  sum += sum_.load(std::memory_order_relaxed);
+}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl()
+    : computed_quantiles_(supportedQuantilesList().size(),
+                          std::numeric_limits<double>::quiet_NaN()) {}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl(const std::vector<uint64_t>& counts,
+                                                 uint64_t sum)
+    : HistogramStatisticsImpl() {
+  ASSERT(counts.size() == LogLinearBuckets::NumBuckets);
+  for (uint64_t count : counts) {
+    sample_count_ += count;
+  }
+  sample_sum_ = sum;
+  if (sample_count_ == 0) {
+    return;
+  }
+
+  // Walk the buckets once, resolving the quantiles in ascending order. Within a bucket the samples
+  // are assumed to be spread evenly between its smallest and largest value.
+  const std::vector<double>& quantiles = supportedQuantiles();
+  uint64_t samples_below = 0;
+  uint32_t index = 0;
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    const double rank = quantiles[i] * sample_count_;
+    while (counts[index] == 0 || samples_below + counts[index] < rank) {
+      samples_below += counts[index];
+      index++;
+    }
+    const double fraction = (rank - samples_below) / counts[index];
+    computed_quantiles_[i] = LogLinearBuckets::lowerBound(index) +
+                             fraction * (LogLinearBuckets::width(index) - 1);
+  }
+}
+
+std::string HistogramStatisticsImpl::summary() const {
+  if (sample_count_ == 0) {
+    return "No recorded values";
+  }
+  std::vector<std::string> summary;
+  summary.reserve(computed_quantiles_.size());
+  for (size_t i = 0; i < computed_quantiles_.size(); i++) {
+    summary.push_back(fmt::format("{}: {}", quantileNames()[i], computed_quantiles_[i]));
+  }
+  return StringUtil::join(summary, ", ");
+}
+
+const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
+  return supportedQuantilesList();
+}
+
+} // namespace Stats
+} // namespace Envoy
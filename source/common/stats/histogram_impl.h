@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Log-linear bucketing of values. Values below SubBucketCount each have their own bucket. Above
+ * that, each power of two range [2^n, 2^(n+1)) is split into SubBucketCount buckets of equal
+ * width, so a value is known to within 1/SubBucketCount of its magnitude (HdrHistogram style).
+ * Buckets are grouped by power of two: group 0 holds the exact values and group g > 0 holds
+ * [2^(g + SubBucketBits - 1), 2^(g + SubBucketBits)).
+ */
+class LogLinearBuckets {
+public:
+  static constexpr uint32_t SubBucketBits = 4;
+  static constexpr uint32_t SubBucketCount = 1 << SubBucketBits;
+  static constexpr uint32_t NumGroups = 64 - SubBucketBits + 1;
+  static constexpr uint32_t NumBuckets = NumGroups * SubBucketCount;
+
+  /**
+   * @return the index of the bucket holding value.
+   */
+  static uint32_t index(uint64_t value) {
+    if (value < SubBucketCount) {
+      return value;
+    }
+    const uint32_t exponent = 63 - __builtin_clzll(value);
+    const uint32_t shift = exponent - SubBucketBits;
+    return (shift + 1) * SubBucketCount + ((value >> shift) - SubBucketCount);
+  }
+
+  /**
+   * @return the smallest value held by a bucket.
+   */
+  static uint64_t lowerBound(uint32_t index) {
+    const uint32_t group = index / SubBucketCount;
+    const uint64_t sub_bucket = index % SubBucketCount;
+    return group == 0 ? sub_bucket : (SubBucketCount + sub_bucket) << (group - 1);
+  }
+
+  /**
+   * @return the number of distinct values held by a bucket.
+   */
+  static uint64_t width(uint32_t index) {
+    const uint32_t group = index / SubBucketCount;
+    return group == 0 ? 1 : 1ULL << (group - 1);
+  }
+};
+
+/**
+ * Bucket counts for values recorded by a single thread. Recording is lock free and wait free:
+ * each bucket is an atomic counter that is only ever written by the recording thread, so an
+ * increment is a relaxed load and store. Other threads may read the counts concurrently via
+ * addTo(). Bucket groups are allocated the first time a value falls into them, so a histogram only
+ * pays for the range of values it actually sees.
+ *
+ * Recording into the same instance from several threads is safe but may lose samples.
+ */
+class ThreadLocalHistogram : NonCopyable {
+public:
+  ThreadLocalHistogram();
+  ~ThreadLocalHistogram();
+
+  /**
+   * Record a value.
+   */
+  void recordValue(uint64_t value);
+
+  /**
+   * Add all counts recorded so far to a set of counts.
+   * @param counts supplies LogLinearBuckets::NumBuckets counts to add to.
+   * @param sum supplies the sum of recorded values to add to.
+   */
+  void addTo(std::vector<uint64_t>& counts, uint64_t& sum) const;
+
+private:
+  typedef std::atomic<uint64_t> BucketGroup[LogLinearBuckets::SubBucketCount];
+
+  BucketGroup& group(uint32_t group_index);
+
+  std::atomic<BucketGroup*> groups_[LogLinearBuckets::NumGroups];
+  std::atomic<uint64_t> sum_{0};
+};
+
+typedef std::shared_ptr<ThreadLocalHistogram> ThreadLocalHistogramSharedPtr;
+
+/**
+ * Quantiles computed from a set of log-linear bucket counts. The value of a quantile is
+ * interpolated linearly within the bucket it falls in.
+ */
+class HistogramStatisticsImpl : public HistogramStatistics {
+public:
+  HistogramStatisticsImpl();
+  HistogramStatisticsImpl(const std::vector<uint64_t>& counts, uint64_t sum);
+
+  // Stats::HistogramStatistics
+  std::string summary() const override;
+  const std::vector<double>& supportedQuantiles() const override;
+  const std::vector<double>& computedQuantiles() const override { return computed_quantiles_; }
+  uint64_t sampleCount() const override { return sample_count_; }
+  uint64_t sampleSum() const override { return sample_sum_; }
+
+private:
+  std::vector<double> computed_quantiles_;
+  uint64_t sample_count_{0};
+  uint64_t sample_sum_{0};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -61,8 +61,9 @@ std::string Utility::sanitizeStatsName(const std::string& name) {
   return stats_name;
 }
 
-TagExtractorImpl::TagExtractorImpl(const std::string& name, const std::string& regex)
-    : name_(name), regex_(RegexUtil::parseRegex(regex)) {}
+TagExtractorImpl::TagExtractorImpl(const std::string& name, const std::string& regex,
+                                   const std::string& substr)
+    : name_(name), regex_(RegexUtil::parseRegex(regex)), substr_(substr) {}
 
 TagExtractorPtr TagExtractorImpl::createTagExtractor(const std::string& name,
                                                      const std::string& regex) {
@@ -75,22 +76,27 @@ TagExtractorPtr TagExtractorImpl::createTagExtractor(const std::string& name,
     return TagExtractorPtr{new TagExtractorImpl(name, regex)};
   } else {
     // Look up the default for that name.
-    const auto& name_regex_pairs = Config::TagNames::get().name_regex_pairs_;
-    auto it = std::find_if(name_regex_pairs.begin(), name_regex_pairs.end(),
-                           [&name](const std::pair<std::string, std::string>& name_regex_pair) {
-                             return name == name_regex_pair.first;
+    const auto& descriptors = Config::TagNames::get().descriptors_;
+    auto it = std::find_if(descriptors.begin(), descriptors.end(),
+                           [&name](const Config::TagNameValues::Descriptor& descriptor) {
+                             return name == descriptor.name_;
                            });
-    if (it != name_regex_pairs.end()) {
-      return TagExtractorPtr{new TagExtractorImpl(name, it->second)};
-    } else {
+    if (it == descriptors.end()) {
       throw EnvoyException(fmt::format(
           "No regex specified for tag specifier and no default regex for name: '{}'", name));
+    } else if (!it->token_patterns_.empty()) {
+      return TagExtractorPtr{new TagExtractorTokensImpl(name, it->token_patterns_)};
+    } else {
+      return TagExtractorPtr{new TagExtractorImpl(name, it->regex_, it->substr_)};
     }
   }
 }
 
-std::string TagExtractorImpl::extractTag(const std::string& tag_extracted_name,
-                                         std::vector<Tag>& tags) const {
+bool TagExtractorImpl::extractTag(std::string& tag_extracted_name, std::vector<Tag>& tags) const {
+  if (!substr_.empty() && tag_extracted_name.find(substr_) == std::string::npos) {
+    return false;
+  }
+
   std::smatch match;
   // The regex must match and contain one or more subexpressions (all after the first are ignored).
   if (std::regex_search(tag_extracted_name, match, regex_) && match.size() > 1) {
@@ -108,11 +114,105 @@ std::string TagExtractorImpl::extractTag(const std::string& tag_extracted_name,
     tag.name_ = name_;
     tag.value_ = value_subexpr.str();
 
-    // Reconstructs the tag_extracted_name without remove_subexpr.
-    return std::string(match.prefix().first, remove_subexpr.first)
-        .append(remove_subexpr.second, match.suffix().second);
+    tag_extracted_name.erase(remove_subexpr.first, remove_subexpr.second);
+    return true;
   }
-  return tag_extracted_name;
+  return false;
+}
+
+TagExtractorTokensImpl::TagExtractorTokensImpl(const std::string& name,
+                                               const std::vector<std::string>& patterns)
+    : name_(name) {
+  for (const std::string& pattern : patterns) {
+    patterns_.emplace_back();
+    uint32_t values = 0;
+    for (absl::string_view token : StringUtil::splitToken(pattern, ".", true)) {
+      if (token == "*") {
+        patterns_.back().push_back({Token::Type::Any, ""});
+      } else if (token == "**") {
+        patterns_.back().push_back({Token::Type::AnySequence, ""});
+      } else if (token == "$") {
+        patterns_.back().push_back({Token::Type::Value, ""});
+        values++;
+      } else {
+        patterns_.back().push_back({Token::Type::Literal, std::string(token)});
+      }
+    }
+    if (values != 1) {
+      throw EnvoyException(
+          fmt::format("Tag pattern '{}' for '{}' must contain exactly one $", pattern, name));
+    }
+  }
+}
+
+bool TagExtractorTokensImpl::extractTag(std::string& tag_extracted_name,
+                                        std::vector<Tag>& tags) const {
+  for (const Pattern& pattern : patterns_) {
+    size_t value_start = 0;
+    size_t value_end = 0;
+    if (!match(pattern, 0, tag_extracted_name, 0, value_start, value_end)) {
+      continue;
+    }
+
+    tags.emplace_back();
+    Tag& tag = tags.back();
+    tag.name_ = name_;
+    tag.value_ = tag_extracted_name.substr(value_start, value_end - value_start);
+
+    // Remove the value and the dot that follows it, or the dot before it if it is the last token.
+    if (value_end < tag_extracted_name.size()) {
+      value_end++;
+    } else if (value_start > 0) {
+      value_start--;
+    }
+    tag_extracted_name.erase(value_start, value_end - value_start);
+    return true;
+  }
+  return false;
+}
+
+bool TagExtractorTokensImpl::match(const Pattern& pattern, size_t token, absl::string_view name,
+                                   size_t position, size_t& value_start, size_t& value_end) {
+  // position is the start of the next token of the name, or npos once all of them are matched.
+  if (token == pattern.size()) {
+    return position == absl::string_view::npos;
+  }
+
+  if (pattern[token].type_ == Token::Type::AnySequence) {
+    while (!match(pattern, token + 1, name, position, value_start, value_end)) {
+      if (position == absl::string_view::npos) {
+        return false;
+      }
+      const size_t end = name.find('.', position);
+      position = end == absl::string_view::npos ? end : end + 1;
+    }
+    return true;
+  }
+
+  if (position == absl::string_view::npos) {
+    return false;
+  }
+  const size_t end = std::min(name.find('.', position), name.size());
+  switch (pattern[token].type_) {
+  case Token::Type::Literal:
+    if (name.substr(position, end - position) != pattern[token].literal_) {
+      return false;
+    }
+    break;
+  case Token::Type::Value:
+    value_start = position;
+    value_end = end;
+    break;
+  default:
+    break;
+  }
+  return match(pattern, token + 1, name, end == name.size() ? absl::string_view::npos : end + 1,
+               value_start, value_end);
+}
+
+const std::vector<Tag>& CompactMetricImpl::tags() const {
+  static const std::vector<Tag>* no_tags = new std::vector<Tag>();
+  return *no_tags;
 }
 
 RawStatData* HeapRawStatDataAllocator::alloc(const std::string& name) {
@@ -154,7 +254,7 @@ std::string TagProducerImpl::produceTags(const std::string& name, std::vector<Ta
 
   std::string tag_extracted_name = name;
   for (const TagExtractorPtr& tag_extractor : tag_extractors_) {
-    tag_extracted_name = tag_extractor->extractTag(tag_extracted_name, tags);
+    tag_extractor->extractTag(tag_extracted_name, tags);
   }
   return tag_extracted_name;
 }
@@ -164,7 +264,7 @@ void TagProducerImpl::reserveResources(const envoy::config::metrics::v2::StatsCo
   default_tags_.reserve(config.stats_tags().size());
 
   if (!config.has_use_all_default_tags() || config.use_all_default_tags().value()) {
-    tag_extractors_.reserve(Config::TagNames::get().name_regex_pairs_.size() +
+    tag_extractors_.reserve(Config::TagNames::get().descriptors_.size() +
                             config.stats_tags().size());
   } else {
     tag_extractors_.reserve(config.stats_tags().size());
@@ -174,10 +274,10 @@ void TagProducerImpl::reserveResources(const envoy::config::metrics::v2::StatsCo
 void TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v2::StatsConfig& config,
                                            std::unordered_set<std::string>& names) {
   if (!config.has_use_all_default_tags() || config.use_all_default_tags().value()) {
-    for (const auto& extractor : Config::TagNames::get().name_regex_pairs_) {
-      names.emplace(extractor.first);
+    for (const auto& descriptor : Config::TagNames::get().descriptors_) {
+      names.emplace(descriptor.name_);
       tag_extractors_.emplace_back(
-          Stats::TagExtractorImpl::createTagExtractor(extractor.first, extractor.second));
+          Stats::TagExtractorImpl::createTagExtractor(descriptor.name_, ""));
     }
   }
 }
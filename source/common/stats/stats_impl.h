@@ -28,22 +28,77 @@ namespace Stats {
 class TagExtractorImpl : public TagExtractor {
 public:
   /**
-   * Creates a tag extractor from the regex provided or looks up a default regex.
+   * Creates a tag extractor from the regex provided or looks up a default tag extractor.
    * @param name name for tag extractor. Used to look up a default tag extractor if regex is empty.
    * @param regex optional regex expression. Can be specified as an empty string to trigger a
-   * default regex lookup.
+   * default tag extractor lookup.
    * @return TagExtractorPtr newly constructed TagExtractor.
    */
   static TagExtractorPtr createTagExtractor(const std::string& name, const std::string& regex);
 
-  TagExtractorImpl(const std::string& name, const std::string& regex);
+  /**
+   * @param name supplies the tag name.
+   * @param regex supplies the regex, whose first subexpression is removed from names and whose
+   *        second subexpression, if any, is the tag value.
+   * @param substr supplies a string that names must contain for the regex to match, or an empty
+   *        string to match every name against the regex.
+   */
+  TagExtractorImpl(const std::string& name, const std::string& regex,
+                   const std::string& substr = "");
+
+  // Stats::TagExtractor
   std::string name() const override { return name_; }
-  std::string extractTag(const std::string& tag_extracted_name,
-                         std::vector<Tag>& tags) const override;
+  bool extractTag(std::string& tag_extracted_name, std::vector<Tag>& tags) const override;
 
 private:
   const std::string name_;
   const std::regex regex_;
+  const std::string substr_;
+};
+
+/**
+ * Extracts a tag whose value is a whole token of the dot separated stat name, by matching the
+ * tokens of the name against patterns. This is much cheaper than matching a regex, as most names
+ * are rejected by their first token. A pattern is itself a dot separated list of tokens, in which:
+ * - A literal matches the same token.
+ * - * matches any single token.
+ * - ** matches any number of tokens, including none. The fewest tokens that let the rest of the
+ *   pattern match are used.
+ * - $ matches any single token, which is the tag value. It is removed from the name along with the
+ *   dot that follows it, or precedes it if it is the last token.
+ * The pattern must match the whole name, so a pattern that does not end with ** limits the number
+ * of tokens in the name. For example, "cluster.**.grpc.$.**" extracts "foo" from
+ * "cluster.bar.grpc.foo.success" and leaves "cluster.bar.grpc.success".
+ */
+class TagExtractorTokensImpl : public TagExtractor {
+public:
+  /**
+   * @param name supplies the tag name.
+   * @param patterns supplies the patterns, tried in order until one matches. Each must contain
+   *        exactly one $.
+   * @throw EnvoyException if a pattern is invalid.
+   */
+  TagExtractorTokensImpl(const std::string& name, const std::vector<std::string>& patterns);
+
+  // Stats::TagExtractor
+  std::string name() const override { return name_; }
+  bool extractTag(std::string& tag_extracted_name, std::vector<Tag>& tags) const override;
+
+private:
+  struct Token {
+    enum class Type { Literal, Any, AnySequence, Value };
+
+    Type type_;
+    std::string literal_;
+  };
+
+  typedef std::vector<Token> Pattern;
+
+  static bool match(const Pattern& pattern, size_t token, absl::string_view name, size_t position,
+                    size_t& value_start, size_t& value_end);
+
+  const std::string name_;
+  std::vector<Pattern> patterns_;
 };
 
 class TagProducerImpl : public TagProducer {
@@ -295,6 +350,80 @@ private:
   RawStatDataAllocator& alloc_;
 };
 
+/**
+ * Metric implementation for stats that exist in large numbers, such as per host stats. The name is
+ * not copied, so it must outlive the metric and is typically shared by many metrics. There are no
+ * tags.
+ */
+class CompactMetricImpl : public virtual Metric {
+public:
+  CompactMetricImpl(const std::string& name) : name_(name) {}
+
+  const std::string& name() const override { return name_; }
+  const std::string& tagExtractedName() const override { return name_; }
+  const std::vector<Tag>& tags() const override;
+
+private:
+  const std::string& name_;
+};
+
+/**
+ * Counter implementation that keeps its value inline rather than in a RawStatData.
+ */
+class CompactCounterImpl : public Counter, public CompactMetricImpl {
+public:
+  CompactCounterImpl(const std::string& name) : CompactMetricImpl(name) {}
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    value_ += amount;
+    pending_increment_ += amount;
+    used_ = true;
+  }
+
+  void inc() override { add(1); }
+  uint64_t latch() override { return pending_increment_.exchange(0); }
+  void reset() override { value_ = 0; }
+  bool used() const override { return used_; }
+  uint64_t value() const override { return value_; }
+
+private:
+  std::atomic<uint64_t> value_{};
+  std::atomic<uint64_t> pending_increment_{};
+  std::atomic<bool> used_{};
+};
+
+/**
+ * Gauge implementation that keeps its value inline rather than in a RawStatData.
+ */
+class CompactGaugeImpl : public Gauge, public CompactMetricImpl {
+public:
+  CompactGaugeImpl(const std::string& name) : CompactMetricImpl(name) {}
+
+  // Stats::Gauge
+  void add(uint64_t amount) override {
+    value_ += amount;
+    used_ = true;
+  }
+  void dec() override { sub(1); }
+  void inc() override { add(1); }
+  void set(uint64_t value) override {
+    value_ = value;
+    used_ = true;
+  }
+  void sub(uint64_t amount) override {
+    ASSERT(value_ >= amount);
+    ASSERT(used());
+    value_ -= amount;
+  }
+  uint64_t value() const override { return value_; }
+  bool used() const override { return used_; }
+
+private:
+  std::atomic<uint64_t> value_{};
+  std::atomic<bool> used_{};
+};
+
 /**
  * Histogram implementation for the heap.
  */
@@ -387,6 +516,9 @@ public:
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override { return counters_.toList(); }
   std::list<GaugeSharedPtr> gauges() const override { return gauges_.toList(); }
+  std::list<ParentHistogramSharedPtr> histograms() const override {
+    return std::list<ParentHistogramSharedPtr>{};
+  }
 
 private:
   struct ScopeImpl : public Scope {
@@ -1,8 +1,10 @@
 #include "common/stats/statsd.h"
 
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/event/dispatcher.h"
@@ -17,6 +19,33 @@ namespace Envoy {
 namespace Stats {
 namespace Statsd {
 
+namespace {
+
+/**
+ * Invoke a callback with the statsd name suffix and the rounded value of each computed quantile,
+ * e.g. "p50" and "p999" for the 0.5 and 0.999 quantiles. Nothing is emitted for an interval
+ * without samples.
+ */
+template <class Callback>
+void forEachQuantile(const HistogramStatistics& statistics, Callback callback) {
+  if (statistics.sampleCount() == 0) {
+    return;
+  }
+
+  const std::vector<double>& quantiles = statistics.supportedQuantiles();
+  const std::vector<double>& values = statistics.computedQuantiles();
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    // "0.990" -> "99", "0.999" -> "999", "0.500" -> "50".
+    std::string digits = fmt::format("{:.3f}", quantiles[i]).substr(2);
+    while (digits.size() > 2 && digits.back() == '0') {
+      digits.pop_back();
+    }
+    callback("p" + digits, static_cast<uint64_t>(std::round(values[i])));
+  }
+}
+
+} // namespace
+
 Writer::Writer(Network::Address::InstanceConstSharedPtr address) {
   fd_ = address->socket(Network::Address::SocketType::Datagram);
   ASSERT(fd_ != -1);
@@ -56,6 +85,17 @@ void UdpStatsdSink::flushGauge(const Gauge& gauge, uint64_t value) {
   tls_->getTyped<Writer>().write(message);
 }
 
+void UdpStatsdSink::flushHistogram(const ParentHistogram& histogram) {
+  // Quantiles are flushed as gauges as statsd has no notion of a pre-aggregated timer.
+  const std::string name = getName(histogram);
+  const std::string tags = buildTagStr(histogram.tags());
+  forEachQuantile(histogram.intervalStatistics(),
+                  [this, &name, &tags](const std::string& suffix, uint64_t value) -> void {
+                    tls_->getTyped<Writer>().write(
+                        fmt::format("envoy.{}.{}:{}|g{}", name, suffix, value, tags));
+                  });
+}
+
 void UdpStatsdSink::onHistogramComplete(const Histogram& histogram, uint64_t value) {
   // For statsd histograms are all timers.
   const std::string message(fmt::format("envoy.{}:{}|ms{}", getName(histogram),
@@ -158,6 +198,13 @@ void TcpStatsdSink::TlsSink::flushGauge(const std::string& name, uint64_t value)
   commonFlush(name, value, 'g');
 }
 
+void TcpStatsdSink::TlsSink::flushHistogram(const std::string& name,
+                                            const HistogramStatistics& statistics) {
+  forEachQuantile(statistics, [this, &name](const std::string& suffix, uint64_t value) -> void {
+    commonFlush(name + "." + suffix, value, 'g');
+  });
+}
+
 void TcpStatsdSink::TlsSink::endFlush(bool do_write) {
   ASSERT(current_slice_mem_ != nullptr);
   current_buffer_slice_.len_ = usedBuffer();
@@ -53,6 +53,7 @@ public:
   void beginFlush() override {}
   void flushCounter(const Counter& counter, uint64_t delta) override;
   void flushGauge(const Gauge& gauge, uint64_t value) override;
+  void flushHistogram(const ParentHistogram& histogram) override;
   void endFlush() override {}
   void onHistogramComplete(const Histogram& histogram, uint64_t value) override;
 
@@ -89,6 +90,10 @@ public:
     tls_->getTyped<TlsSink>().flushGauge(gauge.name(), value);
   }
 
+  void flushHistogram(const ParentHistogram& histogram) override {
+    tls_->getTyped<TlsSink>().flushHistogram(histogram.name(), histogram.intervalStatistics());
+  }
+
   void endFlush() override { tls_->getTyped<TlsSink>().endFlush(true); }
 
   void onHistogramComplete(const Histogram& histogram, uint64_t value) override {
@@ -107,6 +112,7 @@ private:
     void commonFlush(const std::string& name, uint64_t value, char stat_type);
     void flushCounter(const std::string& name, uint64_t delta);
     void flushGauge(const std::string& name, uint64_t value);
+    void flushHistogram(const std::string& name, const HistogramStatistics& statistics);
     void endFlush(bool do_write);
     void onTimespanComplete(const std::string& name, std::chrono::milliseconds ms);
     uint64_t usedBuffer();
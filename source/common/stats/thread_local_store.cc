@@ -7,6 +7,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 namespace Envoy {
 namespace Stats {
@@ -61,6 +62,22 @@ std::list<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   return ret;
 }
 
+std::list<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
+  // Overlapping scopes share the parent histogram, so there is no need to de-dup.
+  std::list<ParentHistogramSharedPtr> ret;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (const auto& histogram : histogram_set_) {
+    // The references are only dropped once the lock is released, as releasing the last one
+    // re-enters the store.
+    ret.push_back(histogram.second.lock());
+    if (!ret.back()) {
+      ret.pop_back();
+    }
+  }
+
+  return ret;
+}
+
 void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                                                ThreadLocal::Instance& tls) {
   main_thread_dispatcher_ = &main_thread_dispatcher;
@@ -101,6 +118,46 @@ void ThreadLocalStoreImpl::clearScopeFromCaches(ScopeImpl* scope) {
   }
 }
 
+void ThreadLocalStoreImpl::releaseHistogramCrossThread(ParentHistogramImpl& histogram) {
+  std::unique_lock<std::mutex> lock(lock_);
+  // A scope may already have created a new parent with the same name.
+  auto existing = histogram_set_.find(histogram.name());
+  if (existing != histogram_set_.end() && existing->second.expired()) {
+    histogram_set_.erase(existing);
+  }
+
+  // As with scopes, the thread local caches are flushed from the main thread.
+  const uint64_t histogram_id = histogram.id();
+  if (!shutting_down_ && main_thread_dispatcher_) {
+    main_thread_dispatcher_->post(
+        [this, histogram_id]() -> void { clearHistogramFromCaches(histogram_id); });
+  }
+}
+
+void ThreadLocalStoreImpl::clearHistogramFromCaches(uint64_t histogram_id) {
+  if (!shutting_down_) {
+    tls_->runOnAllThreads([this, histogram_id]() -> void {
+      tls_->getTyped<TlsCache>().tls_histograms_.erase(histogram_id);
+    });
+  }
+}
+
+void ThreadLocalStoreImpl::recordHistogramValue(ParentHistogramImpl& histogram, uint64_t value) {
+  // This is the same lookup as in ScopeImpl::counter(), but the thread local cache is keyed by the
+  // parent histogram's id so that the per sample cost is an integer hash rather than a string hash.
+  if (shutting_down_ || !tls_) {
+    histogram.recordValueNoTls(value);
+    return;
+  }
+
+  ThreadLocalHistogramSharedPtr& tls_ref =
+      tls_->getTyped<TlsCache>().tls_histograms_[histogram.id()];
+  if (!tls_ref) {
+    tls_ref = histogram.createThreadLocalHistogram();
+  }
+  tls_ref->recordValue(value);
+}
+
 ThreadLocalStoreImpl::SafeAllocData ThreadLocalStoreImpl::safeAlloc(const std::string& name) {
   RawStatData* data = alloc_.alloc(name);
   if (!data) {
@@ -204,7 +261,7 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   // See comments in counter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
   std::string final_name = prefix_ + name;
-  HistogramSharedPtr* tls_ref = nullptr;
+  ParentHistogramImplSharedPtr* tls_ref = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[final_name];
   }
@@ -214,12 +271,19 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   }
 
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  HistogramSharedPtr& central_ref = central_cache_.histograms_[final_name];
+  ParentHistogramImplSharedPtr& central_ref = central_cache_.histograms_[final_name];
   if (!central_ref) {
-    std::vector<Tag> tags;
-    std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    central_ref.reset(
-        new HistogramImpl(final_name, parent_, std::move(tag_extracted_name), std::move(tags)));
+    // Overlapping scopes share a single parent histogram, so that values recorded through any of
+    // them are merged together.
+    std::weak_ptr<ParentHistogramImpl>& shared_ref = parent_.histogram_set_[final_name];
+    central_ref = shared_ref.lock();
+    if (!central_ref) {
+      std::vector<Tag> tags;
+      std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
+      central_ref.reset(new ParentHistogramImpl(final_name, parent_, parent_.next_histogram_id_++,
+                                                std::move(tag_extracted_name), std::move(tags)));
+      shared_ref = central_ref;
+    }
   }
 
   if (tls_ref) {
@@ -229,5 +293,59 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
   return *central_ref;
 }
 
+ThreadLocalStoreImpl::ParentHistogramImpl::ParentHistogramImpl(const std::string& name,
+                                                               ThreadLocalStoreImpl& parent,
+                                                               uint64_t id,
+                                                               std::string&& tag_extracted_name,
+                                                               std::vector<Tag>&& tags)
+    : MetricImpl(name, std::move(tag_extracted_name), std::move(tags)), parent_(parent), id_(id),
+      no_tls_histogram_(createThreadLocalHistogram()) {}
+
+ThreadLocalStoreImpl::ParentHistogramImpl::~ParentHistogramImpl() {
+  parent_.releaseHistogramCrossThread(*this);
+}
+
+ThreadLocalHistogramSharedPtr
+ThreadLocalStoreImpl::ParentHistogramImpl::createThreadLocalHistogram() {
+  ThreadLocalHistogramSharedPtr histogram = std::make_shared<ThreadLocalHistogram>();
+  std::unique_lock<std::mutex> lock(lock_);
+  tls_histograms_.push_back(histogram);
+  return histogram;
+}
+
+void ThreadLocalStoreImpl::ParentHistogramImpl::recordValue(uint64_t value) {
+  parent_.recordHistogramValue(*this, value);
+}
+
+void ThreadLocalStoreImpl::ParentHistogramImpl::merge() {
+  // The per thread histograms only ever grow, so the values recorded since the last merge are the
+  // difference between the current and the last cumulative counts.
+  std::vector<uint64_t> cumulative_counts(LogLinearBuckets::NumBuckets);
+  uint64_t cumulative_sum = 0;
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    for (const ThreadLocalHistogramSharedPtr& histogram : tls_histograms_) {
+      histogram->addTo(cumulative_counts, cumulative_sum);
+    }
+  }
+
+  std::vector<uint64_t> interval_counts(cumulative_counts);
+  for (const auto& last_count : last_cumulative_counts_) {
+    interval_counts[last_count.first] -= last_count.second;
+  }
+
+  interval_statistics_ =
+      HistogramStatisticsImpl(interval_counts, cumulative_sum - last_cumulative_sum_);
+  cumulative_statistics_ = HistogramStatisticsImpl(cumulative_counts, cumulative_sum);
+
+  last_cumulative_counts_.clear();
+  for (uint32_t i = 0; i < LogLinearBuckets::NumBuckets; i++) {
+    if (cumulative_counts[i] != 0) {
+      last_cumulative_counts_.emplace_back(i, cumulative_counts[i]);
+    }
+  }
+  last_cumulative_sum_ = cumulative_sum;
+}
+
 } // namespace Stats
 } // namespace Envoy
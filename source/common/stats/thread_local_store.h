@@ -8,9 +8,11 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/stats/histogram_impl.h"
 #include "common/stats/stats_impl.h"
 
 namespace Envoy {
@@ -38,8 +40,14 @@ namespace Stats {
  *         with the same address, and a cache flush operation could race and delete cache data
  *         for the new scope. This is extremely unlikely, and if it happens the cache will be
  *         repopulated on the next access.
- * - Since it's possible to have overlapping scopes, we de-dup stats when counters() or gauges() is
- *   called since these are very uncommon operations.
+ * - Since it's possible to have overlapping scopes, we de-dup stats when counters(), gauges() or
+ *   histograms() is called since these are very uncommon operations.
+ * - Histograms are aggregated in process. The histogram handed out by a scope is a parent
+ *   histogram that lives in the central cache. Unlike counters and gauges, which share their
+ *   backing stat data, overlapping scopes share the parent histogram itself, so there is a single
+ *   parent per name. Recorded values are routed to a per thread histogram found via the thread
+ *   local cache, so recording takes no locks. The parent owns the per thread histograms and merges
+ *   them on the main thread when stats are flushed.
  * - Though this implementation is designed to work with a fixed shared memory space, it will fall
  *   back to heap allocated stats if needed. NOTE: In this case, overlapping scopes will not share
  *   the same backing store. This is to keep things simple, it could be done in the future if
@@ -64,6 +72,7 @@ public:
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override;
   std::list<GaugeSharedPtr> gauges() const override;
+  std::list<ParentHistogramSharedPtr> histograms() const override;
 
   // Stats::StoreRoot
   void addSink(Sink& sink) override { timer_sinks_.push_back(sink); }
@@ -75,10 +84,66 @@ public:
   void shutdownThreading() override;
 
 private:
+  struct ScopeImpl;
+
+  /**
+   * Histogram that is handed out by scopes. Values recorded from any thread are added to that
+   * thread's histogram, and merge() combines all of them on the main thread.
+   */
+  class ParentHistogramImpl : public ParentHistogram, public MetricImpl {
+  public:
+    ParentHistogramImpl(const std::string& name, ThreadLocalStoreImpl& parent, uint64_t id,
+                        std::string&& tag_extracted_name, std::vector<Tag>&& tags);
+    ~ParentHistogramImpl();
+
+    /**
+     * @return uint64_t an identifier that is unique for the lifetime of the store, used to key the
+     *         thread local caches.
+     */
+    uint64_t id() const { return id_; }
+
+    /**
+     * Create a histogram for the calling thread to record into. The parent keeps a reference so
+     * that recorded values are merged even after the thread's cache is flushed.
+     */
+    ThreadLocalHistogramSharedPtr createThreadLocalHistogram();
+
+    /**
+     * Record a value into the histogram shared by threads that have no thread local cache.
+     */
+    void recordValueNoTls(uint64_t value) { no_tls_histogram_->recordValue(value); }
+
+    // Stats::Histogram
+    void recordValue(uint64_t value) override;
+
+    // Stats::ParentHistogram
+    void merge() override;
+    const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+    const HistogramStatistics& cumulativeStatistics() const override {
+      return cumulative_statistics_;
+    }
+    bool used() const override { return cumulative_statistics_.sampleCount() > 0; }
+
+  private:
+    ThreadLocalStoreImpl& parent_;
+    const uint64_t id_;
+    std::mutex lock_;
+    std::vector<ThreadLocalHistogramSharedPtr> tls_histograms_;
+    ThreadLocalHistogramSharedPtr no_tls_histogram_;
+    // Only accessed on the main thread. Bucket counts are kept sparse (as index/count pairs) as
+    // most histograms only ever see a handful of buckets.
+    std::vector<std::pair<uint32_t, uint64_t>> last_cumulative_counts_;
+    uint64_t last_cumulative_sum_{0};
+    HistogramStatisticsImpl interval_statistics_;
+    HistogramStatisticsImpl cumulative_statistics_;
+  };
+
+  typedef std::shared_ptr<ParentHistogramImpl> ParentHistogramImplSharedPtr;
+
   struct TlsCacheEntry {
     std::unordered_map<std::string, CounterSharedPtr> counters_;
     std::unordered_map<std::string, GaugeSharedPtr> gauges_;
-    std::unordered_map<std::string, HistogramSharedPtr> histograms_;
+    std::unordered_map<std::string, ParentHistogramImplSharedPtr> histograms_;
   };
 
   struct ScopeImpl : public Scope {
@@ -102,6 +167,8 @@ private:
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
     std::unordered_map<ScopeImpl*, TlsCacheEntry> scope_cache_;
+    // This thread's histogram for each parent histogram, keyed by ParentHistogramImpl::id().
+    std::unordered_map<uint64_t, ThreadLocalHistogramSharedPtr> tls_histograms_;
   };
 
   struct SafeAllocData {
@@ -112,6 +179,9 @@ private:
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags);
   void clearScopeFromCaches(ScopeImpl* scope);
   void releaseScopeCrossThread(ScopeImpl* scope);
+  void clearHistogramFromCaches(uint64_t histogram_id);
+  void releaseHistogramCrossThread(ParentHistogramImpl& histogram);
+  void recordHistogramValue(ParentHistogramImpl& histogram, uint64_t value);
   SafeAllocData safeAlloc(const std::string& name);
 
   RawStatDataAllocator& alloc_;
@@ -119,6 +189,9 @@ private:
   ThreadLocal::SlotPtr tls_;
   mutable std::mutex lock_;
   std::unordered_set<ScopeImpl*> scopes_;
+  // The parent histogram for each name, shared by all scopes.
+  std::unordered_map<std::string, std::weak_ptr<ParentHistogramImpl>> histogram_set_;
+  uint64_t next_histogram_id_{};
   ScopePtr default_scope_;
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
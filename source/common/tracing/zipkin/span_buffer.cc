@@ -3,8 +3,7 @@
 namespace Envoy {
 namespace Zipkin {
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
-bool SpanBuffer::addSpan(const Span& span) {
+bool SpanBuffer::addSpan(Span&& span) {
   if (span_buffer_.size() == span_buffer_.capacity()) {
     // Buffer full
     return false;
@@ -29,5 +28,16 @@ std::string SpanBuffer::toStringifiedJsonArray() {
 
   return stringified_json_array;
 }
+
+std::string SpanBuffer::toThriftList() const {
+  std::string thrift_list;
+  ThriftBinaryWriter writer(thrift_list);
+  writer.writeListBegin(ThriftBinaryWriter::Type::Struct, span_buffer_.size());
+  for (const Span& span : span_buffer_) {
+    span.toThrift(writer);
+  }
+
+  return thrift_list;
+}
 } // namespace Zipkin
 } // namespace Envoy
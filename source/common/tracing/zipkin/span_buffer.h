@@ -32,13 +32,14 @@ public:
   void allocateBuffer(uint64_t size) { span_buffer_.reserve(size); }
 
   /**
-   * Adds the given Zipkin span to the buffer.
+   * Adds the given Zipkin span to the buffer. The span is moved into space that was allocated
+   * up front, so that buffering it does not copy its annotations.
    *
    * @param span The span to be added to the buffer.
    *
    * @return true if the span was successfully added, or false if the buffer was full.
    */
-  bool addSpan(const Span& span);
+  bool addSpan(Span&& span);
 
   /**
    * Empties the buffer. This method is supposed to be called when all buffered spans
@@ -57,6 +58,12 @@ public:
    */
   std::string toStringifiedJsonArray();
 
+  /**
+   * @return the contents of the buffer as a Thrift list of Zipkin span structs, encoded with
+   * the Thrift binary protocol.
+   */
+  std::string toThriftList() const;
+
 private:
   // We use a pre-allocated vector to improve performance
   std::vector<Span> span_buffer_;
@@ -28,9 +28,10 @@ public:
    * Method that a concrete Reporter class must implement to handle finished spans.
    * For example, a span-buffer management policy could be implemented.
    *
-   * @param span The span that needs action.
+   * @param span The span that needs action. It is moved from, so its contents can be kept without
+   * copying them.
    */
-  virtual void reportSpan(const Span& span) PURE;
+  virtual void reportSpan(Span&& span) PURE;
 };
 
 typedef std::unique_ptr<Reporter> ReporterPtr;
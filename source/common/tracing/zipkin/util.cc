@@ -54,5 +54,42 @@ uint64_t Util::generateRandom64() {
   std::mt19937_64 rand_64(seed);
   return rand_64();
 }
+
+void ThriftBinaryWriter::writeFieldBegin(Type type, int16_t id) {
+  output_.push_back(static_cast<char>(type));
+  writeI16(id);
+}
+
+void ThriftBinaryWriter::writeFieldStop() { output_.push_back(0); }
+
+void ThriftBinaryWriter::writeListBegin(Type element_type, uint32_t size) {
+  output_.push_back(static_cast<char>(element_type));
+  writeI32(size);
+}
+
+void ThriftBinaryWriter::writeBool(bool value) { output_.push_back(value ? 1 : 0); }
+
+void ThriftBinaryWriter::writeI16(int16_t value) {
+  writeBigEndian(static_cast<uint16_t>(value), sizeof(value));
+}
+
+void ThriftBinaryWriter::writeI32(int32_t value) {
+  writeBigEndian(static_cast<uint32_t>(value), sizeof(value));
+}
+
+void ThriftBinaryWriter::writeI64(int64_t value) {
+  writeBigEndian(static_cast<uint64_t>(value), sizeof(value));
+}
+
+void ThriftBinaryWriter::writeString(absl::string_view value) {
+  writeI32(value.size());
+  output_.append(value.data(), value.size());
+}
+
+void ThriftBinaryWriter::writeBigEndian(uint64_t value, size_t size) {
+  for (size_t shift = size * 8; shift > 0; shift -= 8) {
+    output_.push_back(static_cast<char>((value >> (shift - 8)) & 0xff));
+  }
+}
 } // namespace Zipkin
 } // namespace Envoy
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Zipkin {
 
@@ -45,5 +48,64 @@ public:
    */
   static uint64_t generateRandom64();
 };
+
+/**
+ * Appends values to a string using the Thrift binary protocol, which is the encoding accepted by
+ * Zipkin's Thrift transport. Only the parts of the protocol needed to encode spans are provided.
+ */
+class ThriftBinaryWriter {
+public:
+  /**
+   * Thrift types, as they are identified in field and list headers.
+   */
+  enum class Type : uint8_t {
+    Bool = 2,
+    I16 = 6,
+    I32 = 8,
+    I64 = 10,
+    String = 11,
+    Struct = 12,
+    List = 15,
+  };
+
+  /**
+   * @param output supplies the string the encoded values are appended to.
+   */
+  ThriftBinaryWriter(std::string& output) : output_(output) {}
+
+  /**
+   * Starts a struct field. It must be followed by the field's value.
+   * @param type supplies the type of the field's value.
+   * @param id supplies the field id from the Thrift definition of the struct.
+   */
+  void writeFieldBegin(Type type, int16_t id);
+
+  /**
+   * Ends a struct, after its last field.
+   */
+  void writeFieldStop();
+
+  /**
+   * Starts a list. It must be followed by the list's elements.
+   * @param element_type supplies the type of the elements.
+   * @param size supplies the number of elements.
+   */
+  void writeListBegin(Type element_type, uint32_t size);
+
+  void writeBool(bool value);
+  void writeI16(int16_t value);
+  void writeI32(int32_t value);
+  void writeI64(int64_t value);
+
+  /**
+   * Writes a string or binary value.
+   */
+  void writeString(absl::string_view value);
+
+private:
+  void writeBigEndian(uint64_t value, size_t size);
+
+  std::string& output_;
+};
 } // namespace Zipkin
 } // namespace Envoy
@@ -1,5 +1,9 @@
 #include "common/tracing/zipkin/zipkin_core_types.h"
 
+#include <arpa/inet.h>
+
+#include <cstring>
+
 #include "common/common/utility.h"
 #include "common/tracing/zipkin/span_context.h"
 #include "common/tracing/zipkin/util.h"
@@ -54,6 +58,29 @@ const std::string Endpoint::toJson() {
   return json_string;
 }
 
+void Endpoint::toThrift(ThriftBinaryWriter& writer) const {
+  // The ipv4 field is required, so it is zero when the endpoint has an IPv6 address or no address.
+  uint32_t ipv4 = 0;
+  if (address_ && address_->ip()->version() == Network::Address::IpVersion::v4) {
+    ipv4 = ntohl(address_->ip()->ipv4()->address());
+  }
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I32, 1);
+  writer.writeI32(ipv4);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I16, 2);
+  writer.writeI16(address_ ? address_->ip()->port() : 0);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 3);
+  writer.writeString(service_name_);
+  if (address_ && address_->ip()->version() == Network::Address::IpVersion::v6) {
+    // The address is already in network byte order, which is what Zipkin expects.
+    const absl::uint128 ipv6 = address_->ip()->ipv6()->address();
+    char ipv6_bytes[sizeof(ipv6)];
+    memcpy(ipv6_bytes, &ipv6, sizeof(ipv6));
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 4);
+    writer.writeString(absl::string_view(ipv6_bytes, sizeof(ipv6_bytes)));
+  }
+  writer.writeFieldStop();
+}
+
 Annotation::Annotation(const Annotation& ann) {
   timestamp_ = ann.timestamp();
   value_ = ann.value();
@@ -98,6 +125,18 @@ const std::string Annotation::toJson() {
   return json_string;
 }
 
+void Annotation::toThrift(ThriftBinaryWriter& writer) const {
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 1);
+  writer.writeI64(timestamp_);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 2);
+  writer.writeString(value_);
+  if (endpoint_.valid()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::Struct, 3);
+    endpoint_.value().toThrift(writer);
+  }
+  writer.writeFieldStop();
+}
+
 BinaryAnnotation::BinaryAnnotation(const BinaryAnnotation& ann) {
   key_ = ann.key();
   value_ = ann.value();
@@ -138,6 +177,24 @@ const std::string BinaryAnnotation::toJson() {
   return json_string;
 }
 
+void BinaryAnnotation::toThrift(ThriftBinaryWriter& writer) const {
+  // Zipkin's Thrift AnnotationType numbers types differently than the AnnotationType enum.
+  const int32_t thrift_bool_type = 0;
+  const int32_t thrift_string_type = 6;
+
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 1);
+  writer.writeString(key_);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 2);
+  writer.writeString(value_);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I32, 3);
+  writer.writeI32(annotation_type_ == BOOL ? thrift_bool_type : thrift_string_type);
+  if (endpoint_.valid()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::Struct, 4);
+    endpoint_.value().toThrift(writer);
+  }
+  writer.writeFieldStop();
+}
+
 const std::string Span::EMPTY_HEX_STRING_ = "0000000000000000";
 
 Span::Span(const Span& span) {
@@ -217,6 +274,54 @@ const std::string Span::toJson() {
   return json_string;
 }
 
+void Span::toThrift(ThriftBinaryWriter& writer) const {
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 1);
+  writer.writeI64(trace_id_);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::String, 3);
+  writer.writeString(name_);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 4);
+  writer.writeI64(id_);
+
+  if (parent_id_.valid() && parent_id_.value()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 5);
+    writer.writeI64(parent_id_.value());
+  }
+
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::List, 6);
+  writer.writeListBegin(ThriftBinaryWriter::Type::Struct, annotations_.size());
+  for (const Annotation& annotation : annotations_) {
+    annotation.toThrift(writer);
+  }
+
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::List, 8);
+  writer.writeListBegin(ThriftBinaryWriter::Type::Struct, binary_annotations_.size());
+  for (const BinaryAnnotation& binary_annotation : binary_annotations_) {
+    binary_annotation.toThrift(writer);
+  }
+
+  if (debug_) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::Bool, 9);
+    writer.writeBool(true);
+  }
+
+  if (timestamp_.valid()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 10);
+    writer.writeI64(timestamp_.value());
+  }
+
+  if (duration_.valid()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 11);
+    writer.writeI64(duration_.value());
+  }
+
+  if (trace_id_high_.valid()) {
+    writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 12);
+    writer.writeI64(trace_id_high_.value());
+  }
+
+  writer.writeFieldStop();
+}
+
 void Span::finish() {
   // Assumption: Span will have only one annotation when this method is called
   SpanContext context(*this);
@@ -29,6 +29,12 @@ public:
    * the corresponding abstraction to a Zipkin-compliant JSON.
    */
   virtual const std::string toJson() PURE;
+
+  /**
+   * All classes defining Zipkin abstractions need to implement this method to append
+   * the corresponding abstraction, encoded as its Zipkin Thrift struct, to a writer.
+   */
+  virtual void toThrift(ThriftBinaryWriter& writer) const PURE;
 };
 
 /**
@@ -88,6 +94,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the endpoint as a Zipkin Thrift struct.
+   */
+  void toThrift(ThriftBinaryWriter& writer) const override;
+
 private:
   std::string service_name_;
   Network::Address::InstanceConstSharedPtr address_;
@@ -180,6 +191,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the annotation as a Zipkin Thrift struct.
+   */
+  void toThrift(ThriftBinaryWriter& writer) const override;
+
 private:
   uint64_t timestamp_;
   std::string value_;
@@ -279,6 +295,11 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the binary annotation as a Zipkin Thrift struct.
+   */
+  void toThrift(ThriftBinaryWriter& writer) const override;
+
 private:
   std::string key_;
   std::string value_;
@@ -298,6 +319,17 @@ public:
    */
   Span(const Span&);
 
+  /**
+   * Move constructor. Moves the annotations rather than copying them.
+   */
+  Span(Span&&) = default;
+
+  /**
+   * Assignment operators.
+   */
+  Span& operator=(const Span&) = default;
+  Span& operator=(Span&&) = default;
+
   /**
    * Default constructor. Creates an empty span.
    */
@@ -496,6 +528,12 @@ public:
    */
   const std::string toJson() override;
 
+  /**
+   * Serializes the span as a Zipkin Thrift struct. A list of spans encoded this way can be
+   * sent to Zipkin with an HTTP POST call with the application/x-thrift content type.
+   */
+  void toThrift(ThriftBinaryWriter& writer) const override;
+
   /**
    * Associates a Tracer object with the span. The tracer's reportSpan() method is invoked
    * by the span's finish() method so that the tracer can decide what to do with the span
@@ -1,8 +1,10 @@
 #include "common/tracing/zipkin/zipkin_tracer_impl.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
 #include "common/common/utility.h"
+#include "common/compressor/zlib_compressor_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
 #include "common/http/utility.h"
@@ -11,6 +13,13 @@
 
 namespace Envoy {
 namespace Zipkin {
+namespace {
+
+// The largest window, plus 16 so that zlib writes a gzip header and trailer rather than zlib ones.
+const int64_t GzipWindowBits = 15 + 16;
+const uint64_t GzipMemoryLevel = 8;
+
+} // namespace
 
 ZipkinSpan::ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer) : span_(span), tracer_(tracer) {}
 
@@ -64,6 +73,22 @@ Driver::Driver(const Json::Object& config, Upstream::ClusterManager& cluster_man
   }
   cluster_ = cluster->info();
 
+  const std::string collector_encoding = config.getString("collector_encoding", "json");
+  if (collector_encoding == "json") {
+    collector_encoding_ = CollectorEncoding::Json;
+  } else if (collector_encoding == "thrift") {
+    collector_encoding_ = CollectorEncoding::Thrift;
+  } else {
+    throw EnvoyException(fmt::format("unknown zipkin collector encoding '{}'", collector_encoding));
+  }
+
+  const std::string collector_compression = config.getString("collector_compression", "none");
+  if (collector_compression != "none" && collector_compression != "gzip") {
+    throw EnvoyException(
+        fmt::format("unknown zipkin collector compression '{}'", collector_compression));
+  }
+  gzip_spans_ = collector_compression == "gzip";
+
   const std::string collector_endpoint =
       config.getString("collector_endpoint", ZipkinCoreConstants::get().DEFAULT_COLLECTOR_ENDPOINT);
 
@@ -149,9 +174,8 @@ ReporterPtr ReporterImpl::NewInstance(Driver& driver, Event::Dispatcher& dispatc
   return ReporterPtr(new ReporterImpl(driver, dispatcher, collector_endpoint));
 }
 
-// TODO(fabolive): Need to avoid the copy to improve performance.
-void ReporterImpl::reportSpan(const Span& span) {
-  span_buffer_.addSpan(span);
+void ReporterImpl::reportSpan(Span&& span) {
+  span_buffer_.addSpan(std::move(span));
 
   const uint64_t min_flush_spans =
       driver_.runtime().snapshot().getInteger("tracing.zipkin.min_flush_spans", 5U);
@@ -171,16 +195,36 @@ void ReporterImpl::flushSpans() {
   if (span_buffer_.pendingSpans()) {
     driver_.tracerStats().spans_sent_.add(span_buffer_.pendingSpans());
 
-    const std::string request_body = span_buffer_.toStringifiedJsonArray();
     Http::MessagePtr message(new Http::RequestMessageImpl());
     message->headers().insertMethod().value().setReference(Http::Headers::get().MethodValues.Post);
     message->headers().insertPath().value(collector_endpoint_);
     message->headers().insertHost().value(driver_.cluster()->name());
-    message->headers().insertContentType().value().setReference(
-        Http::Headers::get().ContentTypeValues.Json);
 
     Buffer::InstancePtr body(new Buffer::OwnedImpl());
-    body->add(request_body);
+    if (driver_.collectorEncoding() == CollectorEncoding::Thrift) {
+      message->headers().insertContentType().value().setReference(
+          Http::Headers::get().ContentTypeValues.Thrift);
+      body->add(span_buffer_.toThriftList());
+    } else {
+      message->headers().insertContentType().value().setReference(
+          Http::Headers::get().ContentTypeValues.Json);
+      body->add(span_buffer_.toStringifiedJsonArray());
+    }
+
+    if (driver_.gzipSpans()) {
+      // Spans are compressed for speed, since the point of batching them is to keep the cost of
+      // tracing down.
+      Compressor::ZlibCompressorImpl compressor;
+      compressor.init(Compressor::ZlibCompressorImpl::CompressionLevel::Speed,
+                      Compressor::ZlibCompressorImpl::CompressionStrategy::Standard, GzipWindowBits,
+                      GzipMemoryLevel);
+      Buffer::InstancePtr compressed_body(new Buffer::OwnedImpl());
+      compressor.compress(*body, *compressed_body);
+      compressor.finish(*compressed_body);
+      body = std::move(compressed_body);
+      message->headers().addReference(Http::Headers::get().ContentEncoding,
+                                      Http::Headers::get().ContentEncodingValues.Gzip);
+    }
     message->body() = std::move(body);
 
     const uint64_t timeout =
@@ -25,6 +25,11 @@ struct ZipkinTracerStats {
   ZIPKIN_TRACER_STATS(GENERATE_COUNTER_STRUCT)
 };
 
+/**
+ * Encodings that spans can be sent to the Zipkin collector in.
+ */
+enum class CollectorEncoding { Json, Thrift };
+
 /**
  * Class for Zipkin spans, wrapping a Zipkin::Span object.
  */
@@ -83,6 +88,9 @@ public:
   /**
    * Constructor. It adds itself and a newly-created Zipkin::Tracer object to a thread-local store.
    * Also, it associates the given random-number generator to the Zipkin::Tracer object it creates.
+   *
+   * Besides the collector cluster and endpoint, the config can set "collector_encoding" to "json"
+   * (the default) or "thrift", and "collector_compression" to "none" (the default) or "gzip".
    */
   Driver(const Json::Object& config, Upstream::ClusterManager& cluster_manager, Stats::Store& stats,
          ThreadLocal::SlotAllocator& tls, Runtime::Loader& runtime,
@@ -106,6 +114,8 @@ public:
   Upstream::ClusterInfoConstSharedPtr cluster() { return cluster_; }
   Runtime::Loader& runtime() { return runtime_; }
   ZipkinTracerStats& tracerStats() { return tracer_stats_; }
+  CollectorEncoding collectorEncoding() const { return collector_encoding_; }
+  bool gzipSpans() const { return gzip_spans_; }
 
 private:
   /**
@@ -124,12 +134,14 @@ private:
   ThreadLocal::SlotPtr tls_;
   Runtime::Loader& runtime_;
   const LocalInfo::LocalInfo& local_info_;
+  CollectorEncoding collector_encoding_;
+  bool gzip_spans_;
 };
 
 /**
  * This class derives from the abstract Zipkin::Reporter.
  * It buffers spans and relies on Http::AsyncClient to send spans to
- * Zipkin using JSON over HTTP.
+ * Zipkin using JSON or Thrift over HTTP, optionally compressed with gzip.
  *
  * Two runtime parameters control the span buffering/flushing behavior, namely:
  * tracing.zipkin.min_flush_spans and tracing.zipkin.flush_interval_ms.
@@ -161,7 +173,7 @@ public:
    *
    * @param span The span to be buffered.
    */
-  void reportSpan(const Span& span) override;
+  void reportSpan(Span&& span) override;
 
   // Http::AsyncClient::Callbacks.
   // The callbacks below record Zipkin-span-related stats.
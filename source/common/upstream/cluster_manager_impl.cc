@@ -28,6 +28,7 @@
 #include "common/router/shadow_writer_impl.h"
 #include "common/upstream/cds_api_impl.h"
 #include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/maglev_lb.h"
 #include "common/upstream/original_dst_cluster.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/subset_lb.h"
@@ -170,7 +171,8 @@ ClusterManagerImpl::ClusterManagerImpl(const envoy::config::bootstrap::v2::Boots
                                        AccessLog::AccessLogManager& log_manager,
                                        Event::Dispatcher& primary_dispatcher)
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls.allocateSlot()),
-      random_(random), local_info_(local_info), cm_stats_(generateStats(stats)),
+      random_(random), primary_dispatcher_(primary_dispatcher), local_info_(local_info),
+      cm_stats_(generateStats(stats)),
       init_helper_([this](Cluster& cluster) { onClusterInit(cluster); }) {
   async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(*this, tls);
   const auto& cm_config = bootstrap.cluster_manager();
@@ -303,7 +305,8 @@ ClusterManagerImpl::ClusterManagerImpl(const envoy::config::bootstrap::v2::Boots
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                    POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                    POOL_GAUGE_PREFIX(scope, final_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
 }
 
 void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
@@ -322,7 +325,7 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
                        const std::vector<HostSharedPtr>& hosts_removed) {
         // This fires when a cluster is about to have an updated member set. We need to send this
         // out to all of the thread local configurations.
-        postThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
+        scheduleThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
       });
 
   // Finally, if the cluster has any hosts, post updates cross-thread so the per-thread load
@@ -332,7 +335,7 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
       continue;
     }
     postThreadLocalClusterUpdate(cluster, host_set->priority(), host_set->hosts(),
-                                 std::vector<HostSharedPtr>{});
+                                 std::vector<HostSharedPtr>{}, std::chrono::steady_clock::now());
   }
 }
 
@@ -349,6 +352,8 @@ bool ClusterManagerImpl::addOrUpdatePrimaryCluster(const envoy::api::v2::Cluster
 
   if (existing_cluster != primary_clusters_.end()) {
     init_helper_.removeCluster(*existing_cluster->second.cluster_);
+    // The new cluster posts all of its hosts once it initializes.
+    pending_cluster_updates_.erase(cluster_name);
   }
 
   loadCluster(cluster, true);
@@ -385,6 +390,7 @@ bool ClusterManagerImpl::removePrimaryCluster(const std::string& cluster_name) {
   }
 
   init_helper_.removeCluster(*existing_cluster->second.cluster_);
+  pending_cluster_updates_.erase(cluster_name);
   primary_clusters_.erase(existing_cluster);
   cm_stats_.cluster_removed_.inc();
   cm_stats_.total_clusters_.set(primary_clusters_.size());
@@ -444,6 +450,10 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster, boo
     cluster_entry_it->second.thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
         primary_cluster_reference.prioritySet(), primary_cluster_reference.info()->stats(),
         runtime_, random_, primary_cluster_reference.info()->lbRingHashConfig());
+  } else if (primary_cluster_reference.info()->lbType() == LoadBalancerType::Maglev) {
+    cluster_entry_it->second.thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
+        primary_cluster_reference.prioritySet(), primary_cluster_reference.info()->stats(),
+        runtime_, random_);
   }
 
   cm_stats_.total_clusters_.set(primary_clusters_.size());
@@ -479,10 +489,67 @@ ClusterManagerImpl::httpConnPoolForCluster(const std::string& cluster, ResourceP
   return entry->second->connPool(priority, protocol, context);
 }
 
-void ClusterManagerImpl::postThreadLocalClusterUpdate(
+void ClusterManagerImpl::scheduleThreadLocalClusterUpdate(
     const Cluster& primary_cluster, uint32_t priority,
     const std::vector<HostSharedPtr>& hosts_added,
     const std::vector<HostSharedPtr>& hosts_removed) {
+  const std::string& name = primary_cluster.info()->name();
+  const uint64_t merge_window_ms =
+      runtime_.snapshot().getInteger("upstream.membership_update_merge_window_ms", 0);
+  auto pending = pending_cluster_updates_.find(name);
+  if (merge_window_ms == 0 &&
+      (pending == pending_cluster_updates_.end() || pending->second.host_changes_.empty())) {
+    postThreadLocalClusterUpdate(primary_cluster, priority, hosts_added, hosts_removed,
+                                 std::chrono::steady_clock::now());
+    return;
+  }
+
+  PendingClusterUpdate& update = pending_cluster_updates_[name];
+  if (update.host_changes_.empty()) {
+    if (update.timer_ == nullptr) {
+      update.timer_ =
+          primary_dispatcher_.createTimer([this, name]() { flushThreadLocalClusterUpdate(name); });
+    }
+    update.timer_->enableTimer(std::chrono::milliseconds(merge_window_ms));
+    update.first_update_time_ = std::chrono::steady_clock::now();
+  } else {
+    cm_stats_.membership_update_merged_.inc();
+  }
+
+  // A host that is added and then removed within the window, or the other way around, cancels out.
+  // The host set snapshot is taken when the update is posted, so only the changes need merging.
+  PendingClusterUpdate::HostChanges& changes = update.host_changes_[priority];
+  for (const HostSharedPtr& host : hosts_added) {
+    if (changes.hosts_removed_.erase(host) == 0) {
+      changes.hosts_added_.insert(host);
+    }
+  }
+  for (const HostSharedPtr& host : hosts_removed) {
+    if (changes.hosts_added_.erase(host) == 0) {
+      changes.hosts_removed_.insert(host);
+    }
+  }
+}
+
+void ClusterManagerImpl::flushThreadLocalClusterUpdate(const std::string& cluster_name) {
+  PendingClusterUpdate& update = pending_cluster_updates_.at(cluster_name);
+  const Cluster& primary_cluster = *primary_clusters_.at(cluster_name).cluster_;
+  for (const auto& changes : update.host_changes_) {
+    postThreadLocalClusterUpdate(
+        primary_cluster, changes.first,
+        std::vector<HostSharedPtr>(changes.second.hosts_added_.begin(),
+                                   changes.second.hosts_added_.end()),
+        std::vector<HostSharedPtr>(changes.second.hosts_removed_.begin(),
+                                   changes.second.hosts_removed_.end()),
+        update.first_update_time_);
+  }
+  update.host_changes_.clear();
+}
+
+void ClusterManagerImpl::postThreadLocalClusterUpdate(
+    const Cluster& primary_cluster, uint32_t priority,
+    const std::vector<HostSharedPtr>& hosts_added,
+    const std::vector<HostSharedPtr>& hosts_removed, MonotonicTime update_time) {
   const auto& host_set = primary_cluster.prioritySet().hostSetsPerPriority()[priority];
 
   HostVectorConstSharedPtr hosts_copy(new std::vector<HostSharedPtr>(host_set->hosts()));
@@ -495,13 +562,18 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(
 
   tls_->runOnAllThreads([
     this, name = primary_cluster.info()->name(), priority, hosts_copy, healthy_hosts_copy,
-    hosts_per_locality_copy, healthy_hosts_per_locality_copy, hosts_added, hosts_removed
+    hosts_per_locality_copy, healthy_hosts_per_locality_copy, hosts_added, hosts_removed,
+    update_time
   ]()
                             ->void {
                               ThreadLocalClusterManagerImpl::updateClusterMembership(
                                   name, priority, hosts_copy, healthy_hosts_copy,
                                   hosts_per_locality_copy, healthy_hosts_per_locality_copy,
                                   hosts_added, hosts_removed, *tls_);
+                              cm_stats_.membership_update_lag_ms_.recordValue(
+                                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - update_time)
+                                      .count());
                             });
 }
 
@@ -709,7 +781,8 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                                            parent.parent_.random_));
       break;
     }
-    case LoadBalancerType::RingHash: {
+    case LoadBalancerType::RingHash:
+    case LoadBalancerType::Maglev: {
       ASSERT(lb_factory_ != nullptr);
       lb_ = lb_factory_->create();
       break;
@@ -4,12 +4,16 @@
 #include <cstdint>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/http/codes.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/runtime/runtime.h"
@@ -124,18 +128,21 @@ private:
  * All cluster manager stats. @see stats_macros.h
  */
 // clang-format off
-#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                                  \
-  COUNTER(cluster_added)                                                                           \
-  COUNTER(cluster_modified)                                                                        \
-  COUNTER(cluster_removed)                                                                         \
-  GAUGE  (total_clusters)
+#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE, HISTOGRAM)                                       \
+  COUNTER  (cluster_added)                                                                         \
+  COUNTER  (cluster_modified)                                                                      \
+  COUNTER  (cluster_removed)                                                                       \
+  COUNTER  (membership_update_merged)                                                              \
+  GAUGE    (total_clusters)                                                                        \
+  HISTOGRAM(membership_update_lag_ms)
 // clang-format on
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ClusterManagerStats {
-  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                            GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -175,6 +182,7 @@ public:
   bool removePrimaryCluster(const std::string& cluster) override;
   void shutdown() override {
     cds_api_.reset();
+    pending_cluster_updates_.clear();
     primary_clusters_.clear();
   }
 
@@ -280,12 +288,35 @@ private:
     ThreadAwareLoadBalancerPtr thread_aware_lb_;
   };
 
+  /**
+   * Membership changes of a cluster that are waiting to be posted to the workers. Changes that
+   * happen within the merge window are merged, so that the workers only rebuild their host sets
+   * and load balancers once per window rather than once per change.
+   */
+  struct PendingClusterUpdate {
+    struct HostChanges {
+      std::unordered_set<HostSharedPtr> hosts_added_;
+      std::unordered_set<HostSharedPtr> hosts_removed_;
+    };
+
+    Event::TimerPtr timer_;
+    // Time of the first change that is waiting to be posted.
+    MonotonicTime first_update_time_;
+    // Changes waiting to be posted, by priority.
+    std::map<uint32_t, HostChanges> host_changes_;
+  };
+
   static ClusterManagerStats generateStats(Stats::Scope& scope);
   void loadCluster(const envoy::api::v2::Cluster& cluster, bool added_via_api);
   void onClusterInit(Cluster& cluster);
+  void scheduleThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
+                                        const std::vector<HostSharedPtr>& hosts_added,
+                                        const std::vector<HostSharedPtr>& hosts_removed);
+  void flushThreadLocalClusterUpdate(const std::string& cluster_name);
   void postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
                                     const std::vector<HostSharedPtr>& hosts_added,
-                                    const std::vector<HostSharedPtr>& hosts_removed);
+                                    const std::vector<HostSharedPtr>& hosts_removed,
+                                    MonotonicTime update_time);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
 
   ClusterManagerFactory& factory_;
@@ -294,6 +325,9 @@ private:
   ThreadLocal::SlotPtr tls_;
   Runtime::RandomGenerator& random_;
   std::unordered_map<std::string, PrimaryClusterData> primary_clusters_;
+  // Merged membership changes waiting to be posted to the workers, by cluster name.
+  std::unordered_map<std::string, PendingClusterUpdate> pending_cluster_updates_;
+  Event::Dispatcher& primary_dispatcher_;
   Optional<envoy::api::v2::ConfigSource> eds_config_;
   Network::Address::InstanceConstSharedPtr source_address_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
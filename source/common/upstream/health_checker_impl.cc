@@ -15,6 +15,7 @@
 #include "common/buffer/zero_copy_input_stream_impl.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
+#include "common/common/hash.h"
 #include "common/common/hex.h"
 #include "common/common/utility.h"
 #include "common/grpc/common.h"
@@ -37,11 +38,13 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(const envoy::api::v2::Health
   switch (hc_config.health_checker_case()) {
   case envoy::api::v2::HealthCheck::HealthCheckerCase::kHttpHealthCheck:
     return std::make_shared<ProdHttpHealthCheckerImpl>(cluster, hc_config, dispatcher, runtime,
-                                                       random);
+                                                       random, ProdMonotonicTimeSource::instance_);
   case envoy::api::v2::HealthCheck::HealthCheckerCase::kTcpHealthCheck:
-    return std::make_shared<TcpHealthCheckerImpl>(cluster, hc_config, dispatcher, runtime, random);
+    return std::make_shared<TcpHealthCheckerImpl>(cluster, hc_config, dispatcher, runtime, random,
+                                                  ProdMonotonicTimeSource::instance_);
   case envoy::api::v2::HealthCheck::HealthCheckerCase::kRedisHealthCheck:
     return std::make_shared<RedisHealthCheckerImpl>(cluster, hc_config, dispatcher, runtime, random,
+                                                    ProdMonotonicTimeSource::instance_,
                                                     Redis::ConnPool::ClientFactoryImpl::instance_);
   case envoy::api::v2::HealthCheck::HealthCheckerCase::kGrpcHealthCheck:
     if (!(cluster.info()->features() & Upstream::ClusterInfo::Features::HTTP2)) {
@@ -49,7 +52,7 @@ HealthCheckerSharedPtr HealthCheckerFactory::create(const envoy::api::v2::Health
                                        cluster.info()->name()));
     }
     return std::make_shared<ProdGrpcHealthCheckerImpl>(cluster, hc_config, dispatcher, runtime,
-                                                       random);
+                                                       random, ProdMonotonicTimeSource::instance_);
   default:
     // TODO(htuch): This should be subsumed eventually by the constraint checking in #1308.
     throw EnvoyException("Health checker type not set");
@@ -62,7 +65,8 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
                                              const envoy::api::v2::HealthCheck& config,
                                              Event::Dispatcher& dispatcher,
                                              Runtime::Loader& runtime,
-                                             Runtime::RandomGenerator& random)
+                                             Runtime::RandomGenerator& random,
+                                             MonotonicTimeSource& time_source)
     : cluster_(cluster), dispatcher_(dispatcher),
       timeout_(PROTOBUF_GET_MS_REQUIRED(config, timeout)),
       unhealthy_threshold_(PROTOBUF_GET_WRAPPED_REQUIRED(config, unhealthy_threshold)),
@@ -70,7 +74,19 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       stats_(generateStats(cluster.info()->statsScope())), runtime_(runtime), random_(random),
       reuse_connection_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, reuse_connection, true)),
       interval_(PROTOBUF_GET_MS_REQUIRED(config, interval)),
-      interval_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_jitter, 0)) {
+      interval_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_jitter, 0)),
+      shard_count_(runtime.snapshot().getInteger("health_check.shard_count", 1)),
+      shard_index_(runtime.snapshot().getInteger("health_check.shard_index", 0)),
+      shared_state_max_age_(
+          runtime.snapshot().getInteger("health_check.shared_state_max_age_ms", 60000)),
+      shared_state_key_("health_check.shared_state." + cluster.info()->name()),
+      time_source_(time_source) {
+  // With an out of range index, no host would hash to the shard of this proxy.
+  if (shard_count_ > 1 && shard_index_ >= shard_count_) {
+    throw EnvoyException(
+        fmt::format("health_check.shard_index {} must be less than health_check.shard_count {}",
+                    shard_index_, shard_count_));
+  }
   cluster_.prioritySet().addMemberUpdateCb(
       [this](uint32_t, const std::vector<HostSharedPtr>& hosts_added,
              const std::vector<HostSharedPtr>& hosts_removed) -> void {
@@ -139,12 +155,45 @@ void HealthCheckerImplBase::onClusterMemberUpdate(const std::vector<HostSharedPt
   }
 }
 
+bool HealthCheckerImplBase::ownsHost(const Host& host) const {
+  if (shard_count_ <= 1) {
+    return true;
+  }
+  return HashUtil::xxHash64(host.address()->asString()) % shard_count_ == shard_index_;
+}
+
 void HealthCheckerImplBase::refreshHealthyStat() {
   // Each hot restarted process health checks independently. To make the stats easier to read,
   // we assume that both processes will converge and the last one that writes wins for the host.
   stats_.healthy_.set(local_process_healthy_);
 }
 
+bool HealthCheckerImplBase::refreshSharedState() {
+  const MonotonicTime now = time_source_.currentTime();
+  // The value only changes when the aggregator writes it, so it is parsed again only then.
+  const std::string& shared_state = runtime_.snapshot().get(shared_state_key_);
+  if (shared_state != shared_state_) {
+    shared_state_ = shared_state;
+    shared_state_unhealthy_hosts_.clear();
+    std::vector<absl::string_view> tokens = StringUtil::splitToken(shared_state_, " \t\r\n");
+    const std::string version = tokens.empty() ? EMPTY_STRING : std::string(tokens[0]);
+    if (version != shared_state_version_) {
+      shared_state_version_ = version;
+      shared_state_version_time_ = now;
+    }
+    for (size_t i = 1; i < tokens.size(); i++) {
+      shared_state_unhealthy_hosts_.emplace(std::string(tokens[i]));
+    }
+  }
+
+  // A missing value, or one the aggregator has stopped updating, can't be trusted.
+  return !shared_state_version_.empty() && now - shared_state_version_time_ < shared_state_max_age_;
+}
+
+bool HealthCheckerImplBase::sharedStateUnhealthy(const Host& host) const {
+  return shared_state_unhealthy_hosts_.count(host.address()->asString()) > 0;
+}
+
 void HealthCheckerImplBase::runCallbacks(HostSharedPtr host, bool changed_state) {
   // When a parent process shuts down, it will kill all of the active health checking sessions,
   // which will decrement the healthy count and the healthy stat in the parent. If the child is
@@ -197,7 +246,7 @@ void HealthCheckerImplBase::start() {
 
 HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
-    : host_(host), parent_(parent),
+    : host_(host), parent_(parent), owned_(parent.ownsHost(*host)),
       interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
       timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })) {
 
@@ -213,6 +262,14 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess() {
+  parent_.stats_.success_.inc();
+  applyHealthyResult();
+
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval());
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::applyHealthyResult() {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -228,15 +285,22 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess() {
     }
   }
 
-  parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
-
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval());
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(FailureType type) {
+  parent_.stats_.failure_.inc();
+  if (type == FailureType::Network) {
+    parent_.stats_.network_failure_.inc();
+  } else if (type == FailureType::Passive) {
+    parent_.stats_.passive_failure_.inc();
+  }
+
+  applyUnhealthyResult(type);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::applyUnhealthyResult(FailureType type) {
   // If we are unhealthy, reset the # of healthy to zero.
   num_healthy_ = 0;
 
@@ -249,13 +313,6 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(FailureType t
     }
   }
 
-  parent_.stats_.failure_.inc();
-  if (type == FailureType::Network) {
-    parent_.stats_.network_failure_.inc();
-  } else if (type == FailureType::Passive) {
-    parent_.stats_.passive_failure_.inc();
-  }
-
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
 }
@@ -266,7 +323,36 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(FailureType
   interval_timer_->enableTimer(parent_.interval());
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  if (!owned_) {
+    // Read the shared state on the next loop iteration rather than while the host is being added,
+    // as the result may update the host set.
+    interval_timer_->enableTimer(std::chrono::milliseconds(0));
+    return;
+  }
+  onIntervalBase();
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (!owned_) {
+    if (parent_.refreshSharedState()) {
+      // Another proxy actively checks this host. Its result goes through the same thresholds as
+      // our own checks, so that passive failures are not cleared by a single shared state update.
+      // It is not counted as a success or failure, as this proxy made no check.
+      parent_.stats_.shard_skipped_.inc();
+      if (parent_.sharedStateUnhealthy(*host_)) {
+        applyUnhealthyResult(FailureType::Active);
+      } else {
+        applyHealthyResult();
+      }
+      interval_timer_->enableTimer(parent_.interval());
+      return;
+    }
+
+    // The shared state is missing or no longer updated. Check the host here until it is.
+    parent_.stats_.shared_state_stale_.inc();
+  }
+
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
@@ -281,8 +367,9 @@ HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
                                              const envoy::api::v2::HealthCheck& config,
                                              Event::Dispatcher& dispatcher,
                                              Runtime::Loader& runtime,
-                                             Runtime::RandomGenerator& random)
-    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random),
+                                             Runtime::RandomGenerator& random,
+                                             MonotonicTimeSource& time_source)
+    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random, time_source),
       path_(config.http_health_check().path()) {
   if (!config.http_health_check().service_name().empty()) {
     service_name_.value(config.http_health_check().service_name());
@@ -437,8 +524,10 @@ bool TcpHealthCheckMatcher::match(const MatchSegments& expected, const Buffer::I
 TcpHealthCheckerImpl::TcpHealthCheckerImpl(const Cluster& cluster,
                                            const envoy::api::v2::HealthCheck& config,
                                            Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                                           Runtime::RandomGenerator& random)
-    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random), send_bytes_([&config] {
+                                           Runtime::RandomGenerator& random,
+                                           MonotonicTimeSource& time_source)
+    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random, time_source),
+      send_bytes_([&config] {
         Protobuf::RepeatedPtrField<envoy::api::v2::HealthCheck::Payload> send_repeated;
         if (!config.tcp_health_check().send().text().empty()) {
           send_repeated.Add()->CopyFrom(config.tcp_health_check().send());
@@ -525,8 +614,9 @@ RedisHealthCheckerImpl::RedisHealthCheckerImpl(const Cluster& cluster,
                                                Event::Dispatcher& dispatcher,
                                                Runtime::Loader& runtime,
                                                Runtime::RandomGenerator& random,
+                                               MonotonicTimeSource& time_source,
                                                Redis::ConnPool::ClientFactory& client_factory)
-    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random),
+    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random, time_source),
       client_factory_(client_factory) {}
 
 RedisHealthCheckerImpl::RedisActiveHealthCheckSession::RedisActiveHealthCheckSession(
@@ -600,8 +690,9 @@ GrpcHealthCheckerImpl::GrpcHealthCheckerImpl(const Cluster& cluster,
                                              const envoy::api::v2::HealthCheck& config,
                                              Event::Dispatcher& dispatcher,
                                              Runtime::Loader& runtime,
-                                             Runtime::RandomGenerator& random)
-    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random),
+                                             Runtime::RandomGenerator& random,
+                                             MonotonicTimeSource& time_source)
+    : HealthCheckerImplBase(cluster, config, dispatcher, runtime, random, time_source),
       service_method_(*Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
           "grpc.health.v1.Health.Check")) {
   if (!config.grpc_health_check().service_name().empty()) {
@@ -6,9 +6,11 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/api/v2/health_check.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/event/timer.h"
 #include "envoy/grpc/status.h"
 #include "envoy/http/codec.h"
@@ -60,6 +62,8 @@ public:
   COUNTER(passive_failure)                                                                         \
   COUNTER(network_failure)                                                                         \
   COUNTER(verify_cluster)                                                                          \
+  COUNTER(shard_skipped)                                                                           \
+  COUNTER(shared_state_stale)                                                                      \
   GAUGE  (healthy)
 // clang-format on
 
@@ -72,6 +76,20 @@ struct HealthCheckerStats {
 
 /**
  * Base implementation for all health checkers.
+ *
+ * Health checking can be sharded across a fleet of proxies by setting the health_check.shard_count
+ * runtime key to the number of shards and health_check.shard_index to the shard of this proxy,
+ * which must be less than the number of shards. Each proxy then only actively checks the hosts
+ * whose address hashes to its shard. The shard settings are read when the health checker is
+ * created, so a change applies to a cluster once it is next created or updated, rather than moving
+ * hosts between shards while they are checked.
+ *
+ * The state of the other hosts is read from the health_check.shared_state.<cluster name> runtime
+ * key, which an aggregator of the fleet's results keeps up to date. The value is a version, which
+ * the aggregator changes on every write, followed by the whitespace separated addresses of the
+ * unhealthy hosts. Hosts that are not listed are considered healthy. If the value is missing, or
+ * its version has not changed for health_check.shared_state_max_age_ms (60 seconds by default),
+ * the hosts of the other shards are checked locally until it is updated again.
  */
 class HealthCheckerImplBase : public HealthChecker,
                               protected Logger::Loggable<Logger::Id::hc>,
@@ -88,7 +106,7 @@ protected:
 
     virtual ~ActiveHealthCheckSession();
     void setUnhealthy(FailureType type);
-    void start() { onIntervalBase(); }
+    void start();
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -99,12 +117,18 @@ protected:
     HostSharedPtr host_;
 
   private:
+    // Apply a check result to the health flags and thresholds of the host, without counting it as
+    // a check made by this proxy.
+    void applyHealthyResult();
+    void applyUnhealthyResult(FailureType type);
     virtual void onInterval() PURE;
     void onIntervalBase();
     virtual void onTimeout() PURE;
     void onTimeoutBase();
 
     HealthCheckerImplBase& parent_;
+    // Whether the host is in the shard of this proxy.
+    const bool owned_;
     Event::TimerPtr interval_timer_;
     Event::TimerPtr timeout_timer_;
     uint32_t num_unhealthy_{};
@@ -116,7 +140,7 @@ protected:
 
   HealthCheckerImplBase(const Cluster& cluster, const envoy::api::v2::HealthCheck& config,
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                        Runtime::RandomGenerator& random);
+                        Runtime::RandomGenerator& random, MonotonicTimeSource& time_source);
 
   virtual ActiveHealthCheckSessionPtr makeSession(HostSharedPtr host) PURE;
 
@@ -150,7 +174,10 @@ private:
   std::chrono::milliseconds interval() const;
   void onClusterMemberUpdate(const std::vector<HostSharedPtr>& hosts_added,
                              const std::vector<HostSharedPtr>& hosts_removed);
+  bool ownsHost(const Host& host) const;
   void refreshHealthyStat();
+  bool refreshSharedState();
+  bool sharedStateUnhealthy(const Host& host) const;
   void runCallbacks(HostSharedPtr host, bool changed_state);
   void setUnhealthyCrossThread(const HostSharedPtr& host);
 
@@ -161,6 +188,17 @@ private:
   const std::chrono::milliseconds interval_jitter_;
   std::unordered_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   uint64_t local_process_healthy_{};
+  const uint64_t shard_count_;
+  const uint64_t shard_index_;
+  const std::chrono::milliseconds shared_state_max_age_;
+  const std::string shared_state_key_;
+  MonotonicTimeSource& time_source_;
+  // The last shared state runtime value, and the version and unhealthy host addresses parsed from
+  // it. shared_state_version_time_ is when the version was first seen.
+  std::string shared_state_;
+  std::string shared_state_version_;
+  MonotonicTime shared_state_version_time_;
+  std::unordered_set<std::string> shared_state_unhealthy_hosts_;
 };
 
 /**
@@ -170,7 +208,7 @@ class HttpHealthCheckerImpl : public HealthCheckerImplBase {
 public:
   HttpHealthCheckerImpl(const Cluster& cluster, const envoy::api::v2::HealthCheck& config,
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                        Runtime::RandomGenerator& random);
+                        Runtime::RandomGenerator& random, MonotonicTimeSource& time_source);
 
 private:
   struct HttpActiveHealthCheckSession : public ActiveHealthCheckSession,
@@ -305,7 +343,7 @@ class TcpHealthCheckerImpl : public HealthCheckerImplBase {
 public:
   TcpHealthCheckerImpl(const Cluster& cluster, const envoy::api::v2::HealthCheck& config,
                        Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                       Runtime::RandomGenerator& random);
+                       Runtime::RandomGenerator& random, MonotonicTimeSource& time_source);
 
 private:
   struct TcpActiveHealthCheckSession;
@@ -363,7 +401,7 @@ class RedisHealthCheckerImpl : public HealthCheckerImplBase {
 public:
   RedisHealthCheckerImpl(const Cluster& cluster, const envoy::api::v2::HealthCheck& config,
                          Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                         Runtime::RandomGenerator& random,
+                         Runtime::RandomGenerator& random, MonotonicTimeSource& time_source,
                          Redis::ConnPool::ClientFactory& client_factory);
 
   static const Redis::RespValue& healthCheckRequest() {
@@ -389,6 +427,8 @@ private:
       // Allow the main HC infra to control timeout.
       return parent_.timeout_ * 2;
     }
+    uint32_t maxConnectionsPerHost() const override { return 1; }
+    bool enableCommandBatching() const override { return false; }
 
     // Redis::ConnPool::PoolCallbacks
     void onResponse(Redis::RespValuePtr&& value) override;
@@ -427,7 +467,7 @@ class GrpcHealthCheckerImpl : public HealthCheckerImplBase {
 public:
   GrpcHealthCheckerImpl(const Cluster& cluster, const envoy::api::v2::HealthCheck& config,
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
-                        Runtime::RandomGenerator& random);
+                        Runtime::RandomGenerator& random, MonotonicTimeSource& time_source);
 
 private:
   struct GrpcActiveHealthCheckSession : public ActiveHealthCheckSession,
@@ -0,0 +1,85 @@
+#include "common/upstream/maglev_lb.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+
+// Marks table entries that no host has claimed yet.
+const uint32_t UnassignedEntry = std::numeric_limits<uint32_t>::max();
+
+// A host's permutation of the table, walked one entry at a time while the table is populated.
+struct Permutation {
+  uint64_t next_;
+  uint64_t skip_;
+};
+
+} // namespace
+
+const uint64_t MaglevTable::DefaultTableSize;
+
+MaglevTable::MaglevTable(const std::vector<HostSharedPtr>& hosts, uint64_t table_size) {
+  ENVOY_LOG(trace, "maglev: building table");
+  if (hosts.empty()) {
+    return;
+  }
+  ASSERT(table_size > 1);
+  ASSERT(hosts.size() < UnassignedEntry);
+
+  // A host's permutation starts at offset and then visits every skip-th entry. Both are derived
+  // from the host's address so that a host keeps its preferences as other hosts come and go.
+  std::vector<Permutation> permutations;
+  permutations.reserve(hosts.size());
+  hosts_.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    const std::string& address_string = host->address()->asString();
+    const uint64_t offset = HashUtil::xxHash64(address_string) % table_size;
+    const uint64_t skip = HashUtil::xxHash64(address_string, 1) % (table_size - 1) + 1;
+    ENVOY_LOG(trace, "maglev: host={} offset={} skip={}", address_string, offset, skip);
+    permutations.push_back({offset, skip});
+    hosts_.push_back(host);
+  }
+
+  // Hosts take turns claiming the next entry of their permutation that is still unassigned, until
+  // the table is full.
+  table_.assign(table_size, UnassignedEntry);
+  uint64_t assigned = 0;
+  for (uint32_t host_index = 0; assigned < table_size;
+       host_index = (host_index + 1) % permutations.size()) {
+    Permutation& permutation = permutations[host_index];
+    uint64_t entry;
+    do {
+      entry = permutation.next_;
+      permutation.next_ = (permutation.next_ + permutation.skip_) % table_size;
+    } while (table_[entry] != UnassignedEntry);
+
+    table_[entry] = host_index;
+    assigned++;
+  }
+
+  ENVOY_LOG(debug, "maglev: table_size={} hosts={}", table_size, hosts_.size());
+}
+
+HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
+  if (table_.empty()) {
+    return nullptr;
+  }
+
+  return hosts_[table_[hash % table_.size()]];
+}
+
+MaglevLoadBalancer::MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats,
+                                       Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                                       uint64_t table_size)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random), table_size_(table_size) {}
+
+} // namespace Upstream
+} // namespace Envoy
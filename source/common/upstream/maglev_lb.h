@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "common/common/logger.h"
+#include "common/upstream/thread_aware_lb_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A Maglev lookup table as described in "Maglev: A Fast and Reliable Software Network Load
+ * Balancer" (https://research.google.com/pubs/pub44824.html). Each host fills table entries in
+ * the order given by its own permutation of the table, round robin with the other hosts, so that
+ * every host owns an almost equal share of the table and few entries move when hosts change.
+ * Lookups are a single index into the table.
+ */
+class MaglevTable : public ThreadAwareLoadBalancerBase::HashingLoadBalancer,
+                    Logger::Loggable<Logger::Id::upstream> {
+public:
+  MaglevTable(const std::vector<HostSharedPtr>& hosts, uint64_t table_size = DefaultTableSize);
+
+  // ThreadAwareLoadBalancerBase::HashingLoadBalancer
+  HostConstSharedPtr chooseHost(uint64_t hash) const override;
+
+  // The table size must be prime for the host permutations to cover the whole table. It should be
+  // much larger than the number of hosts to keep the shares even.
+  static const uint64_t DefaultTableSize = 65537;
+
+private:
+  // Hosts are stored once, and the table holds indexes into them. This keeps the table at 4 bytes
+  // per entry rather than the size of a shared pointer.
+  std::vector<HostConstSharedPtr> hosts_;
+  std::vector<uint32_t> table_;
+};
+
+/**
+ * Thread aware load balancer that implements Maglev consistent hashing. Currently, zone aware
+ * routing and weighting are not supported. As with the ring hash load balancer, a table is built
+ * for the healthy hosts of each priority, or for all hosts when the priority is in panic.
+ */
+class MaglevLoadBalancer : public ThreadAwareLoadBalancerBase {
+public:
+  MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
+                     Runtime::RandomGenerator& random,
+                     uint64_t table_size = MaglevTable::DefaultTableSize);
+
+private:
+  // ThreadAwareLoadBalancerBase
+  HashingLoadBalancerSharedPtr
+  createLoadBalancer(const std::vector<HostSharedPtr>& hosts) override {
+    return std::make_shared<MaglevTable>(hosts, table_size_);
+  }
+
+  const uint64_t table_size_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/upstream/outlier_detection_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -45,6 +46,28 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
   success_rate_accumulator_bucket_.store(success_rate_accumulator_.updateCurrentWriter());
 }
 
+void DetectorHostMonitorImpl::enableLatencyAccumulator() {
+  if (latency_accumulator_ == nullptr) {
+    latency_accumulator_.reset(new LatencyAccumulator());
+    updateCurrentLatencyBucket();
+  }
+}
+
+void DetectorHostMonitorImpl::updateCurrentLatencyBucket() {
+  if (latency_accumulator_ != nullptr) {
+    latency_accumulator_bucket_.store(latency_accumulator_->updateCurrentWriter());
+  }
+}
+
+void DetectorHostMonitorImpl::putResponseTime(std::chrono::milliseconds time) {
+  LatencyAccumulatorBucket* bucket = latency_accumulator_bucket_.load();
+  if (bucket == nullptr) {
+    return;
+  }
+  bucket->counts_[LatencyAccumulatorBucket::index(time.count())].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
   success_rate_accumulator_bucket_.load()->total_request_counter_++;
   if (Http::CodeUtility::is5xx(response_code)) {
@@ -124,7 +147,11 @@ DetectorConfig::DetectorConfig(const envoy::api::v2::cluster::OutlierDetection&
       enforcing_consecutive_gateway_failure_(static_cast<uint64_t>(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_consecutive_gateway_failure, 0))),
       enforcing_success_rate_(static_cast<uint64_t>(
-          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_success_rate, 100))) {}
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enforcing_success_rate, 100))),
+      // Latency outlier detection is not part of the OutlierDetection proto yet, so it can only be
+      // configured through runtime. Latency outliers are detected but not ejected by default.
+      detect_latency_(1), latency_minimum_hosts_(5), latency_request_volume_(100),
+      latency_quantile_(990), latency_factor_(3000), enforcing_latency_(0) {}
 
 DetectorImpl::DetectorImpl(const Cluster& cluster,
                            const envoy::api::v2::cluster::OutlierDetection& config,
@@ -133,8 +160,8 @@ DetectorImpl::DetectorImpl(const Cluster& cluster,
     : config_(config), dispatcher_(dispatcher), runtime_(runtime), time_source_(time_source),
       stats_(generateStats(cluster.info()->statsScope())),
       interval_timer_(dispatcher.createTimer([this]() -> void { onIntervalTimer(); })),
-      event_logger_(event_logger), success_rate_average_(-1), success_rate_ejection_threshold_(-1) {
-}
+      event_logger_(event_logger), success_rate_average_(-1), success_rate_ejection_threshold_(-1),
+      latency_cluster_quantile_(-1), latency_ejection_threshold_(-1) {}
 
 DetectorImpl::~DetectorImpl() {
   for (auto host : host_monitors_) {
@@ -187,6 +214,9 @@ void DetectorImpl::addHostMonitor(HostSharedPtr host) {
   ASSERT(host_monitors_.count(host) == 0);
   DetectorHostMonitorImpl* monitor = new DetectorHostMonitorImpl(shared_from_this(), host);
   host_monitors_[host] = monitor;
+  if (latencyDetectionEnabled()) {
+    monitor->enableLatencyAccumulator();
+  }
   host->setOutlierDetector(DetectorHostMonitorPtr{monitor});
 }
 
@@ -233,11 +263,19 @@ bool DetectorImpl::enforceEjection(EjectionType type) {
   case EjectionType::SuccessRate:
     return runtime_.snapshot().featureEnabled("outlier_detection.enforcing_success_rate",
                                               config_.enforcingSuccessRate());
+  case EjectionType::Latency:
+    return runtime_.snapshot().featureEnabled("outlier_detection.enforcing_latency",
+                                              config_.enforcingLatency());
   }
 
   NOT_REACHED;
 }
 
+bool DetectorImpl::latencyDetectionEnabled() {
+  return runtime_.snapshot().getInteger("outlier_detection.detect_latency",
+                                        config_.detectLatency()) > 0;
+}
+
 void DetectorImpl::updateEnforcedEjectionStats(EjectionType type) {
   stats_.ejections_enforced_total_.inc();
   switch (type) {
@@ -250,6 +288,9 @@ void DetectorImpl::updateEnforcedEjectionStats(EjectionType type) {
   case EjectionType::ConsecutiveGatewayFailure:
     stats_.ejections_enforced_consecutive_gateway_failure_.inc();
     break;
+  case EjectionType::Latency:
+    stats_.ejections_enforced_latency_.inc();
+    break;
   }
 }
 
@@ -343,6 +384,7 @@ void DetectorImpl::onConsecutiveErrorWorker(HostSharedPtr host, EjectionType typ
     host_monitors_[host]->resetConsecutiveGatewayFailure();
     break;
   case EjectionType::SuccessRate:
+  case EjectionType::Latency:
     NOT_REACHED;
   }
 }
@@ -431,8 +473,91 @@ void DetectorImpl::processSuccessRateEjections() {
   }
 }
 
+Utility::LatencyEjectionPair
+Utility::latencyEjectionThreshold(std::vector<HostLatencyPair> valid_latency_hosts,
+                                  double latency_factor) {
+  // The median of the hosts' quantiles is the typical quantile of a host. Hosts whose quantile is
+  // more than latency_factor times the median are outliers. For example with quantiles of
+  // {10, 12, 15, 20, 200} and a factor of 3, the median is 15 and the threshold is 45.
+  const size_t middle = valid_latency_hosts.size() / 2;
+  const auto by_quantile = [](const HostLatencyPair& a, const HostLatencyPair& b) {
+    return a.latency_quantile_ < b.latency_quantile_;
+  };
+  std::nth_element(valid_latency_hosts.begin(), valid_latency_hosts.begin() + middle,
+                   valid_latency_hosts.end(), by_quantile);
+  double median = valid_latency_hosts[middle].latency_quantile_;
+  if (valid_latency_hosts.size() % 2 == 0) {
+    // With an even number of hosts, the median is the mean of the two middle quantiles. The lower
+    // one is the largest quantile before the middle.
+    const double lower =
+        std::max_element(valid_latency_hosts.begin(), valid_latency_hosts.begin() + middle,
+                         by_quantile)
+            ->latency_quantile_;
+    median = (median + lower) / 2;
+  }
+
+  return {median, median * latency_factor};
+}
+
+void DetectorImpl::processLatencyEjections() {
+  uint64_t latency_minimum_hosts = runtime_.snapshot().getInteger(
+      "outlier_detection.latency_minimum_hosts", config_.latencyMinimumHosts());
+  uint64_t latency_request_volume = runtime_.snapshot().getInteger(
+      "outlier_detection.latency_request_volume", config_.latencyRequestVolume());
+  double latency_quantile =
+      std::min<uint64_t>(1000, runtime_.snapshot().getInteger("outlier_detection.latency_quantile",
+                                                               config_.latencyQuantile())) /
+      1000.0;
+  std::vector<HostLatencyPair> valid_latency_hosts;
+
+  // Reset the Detector's latency quantile and threshold.
+  latency_cluster_quantile_ = -1;
+  latency_ejection_threshold_ = -1;
+
+  // Exit early if latency detection is disabled or there are not enough hosts.
+  if (!latencyDetectionEnabled() || host_monitors_.size() < latency_minimum_hosts ||
+      host_monitors_.empty()) {
+    return;
+  }
+
+  // reserve upper bound of vector size to avoid reallocation.
+  valid_latency_hosts.reserve(host_monitors_.size());
+
+  for (const auto& host : host_monitors_) {
+    // Don't do work if the host is already ejected, or does not record response times.
+    LatencyAccumulator* accumulator = host.second->latencyAccumulator();
+    if (accumulator != nullptr &&
+        !host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      Optional<double> host_latency_quantile =
+          accumulator->getLatencyQuantile(latency_request_volume, latency_quantile);
+
+      if (host_latency_quantile.valid()) {
+        valid_latency_hosts.emplace_back(host.first, host_latency_quantile.value());
+        host.second->latencyQuantile(host_latency_quantile.value());
+      }
+    }
+  }
+
+  if (!valid_latency_hosts.empty() && valid_latency_hosts.size() >= latency_minimum_hosts) {
+    double latency_factor = runtime_.snapshot().getInteger("outlier_detection.latency_factor",
+                                                           config_.latencyFactor()) /
+                            1000.0;
+    Utility::LatencyEjectionPair ejection_pair =
+        Utility::latencyEjectionThreshold(valid_latency_hosts, latency_factor);
+    latency_cluster_quantile_ = ejection_pair.cluster_quantile_;
+    latency_ejection_threshold_ = ejection_pair.ejection_threshold_;
+    for (const auto& host_latency_pair : valid_latency_hosts) {
+      if (host_latency_pair.latency_quantile_ > latency_ejection_threshold_) {
+        stats_.ejections_detected_latency_.inc();
+        ejectHost(host_latency_pair.host_, EjectionType::Latency);
+      }
+    }
+  }
+}
+
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.currentTime();
+  const bool latency_detection_enabled = latencyDetectionEnabled();
 
   for (auto host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
@@ -442,9 +567,15 @@ void DetectorImpl::onIntervalTimer() {
     // Refresh host success rate stat for the /clusters endpoint. If there is a new valid value, it
     // will get updated in processSuccessRateEjections().
     host.second->successRate(-1);
+    host.second->updateCurrentLatencyBucket();
+    host.second->latencyQuantile(-1);
+    if (latency_detection_enabled) {
+      host.second->enableLatencyAccumulator();
+    }
   }
 
   processSuccessRateEjections();
+  processLatencyEjections();
 
   armIntervalTimer();
 }
@@ -485,6 +616,21 @@ void EventLoggerImpl::logEject(HostDescriptionConstSharedPtr host, Detector& det
     "\"cluster_average_success_rate\": \"{}\", " +
     "\"cluster_success_rate_ejection_threshold\": \"{}\"" +
     "}}\n";
+
+  static const std::string json_latency =
+    std::string("{{") +
+    "\"time\": \"{}\", " +
+    "\"secs_since_last_action\": \"{}\", " +
+    "\"cluster\": \"{}\", " +
+    "\"upstream_url\": \"{}\", " +
+    "\"action\": \"eject\", " +
+    "\"type\": \"{}\", " +
+    "\"num_ejections\": \"{}\", " +
+    "\"enforced\": \"{}\", " +
+    "\"host_latency_quantile\": \"{}\", " +
+    "\"cluster_latency_quantile\": \"{}\", " +
+    "\"cluster_latency_ejection_threshold\": \"{}\"" +
+    "}}\n";
   // clang-format on
   SystemTime now = time_source_.currentTime();
   MonotonicTime monotonic_now = monotonic_time_source_.currentTime();
@@ -506,6 +652,14 @@ void EventLoggerImpl::logEject(HostDescriptionConstSharedPtr host, Detector& det
         host->outlierDetector().numEjections(), enforced, host->outlierDetector().successRate(),
         detector.successRateAverage(), detector.successRateEjectionThreshold()));
     break;
+  case EjectionType::Latency:
+    file_->write(fmt::format(
+        json_latency, AccessLogDateTimeFormatter::fromTime(now),
+        secsSinceLastAction(host->outlierDetector().lastUnejectionTime(), monotonic_now),
+        host->cluster().name(), host->address()->asString(), typeToString(type),
+        host->outlierDetector().numEjections(), enforced, host->outlierDetector().latencyQuantile(),
+        detector.latencyClusterQuantile(), detector.latencyEjectionThreshold()));
+    break;
   }
 }
 
@@ -538,6 +692,8 @@ std::string EventLoggerImpl::typeToString(EjectionType type) {
     return "GatewayFailure";
   case EjectionType::SuccessRate:
     return "SuccessRate";
+  case EjectionType::Latency:
+    return "Latency";
   }
 
   NOT_REACHED;
@@ -570,6 +726,52 @@ Optional<double> SuccessRateAccumulator::getSuccessRate(uint64_t success_rate_re
                           backup_success_rate_bucket_->total_request_counter_);
 }
 
+constexpr uint32_t LatencyAccumulatorBucket::MaxResponseTimeBits;
+constexpr uint64_t LatencyAccumulatorBucket::MaxResponseTimeMs;
+constexpr uint32_t LatencyAccumulatorBucket::NumBuckets;
+
+LatencyAccumulatorBucket* LatencyAccumulator::updateCurrentWriter() {
+  // Right now current is being written to and backup is not. Flush the backup and swap.
+  resetBucket(*backup_latency_bucket_);
+
+  current_latency_bucket_.swap(backup_latency_bucket_);
+
+  return current_latency_bucket_.get();
+}
+
+Optional<double> LatencyAccumulator::getLatencyQuantile(uint64_t latency_request_volume,
+                                                        double quantile) {
+  const LatencyAccumulatorBucket& bucket = *backup_latency_bucket_;
+  uint64_t total = 0;
+  for (const std::atomic<uint64_t>& count : bucket.counts_) {
+    total += count.load(std::memory_order_relaxed);
+  }
+  if (total == 0 || total < latency_request_volume) {
+    return Optional<double>();
+  }
+
+  // Within the bucket that holds the quantile, response times are assumed to be spread evenly.
+  const double rank = quantile * total;
+  uint64_t requests_below = 0;
+  for (uint32_t i = 0; i < LatencyAccumulatorBucket::NumBuckets; i++) {
+    const uint64_t count = bucket.counts_[i].load(std::memory_order_relaxed);
+    if (count > 0 && requests_below + count >= rank) {
+      const double fraction = (rank - requests_below) / count;
+      return Optional<double>(Stats::LogLinearBuckets::lowerBound(i) +
+                              fraction * (Stats::LogLinearBuckets::width(i) - 1));
+    }
+    requests_below += count;
+  }
+
+  NOT_REACHED;
+}
+
+void LatencyAccumulator::resetBucket(LatencyAccumulatorBucket& bucket) {
+  for (std::atomic<uint64_t>& count : bucket.counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
 } // namespace Outlier
 } // namespace Upstream
 } // namespace Envoy
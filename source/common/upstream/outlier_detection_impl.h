@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -17,6 +18,8 @@
 #include "envoy/upstream/outlier_detection.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/stats/histogram_impl.h"
+
 namespace Envoy {
 namespace Upstream {
 namespace Outlier {
@@ -34,6 +37,7 @@ public:
   const Optional<MonotonicTime>& lastEjectionTime() override { return time_; }
   const Optional<MonotonicTime>& lastUnejectionTime() override { return time_; }
   double successRate() const override { return -1; }
+  double latencyQuantile() const override { return -1; }
 
 private:
   const Optional<MonotonicTime> time_;
@@ -97,6 +101,75 @@ private:
   std::unique_ptr<SuccessRateAccumulatorBucket> backup_success_rate_bucket_;
 };
 
+/**
+ * Thin struct to facilitate calculations for latency outlier detection.
+ */
+struct HostLatencyPair {
+  HostLatencyPair(HostSharedPtr host, double latency_quantile)
+      : host_(host), latency_quantile_(latency_quantile) {}
+  HostSharedPtr host_;
+  double latency_quantile_;
+};
+
+/**
+ * Histogram of the response times of a host, in milliseconds, using the Stats::LogLinearBuckets
+ * layout. Only the buckets up to MaxResponseTimeMs are kept. Buckets are written by all workers.
+ */
+struct LatencyAccumulatorBucket {
+  // About 9 hours. Longer response times are counted in the last bucket.
+  static constexpr uint32_t MaxResponseTimeBits = 25;
+  static constexpr uint64_t MaxResponseTimeMs = (1ULL << MaxResponseTimeBits) - 1;
+  static constexpr uint32_t NumBuckets =
+      (MaxResponseTimeBits - Stats::LogLinearBuckets::SubBucketBits + 1) *
+      Stats::LogLinearBuckets::SubBucketCount;
+
+  /**
+   * @return the index of the bucket that counts a response time.
+   */
+  static uint32_t index(uint64_t response_time_ms) {
+    return Stats::LogLinearBuckets::index(std::min(response_time_ms, MaxResponseTimeMs));
+  }
+
+  std::atomic<uint64_t> counts_[NumBuckets];
+};
+
+/**
+ * The LatencyAccumulator uses the LatencyAccumulatorBucket to get per host response time
+ * quantiles. As with the SuccessRateAccumulator, one bucket is written to while the other holds
+ * the previous interval's data.
+ */
+class LatencyAccumulator {
+public:
+  LatencyAccumulator()
+      : current_latency_bucket_(new LatencyAccumulatorBucket()),
+        backup_latency_bucket_(new LatencyAccumulatorBucket()) {
+    resetBucket(*current_latency_bucket_);
+    resetBucket(*backup_latency_bucket_);
+  }
+
+  /**
+   * This function updates the bucket to write data to.
+   * @return a pointer to the LatencyAccumulatorBucket.
+   */
+  LatencyAccumulatorBucket* updateCurrentWriter();
+  /**
+   * This function returns a response time quantile of a host over a window of time if the request
+   * volume is high enough.
+   * @param latency_request_volume the threshold of requests an accumulator has to have in order to
+   *                               be able to return a significant quantile.
+   * @param quantile the quantile to compute, in the range 0-1.
+   * @return a valid Optional<double> with the quantile in milliseconds. If there were not enough
+   *         requests, an invalid Optional<double> is returned.
+   */
+  Optional<double> getLatencyQuantile(uint64_t latency_request_volume, double quantile);
+
+private:
+  static void resetBucket(LatencyAccumulatorBucket& bucket);
+
+  std::unique_ptr<LatencyAccumulatorBucket> current_latency_bucket_;
+  std::unique_ptr<LatencyAccumulatorBucket> backup_latency_bucket_;
+};
+
 class DetectorImpl;
 
 /**
@@ -105,7 +178,8 @@ class DetectorImpl;
 class DetectorHostMonitorImpl : public DetectorHostMonitor {
 public:
   DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> detector, HostSharedPtr host)
-      : detector_(detector), host_(host), success_rate_(-1) {
+      : detector_(detector), host_(host), success_rate_(-1), latency_accumulator_bucket_(nullptr),
+        latency_quantile_(-1) {
     // Point the success_rate_accumulator_bucket_ pointer to a bucket.
     updateCurrentSuccessRateBucket();
   }
@@ -115,6 +189,17 @@ public:
   void updateCurrentSuccessRateBucket();
   SuccessRateAccumulator& successRateAccumulator() { return success_rate_accumulator_; }
   void successRate(double new_success_rate) { success_rate_ = new_success_rate; }
+  /**
+   * Start recording response times. The latency accumulator is only allocated once latency
+   * detection is enabled, and is kept from then on since workers may still be writing to it.
+   */
+  void enableLatencyAccumulator();
+  void updateCurrentLatencyBucket();
+  /**
+   * @return the latency accumulator, or nullptr if response times are not recorded.
+   */
+  LatencyAccumulator* latencyAccumulator() { return latency_accumulator_.get(); }
+  void latencyQuantile(double new_latency_quantile) { latency_quantile_ = new_latency_quantile; }
   void resetConsecutive5xx() { consecutive_5xx_ = 0; }
   void resetConsecutiveGatewayFailure() { consecutive_gateway_failure_ = 0; }
   static Http::Code resultToHttpCode(Result result);
@@ -123,10 +208,11 @@ public:
   uint32_t numEjections() override { return num_ejections_; }
   void putHttpResponseCode(uint64_t response_code) override;
   void putResult(Result result) override;
-  void putResponseTime(std::chrono::milliseconds) override {}
+  void putResponseTime(std::chrono::milliseconds time) override;
   const Optional<MonotonicTime>& lastEjectionTime() override { return last_ejection_time_; }
   const Optional<MonotonicTime>& lastUnejectionTime() override { return last_unejection_time_; }
   double successRate() const override { return success_rate_; }
+  double latencyQuantile() const override { return latency_quantile_; }
 
 private:
   std::weak_ptr<DetectorImpl> detector_;
@@ -139,6 +225,9 @@ private:
   SuccessRateAccumulator success_rate_accumulator_;
   std::atomic<SuccessRateAccumulatorBucket*> success_rate_accumulator_bucket_;
   double success_rate_;
+  std::unique_ptr<LatencyAccumulator> latency_accumulator_;
+  std::atomic<LatencyAccumulatorBucket*> latency_accumulator_bucket_;
+  double latency_quantile_;
 };
 
 /**
@@ -157,7 +246,9 @@ private:
   COUNTER(ejections_detected_success_rate)                                                         \
   COUNTER(ejections_enforced_success_rate)                                                         \
   COUNTER(ejections_detected_consecutive_gateway_failure)                                          \
-  COUNTER(ejections_enforced_consecutive_gateway_failure)
+  COUNTER(ejections_enforced_consecutive_gateway_failure)                                          \
+  COUNTER(ejections_detected_latency)                                                              \
+  COUNTER(ejections_enforced_latency)
 // clang-format on
 
 /**
@@ -185,6 +276,12 @@ public:
   uint64_t enforcingConsecutive5xx() { return enforcing_consecutive_5xx_; }
   uint64_t enforcingConsecutiveGatewayFailure() { return enforcing_consecutive_gateway_failure_; }
   uint64_t enforcingSuccessRate() { return enforcing_success_rate_; }
+  uint64_t detectLatency() { return detect_latency_; }
+  uint64_t latencyMinimumHosts() { return latency_minimum_hosts_; }
+  uint64_t latencyRequestVolume() { return latency_request_volume_; }
+  uint64_t latencyQuantile() { return latency_quantile_; }
+  uint64_t latencyFactor() { return latency_factor_; }
+  uint64_t enforcingLatency() { return enforcing_latency_; }
 
 private:
   const uint64_t interval_ms_;
@@ -198,6 +295,12 @@ private:
   const uint64_t enforcing_consecutive_5xx_;
   const uint64_t enforcing_consecutive_gateway_failure_;
   const uint64_t enforcing_success_rate_;
+  const uint64_t detect_latency_;
+  const uint64_t latency_minimum_hosts_;
+  const uint64_t latency_request_volume_;
+  const uint64_t latency_quantile_;
+  const uint64_t latency_factor_;
+  const uint64_t enforcing_latency_;
 };
 
 /**
@@ -222,6 +325,8 @@ public:
   void addChangedStateCb(ChangeStateCb cb) override { callbacks_.push_back(cb); }
   double successRateAverage() const override { return success_rate_average_; }
   double successRateEjectionThreshold() const override { return success_rate_ejection_threshold_; }
+  double latencyClusterQuantile() const override { return latency_cluster_quantile_; }
+  double latencyEjectionThreshold() const override { return latency_ejection_threshold_; }
 
 private:
   DetectorImpl(const Cluster& cluster, const envoy::api::v2::cluster::OutlierDetection& config,
@@ -239,8 +344,10 @@ private:
   void onIntervalTimer();
   void runCallbacks(HostSharedPtr host);
   bool enforceEjection(EjectionType type);
+  bool latencyDetectionEnabled();
   void updateEnforcedEjectionStats(EjectionType type);
   void processSuccessRateEjections();
+  void processLatencyEjections();
 
   DetectorConfig config_;
   Event::Dispatcher& dispatcher_;
@@ -253,6 +360,8 @@ private:
   EventLoggerSharedPtr event_logger_;
   double success_rate_average_;
   double success_rate_ejection_threshold_;
+  double latency_cluster_quantile_;
+  double latency_ejection_threshold_;
 };
 
 class EventLoggerImpl : public EventLogger {
@@ -286,6 +395,11 @@ public:
     double ejection_threshold_;
   };
 
+  struct LatencyEjectionPair {
+    double cluster_quantile_;
+    double ejection_threshold_;
+  };
+
   /**
    * This function returns an EjectionPair for success rate outlier detection. The pair contains
    * the average success rate of all valid hosts in the cluster and the ejection threshold.
@@ -299,6 +413,20 @@ public:
   successRateEjectionThreshold(double success_rate_sum,
                                const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
                                double success_rate_stdev_factor);
+
+  /**
+   * This function returns a LatencyEjectionPair for latency outlier detection. The pair contains
+   * the median of the response time quantiles of all valid hosts in the cluster, and the ejection
+   * threshold. If a host's response time quantile is over this threshold, the host is an outlier.
+   * The median is used rather than the quantile of the cluster as a whole, since a slow host
+   * dominates the tail of the cluster's response times.
+   * @param valid_latency_hosts is the vector containing the individual response time quantile data
+   *        points.
+   * @param latency_factor is the factor of the median that a host's quantile may reach.
+   * @return LatencyEjectionPair.
+   */
+  static LatencyEjectionPair
+  latencyEjectionThreshold(std::vector<HostLatencyPair> valid_latency_hosts, double latency_factor);
 };
 
 } // namespace Outlier
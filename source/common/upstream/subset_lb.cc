@@ -10,6 +10,7 @@
 #include "common/config/well_known_names.h"
 #include "common/protobuf/utility.h"
 #include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 
 namespace Envoy {
@@ -358,6 +359,14 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
     lb_ = thread_aware_lb_->factory()->create();
     break;
 
+  case LoadBalancerType::Maglev:
+    // See the comment above for the ring hash LB.
+    thread_aware_lb_.reset(new MaglevLoadBalancer(*this, subset_lb.stats_, subset_lb.runtime_,
+                                                  subset_lb.random_));
+    thread_aware_lb_->initialize();
+    lb_ = thread_aware_lb_->factory()->create();
+    break;
+
   case LoadBalancerType::OriginalDst:
     NOT_REACHED;
   }
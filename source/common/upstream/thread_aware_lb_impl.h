@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "common/upstream/load_balancer_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Base class for thread aware load balancers that map a hash to a host, such as the ring hash and
+ * Maglev load balancers. The hashing structure for each priority is built on the main thread when
+ * the host set changes, and is shared read-only by the load balancers that the factory hands to
+ * the workers.
+ */
+class ThreadAwareLoadBalancerBase : public LoadBalancerBase, public ThreadAwareLoadBalancer {
+public:
+  /**
+   * Hashing structure built for a single priority's hosts.
+   */
+  class HashingLoadBalancer {
+  public:
+    virtual ~HashingLoadBalancer() {}
+
+    /**
+     * @return HostConstSharedPtr the host that a hash maps to, or nullptr if there are no hosts.
+     */
+    virtual HostConstSharedPtr chooseHost(uint64_t hash) const PURE;
+  };
+  typedef std::shared_ptr<const HashingLoadBalancer> HashingLoadBalancerSharedPtr;
+
+  // Upstream::ThreadAwareLoadBalancer
+  LoadBalancerFactorySharedPtr factory() override { return factory_; }
+  void initialize() override;
+
+protected:
+  ThreadAwareLoadBalancerBase(PrioritySet& priority_set, ClusterStats& stats,
+                              Runtime::Loader& runtime, Runtime::RandomGenerator& random)
+      : LoadBalancerBase(priority_set, stats, runtime, random),
+        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+
+private:
+  struct PerPriorityState {
+    HashingLoadBalancerSharedPtr current_lb_;
+    bool global_panic_{};
+  };
+  typedef std::unique_ptr<PerPriorityState> PerPriorityStatePtr;
+
+  struct LoadBalancerImpl : public LoadBalancer {
+    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
+        : stats_(stats), random_(random) {}
+
+    // Upstream::LoadBalancer
+    HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+
+    ClusterStats& stats_;
+    Runtime::RandomGenerator& random_;
+    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
+    std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
+  };
+
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+    LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
+        : stats_(stats), random_(random) {}
+
+    // Upstream::LoadBalancerFactory
+    LoadBalancerPtr create() override;
+
+    ClusterStats& stats_;
+    Runtime::RandomGenerator& random_;
+    std::shared_timed_mutex mutex_;
+    // TOOD(mattklein123): Added GUARDED_BY(mutex_) to to the following variables. OSX clang
+    // seems to not like them with shared mutexes so we need to ifdef them out on OSX. I don't
+    // have time to do this right now.
+    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
+    // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriorirty can be reused.
+    std::shared_ptr<std::vector<uint32_t>> per_priority_load_;
+  };
+
+  /**
+   * Build the hashing structure for a set of hosts. Called on the main thread.
+   */
+  virtual HashingLoadBalancerSharedPtr
+  createLoadBalancer(const std::vector<HostSharedPtr>& hosts) PURE;
+  void refresh();
+
+  std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,10 +1,12 @@
 #include "common/upstream/upstream_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -49,6 +51,31 @@ getSourceAddress(const envoy::api::v2::Cluster& cluster,
 }
 } // namespace
 
+#define GENERATE_HOST_STAT_INIT(NAME) NAME##_(HostStatNames::get().NAME##_),
+#define GENERATE_HOST_STAT_REF(NAME) NAME##_,
+
+HostStatsStorage::HostStatsStorage()
+    : ALL_HOST_STATS(GENERATE_HOST_STAT_INIT, GENERATE_HOST_STAT_INIT)
+          stats_{ALL_HOST_STATS(GENERATE_HOST_STAT_REF, GENERATE_HOST_STAT_REF)} {}
+
+#undef GENERATE_HOST_STAT_INIT
+#undef GENERATE_HOST_STAT_REF
+
+std::list<Stats::CounterSharedPtr> HostStatsStorage::counters() const {
+  // The aliasing constructor gives pointers that do not own, or keep alive, the counter.
+#define HOST_COUNTER_PTR(NAME) Stats::CounterSharedPtr(Stats::CounterSharedPtr(), &NAME##_),
+#define IGNORE_HOST_STAT(NAME)
+  return {ALL_HOST_STATS(HOST_COUNTER_PTR, IGNORE_HOST_STAT)};
+#undef HOST_COUNTER_PTR
+}
+
+std::list<Stats::GaugeSharedPtr> HostStatsStorage::gauges() const {
+#define HOST_GAUGE_PTR(NAME) Stats::GaugeSharedPtr(Stats::GaugeSharedPtr(), &NAME##_),
+  return {ALL_HOST_STATS(IGNORE_HOST_STAT, HOST_GAUGE_PTR)};
+#undef HOST_GAUGE_PTR
+#undef IGNORE_HOST_STAT
+}
+
 Host::CreateConnectionData
 HostImpl::createConnection(Event::Dispatcher& dispatcher,
                            const Network::ConnectionSocket::OptionsSharedPtr& options) const {
@@ -103,7 +130,7 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       stats_scope_(stats.createScope(fmt::format("cluster.{}.", name_))),
-      stats_(generateStats(*stats_scope_)),
+      stats_(generateStats(*stats_scope_)), code_stats_(*stats_scope_),
       load_report_stats_(generateLoadReportStats(load_report_stats_store_)),
       features_(parseFeatures(config)),
       http2_settings_(Http::Utility::parseHttp2Settings(config.http2_protocol_options())),
@@ -510,41 +537,36 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const std::vector<HostSharedP
   uint64_t max_host_weight = 1;
 
   // Go through and see if the list we have is different from what we just got. If it is, we
-  // make a new host list and raise a change notification. This uses an N^2 search given that
-  // this does not happen very often and the list sizes should be small. We also check for
-  // duplicates here. It's possible for DNS to return the same address multiple times, and a bad
-  // SDS implementation could do the same thing.
+  // make a new host list and raise a change notification. Current hosts are looked up by address
+  // so that the cost of an update is linear in the number of hosts, which matters for large EDS
+  // clusters where a single endpoint change resends the whole list. We also check for duplicates
+  // here. It's possible for DNS to return the same address multiple times, and a bad SDS
+  // implementation could do the same thing.
+  std::unordered_map<std::string, HostSharedPtr> existing_hosts;
+  for (const HostSharedPtr& host : current_hosts) {
+    existing_hosts.emplace(host->address()->asString(), host);
+  }
+
   std::unordered_set<std::string> host_addresses;
   std::vector<HostSharedPtr> final_hosts;
   for (const HostSharedPtr& host : new_hosts) {
-    if (host_addresses.count(host->address()->asString())) {
+    const std::string address = host->address()->asString();
+    if (!host_addresses.emplace(address).second) {
       continue;
     }
-    host_addresses.emplace(host->address()->asString());
 
-    bool found = false;
-    for (auto i = current_hosts.begin(); i != current_hosts.end();) {
-      // If we find a host matched based on address, we keep it. However we do change weight inline
-      // so do that here.
-      if (*(*i)->address() == *host->address()) {
-        if (host->weight() > max_host_weight) {
-          max_host_weight = host->weight();
-        }
-
-        (*i)->weight(host->weight());
-        final_hosts.push_back(*i);
-        i = current_hosts.erase(i);
-        found = true;
-      } else {
-        i++;
-      }
+    if (host->weight() > max_host_weight) {
+      max_host_weight = host->weight();
     }
 
-    if (!found) {
-      if (host->weight() > max_host_weight) {
-        max_host_weight = host->weight();
-      }
-
+    auto existing_host = existing_hosts.find(address);
+    if (existing_host != existing_hosts.end()) {
+      // If we find a host matched based on address, we keep it. However we do change weight inline
+      // so do that here.
+      existing_host->second->weight(host->weight());
+      final_hosts.push_back(existing_host->second);
+      existing_hosts.erase(existing_host);
+    } else {
       final_hosts.push_back(host);
       hosts_added.push_back(host);
 
@@ -555,6 +577,14 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const std::vector<HostSharedP
     }
   }
 
+  // Only the current hosts that are not in the new list remain, in their original order.
+  current_hosts.erase(
+      std::remove_if(current_hosts.begin(), current_hosts.end(),
+                     [&existing_hosts](const HostSharedPtr& host) {
+                       return existing_hosts.count(host->address()->asString()) == 0;
+                     }),
+      current_hosts.end());
+
   // If there are removed hosts, check to see if we should only delete if unhealthy.
   if (!current_hosts.empty() && depend_on_hc) {
     for (auto i = current_hosts.begin(); i != current_hosts.end();) {
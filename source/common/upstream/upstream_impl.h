@@ -29,6 +29,8 @@
 #include "common/common/logger.h"
 #include "common/config/metadata.h"
 #include "common/config/well_known_names.h"
+#include "common/http/codes.h"
+#include "common/singleton/const_singleton.h"
 #include "common/stats/stats_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
@@ -61,6 +63,54 @@ public:
   void setUnhealthy() override {}
 };
 
+/**
+ * Names of the per host stats, shared by every host.
+ */
+struct HostStatNameValues {
+#define GENERATE_HOST_STAT_NAME(NAME) const std::string NAME##_{#NAME};
+  ALL_HOST_STATS(GENERATE_HOST_STAT_NAME, GENERATE_HOST_STAT_NAME)
+#undef GENERATE_HOST_STAT_NAME
+};
+
+typedef ConstSingleton<HostStatNameValues> HostStatNames;
+
+/**
+ * Fixed layout storage for the per host stats. There can be a very large number of hosts, so
+ * rather than allocating each stat separately in a stats store, the stats are stored inline and
+ * share their names with the stats of every other host.
+ */
+class HostStatsStorage {
+public:
+  HostStatsStorage();
+
+  /**
+   * @return the stats backed by this storage.
+   */
+  const HostStats& stats() const { return stats_; }
+
+  /**
+   * @return all counters. The returned pointers do not own the counters, so they must not outlive
+   *         the storage.
+   */
+  std::list<Stats::CounterSharedPtr> counters() const;
+
+  /**
+   * @return all gauges. The returned pointers do not own the gauges, so they must not outlive the
+   *         storage.
+   */
+  std::list<Stats::GaugeSharedPtr> gauges() const;
+
+private:
+#define GENERATE_COMPACT_COUNTER(NAME) mutable Stats::CompactCounterImpl NAME##_;
+#define GENERATE_COMPACT_GAUGE(NAME) mutable Stats::CompactGaugeImpl NAME##_;
+  ALL_HOST_STATS(GENERATE_COMPACT_COUNTER, GENERATE_COMPACT_GAUGE)
+#undef GENERATE_COMPACT_GAUGE
+#undef GENERATE_COMPACT_COUNTER
+
+  // Must be declared after the stats it refers to.
+  const HostStats stats_;
+};
+
 /**
  * Implementation of Upstream::HostDescription.
  */
@@ -74,9 +124,7 @@ public:
         canary_(Config::Metadata::metadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
                                                 Config::MetadataEnvoyLbKeys::get().CANARY)
                     .bool_value()),
-        metadata_(metadata), locality_(locality), stats_{ALL_HOST_STATS(POOL_COUNTER(stats_store_),
-                                                                        POOL_GAUGE(stats_store_))} {
-  }
+        metadata_(metadata), locality_(locality) {}
 
   // Upstream::HostDescription
   bool canary() const override { return canary_; }
@@ -100,7 +148,7 @@ public:
       return *null_outlier_detector;
     }
   }
-  const HostStats& stats() const override { return stats_; }
+  const HostStats& stats() const override { return stats_storage_.stats(); }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
   const envoy::api::v2::Locality& locality() const override { return locality_; }
@@ -112,8 +160,7 @@ protected:
   const bool canary_;
   const envoy::api::v2::Metadata metadata_;
   const envoy::api::v2::Locality locality_;
-  Stats::IsolatedStoreImpl stats_store_;
-  HostStats stats_;
+  HostStatsStorage stats_storage_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
 };
@@ -134,11 +181,13 @@ public:
   }
 
   // Upstream::Host
-  std::list<Stats::CounterSharedPtr> counters() const override { return stats_store_.counters(); }
+  std::list<Stats::CounterSharedPtr> counters() const override {
+    return stats_storage_.counters();
+  }
   CreateConnectionData
   createConnection(Event::Dispatcher& dispatcher,
                    const Network::ConnectionSocket::OptionsSharedPtr& options) const override;
-  std::list<Stats::GaugeSharedPtr> gauges() const override { return stats_store_.gauges(); }
+  std::list<Stats::GaugeSharedPtr> gauges() const override { return stats_storage_.gauges(); }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
   void healthFlagSet(HealthFlag flag) override { health_flags_ |= enumToInt(flag); }
@@ -312,6 +361,7 @@ public:
   ClusterStats& stats() const override { return stats_; }
   Stats::Scope& statsScope() const override { return *stats_scope_; }
   ClusterLoadReportStats& loadReportStats() const override { return load_report_stats_; }
+  Http::CodeStats& codeStats() const override { return code_stats_; }
   const Network::Address::InstanceConstSharedPtr& sourceAddress() const override {
     return source_address_;
   };
@@ -344,6 +394,7 @@ private:
   const uint32_t per_connection_buffer_limit_bytes_;
   Stats::ScopePtr stats_scope_;
   mutable ClusterStats stats_;
+  mutable Http::CodeStatsImpl code_stats_;
   Stats::IsolatedStoreImpl load_report_stats_store_;
   mutable ClusterLoadReportStats load_report_stats_;
   Network::TransportSocketFactoryPtr transport_socket_factory_;
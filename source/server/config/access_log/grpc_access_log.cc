@@ -18,6 +18,11 @@ namespace Configuration {
 // Singleton registration via macro defined in envoy/singleton/manager.h
 SINGLETON_MANAGER_REGISTRATION(grpc_access_log_streamer);
 
+// The streamer is shared by all gRPC access logs, so its buffering is not part of any one log's
+// config.
+static const uint64_t BUFFER_SIZE_BYTES = 16384;
+static const std::chrono::milliseconds BUFFER_FLUSH_INTERVAL(1000);
+
 AccessLog::InstanceSharedPtr HttpGrpcAccessLogFactory::createAccessLogInstance(
     const Protobuf::Message& config, AccessLog::FilterPtr&& filter, FactoryContext& context) {
   const auto& proto_config = MessageUtil::downcastAndValidate<
@@ -29,7 +34,8 @@ AccessLog::InstanceSharedPtr HttpGrpcAccessLogFactory::createAccessLogInstance(
             return std::make_shared<AccessLog::GrpcAccessLogStreamerImpl>(
                 context.clusterManager().grpcAsyncClientManager().factoryForGrpcService(
                     grpc_service, context.scope()),
-                context.threadLocal(), context.localInfo());
+                context.threadLocal(), context.localInfo(), context.scope(), BUFFER_SIZE_BYTES,
+                BUFFER_FLUSH_INTERVAL);
           });
 
   return AccessLog::InstanceSharedPtr{
@@ -105,6 +105,11 @@ public:
     // validation mock.
     return nullptr;
   }
+  std::vector<Network::ListenSocketSharedPtr>
+  createWorkerListenSockets(Network::Address::InstanceConstSharedPtr,
+                            uint32_t num_workers) override {
+    return std::vector<Network::ListenSocketSharedPtr>(num_workers);
+  }
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType) override {
     return nullptr;
   }
@@ -211,6 +211,12 @@ void ConnectionHandlerImpl::ActiveListener::onNewConnection(
   }
 }
 
+void ConnectionHandlerImpl::ActiveListener::onAcceptBatch(uint32_t accepted,
+                                                          std::chrono::microseconds duration) {
+  stats_.downstream_cx_accept_batch_size_.recordValue(accepted);
+  stats_.downstream_cx_accept_latency_us_.recordValue(duration.count());
+}
+
 ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listener,
                                                           Network::ConnectionPtr&& new_connection)
     : listener_(listener), connection_(std::move(new_connection)),
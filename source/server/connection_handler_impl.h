@@ -28,7 +28,9 @@ namespace Server {
   COUNTER  (downstream_cx_total)                                                                   \
   COUNTER  (downstream_cx_destroy)                                                                 \
   GAUGE    (downstream_cx_active)                                                                  \
-  HISTOGRAM(downstream_cx_length_ms)
+  HISTOGRAM(downstream_cx_length_ms)                                                               \
+  HISTOGRAM(downstream_cx_accept_batch_size)                                                       \
+  HISTOGRAM(downstream_cx_accept_latency_us)
 // clang-format on
 
 /**
@@ -79,6 +81,7 @@ private:
     void onAccept(Network::ConnectionSocketPtr&& socket,
                   bool hand_off_restored_destination_connections) override;
     void onNewConnection(Network::ConnectionPtr&& new_connection) override;
+    void onAcceptBatch(uint32_t accepted, std::chrono::microseconds duration) override;
 
     /**
      * Remove and destroy an active connection.
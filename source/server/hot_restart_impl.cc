@@ -4,6 +4,7 @@
 #include <sys/prctl.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <unistd.h>
 
 #include <cstdint>
 #include <string>
@@ -25,7 +26,7 @@ namespace Server {
 
 // Increment this whenever there is a shared memory / RPC change that will prevent a hot restart
 // from working. Operations code can then cope with this and do a full restart.
-const uint64_t SharedMemory::VERSION = 9;
+const uint64_t SharedMemory::VERSION = 10;
 
 static SharedMemoryHashSetOptions sharedMemHashOptions(uint64_t max_stats) {
   SharedMemoryHashSetOptions hash_set_options;
@@ -221,7 +222,9 @@ void HotRestartImpl::drainParentListeners() {
   shmem_.flags_ &= ~SharedMemory::Flags::INITIALIZING;
 }
 
-int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
+int HotRestartImpl::duplicateParentListenSocket(const std::string& address,
+                                                uint32_t worker_index,
+                                                uint32_t num_worker_sockets) {
   if (options_.restartEpoch() == 0 || parent_terminated_) {
     return -1;
   }
@@ -229,9 +232,19 @@ int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
   RpcGetListenSocketRequest rpc;
   ASSERT(address.length() < sizeof(rpc.address_));
   StringUtil::strlcpy(rpc.address_, address.c_str(), sizeof(rpc.address_));
+  rpc.worker_index_ = worker_index;
   sendMessage(parent_address_, rpc);
   RpcGetListenSocketReply* reply =
       receiveTypedRpc<RpcGetListenSocketReply, RpcMessageType::GetListenSocketReply>();
+  if (reply->fd_ != -1 && reply->num_worker_sockets_ != num_worker_sockets) {
+    // Taking over only some of the parent's SO_REUSEPORT sockets would leave the rest in the
+    // reuse group until the parent exits, dropping the connections queued on them.
+    close(reply->fd_);
+    throw EnvoyException(fmt::format(
+        "hot restart: parent listens on {} with {} per worker sockets but {} are configured. The "
+        "--concurrency and --reuse-port options must match the parent's to hot restart",
+        address, reply->num_worker_sockets_, num_worker_sockets));
+  }
   return reply->fd_;
 }
 
@@ -361,11 +374,11 @@ void HotRestartImpl::onGetListenSocket(RpcGetListenSocketRequest& rpc) {
 
   Network::Address::InstanceConstSharedPtr addr =
       Network::Utility::resolveUrl(std::string(rpc.address_));
-  for (const auto& listener : server_->listenerManager().listeners()) {
-    if (*listener.get().socket().localAddress() == *addr) {
-      reply.fd_ = listener.get().socket().fd();
-      break;
-    }
+  Network::ListenSocket* socket =
+      server_->listenerManager().findListenSocket(*addr, rpc.worker_index_);
+  if (socket != nullptr) {
+    reply.fd_ = socket->fd();
+    reply.num_worker_sockets_ = server_->listenerManager().numWorkerListenSockets(*addr);
   }
 
   if (reply.fd_ == -1) {
@@ -125,7 +125,8 @@ public:
 
   // Server::HotRestart
   void drainParentListeners() override;
-  int duplicateParentListenSocket(const std::string& address) override;
+  int duplicateParentListenSocket(const std::string& address, uint32_t worker_index,
+                                  uint32_t num_worker_sockets) override;
   void getParentStats(GetParentStatsInfo& info) override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void shutdownParentAdmin(ShutdownParentAdminInfo& info) override;
@@ -168,12 +169,15 @@ private:
     RpcGetListenSocketRequest() : RpcBase(RpcMessageType::GetListenSocketRequest, sizeof(*this)) {}
 
     char address_[256]{0};
+    uint32_t worker_index_{};
   } __attribute__((packed));
 
   struct RpcGetListenSocketReply : public RpcBase {
     RpcGetListenSocketReply() : RpcBase(RpcMessageType::GetListenSocketReply, sizeof(*this)) {}
 
     int fd_{0};
+    // The number of per worker sockets that the parent listens on for the address.
+    uint32_t num_worker_sockets_{};
   } __attribute__((packed));
 
   struct RpcShutdownAdminReply : public RpcBase {
@@ -81,7 +81,7 @@ ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConst
   // TODO(mattklein123): UDS support.
   ASSERT(address->type() == Network::Address::Type::Ip);
   const std::string addr = fmt::format("tcp://{}", address->asString());
-  const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, 0, 0);
   if (fd != -1) {
     ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
     return std::make_shared<Network::TcpListenSocket>(fd, address);
@@ -90,6 +90,29 @@ ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConst
   }
 }
 
+std::vector<Network::ListenSocketSharedPtr>
+ProdListenerComponentFactory::createWorkerListenSockets(
+    Network::Address::InstanceConstSharedPtr address, uint32_t num_workers) {
+  // Each worker gets its own SO_REUSEPORT socket and the kernel spreads new connections across
+  // them. As above, we first try to get each worker's socket from our parent.
+  ASSERT(address->type() == Network::Address::Type::Ip);
+  const std::string addr = fmt::format("tcp://{}", address->asString());
+  std::vector<Network::ListenSocketSharedPtr> sockets;
+  sockets.reserve(num_workers);
+  for (uint32_t i = 0; i < num_workers; i++) {
+    const int fd = server_.hotRestart().duplicateParentListenSocket(addr, i, num_workers);
+    if (fd != -1) {
+      ENVOY_LOG(debug, "obtained socket for address {} worker {} from parent", addr, i);
+      sockets.push_back(std::make_shared<Network::TcpListenSocket>(fd, address));
+    } else {
+      // If the configured port is 0, the first socket picks the port that the others then use.
+      sockets.push_back(std::make_shared<Network::TcpListenSocket>(
+          i == 0 ? address : sockets[0]->localAddress(), true, true));
+    }
+  }
+  return sockets;
+}
+
 DrainManagerPtr
 ProdListenerComponentFactory::createDrainManager(envoy::api::v2::Listener::DrainType drain_type) {
   return DrainManagerPtr{new DrainManagerImpl(server_, drain_type)};
@@ -271,10 +294,36 @@ void ListenerImpl::setSocket(const Network::ListenSocketSharedPtr& socket) {
   socket_ = socket;
 }
 
+void ListenerImpl::setWorkerSockets(const std::vector<Network::ListenSocketSharedPtr>& sockets) {
+  ASSERT(!sockets.empty());
+  setSocket(sockets[0]);
+  worker_sockets_ = sockets;
+  for (const auto& socket : worker_sockets_) {
+    worker_configs_.emplace_back(new WorkerListenerConfig(*this, socket));
+  }
+}
+
+void ListenerImpl::shareSockets(const ListenerImpl& listener) {
+  if (listener.worker_sockets_.empty()) {
+    setSocket(listener.socket_);
+  } else {
+    setWorkerSockets(listener.worker_sockets_);
+  }
+}
+
+Network::ListenerConfig& ListenerImpl::workerConfig(uint32_t worker_index) {
+  if (worker_configs_.empty()) {
+    return *this;
+  }
+  ASSERT(worker_index < worker_configs_.size());
+  return *worker_configs_[worker_index];
+}
+
 ListenerManagerImpl::ListenerManagerImpl(Instance& server,
                                          ListenerComponentFactory& listener_factory,
                                          WorkerFactory& worker_factory)
-    : server_(server), factory_(listener_factory), stats_(generateStats(server.stats())) {
+    : server_(server), factory_(listener_factory), reuse_port_(server.options().reusePort()),
+      stats_(generateStats(server.stats())) {
   for (uint32_t i = 0; i < std::max(1U, server.options().concurrency()); i++) {
     workers_.emplace_back(worker_factory.createWorker());
   }
@@ -334,12 +383,12 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocket((*existing_warming_listener)->getSocket());
+    new_listener->shareSockets(**existing_warming_listener);
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocket((*existing_active_listener)->getSocket());
+    new_listener->shareSockets(**existing_active_listener);
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -368,20 +417,20 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // to see if there is a listener that has a socket bound to the address we are configured for.
     // This is an edge case, but may happen if a listener is removed and then added back with a same
     // or different name and intended to listen on the same address. This should work and not fail.
-    Network::ListenSocketSharedPtr draining_listener_socket;
     auto existing_draining_listener = std::find_if(
         draining_listeners_.cbegin(), draining_listeners_.cend(),
         [&new_listener](const DrainingListener& listener) {
           return *new_listener->address() == *listener.listener_->socket().localAddress();
         });
     if (existing_draining_listener != draining_listeners_.cend()) {
-      draining_listener_socket = existing_draining_listener->listener_->getSocket();
+      new_listener->shareSockets(*existing_draining_listener->listener_);
+    } else if (reuse_port_ && new_listener->bindToPort()) {
+      new_listener->setWorkerSockets(
+          factory_.createWorkerListenSockets(new_listener->address(), workers_.size()));
+    } else {
+      new_listener->setSocket(
+          factory_.createListenSocket(new_listener->address(), new_listener->bindToPort()));
     }
-
-    new_listener->setSocket(
-        draining_listener_socket
-            ? draining_listener_socket
-            : factory_.createListenSocket(new_listener->address(), new_listener->bindToPort()));
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -477,8 +526,34 @@ std::vector<std::reference_wrapper<Network::ListenerConfig>> ListenerManagerImpl
   return ret;
 }
 
-void ListenerManagerImpl::addListenerToWorker(Worker& worker, ListenerImpl& listener) {
-  worker.addListener(listener, [this, &listener](bool success) -> void {
+Network::ListenSocket*
+ListenerManagerImpl::findListenSocket(const Network::Address::Instance& address,
+                                      uint32_t worker_index) {
+  for (const auto& listener : active_listeners_) {
+    if (*listener->socket().localAddress() != address) {
+      continue;
+    }
+    const auto& worker_sockets = listener->getWorkerSockets();
+    if (worker_sockets.empty()) {
+      return &listener->socket();
+    }
+    return worker_index < worker_sockets.size() ? worker_sockets[worker_index].get() : nullptr;
+  }
+  return nullptr;
+}
+
+uint32_t ListenerManagerImpl::numWorkerListenSockets(const Network::Address::Instance& address) {
+  for (const auto& listener : active_listeners_) {
+    if (*listener->socket().localAddress() == address) {
+      return listener->getWorkerSockets().size();
+    }
+  }
+  return 0;
+}
+
+void ListenerManagerImpl::addListenerToWorker(Worker& worker, uint32_t worker_index,
+                                              ListenerImpl& listener) {
+  worker.addListener(listener.workerConfig(worker_index), [this, &listener](bool success) -> void {
     // The add listener completion runs on the worker thread. Post back to the main thread to
     // avoid locking.
     server_.dispatcher().post([this, success, &listener]() -> void {
@@ -506,8 +581,9 @@ void ListenerManagerImpl::addListenerToWorker(Worker& worker, ListenerImpl& list
 void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
   // The warmed listener should be added first so that the worker will accept new connections
   // when it stops listening on the old listener.
+  uint32_t worker_index = 0;
   for (const auto& worker : workers_) {
-    addListenerToWorker(*worker, listener);
+    addListenerToWorker(*worker, worker_index++, listener);
   }
 
   auto existing_active_listener = getListenerByName(active_listeners_, listener.name());
@@ -567,12 +643,14 @@ void ListenerManagerImpl::startWorkers(GuardDog& guard_dog) {
   ENVOY_LOG(info, "all dependencies initialized. starting workers");
   ASSERT(!workers_started_);
   workers_started_ = true;
+  uint32_t worker_index = 0;
   for (const auto& worker : workers_) {
     ASSERT(warming_listeners_.empty());
     for (const auto& listener : active_listeners_) {
-      addListenerToWorker(*worker, *listener);
+      addListenerToWorker(*worker, worker_index, *listener);
     }
     worker->start(guard_dog);
+    worker_index++;
   }
 }
 
@@ -51,6 +51,9 @@ public:
 
   Network::ListenSocketSharedPtr
   createListenSocket(Network::Address::InstanceConstSharedPtr address, bool bind_to_port) override;
+  std::vector<Network::ListenSocketSharedPtr>
+  createWorkerListenSockets(Network::Address::InstanceConstSharedPtr address,
+                            uint32_t num_workers) override;
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType drain_type) override;
   uint64_t nextListenerTag() override { return next_listener_tag_++; }
 
@@ -97,6 +100,9 @@ public:
   // Server::ListenerManager
   bool addOrUpdateListener(const envoy::api::v2::Listener& config, bool modifiable) override;
   std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners() override;
+  Network::ListenSocket* findListenSocket(const Network::Address::Instance& address,
+                                          uint32_t worker_index) override;
+  uint32_t numWorkerListenSockets(const Network::Address::Instance& address) override;
   uint64_t numConnections() override;
   bool removeListener(const std::string& listener_name) override;
   void startWorkers(GuardDog& guard_dog) override;
@@ -117,7 +123,7 @@ private:
     uint64_t workers_pending_removal_;
   };
 
-  void addListenerToWorker(Worker& worker, ListenerImpl& listener);
+  void addListenerToWorker(Worker& worker, uint32_t worker_index, ListenerImpl& listener);
   static ListenerManagerStats generateStats(Stats::Scope& scope);
   static bool hasListenerWithAddress(const ListenerList& list,
                                      const Network::Address::Instance& address);
@@ -155,10 +161,48 @@ private:
   // and any remaining connections are closed.
   std::list<DrainingListener> draining_listeners_;
   std::list<WorkerPtr> workers_;
+  // Whether listeners that bind get a SO_REUSEPORT socket per worker rather than one shared socket.
+  const bool reuse_port_;
   bool workers_started_{};
   ListenerManagerStats stats_;
 };
 
+/**
+ * The config a worker uses for a listener that has a socket per worker. Everything but the socket
+ * is the listener's, including the tag, so workers stop and remove it like any other listener.
+ */
+class WorkerListenerConfig : public Network::ListenerConfig {
+public:
+  WorkerListenerConfig(Network::ListenerConfig& parent,
+                       const Network::ListenSocketSharedPtr& socket)
+      : parent_(parent), socket_(socket) {}
+
+  // Network::ListenerConfig
+  Network::FilterChainFactory& filterChainFactory() override {
+    return parent_.filterChainFactory();
+  }
+  Network::ListenSocket& socket() override { return *socket_; }
+  bool bindToPort() override { return parent_.bindToPort(); }
+  bool handOffRestoredDestinationConnections() const override {
+    return parent_.handOffRestoredDestinationConnections();
+  }
+  Network::TransportSocketFactory& transportSocketFactory() override {
+    return parent_.transportSocketFactory();
+  }
+  uint32_t perConnectionBufferLimitBytes() override {
+    return parent_.perConnectionBufferLimitBytes();
+  }
+  Stats::Scope& listenerScope() override { return parent_.listenerScope(); }
+  uint64_t listenerTag() const override { return parent_.listenerTag(); }
+  const std::string& name() const override { return parent_.name(); }
+
+private:
+  Network::ListenerConfig& parent_;
+  const Network::ListenSocketSharedPtr socket_;
+};
+
+typedef std::unique_ptr<WorkerListenerConfig> WorkerListenerConfigPtr;
+
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
 //                     initializing all listeners after workers are started.
 
@@ -204,11 +248,33 @@ public:
 
   Network::Address::InstanceConstSharedPtr address() const { return address_; }
   const Network::ListenSocketSharedPtr& getSocket() const { return socket_; }
+  const std::vector<Network::ListenSocketSharedPtr>& getWorkerSockets() const {
+    return worker_sockets_;
+  }
   void debugLog(const std::string& message);
   void initialize();
   DrainManager& localDrainManager() const { return *local_drain_manager_; }
   void setSocket(const Network::ListenSocketSharedPtr& socket);
 
+  /**
+   * Give each worker its own socket. socket() returns the first worker's socket.
+   * @param sockets supplies the sockets, indexed by worker.
+   */
+  void setWorkerSockets(const std::vector<Network::ListenSocketSharedPtr>& sockets);
+
+  /**
+   * Use the same socket, or sockets, as another listener on the same address.
+   * @param listener supplies the listener to share sockets with.
+   */
+  void shareSockets(const ListenerImpl& listener);
+
+  /**
+   * @param worker_index supplies the index of a worker.
+   * @return Network::ListenerConfig& the config the worker listens with. This is the listener
+   *         itself unless the listener has a socket per worker.
+   */
+  Network::ListenerConfig& workerConfig(uint32_t worker_index);
+
   // Network::ListenerConfig
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
   Network::ListenSocket& socket() override { return *socket_; }
@@ -262,6 +328,9 @@ private:
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
   Network::ListenSocketSharedPtr socket_;
+  // Only set if each worker has its own socket.
+  std::vector<Network::ListenSocketSharedPtr> worker_sockets_;
+  std::vector<WorkerListenerConfigPtr> worker_configs_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
   Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   std::vector<Ssl::ServerContextPtr> tls_contexts_;
@@ -46,6 +46,9 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
       "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> concurrency("", "concurrency", "# of worker threads to run", false,
                                         std::thread::hardware_concurrency(), "uint32_t", cmd);
+  TCLAP::SwitchArg reuse_port("", "reuse-port",
+                              "give each worker thread its own SO_REUSEPORT listen socket", cmd,
+                              false);
   TCLAP::ValueArg<std::string> config_path("c", "config-path", "Path to configuration file", false,
                                            "", "string", cmd);
   TCLAP::SwitchArg v2_config_only("", "v2-config-only", "parse config as v2 only", cmd, false);
@@ -156,6 +159,7 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
   // For base ID, scale what the user inputs by 10 so that we have spread for domain sockets.
   base_id_ = base_id.getValue() * 10;
   concurrency_ = concurrency.getValue();
+  reuse_port_ = reuse_port.getValue();
   config_path_ = config_path.getValue();
   v2_config_only_ = v2_config_only.getValue();
   admin_address_path_ = admin_address_path.getValue();
@@ -30,6 +30,7 @@ public:
   // Server::Options
   uint64_t baseId() override { return base_id_; }
   uint32_t concurrency() override { return concurrency_; }
+  bool reusePort() override { return reuse_port_; }
   const std::string& configPath() override { return config_path_; }
   bool v2ConfigOnly() override { return v2_config_only_; }
   const std::string& adminAddressPath() override { return admin_address_path_; }
@@ -50,6 +51,7 @@ public:
 private:
   uint64_t base_id_;
   uint32_t concurrency_;
+  bool reuse_port_;
   std::string config_path_;
   bool v2_config_only_;
   std::string admin_address_path_;
@@ -0,0 +1,94 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/access_log/access_log_formatter.h"
+#include "common/http/header_map_impl.h"
+#include "common/network/utility.h"
+#include "common/request_info/request_info_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/mocks.h"
+
+#include "gmock/gmock.h"
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace {
+
+/**
+ * Request and response headers and request info for a typical proxied request.
+ */
+class FormatTester {
+public:
+  FormatTester()
+      : request_headers_{{Envoy::Http::Headers::get().Method, "GET"},
+                         {Envoy::Http::Headers::get().Path, "/api/v1/users/12345/profile"},
+                         {Envoy::Http::Headers::get().Host, "api.example.com"},
+                         {Envoy::Http::Headers::get().UserAgent,
+                          "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36"},
+                         {Envoy::Http::Headers::get().RequestId,
+                          "6c1c2fd6-55b3-4bd2-a8a6-b3b5cf4e6c30"},
+                         {Envoy::Http::Headers::get().ForwardedFor, "10.0.0.1"}},
+        response_headers_{{Envoy::Http::Headers::get().Status, "200"},
+                          {Envoy::Http::Headers::get().EnvoyUpstreamServiceTime, "12"}},
+        request_info_(Envoy::Http::Protocol::Http11) {
+    request_info_.bytes_received_ = 1234;
+    request_info_.bytes_sent_ = 5678;
+    request_info_.response_code_.value(200);
+    request_info_.upstream_host_ =
+        Envoy::Upstream::makeTestHostDescription(cluster_info_, "tcp://10.0.0.5:443");
+  }
+
+  std::shared_ptr<Envoy::Upstream::MockClusterInfo> cluster_info_{
+      new testing::NiceMock<Envoy::Upstream::MockClusterInfo>()};
+  Envoy::Http::HeaderMapImpl request_headers_;
+  Envoy::Http::HeaderMapImpl response_headers_;
+  Envoy::RequestInfo::RequestInfoImpl request_info_;
+};
+
+void format(benchmark::State& state, const std::string& format) {
+  FormatTester tester;
+  Envoy::AccessLog::FormatterImpl formatter(format);
+  size_t length = 0;
+  for (auto _ : state) {
+    length += formatter
+                  .format(tester.request_headers_, tester.response_headers_, tester.request_info_)
+                  .size();
+  }
+  benchmark::DoNotOptimize(length);
+}
+
+} // namespace
+
+static void BM_AccessLogFormatDefault(benchmark::State& state) {
+  format(state, Envoy::AccessLog::AccessLogFormatUtils::DEFAULT_FORMAT);
+}
+BENCHMARK(BM_AccessLogFormatDefault);
+
+static void BM_AccessLogFormatPlainText(benchmark::State& state) {
+  format(state, "a plain access log line without any operators\n");
+}
+BENCHMARK(BM_AccessLogFormatPlainText);
+
+static void BM_AccessLogFormatHeaders(benchmark::State& state) {
+  format(state, "%REQ(:METHOD)% %REQ(X-ENVOY-ORIGINAL-PATH?:PATH)% %REQ(USER-AGENT)% "
+                "%REQ(X-REQUEST-ID)% %RESP(X-ENVOY-UPSTREAM-SERVICE-TIME)% %REQ(X-MISSING)%\n");
+}
+BENCHMARK(BM_AccessLogFormatHeaders);
+
+static void BM_AccessLogFormatStartTime(benchmark::State& state) {
+  format(state, "[%START_TIME%]\n");
+}
+BENCHMARK(BM_AccessLogFormatStartTime);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -1,5 +1,6 @@
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -263,6 +264,62 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+TEST(AccessLogFormatterTest, CompositeFormatterAppends) {
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  Http::TestHeaderMapImpl request_header{{"first", "GET"}};
+  Http::TestHeaderMapImpl response_header;
+  FormatterImpl formatter("%REQ(FIRST)% %BYTES_RECEIVED% %RESPONSE_CODE%\n");
+
+  EXPECT_CALL(request_info, bytesReceived()).WillRepeatedly(Return(10));
+  Optional<uint32_t> response_code{200};
+  EXPECT_CALL(request_info, responseCode()).WillRepeatedly(ReturnRef(response_code));
+
+  // The log line is appended to what is already in the string, so a string can be reused.
+  std::string log_line = "prefix ";
+  formatter.formatInto(request_header, response_header, request_info, log_line);
+  EXPECT_EQ("prefix GET 10 200\n", log_line);
+
+  log_line.clear();
+  formatter.formatInto(request_header, response_header, request_info, log_line);
+  EXPECT_EQ("GET 10 200\n", log_line);
+}
+
+TEST(AccessLogFormatterTest, JsonFormatter) {
+  NiceMock<RequestInfo::MockRequestInfo> request_info;
+  Http::TestHeaderMapImpl request_header{{"first", "GET"}, {"quoted", "a \"b\"\\c\n\x01"}};
+  Http::TestHeaderMapImpl response_header;
+
+  {
+    JsonFormatterImpl formatter({});
+    EXPECT_EQ("{}\n", formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    Optional<Http::Protocol> protocol = Http::Protocol::Http11;
+    EXPECT_CALL(request_info, protocol()).WillRepeatedly(ReturnRef(protocol));
+
+    JsonFormatterImpl formatter({{"protocol", "%PROTOCOL%"},
+                                 {"method", "%REQ(FIRST)%"},
+                                 {"line", "%REQ(FIRST)% %PROTOCOL% plain"},
+                                 {"missing", "%REQ(NOT_THERE)%"}});
+    EXPECT_EQ("{\"line\":\"GET HTTP/1.1 plain\",\"method\":\"GET\",\"missing\":\"-\","
+              "\"protocol\":\"HTTP/1.1\"}\n",
+              formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    JsonFormatterImpl formatter({{"quoted", "%REQ(QUOTED)%"}, {"key \"with\" quotes", "x"}});
+    EXPECT_EQ("{\"key \\\"with\\\" quotes\":\"x\","
+              "\"quoted\":\"a \\\"b\\\"\\\\c\\n\\u0001\"}\n",
+              formatter.format(request_header, response_header, request_info));
+  }
+
+  {
+    const std::map<std::string, std::string> format_mapping{{"bad", "%NOT_VALID%"}};
+    EXPECT_THROW(JsonFormatterImpl formatter(format_mapping), EnvoyException);
+  }
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
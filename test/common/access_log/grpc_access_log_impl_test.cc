@@ -1,7 +1,9 @@
 #include "common/access_log/grpc_access_log_impl.h"
 #include "common/network/address_impl.h"
+#include "common/stats/stats_impl.h"
 
 #include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/request_info/mocks.h"
@@ -23,12 +25,17 @@ public:
   typedef Grpc::TypedAsyncStreamCallbacks<envoy::service::accesslog::v2::StreamAccessLogsResponse>
       AccessLogCallbacks;
 
-  GrpcAccessLogStreamerImplTest() {
+  void initStreamer(uint64_t buffer_size_bytes) { initStreamer(buffer_size_bytes, stats_store_); }
+
+  void initStreamer(uint64_t buffer_size_bytes, Stats::Scope& scope) {
     EXPECT_CALL(*factory_, create()).WillOnce(Invoke([this] {
       return Grpc::AsyncClientPtr{async_client_};
     }));
+    timer_ = new Event::MockTimer(&tls_.dispatcher_);
+    EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(10)));
     streamer_ = std::make_unique<GrpcAccessLogStreamerImpl>(Grpc::AsyncClientFactoryPtr{factory_},
-                                                            tls_, local_info_);
+                                                            tls_, local_info_, scope,
+                                                            buffer_size_bytes, 10ms);
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -40,15 +47,29 @@ public:
         }));
   }
 
+  void log(const std::string& path, const std::string& log_name) {
+    envoy::api::v2::filter::accesslog::HTTPAccessLogEntry entry;
+    entry.mutable_request()->set_path(path);
+    streamer_->log(entry, log_name);
+    EXPECT_FALSE(entry.has_request());
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("access_logs.grpc_access_log." + name).value();
+  }
+
   NiceMock<ThreadLocal::MockInstance> tls_;
   LocalInfo::MockLocalInfo local_info_;
+  Stats::IsolatedStoreImpl stats_store_;
   Grpc::MockAsyncClient* async_client_{new Grpc::MockAsyncClient};
   Grpc::MockAsyncClientFactory* factory_{new Grpc::MockAsyncClientFactory};
+  Event::MockTimer* timer_;
   std::unique_ptr<GrpcAccessLogStreamerImpl> streamer_;
 };
 
-// Test basic stream logging flow.
+// Test basic stream logging flow without buffering.
 TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
+  initStreamer(0);
   InSequence s;
 
   // Start a stream for the first log.
@@ -56,13 +77,23 @@ TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
   AccessLogCallbacks* callbacks1;
   expectStreamStart(stream1, &callbacks1);
   EXPECT_CALL(local_info_, node());
-  EXPECT_CALL(stream1, sendMessage(_, false));
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message_log1;
-  streamer_->send(message_log1, "log1");
+  EXPECT_CALL(stream1, sendMessage(_, false))
+      .WillOnce(Invoke([](const Protobuf::Message& message, bool) {
+        const auto& logs_message =
+            dynamic_cast<const envoy::service::accesslog::v2::StreamAccessLogsMessage&>(message);
+        EXPECT_EQ("log1", logs_message.identifier().log_name());
+        EXPECT_EQ(1, logs_message.http_logs().log_entry_size());
+      }));
+  log("/a", "log1");
 
-  message_log1.Clear();
-  EXPECT_CALL(stream1, sendMessage(_, false));
-  streamer_->send(message_log1, "log1");
+  // Only the first message on a stream carries the identifier.
+  EXPECT_CALL(stream1, sendMessage(_, false))
+      .WillOnce(Invoke([](const Protobuf::Message& message, bool) {
+        EXPECT_FALSE(
+            dynamic_cast<const envoy::service::accesslog::v2::StreamAccessLogsMessage&>(message)
+                .has_identifier());
+      }));
+  log("/b", "log1");
 
   // Start a stream for the second log.
   MockAccessLogStream stream2;
@@ -70,8 +101,7 @@ TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
   expectStreamStart(stream2, &callbacks2);
   EXPECT_CALL(local_info_, node());
   EXPECT_CALL(stream2, sendMessage(_, false));
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message_log2;
-  streamer_->send(message_log2, "log2");
+  log("/c", "log2");
 
   // Verify that sending an empty response message doesn't do anything bad.
   callbacks1->onReceiveMessage(
@@ -82,11 +112,33 @@ TEST_F(GrpcAccessLogStreamerImplTest, BasicFlow) {
   expectStreamStart(stream2, &callbacks2);
   EXPECT_CALL(local_info_, node());
   EXPECT_CALL(stream2, sendMessage(_, false));
-  streamer_->send(message_log2, "log2");
+  log("/d", "log2");
+
+  EXPECT_EQ(4U, counter("logs_written"));
+  EXPECT_EQ(0U, counter("logs_dropped"));
+}
+
+// Test that the streamer's stats remain valid after the scope it was created with is destroyed, as
+// happens when the listener that created it is removed.
+TEST_F(GrpcAccessLogStreamerImplTest, OutlivesCreatingScope) {
+  Stats::ScopePtr listener_scope = stats_store_.createScope("");
+  initStreamer(0, *listener_scope);
+  listener_scope.reset();
+  InSequence s;
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, sendMessage(_, false));
+  log("/a", "log1");
+
+  EXPECT_EQ(1U, counter("logs_written"));
 }
 
 // Test that stream failure is handled correctly.
 TEST_F(GrpcAccessLogStreamerImplTest, StreamFailure) {
+  initStreamer(0);
   InSequence s;
 
   EXPECT_CALL(*async_client_, start(_, _))
@@ -95,16 +147,86 @@ TEST_F(GrpcAccessLogStreamerImplTest, StreamFailure) {
             callbacks.onRemoteClose(Grpc::Status::Internal, "bad");
             return nullptr;
           }));
+  log("/a", "log1");
+  EXPECT_EQ(0U, counter("logs_written"));
+  EXPECT_EQ(1U, counter("logs_dropped"));
+
+  // The next flush tries to start a new stream.
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
   EXPECT_CALL(local_info_, node());
-  envoy::service::accesslog::v2::StreamAccessLogsMessage message_log1;
-  streamer_->send(message_log1, "log1");
+  EXPECT_CALL(stream, sendMessage(_, false));
+  log("/b", "log1");
+  EXPECT_EQ(1U, counter("logs_written"));
+  EXPECT_EQ(1U, counter("logs_dropped"));
+}
+
+// Test that entries are buffered until they reach the buffer size.
+TEST_F(GrpcAccessLogStreamerImplTest, BufferSize) {
+  envoy::api::v2::filter::accesslog::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path("/a");
+  initStreamer(2 * entry.ByteSize());
+  InSequence s;
+
+  log("/a", "log1");
+  log("/b", "log2");
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, sendMessage(_, false))
+      .WillOnce(Invoke([](const Protobuf::Message& message, bool) {
+        const auto& logs_message =
+            dynamic_cast<const envoy::service::accesslog::v2::StreamAccessLogsMessage&>(message);
+        EXPECT_EQ("log1", logs_message.identifier().log_name());
+        ASSERT_EQ(2, logs_message.http_logs().log_entry_size());
+        EXPECT_EQ("/a", logs_message.http_logs().log_entry(0).request().path());
+        EXPECT_EQ("/c", logs_message.http_logs().log_entry(1).request().path());
+      }));
+  log("/c", "log1");
+  EXPECT_EQ(2U, counter("logs_written"));
+}
+
+// Test that buffered entries are flushed when the flush interval elapses.
+TEST_F(GrpcAccessLogStreamerImplTest, FlushInterval) {
+  initStreamer(1024);
+  InSequence s;
+
+  // Nothing is sent when there are no entries.
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(10)));
+  timer_->callback_();
+
+  log("/a", "log1");
+  log("/b", "log1");
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, sendMessage(_, false))
+      .WillOnce(Invoke([](const Protobuf::Message& message, bool) {
+        EXPECT_EQ(2, dynamic_cast<const envoy::service::accesslog::v2::StreamAccessLogsMessage&>(
+                         message)
+                         .http_logs()
+                         .log_entry_size());
+      }));
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(10)));
+  timer_->callback_();
+  EXPECT_EQ(2U, counter("logs_written"));
+
+  // The buffer is empty after a flush.
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(10)));
+  timer_->callback_();
+  EXPECT_EQ(2U, counter("logs_written"));
 }
 
 class MockGrpcAccessLogStreamer : public GrpcAccessLogStreamer {
 public:
   // GrpcAccessLogStreamer
-  MOCK_METHOD2(send, void(envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                          const std::string& log_name));
+  MOCK_METHOD2(log, void(envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry,
+                         const std::string& log_name));
 };
 
 class HttpGrpcAccessLogTest : public testing::Test {
@@ -115,14 +237,14 @@ public:
     access_log_.reset(new HttpGrpcAccessLog(FilterPtr{filter_}, config_, streamer_));
   }
 
-  void expectLog(const std::string& expected_request_msg_yaml) {
-    envoy::service::accesslog::v2::StreamAccessLogsMessage expected_request_msg;
-    MessageUtil::loadFromYaml(expected_request_msg_yaml, expected_request_msg);
-    EXPECT_CALL(*streamer_, send(_, "hello_log"))
+  void expectLog(const std::string& expected_log_entry_yaml) {
+    envoy::api::v2::filter::accesslog::HTTPAccessLogEntry expected_log_entry;
+    MessageUtil::loadFromYaml(expected_log_entry_yaml, expected_log_entry);
+    EXPECT_CALL(*streamer_, log(_, "hello_log"))
         .WillOnce(Invoke(
-            [expected_request_msg](envoy::service::accesslog::v2::StreamAccessLogsMessage& message,
-                                   const std::string&) {
-              EXPECT_EQ(message.DebugString(), expected_request_msg.DebugString());
+            [expected_log_entry](envoy::api::v2::filter::accesslog::HTTPAccessLogEntry& entry,
+                                 const std::string&) {
+              EXPECT_EQ(entry.DebugString(), expected_log_entry.DebugString());
             }));
   }
 
@@ -144,22 +266,20 @@ TEST_F(HttpGrpcAccessLogTest, Marshalling) {
     request_info.downstream_local_address_ =
         std::make_shared<Network::Address::PipeInstance>("/foo");
     expectLog(R"EOF(
-http_logs:
-  log_entry:
-    common_properties:
-      downstream_remote_address:
-        socket_address:
-          address: "127.0.0.1"
-          port_value: 0
-      downstream_local_address:
-        pipe:
-          path: "/foo"
-      start_time:
-        seconds: 3600
-      time_to_last_downstream_tx_byte:
-        nanos: 2000000
-    request: {}
-    response: {}
+common_properties:
+  downstream_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+      port_value: 0
+  downstream_local_address:
+    pipe:
+      path: "/foo"
+  start_time:
+    seconds: 3600
+  time_to_last_downstream_tx_byte:
+    nanos: 2000000
+request: {}
+response: {}
 
 )EOF");
     access_log_->log(nullptr, nullptr, request_info);
@@ -193,53 +313,51 @@ http_logs:
     Http::TestHeaderMapImpl response_headers{{":status", "200"}};
 
     expectLog(R"EOF(
-http_logs:
-  log_entry:
-    common_properties:
-      downstream_remote_address:
-        socket_address:
-          address: "127.0.0.1"
-          port_value: 0
-      downstream_local_address:
-        socket_address:
-          address: "127.0.0.2"
-          port_value: 0
-      start_time:
-        seconds: 3600
-      time_to_last_rx_byte:
-        nanos: 2000000
-      time_to_first_upstream_rx_byte:
-        nanos: 4000000
-      time_to_last_downstream_tx_byte:
-        nanos: 6000000
-      upstream_remote_address:
-        socket_address:
-          address: "10.0.0.1"
-          port_value: 443
-      upstream_local_address:
-        socket_address:
-          address: "10.0.0.2"
-          port_value: 0
-      upstream_cluster: "fake_cluster"
-      response_flags:
-        fault_injected: true
-    protocol_version: HTTP10
-    request:
-      scheme: "scheme_value"
-      authority: "authority_value"
-      path: "path_value"
-      user_agent: "user-agent_value"
-      referer: "referer_value"
-      forwarded_for: "x-forwarded-for_value"
-      request_id: "x-request-id_value"
-      original_path: "x-envoy-original-path_value"
-      request_headers_bytes: 219
-      request_body_bytes: 10
-    response:
-      response_code:
-        value: 200
-      response_headers_bytes: 10
-      response_body_bytes: 20
+common_properties:
+  downstream_remote_address:
+    socket_address:
+      address: "127.0.0.1"
+      port_value: 0
+  downstream_local_address:
+    socket_address:
+      address: "127.0.0.2"
+      port_value: 0
+  start_time:
+    seconds: 3600
+  time_to_last_rx_byte:
+    nanos: 2000000
+  time_to_first_upstream_rx_byte:
+    nanos: 4000000
+  time_to_last_downstream_tx_byte:
+    nanos: 6000000
+  upstream_remote_address:
+    socket_address:
+      address: "10.0.0.1"
+      port_value: 443
+  upstream_local_address:
+    socket_address:
+      address: "10.0.0.2"
+      port_value: 0
+  upstream_cluster: "fake_cluster"
+  response_flags:
+    fault_injected: true
+protocol_version: HTTP10
+request:
+  scheme: "scheme_value"
+  authority: "authority_value"
+  path: "path_value"
+  user_agent: "user-agent_value"
+  referer: "referer_value"
+  forwarded_for: "x-forwarded-for_value"
+  request_id: "x-request-id_value"
+  original_path: "x-envoy-original-path_value"
+  request_headers_bytes: 219
+  request_body_bytes: 10
+response:
+  response_code:
+    value: 200
+  response_headers_bytes: 10
+  response_body_bytes: 20
 )EOF");
     access_log_->log(&request_headers, &response_headers, request_info);
   }
@@ -1,3 +1,7 @@
+#include <unistd.h>
+
+#include <string>
+
 #include "common/buffer/buffer_impl.h"
 
 #include "gtest/gtest.h"
@@ -67,6 +71,151 @@ TEST_F(OwnedImplTest, addBufferFragmentDynamicAllocation) {
   EXPECT_TRUE(release_callback_called_);
 }
 
+TEST_F(OwnedImplTest, AddSpansSlabs) {
+  const std::string input(OwnedSlice::SlabSize * 2 + 100, 'a');
+  Buffer::OwnedImpl buffer;
+  buffer.add(input);
+  EXPECT_EQ(input.size(), buffer.length());
+  EXPECT_EQ(3, buffer.getRawSlices(nullptr, 0));
+
+  std::string output(input.size(), '\0');
+  buffer.copyOut(0, output.size(), &output[0]);
+  EXPECT_EQ(input, output);
+}
+
+TEST_F(OwnedImplTest, MoveTransfersSlices) {
+  const std::string input(OwnedSlice::SlabSize, 'a');
+  Buffer::OwnedImpl source(input);
+  RawSlice source_slice;
+  ASSERT_EQ(1, source.getRawSlices(&source_slice, 1));
+
+  Buffer::OwnedImpl destination("hello");
+  destination.move(source);
+  EXPECT_EQ(0, source.length());
+  EXPECT_EQ(input.size() + 5, destination.length());
+
+  // The large slice is moved without copying its data.
+  RawSlice slices[2];
+  ASSERT_EQ(2, destination.getRawSlices(slices, 2));
+  EXPECT_EQ(source_slice.mem_, slices[1].mem_);
+  EXPECT_EQ(source_slice.len_, slices[1].len_);
+}
+
+TEST_F(OwnedImplTest, MovePartial) {
+  const std::string input(OwnedSlice::SlabSize + 10, 'a');
+  Buffer::OwnedImpl source(input);
+  Buffer::OwnedImpl destination;
+
+  destination.move(source, OwnedSlice::SlabSize + 5);
+  EXPECT_EQ(5, source.length());
+  EXPECT_EQ(OwnedSlice::SlabSize + 5, destination.length());
+
+  destination.move(source, 5);
+  EXPECT_EQ(0, source.length());
+  EXPECT_EQ(input.size(), destination.length());
+}
+
+TEST_F(OwnedImplTest, MoveBufferFragment) {
+  char input[] = "hello world";
+  BufferFragmentImpl frag(input, 11, [this](const void*, size_t, const BufferFragmentImpl*) {
+    release_callback_called_ = true;
+  });
+  Buffer::OwnedImpl source;
+  source.addBufferFragment(frag);
+
+  Buffer::OwnedImpl destination;
+  destination.move(source);
+  EXPECT_FALSE(release_callback_called_);
+  EXPECT_EQ(11, destination.length());
+
+  destination.drain(11);
+  EXPECT_TRUE(release_callback_called_);
+}
+
+TEST_F(OwnedImplTest, Linearize) {
+  Buffer::OwnedImpl buffer;
+  const std::string input(OwnedSlice::SlabSize - 1, 'a');
+  buffer.add(input);
+  buffer.add("bcd", 3);
+  EXPECT_EQ(2, buffer.getRawSlices(nullptr, 0));
+
+  const char* data = static_cast<const char*>(buffer.linearize(OwnedSlice::SlabSize + 1));
+  EXPECT_EQ(input + "bc", std::string(data, OwnedSlice::SlabSize + 1));
+  EXPECT_EQ(OwnedSlice::SlabSize + 2, buffer.length());
+
+  std::string output(buffer.length(), '\0');
+  buffer.copyOut(0, output.size(), &output[0]);
+  EXPECT_EQ(input + "bcd", output);
+}
+
+TEST_F(OwnedImplTest, ReserveCommit) {
+  Buffer::OwnedImpl buffer("hello");
+
+  // A single iovec reservation is contiguous and at least as large as requested.
+  RawSlice iovec;
+  ASSERT_EQ(1, buffer.reserve(100, &iovec, 1));
+  EXPECT_GE(iovec.len_, 100);
+  memcpy(iovec.mem_, " world", 6);
+  iovec.len_ = 6;
+  buffer.commit(&iovec, 1);
+  EXPECT_EQ(11, buffer.length());
+  EXPECT_EQ(1, buffer.getRawSlices(nullptr, 0));
+
+  // A reservation larger than the remaining tail spans slices.
+  RawSlice iovecs[2];
+  ASSERT_EQ(2, buffer.reserve(OwnedSlice::SlabSize, iovecs, 2));
+  EXPECT_EQ(OwnedSlice::SlabSize - 11, iovecs[0].len_);
+  EXPECT_GE(iovecs[1].len_, 11);
+  memset(iovecs[0].mem_, 'a', iovecs[0].len_);
+  memset(iovecs[1].mem_, 'b', 1);
+  iovecs[1].len_ = 1;
+  buffer.commit(iovecs, 2);
+  EXPECT_EQ(OwnedSlice::SlabSize + 1, buffer.length());
+
+  // Reserving without committing does not change the buffer contents.
+  buffer.reserve(100, &iovec, 1);
+  EXPECT_EQ(OwnedSlice::SlabSize + 1, buffer.length());
+  EXPECT_EQ(2, buffer.getRawSlices(nullptr, 0));
+}
+
+TEST_F(OwnedImplTest, Search) {
+  Buffer::OwnedImpl buffer;
+  buffer.add(std::string(OwnedSlice::SlabSize - 2, 'a'));
+  buffer.add("bcdbcd");
+
+  EXPECT_EQ(OwnedSlice::SlabSize - 2, buffer.search("bcd", 3, 0));
+  EXPECT_EQ(OwnedSlice::SlabSize + 1, buffer.search("bcd", 3, OwnedSlice::SlabSize - 1));
+  EXPECT_EQ(-1, buffer.search("bcde", 4, 0));
+  EXPECT_EQ(-1, buffer.search("a", 1, OwnedSlice::SlabSize + 4));
+  EXPECT_EQ(-1, buffer.search("a", 1, OwnedSlice::SlabSize * 2));
+}
+
+TEST_F(OwnedImplTest, ReadWrite) {
+  int pipe_fds[2] = {0, 0};
+  ASSERT_EQ(0, pipe(pipe_fds));
+
+  const std::string input(OwnedSlice::SlabSize + 100, 'a');
+  Buffer::OwnedImpl write_buffer(input);
+  uint64_t bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    int rc = write_buffer.write(pipe_fds[1]);
+    ASSERT_GT(rc, 0);
+    bytes_written += rc;
+  }
+  EXPECT_EQ(input.size(), bytes_written);
+
+  Buffer::OwnedImpl read_buffer;
+  while (read_buffer.length() < input.size()) {
+    ASSERT_GT(read_buffer.read(pipe_fds[0], input.size()), 0);
+  }
+  std::string output(read_buffer.length(), '\0');
+  read_buffer.copyOut(0, output.size(), &output[0]);
+  EXPECT_EQ(input, output);
+
+  close(pipe_fds[0]);
+  close(pipe_fds[1]);
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
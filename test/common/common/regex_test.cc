@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Regex {
+
+TEST(RegexUtility, ParseRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  CompiledMatcherPtr matcher = Utility::parseRegex("/api/v[0-9]+/\\w+");
+  EXPECT_TRUE(matcher->match("/api/v1/users"));
+  EXPECT_TRUE(matcher->match("/api/v23/users"));
+  // The whole value must match.
+  EXPECT_FALSE(matcher->match("/api/v1/users/"));
+  EXPECT_FALSE(matcher->match("/v1/api/v1/users"));
+  EXPECT_FALSE(matcher->match(""));
+
+  EXPECT_TRUE(Utility::parseRegex("")->match(""));
+  EXPECT_TRUE(Utility::parseRegex("^x*$")->match("xxx"));
+  EXPECT_TRUE(Utility::parseRegex("a.c")->match(std::string("a\0c", 3)));
+}
+
+// RE2 does not support lookaround assertions or backreferences, so these use std::regex.
+TEST(RegexUtility, ParseStdRegex) {
+  CompiledMatcherPtr matcher = Utility::parseRegex("/foo/(?!bar)\\w+");
+  EXPECT_TRUE(matcher->match("/foo/baz"));
+  EXPECT_FALSE(matcher->match("/foo/bar"));
+  EXPECT_FALSE(matcher->match("/foo/baz/"));
+
+  matcher = Utility::parseRegex("(a+)b\\1");
+  EXPECT_TRUE(matcher->match("aabaa"));
+  EXPECT_FALSE(matcher->match("aaba"));
+}
+
+// Inputs that make backtracking engines take exponential time are matched in linear time.
+TEST(RegexUtility, PathologicalInput) {
+  CompiledMatcherPtr matcher = Utility::parseRegex("(a+)+b");
+  EXPECT_FALSE(matcher->match(std::string(100000, 'a')));
+  EXPECT_TRUE(matcher->match(std::string(100000, 'a') + "b"));
+}
+
+TEST(RegexUtility, ParseRegexSet) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegexSet({"/foo", "(+invalid)"}), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  CompiledMatcherSetPtr set =
+      Utility::parseRegexSet({"/foo/.*", "/bar", "/foo/[0-9]+", ".*", "/foo/bar"});
+  std::vector<uint32_t> matches{42};
+  set->match("/foo/123", matches);
+  EXPECT_THAT(matches, ElementsAre(0, 2, 3));
+  set->match("/foo/bar", matches);
+  EXPECT_THAT(matches, ElementsAre(0, 3, 4));
+  // Each regex must match the whole value.
+  set->match("/bar", matches);
+  EXPECT_THAT(matches, ElementsAre(1, 3));
+  set->match("/bar/", matches);
+  EXPECT_THAT(matches, ElementsAre(3));
+
+  set = Utility::parseRegexSet({"/foo"});
+  set->match("/bar", matches);
+  EXPECT_THAT(matches, IsEmpty());
+}
+
+TEST(RegexUtility, ParseRegexSetWithStdRegexes) {
+  CompiledMatcherSetPtr set =
+      Utility::parseRegexSet({"/foo/(?!bar)\\w+", "/foo/.*", "(/\\w+)\\1", "/bar"});
+  std::vector<uint32_t> matches;
+  set->match("/foo/baz", matches);
+  EXPECT_THAT(matches, ElementsAre(0, 1));
+  set->match("/foo/bar", matches);
+  EXPECT_THAT(matches, ElementsAre(1));
+  set->match("/foo/foo", matches);
+  EXPECT_THAT(matches, ElementsAre(0, 1, 2));
+  set->match("/bar", matches);
+  EXPECT_THAT(matches, ElementsAre(3));
+
+  set = Utility::parseRegexSet({"(?!a)b"});
+  set->match("b", matches);
+  EXPECT_THAT(matches, ElementsAre(0));
+}
+
+TEST(RegexUtility, EmptyRegexSet) {
+  CompiledMatcherSetPtr set = Utility::parseRegexSet({});
+  std::vector<uint32_t> matches{42};
+  set->match("/foo", matches);
+  EXPECT_THAT(matches, IsEmpty());
+}
+
+} // namespace Regex
+} // namespace Envoy
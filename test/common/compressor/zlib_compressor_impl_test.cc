@@ -281,6 +281,32 @@ TEST_F(ZlibCompressorImplTest, CompressWithNotCommonParams) {
   EXPECT_EQ("0000ffff", footer_hex_str.substr(footer_hex_str.size() - 8, 10));
 }
 
+/**
+ * Exercises finishing the stream, which writes the gzip trailer instead of a sync flush marker.
+ */
+TEST_F(ZlibCompressorImplTest, CompressAndFinish) {
+  Buffer::OwnedImpl input_buffer;
+  Buffer::OwnedImpl output_buffer;
+
+  Envoy::Compressor::ZlibCompressorImpl compressor(8);
+  compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                  ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                  memory_level);
+
+  TestUtility::feedBufferWithRandomCharacters(input_buffer, default_input_size);
+  compressor.compress(input_buffer, output_buffer);
+  input_buffer.drain(default_input_size);
+  compressor.finish(output_buffer);
+
+  const std::string output_hex_str = Hex::encode(
+      reinterpret_cast<const uint8_t*>(output_buffer.linearize(output_buffer.length())),
+      output_buffer.length());
+  // HEADER 0x1f = 31 (window_bits)
+  EXPECT_EQ("1f8b", output_hex_str.substr(0, 4));
+  // FOOTER ends with the input size, little endian (796 = 0x31c).
+  EXPECT_EQ("1c030000", output_hex_str.substr(output_hex_str.size() - 8));
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Envoy
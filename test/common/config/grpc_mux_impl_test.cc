@@ -276,6 +276,97 @@ TEST_F(GrpcMuxImplTest, WatchDemux) {
   expectSendMessage(type_url, {}, "2");
 }
 
+// Validate that watches are only notified when one of their resources is added, changed or
+// removed.
+TEST_F(GrpcMuxImplTest, WatchSkipsUnchangedResources) {
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  MockGrpcMuxCallbacks foo_callbacks;
+  auto foo_sub = grpc_mux_->subscribe(type_url, {"x"}, foo_callbacks);
+  MockGrpcMuxCallbacks bar_callbacks;
+  auto bar_sub = grpc_mux_->subscribe(type_url, {"y"}, bar_callbacks);
+  EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"y", "x"}, "");
+  grpc_mux_->start();
+
+  envoy::api::v2::ClusterLoadAssignment load_assignment_x;
+  load_assignment_x.set_cluster_name("x");
+  envoy::api::v2::ClusterLoadAssignment load_assignment_y;
+  load_assignment_y.set_cluster_name("y");
+
+  {
+    std::unique_ptr<envoy::api::v2::DiscoveryResponse> response(
+        new envoy::api::v2::DiscoveryResponse());
+    response->set_type_url(type_url);
+    response->set_version_info("1");
+    response->add_resources()->PackFrom(load_assignment_x);
+    response->add_resources()->PackFrom(load_assignment_y);
+    EXPECT_CALL(bar_callbacks, onConfigUpdate(_, "1"));
+    EXPECT_CALL(foo_callbacks, onConfigUpdate(_, "1"));
+    expectSendMessage(type_url, {"y", "x"}, "1");
+    grpc_mux_->onReceiveMessage(std::move(response));
+  }
+
+  // Only "x" changes.
+  load_assignment_x.add_endpoints()->set_priority(1);
+  {
+    std::unique_ptr<envoy::api::v2::DiscoveryResponse> response(
+        new envoy::api::v2::DiscoveryResponse());
+    response->set_type_url(type_url);
+    response->set_version_info("2");
+    response->add_resources()->PackFrom(load_assignment_x);
+    response->add_resources()->PackFrom(load_assignment_y);
+    EXPECT_CALL(bar_callbacks, onConfigUpdateUnchanged("2"));
+    EXPECT_CALL(foo_callbacks, onConfigUpdate(_, "2"))
+        .WillOnce(Invoke(
+            [&load_assignment_x](const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
+                                 const std::string&) {
+              EXPECT_EQ(1, resources.size());
+              envoy::api::v2::ClusterLoadAssignment expected_assignment;
+              resources[0].UnpackTo(&expected_assignment);
+              EXPECT_TRUE(TestUtility::protoEqual(expected_assignment, load_assignment_x));
+            }));
+    expectSendMessage(type_url, {"y", "x"}, "2");
+    grpc_mux_->onReceiveMessage(std::move(response));
+  }
+
+  // "x" is removed.
+  {
+    std::unique_ptr<envoy::api::v2::DiscoveryResponse> response(
+        new envoy::api::v2::DiscoveryResponse());
+    response->set_type_url(type_url);
+    response->set_version_info("3");
+    response->add_resources()->PackFrom(load_assignment_y);
+    EXPECT_CALL(bar_callbacks, onConfigUpdateUnchanged("3"));
+    EXPECT_CALL(foo_callbacks, onConfigUpdate(_, "3"))
+        .WillOnce(Invoke([](const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
+                            const std::string&) { EXPECT_TRUE(resources.empty()); }));
+    expectSendMessage(type_url, {"y", "x"}, "3");
+    grpc_mux_->onReceiveMessage(std::move(response));
+  }
+
+  // A new watch gets the unchanged "y" on its first update.
+  MockGrpcMuxCallbacks baz_callbacks;
+  expectSendMessage(type_url, {"y", "x"}, "3");
+  auto baz_sub = grpc_mux_->subscribe(type_url, {"y"}, baz_callbacks);
+  {
+    std::unique_ptr<envoy::api::v2::DiscoveryResponse> response(
+        new envoy::api::v2::DiscoveryResponse());
+    response->set_type_url(type_url);
+    response->set_version_info("4");
+    response->add_resources()->PackFrom(load_assignment_y);
+    EXPECT_CALL(baz_callbacks, onConfigUpdate(_, "4"));
+    EXPECT_CALL(bar_callbacks, onConfigUpdateUnchanged("4"));
+    EXPECT_CALL(foo_callbacks, onConfigUpdateUnchanged("4"));
+    expectSendMessage(type_url, {"y", "x"}, "4");
+    grpc_mux_->onReceiveMessage(std::move(response));
+  }
+
+  expectSendMessage(type_url, {"y", "x"}, "4");
+  expectSendMessage(type_url, {"x"}, "4");
+  expectSendMessage(type_url, {}, "4");
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
@@ -67,6 +67,19 @@ TEST_F(GrpcSubscriptionImplTest, RepeatedNonce) {
   verifyStats(7, 2, 2, 0, 13237225503670494420U);
 }
 
+// Validate that an update that does not change any resources is not delivered, but still counts as
+// an accepted update and changes the version.
+TEST_F(GrpcSubscriptionImplTest, UnchangedResources) {
+  InSequence s;
+  startSubscription({"cluster0", "cluster1"});
+  verifyStats(1, 0, 0, 0, 0);
+  deliverConfigUpdate({"cluster0", "cluster1"}, "0", true);
+  verifyStats(2, 1, 0, 0, 7148434200721666028);
+  deliverConfigUpdate({"cluster0", "cluster1"}, "1", true);
+  EXPECT_EQ("1", subscription_->versionInfo());
+  verifyStats(3, 2, 0, 0, 13237225503670494420U);
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
@@ -82,19 +82,30 @@ public:
     response->set_nonce(last_response_nonce_);
     response->set_type_url(Config::TypeUrl::get().ClusterLoadAssignment);
     Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> typed_resources;
+    std::vector<std::string> delivered_cluster_names;
     for (const auto& cluster : cluster_names) {
       if (std::find(last_cluster_names_.begin(), last_cluster_names_.end(), cluster) !=
           last_cluster_names_.end()) {
         envoy::api::v2::ClusterLoadAssignment* load_assignment = typed_resources.Add();
         load_assignment->set_cluster_name(cluster);
         response->add_resources()->PackFrom(*load_assignment);
+        delivered_cluster_names.push_back(cluster);
       }
     }
-    EXPECT_CALL(callbacks_, onConfigUpdate(RepeatedProtoEq(typed_resources)))
-        .WillOnce(ThrowOnRejectedConfig(accept));
-    if (accept) {
+    // An update that does not change any resources of an updated subscription only changes its
+    // version.
+    const bool unchanged = updated_ && delivered_cluster_names == last_delivered_cluster_names_;
+    if (unchanged) {
+      EXPECT_CALL(callbacks_, onConfigUpdate(_)).Times(0);
+    } else {
+      EXPECT_CALL(callbacks_, onConfigUpdate(RepeatedProtoEq(typed_resources)))
+          .WillOnce(ThrowOnRejectedConfig(accept));
+    }
+    if (accept || unchanged) {
       expectSendMessage(last_cluster_names_, version);
       version_ = version;
+      updated_ = true;
+      last_delivered_cluster_names_ = delivered_cluster_names;
     } else {
       EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
       expectSendMessage(last_cluster_names_, version_);
@@ -112,6 +123,7 @@ public:
     expectSendMessage(cluster_names, version_);
     subscription_->updateResources(cluster_names);
     last_cluster_names_ = cluster_names;
+    updated_ = false;
   }
 
   std::string version_;
@@ -127,6 +139,10 @@ public:
   std::unique_ptr<GrpcEdsSubscriptionImpl> subscription_;
   std::string last_response_nonce_;
   std::vector<std::string> last_cluster_names_;
+  // Whether the subscription has accepted an update since it last changed its resources, and the
+  // resources it was sent.
+  bool updated_{};
+  std::vector<std::string> last_delivered_cluster_names_;
 };
 
 // TODO(danielhochman): test with RDS and ensure version_info is same as what API returned
@@ -1,6 +1,7 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
@@ -96,6 +97,59 @@ TEST_F(DispatcherImplTest, Post) {
   cv_.wait(lock, [this]() { return work_finished_; });
 }
 
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  const uint32_t num_threads = 4;
+  const uint32_t num_posts = 1000;
+  uint32_t callbacks_run = 0;
+  // The index of the last callback run from each thread, to check that each thread's callbacks
+  // run in the order they were posted.
+  std::vector<int64_t> last_index(num_threads, -1);
+
+  std::vector<std::unique_ptr<Thread::Thread>> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(new Thread::Thread([this, i, &callbacks_run, &last_index]() {
+      for (uint32_t j = 0; j < num_posts; j++) {
+        dispatcher_->post([this, i, j, &callbacks_run, &last_index]() {
+          std::lock_guard<std::mutex> lock(mu_);
+          EXPECT_EQ(last_index[i] + 1, j);
+          last_index[i] = j;
+          if (++callbacks_run == num_threads * num_posts) {
+            work_finished_ = true;
+            cv_.notify_one();
+          }
+        });
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return work_finished_; });
+}
+
+TEST_F(DispatcherImplTest, PostFromPostCallback) {
+  std::vector<uint32_t> order;
+  // Post from the dispatcher thread, so that both callbacks are pending before either runs.
+  dispatcher_->post([this, &order]() {
+    dispatcher_->post([this, &order]() {
+      order.push_back(1);
+      dispatcher_->post([this, &order]() {
+        std::lock_guard<std::mutex> lock(mu_);
+        order.push_back(3);
+        work_finished_ = true;
+        cv_.notify_one();
+      });
+    });
+    dispatcher_->post([&order]() { order.push_back(2); });
+  });
+
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return work_finished_; });
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 3}), order);
+}
+
 TEST_F(DispatcherImplTest, Timer) {
   TimerPtr timer;
   dispatcher_->post([this, &timer]() {
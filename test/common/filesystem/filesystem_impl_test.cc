@@ -26,14 +26,28 @@ using testing::Throw;
 using testing::_;
 
 namespace Envoy {
+namespace {
+
+// Returns the data written by a writev() call.
+std::string writtenData(const iovec* iov, int num_iovec) {
+  std::string written;
+  for (int i = 0; i < num_iovec; i++) {
+    written.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+  }
+  return written;
+}
+
+} // namespace
 
 TEST(FileSystemImpl, BadFile) {
   Event::MockDispatcher dispatcher;
   Thread::MutexBasicLockable lock;
+  Filesystem::FileFlusher flusher;
   Stats::IsolatedStoreImpl store;
   EXPECT_CALL(dispatcher, createTimer_(_));
-  EXPECT_THROW(Filesystem::FileImpl("", dispatcher, lock, store, std::chrono::milliseconds(10000)),
-               EnvoyException);
+  EXPECT_THROW(
+      Filesystem::FileImpl("", dispatcher, lock, flusher, store, std::chrono::milliseconds(10000)),
+      EnvoyException);
 }
 
 TEST(FileSystemImpl, fileExists) {
@@ -93,18 +107,20 @@ TEST(FileSystemImpl, flushToLogFilePeriodically) {
   Stats::IsolatedStoreImpl stats_store;
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
 
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("test", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("test");
@@ -116,13 +132,13 @@ TEST(FileSystemImpl, flushToLogFilePeriodically) {
     }
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("test2", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   // make sure timer is re-enabled on callback call
@@ -146,17 +162,21 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
   Stats::IsolatedStoreImpl stats_store;
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
 
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
 
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
 
   // The first write to a given file will start the flush thread, which can flush
   // immediately (race on whether it will or not). So do a write and flush to
   // get that state out of the way, then test that small writes don't trigger a flush.
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int, const void*, size_t num_bytes) -> ssize_t { return num_bytes; }));
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        return writtenData(iov, num_iovec).size();
+      }));
   file.write("prime-it");
   file.flush();
   uint32_t expected_writes = 1;
@@ -165,13 +185,13 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
     EXPECT_EQ(expected_writes, os_sys_calls.num_writes_);
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("test", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("test");
@@ -188,13 +208,13 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
     EXPECT_EQ(expected_writes, os_sys_calls.num_writes_);
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("test2", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   // make sure timer is re-enabled on callback call
@@ -219,19 +239,21 @@ TEST(FileSystemImpl, reopenFile) {
   Stats::IsolatedStoreImpl stats_store;
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
 
   Sequence sq;
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(5));
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
       .InSequence(sq)
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("before", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("before");
@@ -247,14 +269,14 @@ TEST(FileSystemImpl, reopenFile) {
   EXPECT_CALL(os_sys_calls, close(5)).InSequence(sq);
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(10));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
       .InSequence(sq)
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
         EXPECT_EQ("reopened", written);
         EXPECT_EQ(10, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   EXPECT_CALL(os_sys_calls, close(10)).InSequence(sq);
@@ -279,19 +301,18 @@ TEST(FilesystemImpl, reopenThrows) {
   Stats::IsolatedStoreImpl stats_store;
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillRepeatedly(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        UNREFERENCED_PARAMETER(fd);
-        UNREFERENCED_PARAMETER(buffer);
-
-        return num_bytes;
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillRepeatedly(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        return writtenData(iov, num_iovec).size();
       }));
 
   Sequence sq;
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(5));
 
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
   EXPECT_CALL(os_sys_calls, close(5)).InSequence(sq);
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(-1));
 
@@ -326,18 +347,20 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
   Stats::IsolatedStoreImpl stats_store;
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
 
-  Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
         UNREFERENCED_PARAMETER(fd);
 
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+        const std::string written = writtenData(iov, num_iovec);
         std::string expected("a");
         EXPECT_EQ(expected, written);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("a");
@@ -351,15 +374,15 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
 
   // First write happens without waiting on thread_flush_. Now make a big string and it should be
   // flushed even when timer is not enabled
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int num_iovec) -> ssize_t {
         UNREFERENCED_PARAMETER(fd);
 
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+        const std::string written = writtenData(iov, num_iovec);
         std::string expected(1024 * 64 + 1, 'b');
         EXPECT_EQ(expected, written);
 
-        return num_bytes;
+        return written.size();
       }));
 
   std::string big_string(1024 * 64 + 1, 'b');
@@ -372,4 +395,99 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
     }
   }
 }
+
+TEST(FilesystemImpl, filesShareFlushThread) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  Thread::MutexBasicLockable mutex;
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
+
+  NiceMock<Event::MockTimer>* timer1 = new NiceMock<Event::MockTimer>(&dispatcher);
+  EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
+  Filesystem::FileImpl file1("", dispatcher, mutex, flusher, stats_store,
+                             std::chrono::milliseconds(40));
+  NiceMock<Event::MockTimer>* timer2 = new NiceMock<Event::MockTimer>(&dispatcher);
+  EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(6));
+  Filesystem::FileImpl file2("", dispatcher, mutex, flusher, stats_store,
+                             std::chrono::milliseconds(40));
+
+  EXPECT_CALL(os_sys_calls, writev_(5, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
+        EXPECT_EQ("file1", written);
+        return written.size();
+      }));
+  EXPECT_CALL(os_sys_calls, writev_(6, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
+        EXPECT_EQ("file2", written);
+        return written.size();
+      }));
+
+  file1.write("file1");
+  file2.write("file2");
+  timer1->callback_();
+  timer2->callback_();
+
+  {
+    std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
+    while (os_sys_calls.num_writes_ != 2) {
+      os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
+    }
+  }
+}
+
+TEST(FilesystemImpl, writesBeyondBufferSizeAreDropped) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher);
+
+  Thread::MutexBasicLockable mutex;
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Filesystem::FileFlusher flusher;
+
+  EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5));
+  Filesystem::FileImpl file("", dispatcher, mutex, flusher, stats_store,
+                            std::chrono::milliseconds(40));
+
+  // The first write is flushed right away, so get it out of the way.
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        return writtenData(iov, num_iovec).size();
+      }));
+  file.write("prime-it");
+  {
+    std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
+    while (os_sys_calls.num_writes_ != 1) {
+      os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
+    }
+  }
+
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int num_iovec) -> ssize_t {
+        const std::string written = writtenData(iov, num_iovec);
+        EXPECT_EQ("a", written);
+        return written.size();
+      }));
+
+  // The second write does not fit in the buffer, so it is dropped rather than flushed.
+  file.write("a");
+  file.write(std::string(1024 * 1024 * 16, 'b'));
+  EXPECT_EQ(2UL, stats_store.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(1UL, stats_store.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(1UL, stats_store.gauge("filesystem.write_total_buffered").value());
+
+  timer->callback_();
+
+  {
+    std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
+    while (os_sys_calls.num_writes_ != 2) {
+      os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
+    }
+  }
+}
+
 } // namespace Envoy
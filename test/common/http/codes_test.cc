@@ -30,7 +30,8 @@ public:
                    const std::string& to_az = EMPTY_STRING) {
     CodeUtility::ResponseStatInfo info{
         global_store_,      cluster_scope_,        "prefix.", code,  internal_request,
-        request_vhost_name, request_vcluster_name, from_az,   to_az, canary};
+        request_vhost_name, request_vcluster_name, from_az,   to_az, canary,
+        nullptr};
 
     CodeUtility::chargeResponseStat(info);
   }
@@ -180,7 +181,7 @@ TEST(CodeUtilityResponseTimingTest, All) {
   CodeUtility::ResponseTimingInfo info{
       global_store, cluster_scope, "prefix.",    std::chrono::milliseconds(5),
       true,         true,          "vhost_name", "req_vcluster_name",
-      "from_az",    "to_az"};
+      "from_az",    "to_az",       nullptr};
 
   EXPECT_CALL(cluster_scope, histogram("prefix.upstream_rq_time"));
   EXPECT_CALL(cluster_scope, deliverHistogramToSinks(
@@ -210,5 +211,88 @@ TEST(CodeUtilityResponseTimingTest, All) {
   CodeUtility::chargeResponseTiming(info);
 }
 
+class CodeStatsImplTest : public testing::Test {
+public:
+  Stats::IsolatedStoreImpl global_store_;
+  Stats::IsolatedStoreImpl cluster_scope_;
+  CodeStatsImpl code_stats_{cluster_scope_};
+};
+
+TEST_F(CodeStatsImplTest, ResponseCodes) {
+  code_stats_.chargeResponseCode(CodeStats::Prefix::None, 200);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::None, 200);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::Canary, 503);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::Internal, 404);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::External, 100);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::Retry, 504);
+
+  EXPECT_EQ(2U, cluster_scope_.counter("upstream_rq_2xx").value());
+  EXPECT_EQ(2U, cluster_scope_.counter("upstream_rq_200").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("internal.upstream_rq_4xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("internal.upstream_rq_404").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_100").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("retry.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("retry.upstream_rq_504").value());
+}
+
+TEST_F(CodeStatsImplTest, UnknownResponseCodes) {
+  // Codes without a name, and codes outside of the known classes, are charged by name.
+  code_stats_.chargeResponseCode(CodeStats::Prefix::None, 299);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::None, 299);
+  code_stats_.chargeResponseCode(CodeStats::Prefix::Canary, 600);
+
+  EXPECT_EQ(2U, cluster_scope_.counter("upstream_rq_2xx").value());
+  EXPECT_EQ(2U, cluster_scope_.counter("upstream_rq_299").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_600").value());
+}
+
+TEST_F(CodeStatsImplTest, MatchesNamedStats) {
+  // Charging through a cluster's CodeStats must produce the same stats as charging by name.
+  CodeUtility::ResponseStatInfo info{
+      global_store_, cluster_scope_, EMPTY_STRING, 503, false, "vhost", "vcluster", "from_az",
+      "to_az",       true,           &code_stats_};
+  CodeUtility::chargeResponseStat(info);
+
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_503").value());
+  EXPECT_EQ(0U, cluster_scope_.counter("internal.upstream_rq_503").value());
+  EXPECT_EQ(1U, global_store_.counter("vhost.vhost.vcluster.vcluster.upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("zone.from_az.to_az.upstream_rq_503").value());
+}
+
+TEST(CodeStatsImplResponseTimingTest, All) {
+  Stats::MockStore global_store;
+  Stats::MockStore cluster_scope;
+  CodeStatsImpl code_stats(cluster_scope);
+
+  CodeUtility::ResponseTimingInfo info{
+      global_store, cluster_scope, EMPTY_STRING, std::chrono::milliseconds(5),
+      true,         false,         EMPTY_STRING, EMPTY_STRING,
+      EMPTY_STRING, EMPTY_STRING,  &code_stats};
+
+  // Histograms are only looked up by name the first time they are charged.
+  EXPECT_CALL(cluster_scope, histogram("upstream_rq_time"));
+  EXPECT_CALL(cluster_scope, histogram("canary.upstream_rq_time"));
+  EXPECT_CALL(cluster_scope, histogram("external.upstream_rq_time"));
+  EXPECT_CALL(cluster_scope,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "upstream_rq_time"), 5))
+      .Times(2);
+  EXPECT_CALL(cluster_scope,
+              deliverHistogramToSinks(Property(&Stats::Metric::name, "canary.upstream_rq_time"), 5))
+      .Times(2);
+  EXPECT_CALL(cluster_scope, deliverHistogramToSinks(
+                                 Property(&Stats::Metric::name, "external.upstream_rq_time"), 5))
+      .Times(2);
+  CodeUtility::chargeResponseTiming(info);
+  CodeUtility::chargeResponseTiming(info);
+}
+
 } // namespace Http
 } // namespace Envoy
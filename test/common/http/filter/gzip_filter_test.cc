@@ -0,0 +1,261 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
+#include "common/http/filter/gzip_filter.h"
+#include "common/json/json_loader.h"
+#include "common/stats/stats_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/http/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+using testing::_;
+
+namespace Envoy {
+namespace Http {
+
+// Records the histogram values that would be delivered to sinks.
+class TestStore : public Stats::IsolatedStoreImpl {
+public:
+  MOCK_METHOD2(deliverHistogramToSinks, void(const Stats::Histogram& histogram, uint64_t value));
+};
+
+class GzipFilterTest : public testing::Test {
+public:
+  GzipFilterTest() { setUpFilter("{}"); }
+
+  void setUpFilter(const std::string& json) {
+    Json::ObjectSharedPtr json_config = Json::Factory::loadFromString(json);
+    config_.reset(new GzipFilterConfig(*json_config, "test.", store_, time_source_));
+    filter_.reset(new GzipFilter(config_));
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+  }
+
+  void doRequest(TestHeaderMapImpl&& headers) {
+    EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+  }
+
+  // Sends a response of the given size, and checks that it was not modified.
+  void doResponseNoCompression(TestHeaderMapImpl& headers, uint64_t size = 1000) {
+    TestHeaderMapImpl original_headers(headers);
+    EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    EXPECT_EQ(original_headers, headers);
+
+    Buffer::OwnedImpl data(std::string(size, 'a'));
+    EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(data, true));
+    EXPECT_EQ(std::string(size, 'a'), TestUtility::bufferToString(data));
+  }
+
+  // Sends a response in two parts and returns the decompressed body.
+  std::string doResponseCompression(TestHeaderMapImpl& headers, const std::string& body,
+                                    int64_t window_bits) {
+    EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+
+    Buffer::OwnedImpl compressed;
+    Buffer::OwnedImpl data1(body.substr(0, body.size() / 2));
+    EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(data1, false));
+    compressed.move(data1);
+
+    Buffer::OwnedImpl data2(body.substr(body.size() / 2));
+    EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(data2, true));
+    compressed.move(data2);
+
+    EXPECT_EQ(body.size(), config_->stats().total_uncompressed_bytes_.value());
+    EXPECT_EQ(compressed.length(), config_->stats().total_compressed_bytes_.value());
+    EXPECT_GT(body.size(), compressed.length());
+    return decompress(compressed, window_bits);
+  }
+
+  std::string decompress(const Buffer::Instance& compressed, int64_t window_bits) {
+    Decompressor::ZlibDecompressorImpl decompressor;
+    decompressor.init(window_bits);
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(compressed, decompressed);
+    return TestUtility::bufferToString(decompressed);
+  }
+
+  std::string body_{std::string(1000, 'a') + std::string(1000, 'b')};
+  NiceMock<TestStore> store_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
+  NiceMock<MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  GzipFilterConfigSharedPtr config_;
+  std::unique_ptr<GzipFilter> filter_;
+};
+
+TEST_F(GzipFilterTest, ChooseContentCoding) {
+  EXPECT_EQ(ContentCoding::Gzip, GzipFilter::chooseContentCoding("gzip"));
+  EXPECT_EQ(ContentCoding::Gzip, GzipFilter::chooseContentCoding("deflate, gzip"));
+  EXPECT_EQ(ContentCoding::Gzip, GzipFilter::chooseContentCoding(" GZIP ;q=0.5, br"));
+  EXPECT_EQ(ContentCoding::Gzip, GzipFilter::chooseContentCoding("*"));
+  EXPECT_EQ(ContentCoding::Gzip, GzipFilter::chooseContentCoding("deflate;q=0.5, *;q=0.8"));
+  EXPECT_EQ(ContentCoding::Deflate, GzipFilter::chooseContentCoding("deflate"));
+  EXPECT_EQ(ContentCoding::Deflate, GzipFilter::chooseContentCoding("gzip;q=0.5, deflate"));
+  EXPECT_EQ(ContentCoding::Deflate, GzipFilter::chooseContentCoding("gzip;q=0, *"));
+  EXPECT_EQ(ContentCoding::Identity, GzipFilter::chooseContentCoding(""));
+  EXPECT_EQ(ContentCoding::Identity, GzipFilter::chooseContentCoding("identity, br"));
+  EXPECT_EQ(ContentCoding::Identity, GzipFilter::chooseContentCoding("gzip;q=0, deflate;q=0"));
+  EXPECT_EQ(ContentCoding::Identity, GzipFilter::chooseContentCoding("*;q=0"));
+}
+
+TEST_F(GzipFilterTest, NoAcceptEncoding) {
+  doRequest({{":method", "get"}});
+  TestHeaderMapImpl headers{{":status", "200"}, {"content-type", "text/html"}};
+  doResponseNoCompression(headers);
+  EXPECT_EQ(1U, config_->stats().no_accept_header_.value());
+  EXPECT_EQ(0U, config_->stats().not_compressed_.value());
+}
+
+TEST_F(GzipFilterTest, IdentityAcceptEncoding) {
+  doRequest({{":method", "get"}, {"accept-encoding", "identity"}});
+  TestHeaderMapImpl headers{{":status", "200"}, {"content-type", "text/html"}};
+  doResponseNoCompression(headers);
+  EXPECT_EQ(1U, config_->stats().header_identity_.value());
+  EXPECT_EQ(0U, config_->stats().not_compressed_.value());
+}
+
+TEST_F(GzipFilterTest, GzipCompression) {
+  doRequest({{":method", "get"}, {"accept-encoding", "deflate;q=0.5, gzip"}});
+  TestHeaderMapImpl headers{{":status", "200"},
+                            {"content-type", "text/html; charset=UTF-8"},
+                            {"content-length", "2000"}};
+
+  MonotonicTime start;
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(start))
+      .WillOnce(Return(start + std::chrono::microseconds(10)))
+      .WillOnce(Return(start + std::chrono::microseconds(20)))
+      .WillOnce(Return(start + std::chrono::microseconds(50)));
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "test.gzip.compression_time_us"), 40));
+  EXPECT_EQ(body_, doResponseCompression(headers, body_, 31));
+
+  EXPECT_EQ("gzip", headers.get_("content-encoding"));
+  EXPECT_EQ("Accept-Encoding", headers.get_("vary"));
+  EXPECT_FALSE(headers.has("content-length"));
+  EXPECT_EQ(1U, config_->stats().header_gzip_.value());
+  EXPECT_EQ(1U, config_->stats().compressed_.value());
+}
+
+TEST_F(GzipFilterTest, DeflateCompression) {
+  setUpFilter(R"EOF({"compression_level": "best", "compression_strategy": "rle",
+                     "memory_level": 9, "window_bits": 15})EOF");
+  doRequest({{":method", "get"}, {"accept-encoding", "deflate"}});
+  TestHeaderMapImpl headers{{":status", "200"}, {"content-type", "application/json"}};
+
+  EXPECT_EQ(body_, doResponseCompression(headers, body_, 15));
+  EXPECT_EQ("deflate", headers.get_("content-encoding"));
+  EXPECT_EQ(1U, config_->stats().header_deflate_.value());
+  EXPECT_EQ(1U, config_->stats().compressed_.value());
+}
+
+TEST_F(GzipFilterTest, CompressionWithTrailers) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+  TestHeaderMapImpl headers{{":status", "200"}, {"content-type", "text/plain"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+
+  Buffer::OwnedImpl compressed;
+  Buffer::OwnedImpl data(body_);
+  EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(data, false));
+  compressed.move(data);
+
+  EXPECT_CALL(encoder_callbacks_, addEncodedData(_, true))
+      .WillOnce(Invoke([&](Buffer::Instance& data, bool) -> void { compressed.move(data); }));
+  TestHeaderMapImpl trailers{{"grpc-status", "0"}};
+  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
+  EXPECT_EQ(body_, decompress(compressed, 31));
+}
+
+TEST_F(GzipFilterTest, HeaderOnlyResponse) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+  TestHeaderMapImpl headers{{":status", "304"}, {"content-type", "text/html"}};
+  TestHeaderMapImpl original_headers(headers);
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, true));
+  EXPECT_EQ(original_headers, headers);
+}
+
+TEST_F(GzipFilterTest, NotCompressible) {
+  const std::vector<TestHeaderMapImpl> responses{
+      {{":status", "200"}, {"content-type", "text/html"}, {"content-length", "99"}},
+      {{":status", "200"}, {"content-type", "text/plain"}},
+      {{":status", "200"}},
+      {{":status", "200"}, {"content-type", "text/html"}, {"content-encoding", "br"}},
+      {{":status", "200"}, {"content-type", "text/html"}, {"cache-control", "no-transform"}},
+      {{":status", "200"}, {"content-type", "text/html"}, {"etag", "\"abc\""}}};
+  for (size_t i = 0; i < responses.size(); i++) {
+    setUpFilter(R"EOF({"content_length": 100, "content_type": ["text/html"],
+                       "disable_on_etag_header": true})EOF");
+    doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+    TestHeaderMapImpl headers(responses[i]);
+    doResponseNoCompression(headers);
+    EXPECT_EQ(i + 1, config_->stats().not_compressed_.value());
+  }
+  EXPECT_EQ(0U, config_->stats().compressed_.value());
+}
+
+TEST_F(GzipFilterTest, WeakEtagAndVary) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+  TestHeaderMapImpl headers{{":status", "200"},
+                            {"content-type", "text/html"},
+                            {"etag", "\"abc\""},
+                            {"vary", "Cookie"}};
+  EXPECT_EQ(body_, doResponseCompression(headers, body_, 31));
+  EXPECT_EQ("W/\"abc\"", headers.get_("etag"));
+  EXPECT_EQ("Cookie, Accept-Encoding", headers.get_("vary"));
+}
+
+TEST_F(GzipFilterTest, VaryByReference) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+  static const std::string vary = "Origin";
+  TestHeaderMapImpl headers{{":status", "200"}, {"content-type", "text/html"}};
+  headers.addReference(Headers::get().Vary, vary);
+  EXPECT_EQ(body_, doResponseCompression(headers, body_, 31));
+  EXPECT_EQ("Origin, Accept-Encoding", headers.get_("vary"));
+  EXPECT_EQ("Origin", vary);
+}
+
+TEST_F(GzipFilterTest, RepeatedAcceptEncoding) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip;q=0"}, {"accept-encoding", "deflate"}});
+  EXPECT_EQ(1U, config_->stats().header_deflate_.value());
+}
+
+TEST_F(GzipFilterTest, RepeatedVary) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+  TestHeaderMapImpl headers{{":status", "200"},
+                            {"content-type", "text/html"},
+                            {"vary", "Cookie"},
+                            {"vary", "Accept-Encoding"}};
+  EXPECT_EQ(body_, doResponseCompression(headers, body_, 31));
+  TestHeaderMapImpl expected_headers{{":status", "200"},
+                                     {"content-type", "text/html"},
+                                     {"vary", "Cookie"},
+                                     {"vary", "Accept-Encoding"},
+                                     {"content-encoding", "gzip"}};
+  EXPECT_EQ(expected_headers, headers);
+}
+
+TEST_F(GzipFilterTest, RemoveAcceptEncodingHeader) {
+  setUpFilter(R"EOF({"remove_accept_encoding_header": true})EOF");
+  TestHeaderMapImpl headers{{":method", "get"}, {"accept-encoding", "gzip"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+  EXPECT_FALSE(headers.has("accept-encoding"));
+  EXPECT_EQ(1U, config_->stats().header_gzip_.value());
+}
+
+TEST_F(GzipFilterTest, BadConfig) {
+  EXPECT_THROW(setUpFilter(R"EOF({"window_bits": 16})EOF"), Json::Exception);
+  EXPECT_THROW(setUpFilter(R"EOF({"compression_level": "fast"})EOF"), Json::Exception);
+  EXPECT_THROW(setUpFilter(R"EOF({"unknown": true})EOF"), Json::Exception);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,108 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/headers.h"
+
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace {
+
+// Adds 'count' custom headers, on top of a typical set of request headers.
+void addHeaders(Envoy::Http::HeaderMapImpl& headers, int64_t count) {
+  headers.insertMethod().value(std::string("GET"));
+  headers.insertPath().value(std::string("/api/v1/users/12345/profile"));
+  headers.insertHost().value(std::string("api.example.com"));
+  headers.insertUserAgent().value(std::string("Mozilla/5.0 (X11; Linux x86_64)"));
+  headers.insertRequestId().value(std::string("6c1c2fd6-55b3-4bd2-a8a6-b3b5cf4e6c30"));
+  headers.insertForwardedFor().value(std::string("10.0.0.1"));
+  for (int64_t i = 0; i < count; i++) {
+    headers.addCopy(Envoy::Http::LowerCaseString("x-custom-header-" + std::to_string(i)),
+                    "custom value " + std::to_string(i));
+  }
+}
+
+} // namespace
+
+static void BM_HeaderMapImplAdd(benchmark::State& state) {
+  for (auto _ : state) {
+    Envoy::Http::HeaderMapImpl headers;
+    addHeaders(headers, state.range(0));
+    benchmark::DoNotOptimize(headers.size());
+  }
+}
+BENCHMARK(BM_HeaderMapImplAdd)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_HeaderMapImplGetInline(benchmark::State& state) {
+  Envoy::Http::HeaderMapImpl headers;
+  addHeaders(headers, state.range(0));
+  size_t length = 0;
+  for (auto _ : state) {
+    length += headers.Path()->value().size();
+  }
+  benchmark::DoNotOptimize(length);
+}
+BENCHMARK(BM_HeaderMapImplGetInline)->Arg(0)->Arg(10)->Arg(50);
+
+// Custom headers are found by a linear scan, so the lookup of the last header is the worst case.
+static void BM_HeaderMapImplGetCustom(benchmark::State& state) {
+  Envoy::Http::HeaderMapImpl headers;
+  addHeaders(headers, state.range(0));
+  const Envoy::Http::LowerCaseString key("x-custom-header-" + std::to_string(state.range(0) - 1));
+  size_t length = 0;
+  for (auto _ : state) {
+    const Envoy::Http::HeaderEntry* entry = headers.get(key);
+    RELEASE_ASSERT(entry != nullptr);
+    length += entry->value().size();
+  }
+  benchmark::DoNotOptimize(length);
+}
+BENCHMARK(BM_HeaderMapImplGetCustom)->Arg(1)->Arg(10)->Arg(50);
+
+static void BM_HeaderMapImplGetMissing(benchmark::State& state) {
+  Envoy::Http::HeaderMapImpl headers;
+  addHeaders(headers, state.range(0));
+  const Envoy::Http::LowerCaseString key("x-missing-header");
+  size_t found = 0;
+  for (auto _ : state) {
+    found += headers.get(key) != nullptr ? 1 : 0;
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_HeaderMapImplGetMissing)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_HeaderMapImplCopy(benchmark::State& state) {
+  Envoy::Http::HeaderMapImpl headers;
+  addHeaders(headers, state.range(0));
+  for (auto _ : state) {
+    Envoy::Http::HeaderMapImpl copy(headers);
+    benchmark::DoNotOptimize(copy.size());
+  }
+}
+BENCHMARK(BM_HeaderMapImplCopy)->Arg(0)->Arg(10)->Arg(50);
+
+static void BM_HeaderMapImplRemove(benchmark::State& state) {
+  const Envoy::Http::LowerCaseString key("x-custom-header-0");
+  for (auto _ : state) {
+    Envoy::Http::HeaderMapImpl headers;
+    addHeaders(headers, state.range(0));
+    headers.remove(key);
+    headers.removeUserAgent();
+    benchmark::DoNotOptimize(headers.size());
+  }
+}
+BENCHMARK(BM_HeaderMapImplRemove)->Arg(1)->Arg(10)->Arg(50);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -1,4 +1,5 @@
 #include <string>
+#include <vector>
 
 #include "common/http/header_map_impl.h"
 
@@ -590,5 +591,66 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
+TEST(HeaderMapImplTest, ManyHeaders) {
+  TestHeaderMapImpl headers;
+  HeaderEntry& host = headers.insertHost();
+  host.value(std::string("host"));
+
+  // Enough headers to span several storage blocks.
+  for (int i = 0; i < 100; i++) {
+    headers.addCopy("header" + std::to_string(i), "value" + std::to_string(i));
+  }
+  EXPECT_EQ(101UL, headers.size());
+
+  // Entries never move, so references taken earlier remain valid.
+  EXPECT_EQ(&host, headers.Host());
+  EXPECT_STREQ("host", host.value().c_str());
+
+  // Remove every other header and check order and size are preserved.
+  for (int i = 0; i < 100; i += 2) {
+    headers.remove(LowerCaseString("header" + std::to_string(i)));
+  }
+  EXPECT_EQ(51UL, headers.size());
+
+  std::vector<std::string> keys;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  ASSERT_EQ(51UL, keys.size());
+  EXPECT_EQ(":authority", keys[0]);
+  for (int i = 1; i < 51; i++) {
+    EXPECT_EQ("header" + std::to_string(i * 2 - 1), keys[i]);
+  }
+
+  uint64_t expected_byte_size = strlen(":authority") + strlen("host");
+  for (int i = 1; i < 100; i += 2) {
+    expected_byte_size += ("header" + std::to_string(i)).size();
+    expected_byte_size += ("value" + std::to_string(i)).size();
+  }
+  EXPECT_EQ(expected_byte_size, headers.byteSize());
+
+  TestHeaderMapImpl copy(headers);
+  EXPECT_EQ(copy, headers);
+  EXPECT_STREQ("host", copy.Host()->value().c_str());
+}
+
+TEST(HeaderMapImplTest, StaticLookupMiss) {
+  TestHeaderMapImpl headers;
+  const HeaderEntry* entry;
+
+  // Keys that are a prefix or an extension of an inline header name are not inline headers.
+  EXPECT_EQ(HeaderMap::Lookup::NotSupported, headers.lookup(LowerCaseString("hos"), &entry));
+  EXPECT_EQ(HeaderMap::Lookup::NotSupported, headers.lookup(LowerCaseString("hostx"), &entry));
+  EXPECT_EQ(HeaderMap::Lookup::NotSupported, headers.lookup(LowerCaseString(""), &entry));
+
+  // The legacy host header maps to :authority.
+  headers.addCopy("host", "foo");
+  EXPECT_EQ(HeaderMap::Lookup::Found, headers.lookup(LowerCaseString("host"), &entry));
+  EXPECT_STREQ(":authority", entry->key().c_str());
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -104,6 +104,31 @@ TEST_F(Http1ServerConnectionImplTest, EmptyHeader) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+TEST_F(Http1ServerConnectionImplTest, RepeatedListHeaders) {
+  initialize();
+
+  InSequence sequence;
+
+  Http::MockStreamDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(ReturnRef(decoder));
+
+  TestHeaderMapImpl expected_headers{
+      {"accept-encoding", "gzip"},      {"accept-encoding", "deflate"},
+      {"content-encoding", "identity"}, {"content-encoding", "gzip"},
+      {"etag", "\"a\""},                {"etag", "\"b\""},
+      {"vary", "Cookie"},               {"vary", "Origin"},
+      {":path", "/"},                   {":method", "GET"},
+  };
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers), true)).Times(1);
+
+  Buffer::OwnedImpl buffer(
+      "GET / HTTP/1.1\r\nAccept-Encoding: gzip\r\nAccept-Encoding: deflate\r\n"
+      "Content-Encoding: identity\r\nContent-Encoding: gzip\r\nETag: \"a\"\r\nETag: \"b\"\r\n"
+      "Vary: Cookie\r\nVary: Origin\r\n\r\n");
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+}
+
 TEST_F(Http1ServerConnectionImplTest, Http10) {
   initialize();
 
@@ -0,0 +1,134 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+static const char Request[] =
+    "GET /api/v1/users/12345/profile?fields=name,email HTTP/1.1\r\n"
+    "Host: api.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n"
+    "Accept: application/json, text/plain, */*\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Cookie: session=4f1e2d3c4b5a69788796a5b4c3d2e1f0; theme=dark\r\n"
+    "X-Request-Id: 6c1c2fd6-55b3-4bd2-a8a6-b3b5cf4e6c30\r\n"
+    "X-Forwarded-For: 10.0.0.1\r\n"
+    "\r\n";
+
+static const char Response[] = "HTTP/1.1 200 OK\r\n"
+                               "Date: Mon, 15 Jan 2018 10:00:00 GMT\r\n"
+                               "Content-Type: application/json; charset=utf-8\r\n"
+                               "Content-Length: 0\r\n"
+                               "Cache-Control: private, max-age=300\r\n"
+                               "Vary: Accept-Encoding\r\n"
+                               "Set-Cookie: theme=dark; Path=/; HttpOnly\r\n"
+                               "X-Envoy-Upstream-Service-Time: 12\r\n"
+                               "\r\n";
+
+namespace {
+
+// A decoder that answers every request with a header only response, so that the server codec is
+// ready for the next request when dispatch() returns.
+class RespondingDecoder : public Envoy::Http::StreamDecoder {
+public:
+  void decodeHeaders(Envoy::Http::HeaderMapPtr&& headers, bool end_stream) override {
+    RELEASE_ASSERT(end_stream);
+    headers_ = headers->size();
+    Envoy::Http::HeaderMapImpl response_headers{{Envoy::Http::Headers::get().Status, "200"}};
+    encoder_->encodeHeaders(response_headers, true);
+  }
+  void decodeData(Envoy::Buffer::Instance&, bool) override {}
+  void decodeTrailers(Envoy::Http::HeaderMapPtr&&) override {}
+
+  Envoy::Http::StreamEncoder* encoder_{};
+  size_t headers_{};
+};
+
+class ServerCallbacks : public Envoy::Http::ServerConnectionCallbacks {
+public:
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+
+  // Http::ServerConnectionCallbacks
+  Envoy::Http::StreamDecoder& newStream(Envoy::Http::StreamEncoder& response_encoder) override {
+    decoder_.encoder_ = &response_encoder;
+    return decoder_;
+  }
+
+  RespondingDecoder decoder_;
+};
+
+class ResponseDecoder : public Envoy::Http::StreamDecoder {
+public:
+  void decodeHeaders(Envoy::Http::HeaderMapPtr&& headers, bool) override {
+    headers_ = headers->size();
+  }
+  void decodeData(Envoy::Buffer::Instance&, bool) override {}
+  void decodeTrailers(Envoy::Http::HeaderMapPtr&&) override {}
+
+  size_t headers_{};
+};
+
+class ClientCallbacks : public Envoy::Http::ConnectionCallbacks {
+public:
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+};
+
+} // namespace
+
+// Each iteration includes encoding the response, which is needed before the next request.
+static void BM_Http1ServerDispatch(benchmark::State& state) {
+  testing::NiceMock<Envoy::Network::MockConnection> connection;
+  ServerCallbacks callbacks;
+  Envoy::Http::Http1Settings settings;
+  Envoy::Http::Http1::ServerConnectionImpl codec(connection, callbacks, settings);
+
+  for (auto _ : state) {
+    Envoy::Buffer::OwnedImpl buffer(Request, sizeof(Request) - 1);
+    codec.dispatch(buffer);
+  }
+  benchmark::DoNotOptimize(callbacks.decoder_.headers_);
+}
+BENCHMARK(BM_Http1ServerDispatch);
+
+static void BM_Http1ClientDispatch(benchmark::State& state) {
+  testing::NiceMock<Envoy::Network::MockConnection> connection;
+  ClientCallbacks callbacks;
+  Envoy::Http::Http1::ClientConnectionImpl codec(connection, callbacks);
+  ResponseDecoder decoder;
+  Envoy::Http::HeaderMapImpl request_headers{{Envoy::Http::Headers::get().Method, "GET"},
+                                             {Envoy::Http::Headers::get().Path, "/"},
+                                             {Envoy::Http::Headers::get().Host, "example.com"}};
+
+  // Each iteration includes encoding the request, as the client codec only parses a response for a
+  // pending request.
+  for (auto _ : state) {
+    codec.newStream(decoder).encodeHeaders(request_headers, true);
+    Envoy::Buffer::OwnedImpl buffer(Response, sizeof(Response) - 1);
+    codec.dispatch(buffer);
+  }
+  benchmark::DoNotOptimize(decoder.headers_);
+}
+BENCHMARK(BM_Http1ClientDispatch);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -212,6 +212,8 @@ public:
     queries_.emplace_back(query);
   }
 
+  void onAcceptBatch(uint32_t, std::chrono::microseconds) override {}
+
   void addHosts(const std::string& hostname, const IpList& ip, const record_type& type) {
     if (type == A) {
       hosts_A_[hostname] = ip;
@@ -0,0 +1,77 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+#include "common/network/cidr_range.h"
+#include "common/network/lc_trie.h"
+#include "common/network/utility.h"
+
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace {
+
+// Builds a trie of 'tags' tags, each with 'ranges_per_tag' disjoint IPv4 /24 ranges, along with a
+// set of addresses to look up, half of which are contained in one of the ranges.
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie>
+buildTrie(int64_t tags, int64_t ranges_per_tag,
+          std::vector<Envoy::Network::Address::InstanceConstSharedPtr>& addresses) {
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>> tag_data;
+  uint32_t range_index = 0;
+  for (int64_t i = 0; i < tags; i++) {
+    std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>> ip_tags;
+    ip_tags.first = fmt::format("tag_{}", i);
+    for (int64_t j = 0; j < ranges_per_tag; j++, range_index++) {
+      ip_tags.second.push_back(Envoy::Network::Address::CidrRange::create(fmt::format(
+          "10.{}.{}.0/24", (range_index >> 8) & 0xff, range_index & 0xff)));
+      addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+          fmt::format("10.{}.{}.1", (range_index >> 8) & 0xff, range_index & 0xff)));
+      addresses.push_back(Envoy::Network::Utility::parseInternetAddress(
+          fmt::format("11.{}.{}.1", (range_index >> 8) & 0xff, range_index & 0xff)));
+    }
+    tag_data.push_back(ip_tags);
+  }
+  return std::make_unique<Envoy::Network::LcTrie::LcTrie>(tag_data);
+}
+
+} // namespace
+
+static void BM_LcTrieGetTag(benchmark::State& state) {
+  std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses;
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie> trie =
+      buildTrie(state.range(0), state.range(1), addresses);
+  size_t i = 0;
+  size_t found = 0;
+  for (auto _ : state) {
+    found += trie->getTag(addresses[i]).empty() ? 0 : 1;
+    if (++i == addresses.size()) {
+      i = 0;
+    }
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_LcTrieGetTag)->Args({1, 1})->Args({10, 10})->Args({100, 10})->Args({1000, 10});
+
+static void BM_LcTrieBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses;
+    benchmark::DoNotOptimize(buildTrie(state.range(0), state.range(1), addresses));
+  }
+}
+BENCHMARK(BM_LcTrieBuild)->Args({100, 10})->Args({1000, 10});
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
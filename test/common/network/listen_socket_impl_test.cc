@@ -49,6 +49,21 @@ TEST_P(ListenSocketImplTest, BindSpecificPort) {
   EXPECT_EQ(addr->asString(), socket3.localAddress()->asString());
 }
 
+TEST_P(ListenSocketImplTest, BindReusePort) {
+  auto loopback = Network::Test::getCanonicalLoopbackAddress(version_);
+  TcpListenSocket socket1(loopback, true, true);
+  EXPECT_EQ(0, listen(socket1.fd(), 0));
+  EXPECT_GT(socket1.localAddress()->ip()->port(), 0U);
+
+  // Other sockets that set SO_REUSEPORT can bind to the same address and port.
+  TcpListenSocket socket2(socket1.localAddress(), true, true);
+  EXPECT_EQ(0, listen(socket2.fd(), 0));
+  EXPECT_EQ(socket1.localAddress()->asString(), socket2.localAddress()->asString());
+
+  // Ones that do not set it cannot.
+  EXPECT_THROW(Network::TcpListenSocket socket3(socket1.localAddress(), true), EnvoyException);
+}
+
 // Validate that we get port allocation when binding to port zero.
 TEST_P(ListenSocketImplTest, BindPortZero) {
   auto loopback = Network::Test::getCanonicalLoopbackAddress(version_);
@@ -1,8 +1,15 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "common/common/assert.h"
 #include "common/network/address_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/stats_impl.h"
 
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
@@ -12,6 +19,7 @@
 #include "gtest/gtest.h"
 
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::_;
 
@@ -62,9 +70,10 @@ TEST_P(ListenerImplDeathTest, ErrorCallback) {
 class TestListenerImpl : public ListenerImpl {
 public:
   TestListenerImpl(Event::DispatcherImpl& dispatcher, ListenSocket& socket, ListenerCallbacks& cb,
-                   bool bind_to_port, bool hand_off_restored_destination_connections)
+                   bool bind_to_port, bool hand_off_restored_destination_connections,
+                   MonotonicTimeSource& time_source)
       : ListenerImpl(dispatcher, socket, cb, bind_to_port,
-                     hand_off_restored_destination_connections) {}
+                     hand_off_restored_destination_connections, time_source) {}
 
   MOCK_METHOD1(getLocalAddress, Address::InstanceConstSharedPtr(int fd));
 };
@@ -76,8 +85,19 @@ protected:
         alt_address_(Network::Test::findOrCheckFreePort(
             Network::Test::getCanonicalLoopbackAddress(version_), Address::SocketType::Stream)) {}
 
+  // Connect a blocking client socket, which returns once the connection is in the backlog of the
+  // listen socket.
+  int connectClient(const Address::Instance& address) {
+    const int fd =
+        ::socket(version_ == Address::IpVersion::v4 ? AF_INET : AF_INET6, SOCK_STREAM, 0);
+    RELEASE_ASSERT(fd != -1);
+    RELEASE_ASSERT(address.connect(fd) == 0);
+    return fd;
+  }
+
   const Address::IpVersion version_;
   const Address::InstanceConstSharedPtr alt_address_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
 };
 INSTANTIATE_TEST_CASE_P(IpVersions, ListenerImplTest,
                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()));
@@ -90,9 +110,11 @@ TEST_P(ListenerImplTest, UseActualDst) {
   Network::MockListenerCallbacks listener_callbacks1;
   Network::MockConnectionHandler connection_handler;
   // Do not redirect since use_original_dst is false.
-  Network::TestListenerImpl listener(dispatcher, socket, listener_callbacks1, true, true);
+  Network::TestListenerImpl listener(dispatcher, socket, listener_callbacks1, true, true,
+                                     time_source_);
   Network::MockListenerCallbacks listener_callbacks2;
-  Network::TestListenerImpl listenerDst(dispatcher, socketDst, listener_callbacks2, false, false);
+  Network::TestListenerImpl listenerDst(dispatcher, socketDst, listener_callbacks2, false, false,
+                                       time_source_);
 
   Network::ClientConnectionPtr client_connection = dispatcher.createClientConnection(
       socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
@@ -126,7 +148,8 @@ TEST_P(ListenerImplTest, WildcardListenerUseActualDst) {
   Network::MockListenerCallbacks listener_callbacks;
   Network::MockConnectionHandler connection_handler;
   // Do not redirect since use_original_dst is false.
-  Network::TestListenerImpl listener(dispatcher, socket, listener_callbacks, true, true);
+  Network::TestListenerImpl listener(dispatcher, socket, listener_callbacks, true, true,
+                                    time_source_);
 
   auto local_dst_address = Network::Utility::getAddressWithPort(
       *Network::Test::getCanonicalLoopbackAddress(version_), socket.localAddress()->ip()->port());
@@ -154,5 +177,90 @@ TEST_P(ListenerImplTest, WildcardListenerUseActualDst) {
   dispatcher.run(Event::Dispatcher::RunType::Block);
 }
 
+TEST_P(ListenerImplTest, AcceptBatchLimit) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::ListenerPtr listener =
+      dispatcher.createListener(socket, listener_callbacks, true, false);
+
+  // Queue up one more connection than the listener accepts per wakeup.
+  const uint32_t num_connections = ListenerImpl::MAX_ACCEPTS_PER_WAKEUP + 1;
+  std::vector<int> client_fds;
+  for (uint32_t i = 0; i < num_connections; i++) {
+    client_fds.push_back(connectClient(*socket.localAddress()));
+  }
+
+  testing::InSequence s;
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _)).Times(ListenerImpl::MAX_ACCEPTS_PER_WAKEUP);
+  EXPECT_CALL(listener_callbacks, onAcceptBatch(ListenerImpl::MAX_ACCEPTS_PER_WAKEUP, _));
+  dispatcher.run(Event::Dispatcher::RunType::NonBlock);
+
+  // The rest of the backlog is accepted on the next wakeup.
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _));
+  EXPECT_CALL(listener_callbacks, onAcceptBatch(1, _));
+  dispatcher.run(Event::Dispatcher::RunType::NonBlock);
+
+  for (int fd : client_fds) {
+    ::close(fd);
+  }
+}
+
+TEST_P(ListenerImplTest, AcceptBatchDuration) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::TestListenerImpl listener(dispatcher, socket, listener_callbacks, true, false,
+                                     time_source_);
+
+  const int client_fd = connectClient(*socket.localAddress());
+
+  // The batch is timed from before the first accept to after the last one.
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(1000))))
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(1250))));
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _));
+  EXPECT_CALL(listener_callbacks, onAcceptBatch(1, std::chrono::microseconds(250000)));
+  dispatcher.run(Event::Dispatcher::RunType::NonBlock);
+
+  ::close(client_fd);
+}
+
+TEST_P(ListenerImplTest, WildcardListenerCachesLocalAddress) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getAnyAddress(version_), true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::ListenerPtr listener =
+      dispatcher.createListener(socket, listener_callbacks, true, false);
+
+  auto local_dst_address = Network::Utility::getAddressWithPort(
+      *Network::Test::getCanonicalLoopbackAddress(version_), socket.localAddress()->ip()->port());
+  std::vector<int> client_fds;
+  for (uint32_t i = 0; i < 2; i++) {
+    client_fds.push_back(connectClient(*local_dst_address));
+  }
+
+  // Both connections have the same local address, which is looked up once.
+  std::vector<Address::InstanceConstSharedPtr> local_addresses;
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        local_addresses.push_back(socket->localAddress());
+      }));
+  EXPECT_CALL(listener_callbacks, onAcceptBatch(2, _));
+  dispatcher.run(Event::Dispatcher::RunType::NonBlock);
+
+  ASSERT_EQ(2U, local_addresses.size());
+  EXPECT_EQ(*local_dst_address, *local_addresses[0]);
+  EXPECT_EQ(local_addresses[0].get(), local_addresses[1].get());
+
+  for (int fd : client_fds) {
+    ::close(fd);
+  }
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,7 @@
 
 #include "test/mocks/common.h"
 #include "test/mocks/redis/mocks.h"
+#include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
 
 #include "gmock/gmock.h"
@@ -267,41 +269,108 @@ TEST_F(RedisSingleServerRequestTest, EvalNoUpstream) {
   EXPECT_EQ(nullptr, handle_);
 };
 
-class RedisMGETCommandHandlerTest : public RedisCommandSplitterImplTest {
+/**
+ * Base for multi key command tests. Each key is named after its index, and hashes to the host
+ * given by the key_hosts passed to setup(), and to the connection given by key_connections, or to
+ * connection 0 if key_connections is empty. One request is expected per host and connection, made
+ * in the order of the first key that hashes to each of them.
+ */
+class RedisBatchedKeysCommandHandlerTest : public RedisCommandSplitterImplTest {
 public:
-  void setup(uint32_t num_gets, const std::list<uint64_t>& null_handle_indexes) {
-    std::vector<std::string> request_strings = {"mget"};
-    for (uint32_t i = 0; i < num_gets; i++) {
+  void setup(const std::string& command, const std::vector<uint32_t>& key_hosts,
+             const std::list<uint64_t>& null_handle_indexes, bool with_values,
+             const std::vector<uint32_t>& key_connections = {}) {
+    std::vector<std::string> request_strings = {command};
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> batch_for_connection;
+    std::vector<std::vector<std::string>> batch_strings;
+    for (uint32_t i = 0; i < key_hosts.size(); i++) {
       request_strings.push_back(std::to_string(i));
+      if (with_values) {
+        request_strings.push_back(std::to_string(i));
+      }
+
+      while (hosts_.size() <= key_hosts[i]) {
+        hosts_.emplace_back(new Upstream::MockHost());
+      }
+      const uint32_t connection = key_connections.empty() ? 0 : key_connections[i];
+      auto batch = batch_for_connection.emplace(std::make_pair(key_hosts[i], connection),
+                                                batch_strings.size());
+      if (batch.second) {
+        batch_hosts_.push_back(key_hosts[i]);
+        batch_connections_.push_back(connection);
+        batch_strings.push_back({command});
+      }
+      batch_strings[batch.first->second].push_back(std::to_string(i));
+      if (with_values) {
+        batch_strings[batch.first->second].push_back(std::to_string(i));
+      }
     }
 
     RespValue request;
     makeBulkStringArray(request, request_strings);
 
-    std::vector<RespValue> tmp_expected_requests(num_gets);
+    const uint32_t num_batches = batch_strings.size();
+    std::vector<RespValue> tmp_expected_requests(num_batches);
     expected_requests_.swap(tmp_expected_requests);
-    pool_callbacks_.resize(num_gets);
-    std::vector<ConnPool::MockPoolRequest> tmp_pool_requests(num_gets);
+    pool_callbacks_.resize(num_batches);
+    std::vector<ConnPool::MockPoolRequest> tmp_pool_requests(num_batches);
     pool_requests_.swap(tmp_pool_requests);
-    for (uint32_t i = 0; i < num_gets; i++) {
-      makeBulkStringArray(expected_requests_[i], {"get", std::to_string(i)});
+
+    for (uint32_t i = 0; i < key_hosts.size(); i++) {
+      EXPECT_CALL(*conn_pool_, chooseHost(std::to_string(i)))
+          .WillOnce(Return(hosts_[key_hosts[i]]));
+      EXPECT_CALL(*conn_pool_, chooseConnection(std::to_string(i)))
+          .WillOnce(Return(key_connections.empty() ? 0 : key_connections[i]));
+    }
+    for (uint32_t i = 0; i < num_batches; i++) {
+      makeBulkStringArray(expected_requests_[i], batch_strings[i]);
       ConnPool::PoolRequest* request_to_use = nullptr;
       if (std::find(null_handle_indexes.begin(), null_handle_indexes.end(), i) ==
           null_handle_indexes.end()) {
         request_to_use = &pool_requests_[i];
       }
-      EXPECT_CALL(*conn_pool_, makeRequest(std::to_string(i), Eq(ByRef(expected_requests_[i])), _))
-          .WillOnce(DoAll(WithArg<2>(SaveArgAddress(&pool_callbacks_[i])), Return(request_to_use)));
+      EXPECT_CALL(*conn_pool_,
+                  makeRequestToHost(Eq(hosts_[batch_hosts_[i]]), batch_connections_[i],
+                                    Eq(ByRef(expected_requests_[i])), _))
+          .WillOnce(DoAll(WithArg<3>(SaveArgAddress(&pool_callbacks_[i])), Return(request_to_use)));
     }
 
     handle_ = splitter_.makeRequest(request, callbacks_);
   }
 
+  std::vector<Upstream::HostSharedPtr> hosts_;
+  std::vector<uint32_t> batch_hosts_;
+  std::vector<uint32_t> batch_connections_;
   std::vector<RespValue> expected_requests_;
   std::vector<ConnPool::PoolCallbacks*> pool_callbacks_;
   std::vector<ConnPool::MockPoolRequest> pool_requests_;
 };
 
+class RedisMGETCommandHandlerTest : public RedisBatchedKeysCommandHandlerTest {
+public:
+  // Each key hashes to its own host.
+  void setup(uint32_t num_gets, const std::list<uint64_t>& null_handle_indexes) {
+    std::vector<uint32_t> key_hosts;
+    for (uint32_t i = 0; i < num_gets; i++) {
+      key_hosts.push_back(i);
+    }
+    setup(key_hosts, null_handle_indexes);
+  }
+
+  void setup(const std::vector<uint32_t>& key_hosts,
+             const std::list<uint64_t>& null_handle_indexes,
+             const std::vector<uint32_t>& key_connections = {}) {
+    RedisBatchedKeysCommandHandlerTest::setup("mget", key_hosts, null_handle_indexes, false,
+                                              key_connections);
+  }
+
+  RespValuePtr makeResponse(const std::vector<std::string>& values) {
+    RespValuePtr response(new RespValue());
+    makeBulkStringArray(*response, values);
+    return response;
+  }
+};
+
 TEST_F(RedisMGETCommandHandlerTest, Normal) {
   InSequence s;
 
@@ -317,16 +386,10 @@ TEST_F(RedisMGETCommandHandlerTest, Normal) {
   elements[1].asString() = "5";
   expected_response.asArray().swap(elements);
 
-  RespValuePtr response2(new RespValue());
-  response2->type(RespType::BulkString);
-  response2->asString() = "5";
-  pool_callbacks_[1]->onResponse(std::move(response2));
+  pool_callbacks_[1]->onResponse(makeResponse({"5"}));
 
-  RespValuePtr response1(new RespValue());
-  response1->type(RespType::BulkString);
-  response1->asString() = "response";
   EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
-  pool_callbacks_[0]->onResponse(std::move(response1));
+  pool_callbacks_[0]->onResponse(makeResponse({"response"}));
 
   EXPECT_EQ(1UL, store_.counter("redis.foo.command.mget.total").value());
 };
@@ -345,13 +408,76 @@ TEST_F(RedisMGETCommandHandlerTest, NormalWithNull) {
   expected_response.asArray().swap(elements);
 
   RespValuePtr response2(new RespValue());
+  response2->type(RespType::Array);
+  std::vector<RespValue> response2_elements(1);
+  response2->asArray().swap(response2_elements);
   pool_callbacks_[1]->onResponse(std::move(response2));
 
-  RespValuePtr response1(new RespValue());
-  response1->type(RespType::BulkString);
-  response1->asString() = "response";
   EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
-  pool_callbacks_[0]->onResponse(std::move(response1));
+  pool_callbacks_[0]->onResponse(makeResponse({"response"}));
+};
+
+// Keys that hash to the same host are fetched with a single MGET, and the responses are put back in
+// the order of the incoming command.
+TEST_F(RedisMGETCommandHandlerTest, Batched) {
+  InSequence s;
+
+  setup({0, 1, 0, 0, 1}, {});
+  EXPECT_NE(nullptr, handle_);
+  EXPECT_EQ(2UL, pool_callbacks_.size());
+
+  RespValue expected_response;
+  makeBulkStringArray(expected_response, {"a", "b", "c", "d", "e"});
+
+  pool_callbacks_[1]->onResponse(makeResponse({"b", "e"}));
+
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(makeResponse({"a", "c", "d"}));
+};
+
+// Keys on the same host that use different connections are not batched together, so that each key
+// stays in order with single key commands for it.
+TEST_F(RedisMGETCommandHandlerTest, BatchedPerConnection) {
+  InSequence s;
+
+  setup({0, 0, 0, 1}, {}, {0, 1, 0, 1});
+  EXPECT_NE(nullptr, handle_);
+  EXPECT_EQ(3UL, pool_callbacks_.size());
+
+  RespValue expected_response;
+  makeBulkStringArray(expected_response, {"a", "b", "c", "d"});
+
+  pool_callbacks_[2]->onResponse(makeResponse({"d"}));
+  pool_callbacks_[1]->onResponse(makeResponse({"b"}));
+
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(makeResponse({"a", "c"}));
+};
+
+TEST_F(RedisMGETCommandHandlerTest, BatchedWrongNumberOfResponses) {
+  InSequence s;
+
+  setup({0, 0, 1}, {});
+  EXPECT_NE(nullptr, handle_);
+
+  RespValue expected_response;
+  expected_response.type(RespType::Array);
+  std::vector<RespValue> elements(3);
+  elements[0].type(RespType::Error);
+  elements[0].asString() = "upstream protocol error";
+  elements[1].type(RespType::Error);
+  elements[1].asString() = "upstream protocol error";
+  elements[2].type(RespType::Error);
+  elements[2].asString() = "ERR unknown";
+  expected_response.asArray().swap(elements);
+
+  pool_callbacks_[0]->onResponse(makeResponse({"a"}));
+
+  RespValuePtr response2(new RespValue());
+  response2->type(RespType::Error);
+  response2->asString() = "ERR unknown";
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[1]->onResponse(std::move(response2));
 };
 
 TEST_F(RedisMGETCommandHandlerTest, NoUpstreamHostForAll) {
@@ -390,6 +516,27 @@ TEST_F(RedisMGETCommandHandlerTest, NoUpstreamHostForOne) {
   pool_callbacks_[1]->onFailure();
 };
 
+TEST_F(RedisMGETCommandHandlerTest, NoHostChosen) {
+  InSequence s;
+
+  RespValue request;
+  makeBulkStringArray(request, {"mget", "0", "1"});
+
+  RespValue expected_response;
+  expected_response.type(RespType::Array);
+  std::vector<RespValue> elements(2);
+  elements[0].type(RespType::Error);
+  elements[0].asString() = "no upstream host";
+  elements[1].type(RespType::Error);
+  elements[1].asString() = "no upstream host";
+  expected_response.asArray().swap(elements);
+
+  EXPECT_CALL(*conn_pool_, chooseHost("0")).WillOnce(Return(nullptr));
+  EXPECT_CALL(*conn_pool_, chooseHost("1")).WillOnce(Return(nullptr));
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  EXPECT_EQ(nullptr, splitter_.makeRequest(request, callbacks_));
+};
+
 TEST_F(RedisMGETCommandHandlerTest, Failure) {
   InSequence s;
 
@@ -407,11 +554,8 @@ TEST_F(RedisMGETCommandHandlerTest, Failure) {
 
   pool_callbacks_[1]->onFailure();
 
-  RespValuePtr response1(new RespValue());
-  response1->type(RespType::BulkString);
-  response1->asString() = "response";
   EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
-  pool_callbacks_[0]->onResponse(std::move(response1));
+  pool_callbacks_[0]->onResponse(makeResponse({"response"}));
 };
 
 TEST_F(RedisMGETCommandHandlerTest, InvalidUpstreamResponse) {
@@ -449,42 +593,28 @@ TEST_F(RedisMGETCommandHandlerTest, Cancel) {
   handle_->cancel();
 };
 
-class RedisMSETCommandHandlerTest : public RedisCommandSplitterImplTest {
+class RedisMSETCommandHandlerTest : public RedisBatchedKeysCommandHandlerTest {
 public:
+  // Each key hashes to its own host.
   void setup(uint32_t num_sets, const std::list<uint64_t>& null_handle_indexes) {
-    std::vector<std::string> request_strings = {"mset"};
-    for (uint32_t i = 0; i < num_sets; i++) {
-      // key
-      request_strings.push_back(std::to_string(i));
-      // value
-      request_strings.push_back(std::to_string(i));
-    }
-
-    RespValue request;
-    makeBulkStringArray(request, request_strings);
-
-    std::vector<RespValue> tmp_expected_requests(num_sets);
-    expected_requests_.swap(tmp_expected_requests);
-    pool_callbacks_.resize(num_sets);
-    std::vector<ConnPool::MockPoolRequest> tmp_pool_requests(num_sets);
-    pool_requests_.swap(tmp_pool_requests);
+    std::vector<uint32_t> key_hosts;
     for (uint32_t i = 0; i < num_sets; i++) {
-      makeBulkStringArray(expected_requests_[i], {"set", std::to_string(i), std::to_string(i)});
-      ConnPool::PoolRequest* request_to_use = nullptr;
-      if (std::find(null_handle_indexes.begin(), null_handle_indexes.end(), i) ==
-          null_handle_indexes.end()) {
-        request_to_use = &pool_requests_[i];
-      }
-      EXPECT_CALL(*conn_pool_, makeRequest(std::to_string(i), Eq(ByRef(expected_requests_[i])), _))
-          .WillOnce(DoAll(WithArg<2>(SaveArgAddress(&pool_callbacks_[i])), Return(request_to_use)));
+      key_hosts.push_back(i);
     }
+    setup(key_hosts, null_handle_indexes);
+  }
 
-    handle_ = splitter_.makeRequest(request, callbacks_);
+  void setup(const std::vector<uint32_t>& key_hosts,
+             const std::list<uint64_t>& null_handle_indexes) {
+    RedisBatchedKeysCommandHandlerTest::setup("mset", key_hosts, null_handle_indexes, true);
   }
 
-  std::vector<RespValue> expected_requests_;
-  std::vector<ConnPool::PoolCallbacks*> pool_callbacks_;
-  std::vector<ConnPool::MockPoolRequest> pool_requests_;
+  RespValuePtr makeResponse(const std::string& value) {
+    RespValuePtr response(new RespValue());
+    response->type(RespType::SimpleString);
+    response->asString() = value;
+    return response;
+  }
 };
 
 TEST_F(RedisMSETCommandHandlerTest, Normal) {
@@ -497,20 +627,49 @@ TEST_F(RedisMSETCommandHandlerTest, Normal) {
   expected_response.type(RespType::SimpleString);
   expected_response.asString() = "OK";
 
-  RespValuePtr response2(new RespValue());
-  response2->type(RespType::SimpleString);
-  response2->asString() = "OK";
-  pool_callbacks_[1]->onResponse(std::move(response2));
+  pool_callbacks_[1]->onResponse(makeResponse("OK"));
 
-  RespValuePtr response1(new RespValue());
-  response1->type(RespType::SimpleString);
-  response1->asString() = "OK";
   EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
-  pool_callbacks_[0]->onResponse(std::move(response1));
+  pool_callbacks_[0]->onResponse(makeResponse("OK"));
 
   EXPECT_EQ(1UL, store_.counter("redis.foo.command.mset.total").value());
 };
 
+// Key and value pairs that hash to the same host are set with a single MSET.
+TEST_F(RedisMSETCommandHandlerTest, Batched) {
+  InSequence s;
+
+  setup({0, 1, 1, 0}, {});
+  EXPECT_NE(nullptr, handle_);
+  EXPECT_EQ(2UL, pool_callbacks_.size());
+
+  RespValue expected_response;
+  expected_response.type(RespType::SimpleString);
+  expected_response.asString() = "OK";
+
+  pool_callbacks_[1]->onResponse(makeResponse("OK"));
+
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onResponse(makeResponse("OK"));
+};
+
+// A failed batch counts an error for each of its keys.
+TEST_F(RedisMSETCommandHandlerTest, BatchedFailure) {
+  InSequence s;
+
+  setup({0, 1, 1, 0, 0}, {});
+  EXPECT_NE(nullptr, handle_);
+
+  RespValue expected_response;
+  expected_response.type(RespType::Error);
+  expected_response.asString() = "finished with 3 error(s)";
+
+  pool_callbacks_[1]->onResponse(makeResponse("OK"));
+
+  EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
+  pool_callbacks_[0]->onFailure();
+};
+
 TEST_F(RedisMSETCommandHandlerTest, NoUpstreamHostForAll) {
   // No InSequence to avoid making setup() more complicated.
 
@@ -533,11 +692,8 @@ TEST_F(RedisMSETCommandHandlerTest, NoUpstreamHostForOne) {
   expected_response.type(RespType::Error);
   expected_response.asString() = "finished with 1 error(s)";
 
-  RespValuePtr response2(new RespValue());
-  response2->type(RespType::SimpleString);
-  response2->asString() = "OK";
   EXPECT_CALL(callbacks_, onResponse_(PointeesEq(&expected_response)));
-  pool_callbacks_[1]->onResponse(std::move(response2));
+  pool_callbacks_[1]->onResponse(makeResponse("OK"));
 };
 
 TEST_F(RedisMSETCommandHandlerTest, Cancel) {
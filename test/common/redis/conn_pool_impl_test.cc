@@ -7,9 +7,11 @@
 
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/redis/mocks.h"
+#include "test/mocks/runtime/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -54,7 +56,7 @@ public:
   }
 
   void setup() {
-    config_.reset(new ConfigImpl(createConnPoolSettings()));
+    config_.reset(new ConfigImpl(createConnPoolSettings(), runtime_));
     finishSetup();
   }
 
@@ -97,6 +99,7 @@ public:
   DecoderCallbacks* callbacks_{};
   NiceMock<Network::MockClientConnection>* upstream_connection_{};
   Network::ReadFilterSharedPtr upstream_read_filter_;
+  NiceMock<Runtime::MockLoader> runtime_;
   std::unique_ptr<Config> config_;
   ClientPtr client_;
 };
@@ -295,6 +298,8 @@ TEST_F(RedisClientImplTest, ConnectFail) {
 class ConfigOutlierDisabled : public Config {
   bool disableOutlierEvents() const override { return true; }
   std::chrono::milliseconds opTimeout() const override { return std::chrono::milliseconds(25); }
+  uint32_t maxConnectionsPerHost() const override { return 1; }
+  bool enableCommandBatching() const override { return false; }
 };
 
 TEST_F(RedisClientImplTest, OutlierDisabled) {
@@ -359,6 +364,55 @@ TEST_F(RedisClientImplTest, OpTimeout) {
   EXPECT_EQ(1UL, host_->cluster_.stats_.upstream_rq_timeout_.value());
 }
 
+TEST_F(RedisClientImplTest, CommandBatching) {
+  ON_CALL(runtime_.snapshot_, getInteger("redis.enable_command_batching", 0))
+      .WillByDefault(Return(1));
+  {
+    InSequence s;
+    setup();
+    onConnected();
+  }
+
+  // The flush timer is created on the first request.
+  Event::MockTimer* flush_timer = new Event::MockTimer(&dispatcher_);
+  InSequence s;
+  auto encode = [](const RespValue&, Buffer::Instance& out) -> void { out.add("request"); };
+
+  // Requests made before the flush timer fires are written together.
+  RespValue request1;
+  MockPoolCallbacks callbacks1;
+  EXPECT_CALL(*encoder_, encode(Ref(request1), _)).WillOnce(Invoke(encode));
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_CALL(*connect_or_op_timer_, enableTimer(_));
+  EXPECT_NE(nullptr, client_->makeRequest(request1, callbacks1));
+
+  RespValue request2;
+  MockPoolCallbacks callbacks2;
+  EXPECT_CALL(*encoder_, encode(Ref(request2), _)).WillOnce(Invoke(encode));
+  EXPECT_NE(nullptr, client_->makeRequest(request2, callbacks2));
+
+  EXPECT_CALL(*upstream_connection_, write(_)).WillOnce(Invoke([](Buffer::Instance& data) -> void {
+    EXPECT_EQ("requestrequest", TestUtility::bufferToString(data));
+    data.drain(data.length());
+  }));
+  flush_timer->callback_();
+
+  // The next request starts a new batch, which is dropped when the connection closes.
+  RespValue request3;
+  MockPoolCallbacks callbacks3;
+  EXPECT_CALL(*encoder_, encode(Ref(request3), _)).WillOnce(Invoke(encode));
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(0)));
+  EXPECT_NE(nullptr, client_->makeRequest(request3, callbacks3));
+
+  EXPECT_CALL(*upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks1, onFailure());
+  EXPECT_CALL(callbacks2, onFailure());
+  EXPECT_CALL(callbacks3, onFailure());
+  EXPECT_CALL(*connect_or_op_timer_, disableTimer());
+  EXPECT_CALL(*flush_timer, disableTimer());
+  client_->close();
+}
+
 TEST(RedisClientFactoryImplTest, Basic) {
   ClientFactoryImpl factory;
   Upstream::MockHost::MockCreateConnectionData conn_info;
@@ -366,15 +420,31 @@ TEST(RedisClientFactoryImplTest, Basic) {
   std::shared_ptr<Upstream::MockHost> host(new NiceMock<Upstream::MockHost>());
   EXPECT_CALL(*host, createConnection_(_, _)).WillOnce(Return(conn_info));
   NiceMock<Event::MockDispatcher> dispatcher;
-  ConfigImpl config(createConnPoolSettings());
+  NiceMock<Runtime::MockLoader> runtime;
+  ConfigImpl config(createConnPoolSettings(), runtime);
   ClientPtr client = factory.create(host, dispatcher, config);
   client->close();
 }
 
+TEST(RedisConnPoolConfigImplTest, MaxConnectionsPerHost) {
+  NiceMock<Runtime::MockLoader> runtime;
+  EXPECT_EQ(1U, ConfigImpl(createConnPoolSettings(), runtime).maxConnectionsPerHost());
+
+  ON_CALL(runtime.snapshot_, getInteger("redis.max_connections_per_host", 1))
+      .WillByDefault(Return(0));
+  EXPECT_EQ(1U, ConfigImpl(createConnPoolSettings(), runtime).maxConnectionsPerHost());
+
+  ON_CALL(runtime.snapshot_, getInteger("redis.max_connections_per_host", 1))
+      .WillByDefault(Return(100000));
+  EXPECT_EQ(ConfigImpl::MaxConnectionsPerHost,
+            ConfigImpl(createConnPoolSettings(), runtime).maxConnectionsPerHost());
+}
+
 class RedisConnPoolImplTest : public testing::Test, public ClientFactory {
 public:
   RedisConnPoolImplTest() {
-    conn_pool_.reset(new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings()));
+    conn_pool_.reset(
+        new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings(), runtime_));
   }
 
   // Redis::ConnPool::ClientFactory
@@ -387,6 +457,7 @@ public:
   const std::string cluster_name_{"foo"};
   NiceMock<Upstream::MockClusterManager> cm_;
   NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Runtime::MockLoader> runtime_;
   InstancePtr conn_pool_;
 };
 
@@ -414,6 +485,97 @@ TEST_F(RedisConnPoolImplTest, Basic) {
   tls_.shutdownThread();
 };
 
+TEST_F(RedisConnPoolImplTest, ChooseHostThenMakeRequestToHost) {
+  InSequence s;
+
+  RespValue value;
+  MockPoolRequest active_request1;
+  MockPoolRequest active_request2;
+  MockPoolCallbacks callbacks;
+  MockClient* client = new NiceMock<MockClient>();
+
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillOnce(Invoke([&](Upstream::LoadBalancerContext* context) -> Upstream::HostConstSharedPtr {
+        EXPECT_EQ(context->computeHashKey().value(), std::hash<std::string>()("foo"));
+        return cm_.thread_local_cluster_.lb_.host_;
+      }));
+  Upstream::HostConstSharedPtr host = conn_pool_->chooseHost("foo");
+  EXPECT_EQ(cm_.thread_local_cluster_.lb_.host_, host);
+
+  // The client for the host is created on the first request and reused after that.
+  EXPECT_CALL(*this, create_(Eq(host))).WillOnce(Return(client));
+  EXPECT_CALL(*client, makeRequest(Ref(value), Ref(callbacks))).WillOnce(Return(&active_request1));
+  EXPECT_EQ(0U, conn_pool_->chooseConnection("foo"));
+  EXPECT_EQ(&active_request1, conn_pool_->makeRequestToHost(host, 0, value, callbacks));
+  EXPECT_CALL(*client, makeRequest(Ref(value), Ref(callbacks))).WillOnce(Return(&active_request2));
+  EXPECT_EQ(0U, conn_pool_->chooseConnection("bar"));
+  EXPECT_EQ(&active_request2, conn_pool_->makeRequestToHost(host, 0, value, callbacks));
+
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+};
+
+TEST_F(RedisConnPoolImplTest, MultipleConnectionsPerHost) {
+  InSequence s;
+
+  // The connection count is read when the pool is created.
+  ON_CALL(runtime_.snapshot_, getInteger("redis.max_connections_per_host", 1))
+      .WillByDefault(Return(2));
+  conn_pool_.reset(
+      new InstanceImpl(cluster_name_, cm_, *this, tls_, createConnPoolSettings(), runtime_));
+  // Later runtime changes do not move keys to other connections.
+  ON_CALL(runtime_.snapshot_, getInteger("redis.max_connections_per_host", 1))
+      .WillByDefault(Return(4));
+
+  // Find two keys that use different connections.
+  const std::string key1 = "foo";
+  std::string key2 = "bar";
+  while (std::hash<std::string>()(key1) % 2 == std::hash<std::string>()(key2) % 2) {
+    key2 += "r";
+  }
+  const uint32_t connection1 = conn_pool_->chooseConnection(key1);
+  const uint32_t connection2 = conn_pool_->chooseConnection(key2);
+  EXPECT_EQ(std::hash<std::string>()(key1) % 2, connection1);
+  EXPECT_EQ(std::hash<std::string>()(key2) % 2, connection2);
+
+  RespValue value;
+  MockPoolCallbacks callbacks;
+  MockPoolRequest active_request;
+  std::shared_ptr<Upstream::Host> host(new Upstream::MockHost());
+  MockClient* client1 = new NiceMock<MockClient>();
+  MockClient* client2 = new NiceMock<MockClient>();
+  MockClient* client3 = new NiceMock<MockClient>();
+
+  // Requests for the same key share a connection.
+  EXPECT_CALL(*this, create_(Eq(host))).WillOnce(Return(client1));
+  EXPECT_CALL(*client1, makeRequest(Ref(value), Ref(callbacks)))
+      .Times(2)
+      .WillRepeatedly(Return(&active_request));
+  conn_pool_->makeRequestToHost(host, connection1, value, callbacks);
+  conn_pool_->makeRequestToHost(host, connection1, value, callbacks);
+
+  EXPECT_CALL(*this, create_(Eq(host))).WillOnce(Return(client2));
+  EXPECT_CALL(*client2, makeRequest(Ref(value), Ref(callbacks))).WillOnce(Return(&active_request));
+  conn_pool_->makeRequestToHost(host, connection2, value, callbacks);
+
+  // A closed connection is replaced without affecting the other connection.
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_));
+  client1->raiseEvent(Network::ConnectionEvent::RemoteClose);
+
+  EXPECT_CALL(*client2, makeRequest(Ref(value), Ref(callbacks))).WillOnce(Return(&active_request));
+  conn_pool_->makeRequestToHost(host, connection2, value, callbacks);
+
+  EXPECT_CALL(*this, create_(Eq(host))).WillOnce(Return(client3));
+  EXPECT_CALL(*client3, makeRequest(Ref(value), Ref(callbacks))).WillOnce(Return(&active_request));
+  conn_pool_->makeRequestToHost(host, connection1, value, callbacks);
+
+  // Removing the host closes all of its connections.
+  EXPECT_CALL(tls_.dispatcher_, deferredDelete_(_)).Times(2);
+  cm_.thread_local_cluster_.cluster_.prioritySet().getMockHostSet(0)->runCallbacks({}, {host});
+
+  tls_.shutdownThread();
+}
+
 TEST_F(RedisConnPoolImplTest, HostRemove) {
   InSequence s;
   MockPoolCallbacks callbacks;
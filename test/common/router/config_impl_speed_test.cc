@@ -0,0 +1,100 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/http/header_map_impl.h"
+#include "common/router/config_impl.h"
+
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+
+#include "gmock/gmock.h"
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace {
+
+// Builds a route configuration with 'virtual_hosts' virtual hosts. Each virtual host has two exact
+// domains and a wildcard domain, and 'routes' prefix routes, the last of which matches everything.
+envoy::api::v2::RouteConfiguration buildRouteConfiguration(int64_t virtual_hosts,
+                                                           int64_t routes) {
+  envoy::api::v2::RouteConfiguration route_config;
+  for (int64_t i = 0; i < virtual_hosts; i++) {
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name(fmt::format("vhost_{}", i));
+    virtual_host->add_domains(fmt::format("service{}.example.com", i));
+    virtual_host->add_domains(fmt::format("www.service{}.example.com", i));
+    virtual_host->add_domains(fmt::format("*.service{}.example.net", i));
+    for (int64_t j = 0; j < routes; j++) {
+      auto* route = virtual_host->add_routes();
+      route->mutable_match()->set_prefix(j == routes - 1 ? "/" : fmt::format("/api/v{}/", j));
+      route->mutable_route()->set_cluster(fmt::format("cluster_{}", j));
+    }
+  }
+  return route_config;
+}
+
+Envoy::Http::HeaderMapImpl genHeaders(const std::string& host, const std::string& path) {
+  return Envoy::Http::HeaderMapImpl{{Envoy::Http::Headers::get().Host, host},
+                                    {Envoy::Http::Headers::get().Path, path},
+                                    {Envoy::Http::Headers::get().Method, "GET"}};
+}
+
+// Routes the given request through a configuration of state.range(0) virtual hosts with
+// state.range(1) routes each.
+void routeRequest(benchmark::State& state, const std::string& host, const std::string& path) {
+  testing::NiceMock<Envoy::Runtime::MockLoader> runtime;
+  testing::NiceMock<Envoy::Upstream::MockClusterManager> cm;
+  Envoy::Router::ConfigImpl config(buildRouteConfiguration(state.range(0), state.range(1)),
+                                   runtime, cm, false);
+  Envoy::Http::HeaderMapImpl headers = genHeaders(host, path);
+
+  for (auto _ : state) {
+    Envoy::Router::RouteConstSharedPtr route = config.route(headers, 0);
+    RELEASE_ASSERT(route != nullptr);
+  }
+}
+
+} // namespace
+
+static void BM_RouteExactDomainFirstRoute(benchmark::State& state) {
+  routeRequest(state, "service0.example.com", "/api/v0/users");
+}
+BENCHMARK(BM_RouteExactDomainFirstRoute)->Args({1000, 1})->Args({1000, 10});
+
+static void BM_RouteExactDomainLastRoute(benchmark::State& state) {
+  routeRequest(state, "www.service500.example.com", "/static/index.html");
+}
+BENCHMARK(BM_RouteExactDomainLastRoute)->Args({1000, 1})->Args({1000, 10})->Args({1000, 100});
+
+static void BM_RouteWildcardDomain(benchmark::State& state) {
+  routeRequest(state, "api.service500.example.net", "/static/index.html");
+}
+BENCHMARK(BM_RouteWildcardDomain)->Args({1000, 1})->Args({1000, 10});
+
+static void BM_RouteUnknownDomain(benchmark::State& state) {
+  testing::NiceMock<Envoy::Runtime::MockLoader> runtime;
+  testing::NiceMock<Envoy::Upstream::MockClusterManager> cm;
+  Envoy::Router::ConfigImpl config(buildRouteConfiguration(state.range(0), 1), runtime, cm,
+                                   false);
+  Envoy::Http::HeaderMapImpl headers = genHeaders("unknown.example.org", "/");
+
+  for (auto _ : state) {
+    Envoy::Router::RouteConstSharedPtr route = config.route(headers, 0);
+    RELEASE_ASSERT(route == nullptr);
+  }
+}
+BENCHMARK(BM_RouteUnknownDomain)->Arg(1000);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
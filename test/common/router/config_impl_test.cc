@@ -481,6 +481,59 @@ TEST(RouteMatcherTest, TestRoutes) {
   }
 }
 
+// Virtual hosts with many routes find them through the route index, which must keep first match
+// semantics.
+TEST(RouteMatcherTest, TestIndexedRoutes) {
+  std::string json = R"EOF(
+{
+  "virtual_hosts": [
+    {
+      "name": "www",
+      "domains": ["www.lyft.com"],
+      "routes": [
+        {"prefix": "/api/v1/", "cluster": "header", "headers": [{"name": "x-v1", "value": "1"}]},
+        {"path": "/api/v1/users", "cluster": "users"},
+        {"path": "/API/V1/LOGIN", "cluster": "login", "case_sensitive": false},
+        {"regex": "/api/v[0-9]/regex.*", "cluster": "regex"},
+        {"prefix": "/api/v1/", "cluster": "v1"},
+        {"prefix": "/API/", "cluster": "api_insensitive", "case_sensitive": false},
+        {"prefix": "/api/v2/users", "cluster": "v2_users"},
+        {"prefix": "/api/v2/", "cluster": "v2"},
+        {"prefix": "/static", "cluster": "static"},
+        {"path": "/", "cluster": "root"},
+        {"prefix": "/", "cluster": "default"}
+      ]
+    }
+  ]
+}
+  )EOF";
+
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Upstream::MockClusterManager> cm;
+  ConfigImpl config(parseRouteConfigurationFromJson(json), runtime, cm, true);
+
+  auto cluster = [&config](const std::string& path) -> std::string {
+    return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+  };
+  EXPECT_EQ("users", cluster("/api/v1/users"));
+  EXPECT_EQ("users", cluster("/api/v1/users?id=1"));
+  EXPECT_EQ("v1", cluster("/api/v1/users/1"));
+  EXPECT_EQ("login", cluster("/api/v1/login"));
+  EXPECT_EQ("regex", cluster("/api/v1/regex/foo"));
+  EXPECT_EQ("regex", cluster("/api/v2/regex"));
+  EXPECT_EQ("v1", cluster("/api/v1/foo"));
+  EXPECT_EQ("api_insensitive", cluster("/Api/v1/foo"));
+  EXPECT_EQ("api_insensitive", cluster("/api/v2/users"));
+  EXPECT_EQ("static", cluster("/static/index.html"));
+  EXPECT_EQ("root", cluster("/"));
+  EXPECT_EQ("root", cluster("/?foo=bar"));
+  EXPECT_EQ("default", cluster("/foo"));
+
+  Http::TestHeaderMapImpl headers = genHeaders("www.lyft.com", "/api/v1/users", "GET");
+  headers.addCopy("x-v1", "1");
+  EXPECT_EQ("header", config.route(headers, 0)->routeEntry()->clusterName());
+}
+
 TEST(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
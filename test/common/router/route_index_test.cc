@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/router/route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+
+class RouteIndexTest : public testing::Test {
+public:
+  std::vector<uint32_t> find(const std::string& path) {
+    std::vector<uint32_t> candidates{42};
+    index_.findCandidates(path, candidates);
+    return candidates;
+  }
+
+  RouteIndex index_;
+};
+
+TEST_F(RouteIndexTest, Empty) {
+  EXPECT_EQ(0U, index_.size());
+  EXPECT_THAT(find("/"), IsEmpty());
+  EXPECT_THAT(find(""), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, Prefix) {
+  index_.addPrefix("/api/v1/users", true);
+  index_.addPrefix("/api/v1/", true);
+  index_.addPrefix("/api/v2/", true);
+  index_.addPrefix("/api", true);
+  index_.addPrefix("/", true);
+  index_.addPrefix("/api/v1/users", true);
+  EXPECT_EQ(6U, index_.size());
+
+  EXPECT_THAT(find("/api/v1/users/123"), ElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(find("/api/v1/users"), ElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(find("/api/v1/user"), ElementsAre(1, 3, 4));
+  EXPECT_THAT(find("/api/v2/users"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(find("/api/v3"), ElementsAre(3, 4));
+  EXPECT_THAT(find("/ap"), ElementsAre(4));
+  EXPECT_THAT(find("/API/v1/users"), ElementsAre(4));
+  EXPECT_THAT(find("api"), IsEmpty());
+  EXPECT_THAT(find(""), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, EmptyPrefix) {
+  index_.addPrefix("/foo", true);
+  index_.addPrefix("", true);
+  EXPECT_THAT(find("/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(find("bar"), ElementsAre(1));
+  EXPECT_THAT(find(""), ElementsAre(1));
+}
+
+TEST_F(RouteIndexTest, Path) {
+  index_.addPath("/foo/bar", true);
+  index_.addPath("/foo", true);
+  index_.addPath("/foo/baz", true);
+  index_.addPath("/foo/bar", true);
+
+  EXPECT_THAT(find("/foo/bar"), ElementsAre(0, 3));
+  EXPECT_THAT(find("/foo/bar?a=b"), ElementsAre(0, 3));
+  EXPECT_THAT(find("/foo"), ElementsAre(1));
+  EXPECT_THAT(find("/foo?"), ElementsAre(1));
+  EXPECT_THAT(find("/foo/baz"), ElementsAre(2));
+  EXPECT_THAT(find("/foo/"), IsEmpty());
+  EXPECT_THAT(find("/foo/bar/"), IsEmpty());
+  EXPECT_THAT(find("/fo"), IsEmpty());
+}
+
+// Prefixes are matched against the whole path, including the query string.
+TEST_F(RouteIndexTest, PrefixWithQueryString) {
+  index_.addPrefix("/foo?bar", true);
+  index_.addPath("/foo", true);
+  EXPECT_THAT(find("/foo?bar=1"), ElementsAre(0, 1));
+  EXPECT_THAT(find("/foo?baz=1"), ElementsAre(1));
+}
+
+TEST_F(RouteIndexTest, CaseInsensitive) {
+  index_.addPrefix("/API/", false);
+  index_.addPrefix("/api/", true);
+  index_.addPath("/Login", false);
+  index_.addPath("/login", true);
+
+  EXPECT_THAT(find("/api/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(find("/Api/foo"), ElementsAre(0));
+  EXPECT_THAT(find("/LOGIN"), ElementsAre(2));
+  EXPECT_THAT(find("/login?next=/"), ElementsAre(2, 3));
+}
+
+TEST_F(RouteIndexTest, CaseInsensitiveSplitLabels) {
+  index_.addPrefix("/Users/Admin", false);
+  index_.addPath("/users/all", false);
+
+  EXPECT_THAT(find("/USERS/ADMIN/1"), ElementsAre(0));
+  EXPECT_THAT(find("/users/ALL"), ElementsAre(1));
+  EXPECT_THAT(find("/Users/Al"), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, Regex) {
+  index_.addPrefix("/foo", true);
+  index_.addRegex("/foo/\\d+");
+  index_.addPath("/foo", true);
+  index_.addRegex("/.*");
+  index_.addRegex("/bar/[a-z]+");
+  index_.compileRegexes();
+
+  EXPECT_THAT(find("/foo"), ElementsAre(0, 2, 3));
+  EXPECT_THAT(find("/foo/123"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(find("/bar/abc"), ElementsAre(3, 4));
+  // Regexes must match the whole path, excluding the query string.
+  EXPECT_THAT(find("/foo/123?a=b"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(find("/bar/abc/"), ElementsAre(3));
+  EXPECT_THAT(find("bar"), IsEmpty());
+}
+
+TEST_F(RouteIndexTest, InvalidRegex) {
+  index_.addRegex("/foo");
+  index_.addRegex("/(+invalid)");
+  EXPECT_THROW(index_.compileRegexes(), EnvoyException);
+}
+
+// Keys that share prefixes split trie edges in different orders.
+TEST_F(RouteIndexTest, SplitEdges) {
+  const std::vector<std::string> prefixes{"/abcdef", "/abc", "/abcxyz", "/ab", "/abd", "/a", "/b"};
+  for (const std::string& prefix : prefixes) {
+    index_.addPrefix(prefix, true);
+  }
+
+  const std::vector<std::string> paths{"/abcdefg", "/abcxy", "/abcx", "/abd", "/abz", "/b", "/c"};
+  for (const std::string& path : paths) {
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < prefixes.size(); i++) {
+      if (path.compare(0, prefixes[i].size(), prefixes[i]) == 0) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(expected, find(path)) << path;
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -1375,6 +1375,10 @@ TEST_F(RouterTest, RetryUpstream5xxNotComplete) {
   response_decoder->decodeHeaders(std::move(response_headers2), true);
   EXPECT_TRUE(verifyHostUpstreamStats(1, 1));
 
+  // Retries charge the same class and code counters as CodeUtility::chargeBasicResponseStat().
+  EXPECT_EQ(1U,
+            cm_.thread_local_cluster_.cluster_.info_->stats_store_.counter("retry.upstream_rq_5xx")
+                .value());
   EXPECT_EQ(1U,
             cm_.thread_local_cluster_.cluster_.info_->stats_store_.counter("retry.upstream_rq_503")
                 .value());
@@ -2081,7 +2081,7 @@ public:
     dispatcher_->run(Event::Dispatcher::RunType::Block);
   }
 
-  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   Event::DispatcherPtr dispatcher_{new Event::DispatcherImpl};
   Network::TcpListenSocket socket_{Network::Test::getCanonicalLoopbackAddress(GetParam()), true};
   Network::MockListenerCallbacks listener_callbacks_;
@@ -2138,6 +2138,59 @@ TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
 
+TEST_P(SslReadBufferLimitTest, WriteRecordSizeRampsUp) {
+  initialize();
+
+  EXPECT_CALL(listener_callbacks_, onAccept_(_, _))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory_->createTransportSocket());
+        listener_callbacks_.onNewConnection(std::move(new_connection));
+      }));
+  EXPECT_CALL(listener_callbacks_, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connection_ = std::move(conn);
+        server_connection_->addConnectionCallbacks(server_callbacks_);
+        server_connection_->addReadFilter(read_filter_);
+      }));
+
+  EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  uint64_t records = 0;
+  EXPECT_CALL(stats_store_, deliverHistogramToSinks(_, _))
+      .WillRepeatedly(Invoke([&](const Stats::Histogram& histogram, uint64_t value) -> void {
+        if (histogram.name() == "ssl.records_per_write") {
+          records += value;
+        }
+      }));
+
+  const uint32_t write_size = 64 * 1024;
+  uint32_t filter_seen = 0;
+  EXPECT_CALL(*read_filter_, onNewConnection());
+  EXPECT_CALL(*read_filter_, onData(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Network::FilterStatus {
+        filter_seen += data.length();
+        data.drain(data.length());
+        if (filter_seen == write_size) {
+          dispatcher_->exit();
+        }
+        return Network::FilterStatus::StopIteration;
+      }));
+
+  Buffer::OwnedImpl data(std::string(write_size, 'a'));
+  client_connection_->write(data);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(write_size, filter_seen);
+
+  // Records of 1400, 2800, ..., 12600 bytes and a last record with the remaining 2536 bytes. The
+  // record size does not depend on how the write is split across doWrite() calls.
+  EXPECT_EQ(10UL, records);
+
+  disconnect();
+}
+
 TEST_P(SslReadBufferLimitTest, TestBind) {
   std::string address_string = TestUtility::getIpv4Loopback();
   if (GetParam() == Network::Address::IpVersion::v4) {
@@ -143,6 +143,36 @@ TEST(MetricsServiceSinkTest, CheckStatsCount) {
   EXPECT_EQ(1, (*streamer_).metric_count);
 }
 
+TEST(MetricsServiceSinkTest, FlushHistogram) {
+  std::shared_ptr<MockGrpcMetricsStreamer> streamer_{new MockGrpcMetricsStreamer()};
+
+  MetricsServiceSink sink(streamer_);
+
+  sink.beginFlush();
+
+  NiceMock<MockParentHistogram> histogram;
+  histogram.name_ = "test_histogram";
+  std::vector<uint64_t> counts(LogLinearBuckets::NumBuckets);
+  counts[3] = 2;
+  histogram.cumulative_statistics_ = HistogramStatisticsImpl(counts, 6);
+  sink.flushHistogram(histogram);
+
+  EXPECT_CALL(*streamer_, send(_))
+      .WillOnce(Invoke([](envoy::service::metrics::v2::StreamMetricsMessage& message) -> void {
+        ASSERT_EQ(1, message.envoy_metrics_size());
+        const auto& metric_family = message.envoy_metrics(0);
+        EXPECT_EQ(io::prometheus::client::MetricType::SUMMARY, metric_family.type());
+        EXPECT_EQ("test_histogram", metric_family.name());
+        const auto& summary = metric_family.metric(0).summary();
+        EXPECT_EQ(2U, summary.sample_count());
+        EXPECT_EQ(6, summary.sample_sum());
+        ASSERT_EQ(4, summary.quantile_size());
+        EXPECT_EQ(0.5, summary.quantile(0).quantile());
+        EXPECT_EQ(3, summary.quantile(0).value());
+      }));
+  sink.endFlush();
+}
+
 } // namespace Metrics
 } // namespace Stats
 } // namespace Envoy
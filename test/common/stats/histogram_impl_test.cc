@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "common/stats/histogram_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(LogLinearBucketsTest, Index) {
+  // Small values are exact.
+  for (uint64_t value = 0; value < 2 * LogLinearBuckets::SubBucketCount; value++) {
+    EXPECT_EQ(value, LogLinearBuckets::index(value));
+    EXPECT_EQ(value, LogLinearBuckets::lowerBound(value));
+    EXPECT_EQ(1UL, LogLinearBuckets::width(value));
+  }
+
+  EXPECT_EQ(32U, LogLinearBuckets::index(32));
+  EXPECT_EQ(32U, LogLinearBuckets::index(33));
+  EXPECT_EQ(33U, LogLinearBuckets::index(34));
+  EXPECT_EQ(LogLinearBuckets::NumBuckets - 1, LogLinearBuckets::index(UINT64_MAX));
+}
+
+TEST(LogLinearBucketsTest, Bounds) {
+  // Every bucket starts where the previous one ends, and holds its lower bound.
+  uint64_t next_lower_bound = 0;
+  for (uint32_t index = 0; index < LogLinearBuckets::NumBuckets; index++) {
+    EXPECT_EQ(next_lower_bound, LogLinearBuckets::lowerBound(index));
+    EXPECT_EQ(index, LogLinearBuckets::index(LogLinearBuckets::lowerBound(index)));
+    const uint64_t upper_bound =
+        LogLinearBuckets::lowerBound(index) + LogLinearBuckets::width(index) - 1;
+    EXPECT_EQ(index, LogLinearBuckets::index(upper_bound));
+    // The relative width of a bucket is bounded.
+    EXPECT_LE(LogLinearBuckets::width(index) * LogLinearBuckets::SubBucketCount,
+              std::max<uint64_t>(LogLinearBuckets::lowerBound(index),
+                                 LogLinearBuckets::SubBucketCount));
+    next_lower_bound = upper_bound + 1;
+  }
+  EXPECT_EQ(0UL, next_lower_bound);
+}
+
+TEST(ThreadLocalHistogramTest, AddTo) {
+  ThreadLocalHistogram histogram;
+  histogram.recordValue(0);
+  histogram.recordValue(5);
+  histogram.recordValue(5);
+  histogram.recordValue(1000000);
+
+  std::vector<uint64_t> counts(LogLinearBuckets::NumBuckets);
+  uint64_t sum = 0;
+  histogram.addTo(counts, sum);
+  histogram.addTo(counts, sum);
+  EXPECT_EQ(2UL, counts[0]);
+  EXPECT_EQ(4UL, counts[5]);
+  EXPECT_EQ(2UL, counts[LogLinearBuckets::index(1000000)]);
+  EXPECT_EQ(2 * 1000010UL, sum);
+}
+
+TEST(HistogramStatisticsImplTest, Empty) {
+  HistogramStatisticsImpl statistics;
+  EXPECT_EQ(0UL, statistics.sampleCount());
+  EXPECT_EQ(0UL, statistics.sampleSum());
+  EXPECT_EQ(statistics.supportedQuantiles().size(), statistics.computedQuantiles().size());
+  for (double value : statistics.computedQuantiles()) {
+    EXPECT_TRUE(std::isnan(value));
+  }
+  EXPECT_EQ("No recorded values", statistics.summary());
+}
+
+TEST(HistogramStatisticsImplTest, Quantiles) {
+  EXPECT_EQ((std::vector<double>{0.5, 0.9, 0.99, 0.999}),
+            HistogramStatisticsImpl().supportedQuantiles());
+
+  // Single valued buckets give exact results.
+  std::vector<uint64_t> counts(LogLinearBuckets::NumBuckets);
+  counts[3] = 500;
+  counts[7] = 499;
+  counts[20] = 1;
+  HistogramStatisticsImpl statistics(counts, 3 * 500 + 7 * 499 + 20);
+  EXPECT_EQ(1000UL, statistics.sampleCount());
+  EXPECT_EQ((std::vector<double>{3, 7, 7, 7}), statistics.computedQuantiles());
+  EXPECT_EQ("P50: 3, P90: 7, P99: 7, P99.9: 7", statistics.summary());
+
+  // Values are interpolated within wider buckets and are within the bucket's bounds.
+  const uint32_t index = LogLinearBuckets::index(100000);
+  counts.assign(LogLinearBuckets::NumBuckets, 0);
+  counts[index] = 10;
+  HistogramStatisticsImpl wide_statistics(counts, 1000000);
+  const double lower_bound = LogLinearBuckets::lowerBound(index);
+  const double upper_bound = lower_bound + LogLinearBuckets::width(index) - 1;
+  EXPECT_DOUBLE_EQ(lower_bound + 0.5 * (upper_bound - lower_bound),
+                   wide_statistics.computedQuantiles()[0]);
+  for (double value : wide_statistics.computedQuantiles()) {
+    EXPECT_LE(lower_bound, value);
+    EXPECT_GE(upper_bound, value);
+  }
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -54,6 +54,43 @@ TEST(StatsIsolatedStoreImplTest, All) {
   EXPECT_EQ(2UL, store.gauges().size());
 }
 
+TEST(StatsCompactImplTest, Counter) {
+  const std::string name("c1");
+  CompactCounterImpl c1(name);
+  EXPECT_EQ("c1", c1.name());
+  EXPECT_EQ("c1", c1.tagExtractedName());
+  EXPECT_EQ(0, c1.tags().size());
+  EXPECT_FALSE(c1.used());
+
+  c1.inc();
+  c1.add(4);
+  EXPECT_TRUE(c1.used());
+  EXPECT_EQ(5, c1.value());
+  EXPECT_EQ(5, c1.latch());
+  EXPECT_EQ(0, c1.latch());
+  EXPECT_EQ(5, c1.value());
+
+  c1.reset();
+  EXPECT_EQ(0, c1.value());
+  EXPECT_TRUE(c1.used());
+}
+
+TEST(StatsCompactImplTest, Gauge) {
+  const std::string name("g1");
+  CompactGaugeImpl g1(name);
+  EXPECT_EQ("g1", g1.name());
+  EXPECT_EQ(0, g1.tags().size());
+  EXPECT_FALSE(g1.used());
+
+  g1.set(5);
+  EXPECT_TRUE(g1.used());
+  g1.inc();
+  g1.add(2);
+  g1.dec();
+  g1.sub(3);
+  EXPECT_EQ(4, g1.value());
+}
+
 /**
  * Test stats macros. @see stats_macros.h
  */
@@ -88,8 +125,8 @@ TEST(TagExtractorTest, TwoSubexpressions) {
   TagExtractorImpl tag_extractor("cluster_name", "^cluster\\.((.+?)\\.)");
   std::string name = "cluster.test_cluster.upstream_cx_total";
   std::vector<Tag> tags;
-  std::string tag_extracted_name = tag_extractor.extractTag(name, tags);
-  EXPECT_EQ("cluster.upstream_cx_total", tag_extracted_name);
+  EXPECT_TRUE(tag_extractor.extractTag(name, tags));
+  EXPECT_EQ("cluster.upstream_cx_total", name);
   ASSERT_EQ(1, tags.size());
   EXPECT_EQ("test_cluster", tags.at(0).value_);
   EXPECT_EQ("cluster_name", tags.at(0).name_);
@@ -99,13 +136,39 @@ TEST(TagExtractorTest, SingleSubexpression) {
   TagExtractorImpl tag_extractor("listner_port", "^listener\\.(\\d+?\\.)");
   std::string name = "listener.80.downstream_cx_total";
   std::vector<Tag> tags;
-  std::string tag_extracted_name = tag_extractor.extractTag(name, tags);
-  EXPECT_EQ("listener.downstream_cx_total", tag_extracted_name);
+  EXPECT_TRUE(tag_extractor.extractTag(name, tags));
+  EXPECT_EQ("listener.downstream_cx_total", name);
   ASSERT_EQ(1, tags.size());
   EXPECT_EQ("80.", tags.at(0).value_);
   EXPECT_EQ("listner_port", tags.at(0).name_);
 }
 
+TEST(TagExtractorTest, NoMatch) {
+  TagExtractorImpl tag_extractor("cluster_name", "^cluster\\.((.+?)\\.)");
+  std::string name = "listener.80.downstream_cx_total";
+  std::vector<Tag> tags;
+  EXPECT_FALSE(tag_extractor.extractTag(name, tags));
+  EXPECT_EQ("listener.80.downstream_cx_total", name);
+  EXPECT_EQ(0, tags.size());
+}
+
+// Names that do not contain the substring are not matched against the regex.
+TEST(TagExtractorTest, Substring) {
+  TagExtractorImpl tag_extractor("response_code", "_rq(_(\\d{3}))$", "_rq_");
+  std::vector<Tag> tags;
+  std::string name = "cluster.foo.upstream_rq_200";
+  EXPECT_TRUE(tag_extractor.extractTag(name, tags));
+  EXPECT_EQ("cluster.foo.upstream_rq", name);
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("200", tags.at(0).value_);
+
+  TagExtractorImpl missing_substr("response_code", "_rq(_(\\d{3}))$", "_rs_");
+  name = "cluster.foo.upstream_rq_200";
+  EXPECT_FALSE(missing_substr.extractTag(name, tags));
+  EXPECT_EQ("cluster.foo.upstream_rq_200", name);
+  EXPECT_EQ(1, tags.size());
+}
+
 TEST(TagExtractorTest, EmptyName) {
   EXPECT_THROW_WITH_MESSAGE(TagExtractorImpl::createTagExtractor("", "^listener\\.(\\d+?\\.)"),
                             EnvoyException, "tag_name cannot be empty");
@@ -116,13 +179,92 @@ TEST(TagExtractorTest, BadRegex) {
                           EnvoyException, "Invalid regex '\\+invalid':");
 }
 
+class TagExtractorTokensTest : public testing::Test {
+public:
+  // Returns the tag extracted name, followed by the tag value if there is one.
+  std::string extract(const std::vector<std::string>& patterns, const std::string& name) {
+    TagExtractorTokensImpl tag_extractor("tag_name", patterns);
+    std::string tag_extracted_name = name;
+    std::vector<Tag> tags;
+    if (!tag_extractor.extractTag(tag_extracted_name, tags)) {
+      EXPECT_EQ(name, tag_extracted_name);
+      EXPECT_EQ(0, tags.size());
+      return tag_extracted_name;
+    }
+    EXPECT_EQ(1, tags.size());
+    EXPECT_EQ("tag_name", tags.at(0).name_);
+    return tag_extracted_name + " " + tags.at(0).value_;
+  }
+};
+
+TEST_F(TagExtractorTokensTest, Literal) {
+  EXPECT_EQ("cluster.upstream_cx_total foo",
+            extract({"cluster.$.**"}, "cluster.foo.upstream_cx_total"));
+  EXPECT_EQ("cluster foo", extract({"cluster.$.**"}, "cluster.foo"));
+  EXPECT_EQ("listener.foo.upstream_cx_total",
+            extract({"cluster.$.**"}, "listener.foo.upstream_cx_total"));
+  EXPECT_EQ("clusters.foo.bar", extract({"cluster.$.**"}, "clusters.foo.bar"));
+  EXPECT_EQ("cluster", extract({"cluster.$.**"}, "cluster"));
+  EXPECT_EQ("", extract({"cluster.$.**"}, ""));
+}
+
+TEST_F(TagExtractorTokensTest, Value) {
+  EXPECT_EQ("foo.bar baz", extract({"foo.bar.$"}, "foo.bar.baz"));
+  EXPECT_EQ(" foo", extract({"$"}, "foo"));
+  EXPECT_EQ("foo.baz ", extract({"foo.$.baz"}, "foo..baz"));
+  EXPECT_EQ("foo.bar.baz.qux", extract({"foo.bar.$"}, "foo.bar.baz.qux"));
+}
+
+TEST_F(TagExtractorTokensTest, Any) {
+  EXPECT_EQ("tcp.downstream_cx_total foo", extract({"tcp.$.*"}, "tcp.foo.downstream_cx_total"));
+  EXPECT_EQ("tcp.foo", extract({"tcp.$.*"}, "tcp.foo"));
+  EXPECT_EQ("tcp.foo.bar.downstream_cx_total",
+            extract({"tcp.$.*"}, "tcp.foo.bar.downstream_cx_total"));
+}
+
+TEST_F(TagExtractorTokensTest, AnySequence) {
+  const std::vector<std::string> patterns{"http.**.user_agent.$.*"};
+  EXPECT_EQ("http.user_agent.downstream_cx_total ios",
+            extract(patterns, "http.user_agent.ios.downstream_cx_total"));
+  EXPECT_EQ("http.foo.user_agent.downstream_cx_total ios",
+            extract(patterns, "http.foo.user_agent.ios.downstream_cx_total"));
+  EXPECT_EQ("http.foo.bar.user_agent.downstream_cx_total ios",
+            extract(patterns, "http.foo.bar.user_agent.ios.downstream_cx_total"));
+  EXPECT_EQ("http.foo.user_agent.ios", extract(patterns, "http.foo.user_agent.ios"));
+
+  // The fewest tokens that let the rest of the pattern match are skipped.
+  EXPECT_EQ("http.user_agent.user_agent.downstream_cx_total ios",
+            extract(patterns, "http.user_agent.user_agent.ios.downstream_cx_total"));
+  EXPECT_EQ("cluster.foo.grpc.grpc.success method",
+            extract({"cluster.**.grpc.**.$.*"}, "cluster.foo.grpc.grpc.method.success"));
+  EXPECT_EQ("cluster.foo.grpc.success service",
+            extract({"cluster.**.grpc.$.**"}, "cluster.foo.grpc.service.success"));
+}
+
+TEST_F(TagExtractorTokensTest, Alternatives) {
+  const std::vector<std::string> patterns{"http.$.**", "listener.**.http.$.**"};
+  EXPECT_EQ("http.downstream_cx_total foo", extract(patterns, "http.foo.downstream_cx_total"));
+  EXPECT_EQ("listener.127.0.0.1_80.http.downstream_cx_total foo",
+            extract(patterns, "listener.127.0.0.1_80.http.foo.downstream_cx_total"));
+  EXPECT_EQ("listener.foo.downstream_cx_total",
+            extract(patterns, "listener.foo.downstream_cx_total"));
+}
+
+TEST_F(TagExtractorTokensTest, InvalidPattern) {
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("tag_name", {"cluster.**"}), EnvoyException,
+                            "Tag pattern 'cluster.**' for 'tag_name' must contain exactly one $");
+  EXPECT_THROW_WITH_MESSAGE(TagExtractorTokensImpl("tag_name", {"cluster.$", "$.$"}),
+                            EnvoyException,
+                            "Tag pattern '$.$' for 'tag_name' must contain exactly one $");
+}
+
 class DefaultTagRegexTester {
 public:
   DefaultTagRegexTester() {
     const auto& tag_names = Config::TagNames::get();
 
-    for (const std::pair<std::string, std::string>& name_and_regex : tag_names.name_regex_pairs_) {
-      tag_extractors_.emplace_back(TagExtractorImpl::createTagExtractor(name_and_regex.first, ""));
+    for (const Config::TagNameValues::Descriptor& descriptor : tag_names.descriptors_) {
+      tag_extractors_.emplace_back(TagExtractorImpl::createTagExtractor(descriptor.name_, ""));
     }
   }
   void testRegex(const std::string& stat_name, const std::string& expected_tag_extracted_name,
@@ -132,7 +274,7 @@ public:
     std::string tag_extracted_name = stat_name;
     std::vector<Tag> tags;
     for (const TagExtractorPtr& tag_extractor : tag_extractors_) {
-      tag_extracted_name = tag_extractor->extractTag(tag_extracted_name, tags);
+      tag_extractor->extractTag(tag_extracted_name, tags);
     }
 
     auto cmp = [](const Tag& lhs, const Tag& rhs) {
@@ -149,7 +291,7 @@ public:
     std::string rev_tag_extracted_name = stat_name;
     std::vector<Tag> rev_tags;
     for (auto it = tag_extractors_.rbegin(); it != tag_extractors_.rend(); ++it) {
-      rev_tag_extracted_name = (*it)->extractTag(rev_tag_extracted_name, rev_tags);
+      (*it)->extractTag(rev_tag_extracted_name, rev_tags);
     }
 
     EXPECT_EQ(expected_tag_extracted_name, rev_tag_extracted_name);
@@ -278,6 +420,9 @@ TEST(TagExtractorTest, DefaultTagExtractors) {
       "http.egress_dynamodb_iad.dynamodb.table.bar_table.capacity.Query.__partition_id=ABC1234",
       "http.dynamodb.table.capacity",
       {dynamo_http_prefix, dynamo_table, dynamo_operation, dynamo_partition});
+  regex_tester.testRegex("http.egress_dynamodb_iad.dynamodb.error.bar_table.ValidationException",
+                         "http.dynamodb.error.ValidationException",
+                         {dynamo_http_prefix, dynamo_table});
 
   // GRPC Http1.1 Bridge
   Tag grpc_cluster;
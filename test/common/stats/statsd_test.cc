@@ -97,6 +97,28 @@ TEST_F(TcpStatsdSinkTest, BasicFlow) {
   tls_.shutdownThread();
 }
 
+TEST_F(TcpStatsdSinkTest, FlushHistogram) {
+  InSequence s;
+  NiceMock<MockParentHistogram> histogram;
+  histogram.name_ = "test_histogram";
+  std::vector<uint64_t> counts(LogLinearBuckets::NumBuckets);
+  counts[LogLinearBuckets::index(7)] = 1;
+  histogram.interval_statistics_ = HistogramStatisticsImpl(counts, 7);
+
+  sink_->beginFlush();
+  sink_->flushHistogram(histogram);
+
+  expectCreateConnection();
+  EXPECT_CALL(*connection_, write(BufferStringEqual("envoy.test_histogram.p50:7|g\n"
+                                                    "envoy.test_histogram.p90:7|g\n"
+                                                    "envoy.test_histogram.p99:7|g\n"
+                                                    "envoy.test_histogram.p999:7|g\n")));
+  sink_->endFlush();
+
+  EXPECT_CALL(*connection_, close(Network::ConnectionCloseType::NoFlush));
+  tls_.shutdownThread();
+}
+
 TEST_F(TcpStatsdSinkTest, BufferReallocate) {
   InSequence s;
 
@@ -0,0 +1,88 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/stats/stats_impl.h"
+#include "common/stats/thread_local_store.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gmock/gmock.h"
+#include "testing/base/public/benchmark.h"
+
+// NOLINT(namespace-envoy)
+
+namespace {
+
+/**
+ * A store with threading initialized, and with 'num_stats' counters already created in each of 10
+ * scopes, so that lookups hit the thread local caches.
+ */
+class StoreTester {
+public:
+  StoreTester(int64_t num_stats) : store_(alloc_) {
+    store_.initializeThreading(dispatcher_, tls_);
+    for (int64_t i = 0; i < 10; i++) {
+      scopes_.push_back(store_.createScope(fmt::format("cluster.cluster_{}.", i)));
+    }
+    for (int64_t i = 0; i < num_stats; i++) {
+      names_.push_back(fmt::format("upstream_rq_{}", i));
+      for (Envoy::Stats::ScopePtr& scope : scopes_) {
+        scope->counter(names_.back());
+      }
+      store_.counter(fmt::format("cluster.cluster_0.{}", names_.back()));
+    }
+  }
+
+  ~StoreTester() {
+    store_.shutdownThreading();
+    tls_.shutdownThread();
+  }
+
+  Envoy::Stats::HeapRawStatDataAllocator alloc_;
+  testing::NiceMock<Envoy::Event::MockDispatcher> dispatcher_;
+  testing::NiceMock<Envoy::ThreadLocal::MockInstance> tls_;
+  Envoy::Stats::ThreadLocalStoreImpl store_;
+  std::vector<Envoy::Stats::ScopePtr> scopes_;
+  std::vector<std::string> names_;
+};
+
+} // namespace
+
+// Looks up existing counters through a scope, as filters and clusters do with their stat prefix.
+static void BM_ScopeCounterLookup(benchmark::State& state) {
+  StoreTester tester(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    Envoy::Stats::Scope& scope = *tester.scopes_[i % tester.scopes_.size()];
+    scope.counter(tester.names_[i++ % tester.names_.size()]).inc();
+  }
+}
+BENCHMARK(BM_ScopeCounterLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+// Looks up existing counters through the store's default scope, by full name.
+static void BM_StoreCounterLookup(benchmark::State& state) {
+  StoreTester tester(state.range(0));
+  std::vector<std::string> full_names;
+  for (const std::string& name : tester.names_) {
+    full_names.push_back("cluster.cluster_0." + name);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    tester.store_.counter(full_names[i++ % full_names.size()]).inc();
+  }
+}
+BENCHMARK(BM_StoreCounterLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
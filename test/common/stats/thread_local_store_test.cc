@@ -1,7 +1,9 @@
 #include <chrono>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/common/c_smart_ptr.h"
 #include "common/stats/thread_local_store.h"
@@ -102,11 +104,20 @@ TEST_F(StatsThreadLocalStoreTest, NoTls) {
 
   Histogram& h1 = store_->histogram("h1");
   EXPECT_EQ(&h1, &store_->histogram("h1"));
-  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 200));
+  // Recorded values are aggregated in process rather than delivered to sinks.
   h1.recordValue(200);
   EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 100));
   store_->deliverHistogramToSinks(h1, 100);
 
+  EXPECT_EQ(1UL, store_->histograms().size());
+  ParentHistogramSharedPtr parent_h1 = store_->histograms().front();
+  EXPECT_EQ(&h1, parent_h1.get());
+  EXPECT_FALSE(parent_h1->used());
+  parent_h1->merge();
+  EXPECT_TRUE(parent_h1->used());
+  EXPECT_EQ(1UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(200UL, parent_h1->intervalStatistics().sampleSum());
+
   EXPECT_EQ(2UL, store_->counters().size());
   EXPECT_EQ(&c1, store_->counters().front().get());
   EXPECT_EQ(2L, store_->counters().front().use_count());
@@ -176,10 +187,9 @@ TEST_F(StatsThreadLocalStoreTest, BasicScope) {
   Histogram& h2 = scope1->histogram("h2");
   EXPECT_EQ("h1", h1.name());
   EXPECT_EQ("scope1.h2", h2.name());
-  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 100));
   h1.recordValue(100);
-  EXPECT_CALL(sink_, onHistogramComplete(Ref(h2), 200));
   h2.recordValue(200);
+  EXPECT_EQ(2UL, store_->histograms().size());
 
   store_->shutdownThreading();
   scope1->deliverHistogramToSinks(h1, 100);
@@ -343,5 +353,103 @@ TEST_F(StatsThreadLocalStoreTest, ShuttingDown) {
   EXPECT_CALL(*this, free(_)).Times(5);
 }
 
+TEST_F(StatsThreadLocalStoreTest, HistogramMerge) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1.");
+  Histogram& h1 = scope1->histogram("h1");
+  for (uint64_t i = 1; i <= 100; i++) {
+    h1.recordValue(i);
+  }
+
+  ParentHistogramSharedPtr parent_h1 = store_->histograms().front();
+  parent_h1->merge();
+  EXPECT_EQ(100UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(5050UL, parent_h1->intervalStatistics().sampleSum());
+  EXPECT_EQ(100UL, parent_h1->cumulativeStatistics().sampleCount());
+  const std::vector<double>& quantiles = parent_h1->intervalStatistics().computedQuantiles();
+  EXPECT_NEAR(50, quantiles[0], 2);
+  EXPECT_NEAR(90, quantiles[1], 4);
+  EXPECT_NEAR(99, quantiles[2], 4);
+
+  // The interval only covers values recorded since the last merge.
+  h1.recordValue(1000);
+  h1.recordValue(1000);
+  parent_h1->merge();
+  EXPECT_EQ(2UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(2000UL, parent_h1->intervalStatistics().sampleSum());
+  EXPECT_NEAR(1000, parent_h1->intervalStatistics().computedQuantiles()[0], 32);
+  EXPECT_EQ(102UL, parent_h1->cumulativeStatistics().sampleCount());
+
+  // An empty interval has no quantiles but cumulative values are retained.
+  parent_h1->merge();
+  EXPECT_EQ(0UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_TRUE(std::isnan(parent_h1->intervalStatistics().computedQuantiles()[0]));
+  EXPECT_EQ("No recorded values", parent_h1->intervalStatistics().summary());
+  EXPECT_EQ(102UL, parent_h1->cumulativeStatistics().sampleCount());
+
+  // The parent histogram keeps its recorded values after its scope is released.
+  EXPECT_CALL(main_thread_dispatcher_, post(_));
+  EXPECT_CALL(tls_, runOnAllThreads(_));
+  scope1.reset();
+  parent_h1->merge();
+  EXPECT_EQ(102UL, parent_h1->cumulativeStatistics().sampleCount());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
+TEST_F(StatsThreadLocalStoreTest, HistogramOverlappingScopes) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  // Both scopes hand out the same parent histogram, so values recorded through either of them are
+  // merged together.
+  ScopePtr scope1 = store_->createScope("scope1.");
+  ScopePtr scope2 = store_->createScope("scope1.");
+  Histogram& h1 = scope1->histogram("h1");
+  Histogram& h2 = scope2->histogram("h1");
+  EXPECT_EQ(&h1, &h2);
+  h1.recordValue(100);
+  h2.recordValue(200);
+
+  EXPECT_EQ(1UL, store_->histograms().size());
+  ParentHistogramSharedPtr parent_h1 = store_->histograms().front();
+  parent_h1->merge();
+  EXPECT_EQ(2UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(300UL, parent_h1->intervalStatistics().sampleSum());
+
+  // The parent outlives the first scope, and values recorded through the other one still reach it.
+  const auto run_post = [](Event::PostCb cb) -> void { cb(); };
+  EXPECT_CALL(main_thread_dispatcher_, post(_)).WillOnce(Invoke(run_post));
+  EXPECT_CALL(tls_, runOnAllThreads(_));
+  scope1.reset();
+  h2.recordValue(300);
+  EXPECT_EQ(1UL, store_->histograms().size());
+  parent_h1->merge();
+  EXPECT_EQ(1UL, parent_h1->intervalStatistics().sampleCount());
+  EXPECT_EQ(3UL, parent_h1->cumulativeStatistics().sampleCount());
+
+  // Once nothing uses the parent, it is no longer listed and its thread local histograms are
+  // flushed from the caches.
+  parent_h1.reset();
+  EXPECT_CALL(main_thread_dispatcher_, post(_)).WillOnce(Invoke(run_post));
+  EXPECT_CALL(tls_, runOnAllThreads(_));
+  EXPECT_CALL(main_thread_dispatcher_, post(_)).WillOnce(Invoke(run_post));
+  EXPECT_CALL(tls_, runOnAllThreads(_));
+  scope2.reset();
+  EXPECT_EQ(0UL, store_->histograms().size());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
 } // namespace Stats
 } // namespace Envoy
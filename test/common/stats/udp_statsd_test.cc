@@ -14,6 +14,7 @@
 #include "spdlog/spdlog.h"
 
 using testing::NiceMock;
+using testing::_;
 
 namespace Envoy {
 namespace Stats {
@@ -129,6 +130,30 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, FlushHistogram) {
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+  MockWriter& writer = *std::dynamic_pointer_cast<NiceMock<MockWriter>>(writer_ptr);
+
+  // Nothing is written for an interval without samples.
+  NiceMock<MockParentHistogram> histogram;
+  histogram.name_ = "test_histogram";
+  EXPECT_CALL(writer, write(_)).Times(0);
+  sink.flushHistogram(histogram);
+
+  std::vector<uint64_t> counts(LogLinearBuckets::NumBuckets);
+  counts[5] = 10;
+  histogram.interval_statistics_ = HistogramStatisticsImpl(counts, 50);
+  EXPECT_CALL(writer, write("envoy.test_histogram.p50:5|g"));
+  EXPECT_CALL(writer, write("envoy.test_histogram.p90:5|g"));
+  EXPECT_CALL(writer, write("envoy.test_histogram.p99:5|g"));
+  EXPECT_CALL(writer, write("envoy.test_histogram.p999:5|g"));
+  sink.flushHistogram(histogram);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
   NiceMock<ThreadLocal::MockInstance> tls_;
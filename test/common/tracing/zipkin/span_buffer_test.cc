@@ -101,5 +101,24 @@ TEST(ZipkinSpanBufferTest, sizeConstructorEndtoEnd) {
   EXPECT_EQ(0ULL, buffer.pendingSpans());
   EXPECT_EQ("[]", buffer.toStringifiedJsonArray());
 }
+
+TEST(ZipkinSpanBufferTest, toThriftList) {
+  SpanBuffer buffer(2);
+  EXPECT_EQ(std::string({12, 0, 0, 0, 0}), buffer.toThriftList());
+
+  buffer.addSpan(Span());
+  buffer.addSpan(Span());
+  EXPECT_FALSE(buffer.addSpan(Span()));
+
+  const std::string empty_span{
+      10, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, // trace id
+      11, 0, 3, 0, 0, 0, 0,             // name
+      10, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, // id
+      15, 0, 6, 12, 0, 0, 0, 0,         // annotations
+      15, 0, 8, 12, 0, 0, 0, 0,         // binary annotations
+      0,                                // stop
+  };
+  EXPECT_EQ(std::string({12, 0, 0, 0, 2}) + empty_span + empty_span, buffer.toThriftList());
+}
 } // namespace Zipkin
 } // namespace Envoy
@@ -38,5 +38,36 @@ TEST(ZipkinUtilTest, utilTests) {
                   "\"val1\"}},\"array_field\":[],\"second_array\":[{\"a1\":10},{\"a2\":\"10\"}]}";
   EXPECT_EQ(expected_json, merged_json);
 }
+
+TEST(ZipkinUtilTest, thriftBinaryWriter) {
+  std::string output;
+  ThriftBinaryWriter writer(output);
+
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I64, 1);
+  writer.writeI64(0x0102030405060708);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I32, 2);
+  writer.writeI32(-2);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::I16, 300);
+  writer.writeI16(80);
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::List, 4);
+  writer.writeListBegin(ThriftBinaryWriter::Type::String, 2);
+  writer.writeString("ab");
+  writer.writeString("");
+  writer.writeFieldBegin(ThriftBinaryWriter::Type::Bool, 5);
+  writer.writeBool(true);
+  writer.writeFieldStop();
+
+  // Fields are the type, then the big endian id and value. Strings are prefixed with their length.
+  const std::string expected{
+      10, 0, 1,  1, 2, 3, 4, 5, 6, 7, 8,          // i64
+      8,  0, 2,  -1, -1, -1, -2,                  // i32
+      6,  1, 44, 0, 80,                           // i16
+      15, 0, 4,  11, 0, 0, 0, 2,                  // list<string>
+      0,  0, 0,  2, 'a', 'b', 0, 0, 0, 0,         // list elements
+      2,  0, 5,  1,                               // bool
+      0,                                          // stop
+  };
+  EXPECT_EQ(expected, output);
+}
 } // namespace Zipkin
 } // namespace Envoy
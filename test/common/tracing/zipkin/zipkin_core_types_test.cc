@@ -567,5 +567,74 @@ TEST(ZipkinCoreTypesSpanTest, setTag) {
   EXPECT_EQ("key2", bann.key());
   EXPECT_EQ("value2", bann.value());
 }
+
+TEST(ZipkinCoreTypesEndpointTest, toThrift) {
+  {
+    Endpoint ep;
+    std::string output;
+    ThriftBinaryWriter writer(output);
+    ep.toThrift(writer);
+    const std::string expected{8, 0, 1, 0, 0, 0, 0, 6, 0, 2, 0, 0, 11, 0, 3, 0, 0, 0, 0, 0};
+    EXPECT_EQ(expected, output);
+  }
+
+  {
+    Endpoint ep(std::string("svc"), Network::Utility::parseInternetAddressAndPort("[::1]:443"));
+    std::string output;
+    ThriftBinaryWriter writer(output);
+    ep.toThrift(writer);
+    const std::string expected{
+        8,  0, 1, 0, 0, 0, 0,                                     // ipv4
+        6,  0, 2, 1, -69,                                         // port
+        11, 0, 3, 0, 0, 0, 3, 's', 'v', 'c',                      // service name
+        11, 0, 4, 0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // ipv6
+        0,  0, 0, 1,                                              // ipv6 (cont.)
+        0,                                                        // stop
+    };
+    EXPECT_EQ(expected, output);
+  }
+}
+
+TEST(ZipkinCoreTypesSpanTest, toThrift) {
+  Span span;
+  span.setTraceId(1);
+  span.setName("n");
+  span.setId(2);
+  span.setParentId(3);
+  Endpoint ep(std::string("svc"), Network::Utility::parseInternetAddressAndPort("1.2.3.4:80"));
+  span.addAnnotation(Annotation(5, ZipkinCoreConstants::get().CLIENT_SEND, ep));
+  span.setTag("k", "v");
+  span.setTimestamp(6);
+  span.setDuration(7);
+
+  std::string output;
+  ThriftBinaryWriter writer(output);
+  span.toThrift(writer);
+
+  const std::string expected{
+      10, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1,  // trace id
+      11, 0, 3, 0, 0, 0, 1, 'n',         // name
+      10, 0, 4, 0, 0, 0, 0, 0, 0, 0, 2,  // id
+      10, 0, 5, 0, 0, 0, 0, 0, 0, 0, 3,  // parent id
+      15, 0, 6, 12, 0, 0, 0, 1,          // annotations
+      10, 0, 1, 0, 0, 0, 0, 0, 0, 0, 5,  //   timestamp
+      11, 0, 2, 0, 0, 0, 2, 'c', 's',    //   value
+      12, 0, 3,                          //   endpoint
+      8,  0, 1, 1, 2, 3, 4,              //     ipv4
+      6,  0, 2, 0, 80,                   //     port
+      11, 0, 3, 0, 0, 0, 3, 's', 'v', 'c', //   service name
+      0,                                 //     stop
+      0,                                 //   stop
+      15, 0, 8, 12, 0, 0, 0, 1,          // binary annotations
+      11, 0, 1, 0, 0, 0, 1, 'k',         //   key
+      11, 0, 2, 0, 0, 0, 1, 'v',         //   value
+      8,  0, 3, 0, 0, 0, 6,              //   annotation type
+      0,                                 //   stop
+      10, 0, 10, 0, 0, 0, 0, 0, 0, 0, 6, // timestamp
+      10, 0, 11, 0, 0, 0, 0, 0, 0, 0, 7, // duration
+      0,                                 // stop
+  };
+  EXPECT_EQ(expected, output);
+}
 } // namespace Zipkin
 } // namespace Envoy
@@ -2,6 +2,8 @@
 #include <memory>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
+#include "common/decompressor/zlib_decompressor_impl.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
@@ -111,6 +113,36 @@ TEST_F(ZipkinDriverTest, InitializeDriver) {
     EXPECT_THROW(setup(*loader, false), EnvoyException);
   }
 
+  {
+    // Valid cluster but unknown encoding.
+    EXPECT_CALL(cm_, get("fake_cluster")).WillOnce(Return(&cm_.thread_local_cluster_));
+
+    std::string invalid_config = R"EOF(
+      {
+       "collector_cluster": "fake_cluster",
+       "collector_encoding": "fake"
+       }
+    )EOF";
+    Json::ObjectSharedPtr loader = Json::Factory::loadFromString(invalid_config);
+
+    EXPECT_THROW(setup(*loader, false), EnvoyException);
+  }
+
+  {
+    // Valid cluster but unknown compression.
+    EXPECT_CALL(cm_, get("fake_cluster")).WillOnce(Return(&cm_.thread_local_cluster_));
+
+    std::string invalid_config = R"EOF(
+      {
+       "collector_cluster": "fake_cluster",
+       "collector_compression": "fake"
+       }
+    )EOF";
+    Json::ObjectSharedPtr loader = Json::Factory::loadFromString(invalid_config);
+
+    EXPECT_THROW(setup(*loader, false), EnvoyException);
+  }
+
   {
     // valid config
     EXPECT_CALL(cm_, get("fake_cluster")).WillRepeatedly(Return(&cm_.thread_local_cluster_));
@@ -177,6 +209,64 @@ TEST_F(ZipkinDriverTest, FlushSeveralSpans) {
   EXPECT_EQ(1U, stats_.counter("tracing.zipkin.reports_failed").value());
 }
 
+TEST_F(ZipkinDriverTest, FlushThriftSpansWithGzip) {
+  EXPECT_CALL(cm_, get("fake_cluster")).WillRepeatedly(Return(&cm_.thread_local_cluster_));
+
+  std::string valid_config = R"EOF(
+    {
+     "collector_cluster": "fake_cluster",
+     "collector_endpoint": "/api/v1/spans",
+     "collector_encoding": "thrift",
+     "collector_compression": "gzip"
+     }
+  )EOF";
+  Json::ObjectSharedPtr loader = Json::Factory::loadFromString(valid_config);
+  setup(*loader, true);
+
+  Http::MockAsyncClientRequest request(&cm_.async_client_);
+  const Optional<std::chrono::milliseconds> timeout(std::chrono::seconds(5));
+
+  EXPECT_CALL(cm_.async_client_, send_(_, _, timeout))
+      .WillOnce(
+          Invoke([&](Http::MessagePtr& message, Http::AsyncClient::Callbacks&,
+                     const Optional<std::chrono::milliseconds>&) -> Http::AsyncClient::Request* {
+            EXPECT_STREQ("/api/v1/spans", message->headers().Path()->value().c_str());
+            EXPECT_STREQ("application/x-thrift",
+                         message->headers().ContentType()->value().c_str());
+            EXPECT_STREQ(
+                "gzip",
+                message->headers().get(Http::Headers::get().ContentEncoding)->value().c_str());
+
+            // 15 window bits, plus 16 to expect a gzip header.
+            Decompressor::ZlibDecompressorImpl decompressor;
+            decompressor.init(31);
+            Buffer::OwnedImpl decompressed;
+            decompressor.decompress(*message->body(), decompressed);
+
+            // The body starts with the header of a list with two span structs.
+            EXPECT_EQ(std::string({12, 0, 0, 0, 2}),
+                      TestUtility::bufferToString(decompressed).substr(0, 5));
+
+            return &request;
+          }));
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.min_flush_spans", 5))
+      .Times(2)
+      .WillRepeatedly(Return(2));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("tracing.zipkin.request_timeout", 5000U))
+      .WillOnce(Return(5000U));
+
+  Tracing::SpanPtr first_span =
+      driver_->startSpan(config_, request_headers_, operation_name_, start_time_);
+  first_span->finishSpan();
+
+  Tracing::SpanPtr second_span =
+      driver_->startSpan(config_, request_headers_, operation_name_, start_time_);
+  second_span->finishSpan();
+
+  EXPECT_EQ(2U, stats_.counter("tracing.zipkin.spans_sent").value());
+}
+
 TEST_F(ZipkinDriverTest, FlushOneSpanReportFailure) {
   setupValidDriver();
 
@@ -493,6 +493,82 @@ TEST_F(ClusterManagerImplTest, RingHashLoadBalancerThreadAwareUpdate) {
             cluster_manager_->get("cluster_0")->loadBalancer().chooseHost(nullptr));
 }
 
+// Test that the cluster manager correctly re-creates the worker local LB when there is a host
+// set change.
+TEST_F(ClusterManagerImplTest, MaglevLoadBalancerThreadAwareUpdate) {
+  const std::string json =
+      fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+  std::shared_ptr<MockCluster> cluster1(new NiceMock<MockCluster>());
+  cluster1->info_->name_ = "cluster_0";
+  cluster1->info_->lb_type_ = LoadBalancerType::Maglev;
+
+  InSequence s;
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).WillOnce(Return(cluster1));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  create(parseBootstrapFromJson(json));
+
+  EXPECT_EQ(nullptr, cluster_manager_->get("cluster_0")->loadBalancer().chooseHost(nullptr));
+
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster1->info_, "tcp://127.0.0.1:80")};
+  cluster1->prioritySet().getMockHostSet(0)->runCallbacks(
+      cluster1->prioritySet().getMockHostSet(0)->hosts_, {});
+  cluster1->initialize_callback_();
+  EXPECT_EQ(cluster1->prioritySet().getMockHostSet(0)->hosts_[0],
+            cluster_manager_->get("cluster_0")->loadBalancer().chooseHost(nullptr));
+}
+
+// Test that membership updates within the merge window are merged into a single update to the
+// workers.
+TEST_F(ClusterManagerImplTest, MergedMembershipUpdates) {
+  const std::string json =
+      fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+  std::shared_ptr<MockCluster> cluster1(new NiceMock<MockCluster>());
+  cluster1->info_->name_ = "cluster_0";
+
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).WillOnce(Return(cluster1));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  create(parseBootstrapFromJson(json));
+  cluster1->initialize_callback_();
+
+  ON_CALL(factory_.runtime_.snapshot_,
+          getInteger("upstream.membership_update_merge_window_ms", _))
+      .WillByDefault(Return(1000));
+  Event::MockTimer* merge_timer = new Event::MockTimer(&factory_.dispatcher_);
+  EXPECT_CALL(*merge_timer, enableTimer(std::chrono::milliseconds(1000)));
+
+  // The first host is added and removed again within the window.
+  MockHostSet& host_set = *cluster1->prioritySet().getMockHostSet(0);
+  HostSharedPtr host1 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80");
+  HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:81");
+  host_set.hosts_ = {host1};
+  host_set.runCallbacks({host1}, {});
+  host_set.hosts_ = {host1, host2};
+  host_set.runCallbacks({host2}, {});
+  host_set.hosts_ = {host2};
+  host_set.runCallbacks({}, {host1});
+  EXPECT_EQ(2UL, factory_.stats_.counter("cluster_manager.membership_update_merged").value());
+
+  // Nothing reaches the workers until the window ends.
+  const PrioritySet& worker_priority_set = cluster_manager_->get("cluster_0")->prioritySet();
+  EXPECT_TRUE(worker_priority_set.hostSetsPerPriority()[0]->hosts().empty());
+
+  std::vector<HostSharedPtr> hosts_added;
+  std::vector<HostSharedPtr> hosts_removed;
+  worker_priority_set.addMemberUpdateCb([&](uint32_t, const std::vector<HostSharedPtr>& added,
+                                            const std::vector<HostSharedPtr>& removed) -> void {
+    hosts_added = added;
+    hosts_removed = removed;
+  });
+  merge_timer->callback_();
+  EXPECT_EQ(std::vector<HostSharedPtr>{host2}, hosts_added);
+  EXPECT_TRUE(hosts_removed.empty());
+  EXPECT_EQ(std::vector<HostSharedPtr>{host2},
+            worker_priority_set.hostSetsPerPriority()[0]->hosts());
+}
+
 TEST_F(ClusterManagerImplTest, TcpHealthChecker) {
   const std::string json = R"EOF(
   {
@@ -5,6 +5,7 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/buffer/zero_copy_input_stream_impl.h"
+#include "common/common/hash.h"
 #include "common/config/cds_json.h"
 #include "common/grpc/common.h"
 #include "common/http/headers.h"
@@ -16,6 +17,7 @@
 
 #include "test/common/http/common.h"
 #include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/redis/mocks.h"
 #include "test/mocks/runtime/mocks.h"
@@ -172,7 +174,8 @@ public:
     )EOF";
 
     health_checker_.reset(new TestHttpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                        dispatcher_, runtime_, random_));
+                                                        dispatcher_, runtime_, random_,
+                                                        time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -193,7 +196,8 @@ public:
     )EOF";
 
     health_checker_.reset(new TestHttpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                        dispatcher_, runtime_, random_));
+                                                        dispatcher_, runtime_, random_,
+                                                        time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -214,7 +218,8 @@ public:
     )EOF";
 
     health_checker_.reset(new TestHttpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                        dispatcher_, runtime_, random_));
+                                                        dispatcher_, runtime_, random_,
+                                                        time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -296,6 +301,7 @@ public:
   std::shared_ptr<TestHttpHealthCheckerImpl> health_checker_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
   std::list<uint32_t> connection_index_{};
   std::list<uint32_t> codec_index_{};
 };
@@ -321,6 +327,135 @@ TEST_F(HttpHealthCheckerImplTest, Success) {
   EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthy());
 }
 
+// Test that a host in the shard of another proxy is not checked, and that its state is read from
+// the shared state instead.
+TEST_F(HttpHealthCheckerImplTest, ShardedHostUsesSharedState) {
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_count", _)).WillByDefault(Return(2));
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_index", _))
+      .WillByDefault(Return((HashUtil::xxHash64("127.0.0.1:80") + 1) % 2));
+  std::string shared_state = "1 127.0.0.1:80 127.0.0.1:81";
+  ON_CALL(runtime_.snapshot_, get("health_check.shared_state.fake_cluster"))
+      .WillByDefault(ReturnRef(shared_state));
+  setupNoServiceValidationHC();
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  expectSessionCreate();
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(std::chrono::milliseconds(0)));
+  health_checker_->start();
+
+  EXPECT_CALL(*this, onHostStatus(_, true));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthFlagGet(
+      Host::HealthFlag::FAILED_ACTIVE_HC));
+
+  // The host needs to be reported healthy healthy_threshold times in a row.
+  shared_state = "2 127.0.0.1:81";
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_FALSE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthy());
+
+  EXPECT_CALL(*this, onHostStatus(_, true));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthy());
+
+  // Results of other proxies are not counted as checks made by this one.
+  EXPECT_EQ(3UL, cluster_->info_->stats_store_.counter("health_check.shard_skipped").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.failure").value());
+
+  // The shard settings are read when the health checker is created.
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_count", _)).WillByDefault(Return(1));
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_EQ(4UL, cluster_->info_->stats_store_.counter("health_check.shard_skipped").value());
+}
+
+// Test that a host in the shard of another proxy is checked locally when there is no shared state,
+// or when it is no longer updated.
+TEST_F(HttpHealthCheckerImplTest, ShardedHostStaleSharedState) {
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_count", _)).WillByDefault(Return(2));
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_index", _))
+      .WillByDefault(Return((HashUtil::xxHash64("127.0.0.1:80") + 1) % 2));
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shared_state_max_age_ms", _))
+      .WillByDefault(Return(1000));
+  std::string shared_state;
+  ON_CALL(runtime_.snapshot_, get("health_check.shared_state.fake_cluster"))
+      .WillByDefault(ReturnRef(shared_state));
+  MonotonicTime now;
+  ON_CALL(time_source_, currentTime()).WillByDefault(Invoke([&now]() { return now; }));
+  setupNoServiceValidationHC();
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  cluster_->info_->stats().upstream_cx_total_.inc();
+  expectSessionCreate();
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(std::chrono::milliseconds(0)));
+  health_checker_->start();
+
+  // There is no shared state.
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, disableTimer());
+  respond(0, "200", false, true);
+  EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthy());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.shared_state_stale").value());
+
+  // The shared state is used until it is older than its maximum age.
+  shared_state = "1 127.0.0.1:81";
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+
+  now += std::chrono::milliseconds(999);
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.shard_skipped").value());
+
+  // The shared state has not been updated for its maximum age.
+  now += std::chrono::milliseconds(1);
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.shared_state_stale").value());
+
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, disableTimer());
+  respond(0, "200", false, true);
+
+  // A new version is used again.
+  shared_state = "2 127.0.0.1:81";
+  EXPECT_CALL(*this, onHostStatus(_, false));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_));
+  test_sessions_[0]->interval_timer_->callback_();
+
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.shared_state_stale").value());
+  EXPECT_EQ(3UL, cluster_->info_->stats_store_.counter("health_check.shard_skipped").value());
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_TRUE(cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->healthy());
+}
+
+// Test that a shard index out of the range of the shard count is rejected.
+TEST_F(HttpHealthCheckerImplTest, ShardIndexOutOfRange) {
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_count", _)).WillByDefault(Return(2));
+  ON_CALL(runtime_.snapshot_, getInteger("health_check.shard_index", _)).WillByDefault(Return(2));
+  EXPECT_THROW_WITH_MESSAGE(
+      setupNoServiceValidationHC(), EnvoyException,
+      "health_check.shard_index 2 must be less than health_check.shard_count 2");
+}
+
 // Test host check success with multiple hosts.
 TEST_F(HttpHealthCheckerImplTest, SuccessWithMultipleHosts) {
   setupNoServiceValidationHC();
@@ -939,7 +1074,8 @@ public:
     )EOF";
 
     health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                   dispatcher_, runtime_, random_));
+                                                   dispatcher_, runtime_, random_,
+                                                   time_source_));
   }
 
   void setupNoData() {
@@ -956,7 +1092,8 @@ public:
     )EOF";
 
     health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                   dispatcher_, runtime_, random_));
+                                                   dispatcher_, runtime_, random_,
+                                                   time_source_));
   }
 
   void setupDataDontReuseConnection() {
@@ -978,7 +1115,8 @@ public:
       )EOF";
 
     health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                   dispatcher_, runtime_, random_));
+                                                   dispatcher_, runtime_, random_,
+                                                   time_source_));
   }
 
   void expectSessionCreate() {
@@ -1001,6 +1139,7 @@ public:
   Network::ReadFilterSharedPtr read_filter_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
 };
 
 TEST_F(TcpHealthCheckerImplTest, Success) {
@@ -1309,7 +1448,8 @@ public:
     )EOF";
 
     health_checker_.reset(new RedisHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                     dispatcher_, runtime_, random_, *this));
+                                                     dispatcher_, runtime_, random_,
+                                                     time_source_, *this));
   }
 
   void setupDontReuseConnection() {
@@ -1325,7 +1465,8 @@ public:
       )EOF";
 
     health_checker_.reset(new RedisHealthCheckerImpl(*cluster_, parseHealthCheckFromJson(json),
-                                                     dispatcher_, runtime_, random_, *this));
+                                                     dispatcher_, runtime_, random_,
+                                                     time_source_, *this));
   }
 
   Redis::ConnPool::ClientPtr create(Upstream::HostConstSharedPtr, Event::Dispatcher&,
@@ -1356,6 +1497,7 @@ public:
   NiceMock<Event::MockDispatcher> dispatcher_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
   Event::MockTimer* timeout_timer_{};
   Event::MockTimer* interval_timer_{};
   Redis::ConnPool::MockClient* client_{};
@@ -1591,7 +1733,8 @@ public:
   void setupHC() {
     const auto config = createGrpcHealthCheckConfig();
     health_checker_.reset(
-        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_));
+        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_,
+                                      time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -1601,7 +1744,8 @@ public:
     auto config = createGrpcHealthCheckConfig();
     config.mutable_unhealthy_threshold()->set_value(value);
     health_checker_.reset(
-        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_));
+        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_,
+                                      time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -1611,7 +1755,8 @@ public:
     auto config = createGrpcHealthCheckConfig();
     config.mutable_grpc_health_check()->set_service_name("service");
     health_checker_.reset(
-        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_));
+        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_,
+                                      time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -1621,7 +1766,8 @@ public:
     auto config = createGrpcHealthCheckConfig();
     config.mutable_reuse_connection()->set_value(false);
     health_checker_.reset(
-        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_));
+        new TestGrpcHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_,
+                                      time_source_));
     health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, bool changed_state) -> void {
       onHostStatus(host, changed_state);
     });
@@ -1771,6 +1917,7 @@ public:
   std::shared_ptr<TestGrpcHealthCheckerImpl> health_checker_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
   std::list<uint32_t> connection_index_{};
   std::list<uint32_t> codec_index_{};
 };
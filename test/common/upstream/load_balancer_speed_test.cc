@@ -0,0 +1,185 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/stats/stats_impl.h"
+#include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/maglev_lb.h"
+#include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/mocks.h"
+
+#include "testing/base/public/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class BenchmarkLoadBalancerContext : public LoadBalancerContext {
+public:
+  // Upstream::LoadBalancerContext
+  Optional<uint64_t> computeHashKey() override { return hash_key_; }
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() const override { return nullptr; }
+  const Network::Connection* downstreamConnection() const override { return nullptr; }
+
+  Optional<uint64_t> hash_key_;
+};
+
+/**
+ * A single priority of healthy hosts, along with everything needed to build a load balancer over
+ * them. Runtime and random are real implementations so that only load balancer code is measured.
+ */
+class BaseTester {
+public:
+  // When 'weighted' is set, the hosts get weights from 1 to 4 rather than all having the same one.
+  BaseTester(uint64_t num_hosts, bool weighted = false)
+      : stats_(ClusterInfoImpl::generateStats(stats_store_)), runtime_(random_) {
+    std::vector<HostSharedPtr> hosts;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256),
+                                   weighted ? (i % 4) + 1 : 1));
+    }
+    HostVectorConstSharedPtr updated_hosts{new std::vector<HostSharedPtr>(hosts)};
+    priority_set_.getOrCreateHostSet(0).updateHosts(
+        updated_hosts, updated_hosts, std::make_shared<std::vector<std::vector<HostSharedPtr>>>(),
+        std::make_shared<std::vector<std::vector<HostSharedPtr>>>(), hosts, {});
+  }
+
+  PrioritySetImpl priority_set_;
+  std::shared_ptr<MockClusterInfo> info_{new testing::NiceMock<MockClusterInfo>()};
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_;
+  Runtime::RandomGeneratorImpl random_;
+  Runtime::NullLoaderImpl runtime_;
+};
+
+class RingHashTester : public BaseTester {
+public:
+  RingHashTester(uint64_t num_hosts) : BaseTester(num_hosts) {}
+
+  std::unique_ptr<ThreadAwareLoadBalancer> create() {
+    return std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, runtime_, random_,
+                                                  config_);
+  }
+
+  Optional<envoy::api::v2::Cluster::RingHashLbConfig> config_;
+};
+
+class MaglevTester : public BaseTester {
+public:
+  MaglevTester(uint64_t num_hosts) : BaseTester(num_hosts) {}
+
+  std::unique_ptr<ThreadAwareLoadBalancer> create() {
+    return std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, runtime_, random_);
+  }
+};
+
+// Time to build the hashing structure for a host set, as happens on every host set update.
+template <class Tester> void BM_LoadBalancerBuild(benchmark::State& state) {
+  Tester tester(state.range(0));
+  for (auto _ : state) {
+    std::unique_ptr<ThreadAwareLoadBalancer> lb = tester.create();
+    lb->initialize();
+  }
+}
+BENCHMARK_TEMPLATE(BM_LoadBalancerBuild, RingHashTester)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadBalancerBuild, MaglevTester)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+// Time for a worker to choose a host for a request.
+template <class Tester> void BM_LoadBalancerChooseHost(benchmark::State& state) {
+  Tester tester(state.range(0));
+  std::unique_ptr<ThreadAwareLoadBalancer> thread_aware_lb = tester.create();
+  thread_aware_lb->initialize();
+  LoadBalancerPtr lb = thread_aware_lb->factory()->create();
+
+  BenchmarkLoadBalancerContext context;
+  uint64_t hash = 0;
+  for (auto _ : state) {
+    // Spread the hashes over the whole hash space.
+    hash += 0x9e3779b97f4a7c15;
+    context.hash_key_ = hash;
+    benchmark::DoNotOptimize(lb->chooseHost(&context));
+  }
+}
+BENCHMARK_TEMPLATE(BM_LoadBalancerChooseHost, RingHashTester)->Arg(10)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_LoadBalancerChooseHost, MaglevTester)->Arg(10)->Arg(1000)->Arg(10000);
+
+class RoundRobinTester : public BaseTester {
+public:
+  RoundRobinTester(uint64_t num_hosts, bool weighted) : BaseTester(num_hosts, weighted) {}
+
+  std::unique_ptr<LoadBalancer> create() {
+    return std::make_unique<RoundRobinLoadBalancer>(priority_set_, nullptr, stats_, runtime_,
+                                                    random_);
+  }
+};
+
+class LeastRequestTester : public BaseTester {
+public:
+  LeastRequestTester(uint64_t num_hosts, bool weighted) : BaseTester(num_hosts, weighted) {}
+
+  std::unique_ptr<LoadBalancer> create() {
+    return std::make_unique<LeastRequestLoadBalancer>(priority_set_, nullptr, stats_, runtime_,
+                                                      random_);
+  }
+};
+
+class RandomTester : public BaseTester {
+public:
+  RandomTester(uint64_t num_hosts, bool weighted) : BaseTester(num_hosts, weighted) {}
+
+  std::unique_ptr<LoadBalancer> create() {
+    return std::make_unique<RandomLoadBalancer>(priority_set_, nullptr, stats_, runtime_,
+                                                random_);
+  }
+};
+
+// Time for a worker to choose a host for a request, with state.range(1) selecting weighted hosts.
+template <class Tester> void BM_ZoneAwareLoadBalancerChooseHost(benchmark::State& state) {
+  Tester tester(state.range(0), state.range(1) != 0);
+  std::unique_ptr<LoadBalancer> lb = tester.create();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lb->chooseHost(nullptr));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ZoneAwareLoadBalancerChooseHost, RoundRobinTester)
+    ->Args({10, 0})
+    ->Args({1000, 0})
+    ->Args({10, 1})
+    ->Args({1000, 1});
+BENCHMARK_TEMPLATE(BM_ZoneAwareLoadBalancerChooseHost, LeastRequestTester)
+    ->Args({10, 0})
+    ->Args({1000, 0})
+    ->Args({10, 1})
+    ->Args({1000, 1});
+BENCHMARK_TEMPLATE(BM_ZoneAwareLoadBalancerChooseHost, RandomTester)
+    ->Args({10, 0})
+    ->Args({1000, 0});
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,220 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "envoy/router/router.h"
+
+#include "common/network/utility.h"
+#include "common/upstream/maglev_lb.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::_;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class TestLoadBalancerContext : public LoadBalancerContext {
+public:
+  TestLoadBalancerContext(uint64_t hash_key) : hash_key_(hash_key) {}
+
+  // Upstream::LoadBalancerContext
+  Optional<uint64_t> computeHashKey() override { return hash_key_; }
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() const override { return nullptr; }
+  const Network::Connection* downstreamConnection() const override { return nullptr; }
+
+  Optional<uint64_t> hash_key_;
+};
+
+} // namespace
+
+class MaglevLoadBalancerTest : public ::testing::TestWithParam<bool> {
+public:
+  MaglevLoadBalancerTest() : stats_(ClusterInfoImpl::generateStats(stats_store_)) {}
+
+  void init(uint64_t table_size = MaglevTable::DefaultTableSize) {
+    lb_.reset(new MaglevLoadBalancer(priority_set_, stats_, runtime_, random_, table_size));
+    lb_->initialize();
+  }
+
+  // Run all tests aginst both priority 0 and priority 1 host sets, to ensure
+  // all the load balancers have equivalent functonality for failover host sets.
+  MockHostSet& hostSet() { return GetParam() ? host_set_ : failover_host_set_; }
+
+  std::vector<HostSharedPtr> makeHosts(uint32_t num_hosts) {
+    std::vector<HostSharedPtr> hosts;
+    for (uint32_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:90", i / 256, i % 256)));
+    }
+    return hosts;
+  }
+
+  NiceMock<MockPrioritySet> priority_set_;
+  MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  MockHostSet& failover_host_set_ = *priority_set_.getMockHostSet(1);
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  std::unique_ptr<MaglevLoadBalancer> lb_;
+};
+
+// For tests which don't need to be run in both primary and failover modes.
+typedef MaglevLoadBalancerTest MaglevFailoverTest;
+
+INSTANTIATE_TEST_CASE_P(MaglevPrimaryOrFailover, MaglevLoadBalancerTest,
+                        ::testing::Values(true, false));
+INSTANTIATE_TEST_CASE_P(MaglevPrimaryOrFailover, MaglevFailoverTest, ::testing::Values(true));
+
+TEST_P(MaglevLoadBalancerTest, NoHost) {
+  init();
+  EXPECT_EQ(nullptr, lb_->factory()->create()->chooseHost(nullptr));
+};
+
+TEST_P(MaglevLoadBalancerTest, Basic) {
+  hostSet().hosts_ = makeHosts(6);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  init(7);
+
+  // Every host owns at least one of the 7 table entries, and hashes map to entries modulo the
+  // table size.
+  LoadBalancerPtr lb = lb_->factory()->create();
+  std::unordered_map<HostConstSharedPtr, uint32_t> entries_per_host;
+  for (uint64_t hash = 0; hash < 7; hash++) {
+    TestLoadBalancerContext context(hash);
+    HostConstSharedPtr host = lb->chooseHost(&context);
+    entries_per_host[host]++;
+
+    TestLoadBalancerContext wrapped_context(hash + 7 * 1000);
+    EXPECT_EQ(host, lb->chooseHost(&wrapped_context));
+  }
+  EXPECT_EQ(6U, entries_per_host.size());
+  for (const auto& host : hostSet().hosts_) {
+    EXPECT_NE(0U, entries_per_host[host]);
+  }
+  {
+    TestLoadBalancerContext context(3);
+    EXPECT_CALL(random_, random()).WillOnce(Return(3));
+    EXPECT_EQ(lb->chooseHost(&context), lb->chooseHost(nullptr));
+  }
+  EXPECT_EQ(0UL, stats_.lb_healthy_panic_.value());
+
+  hostSet().healthy_hosts_.clear();
+  hostSet().runCallbacks({}, {});
+  lb = lb_->factory()->create();
+  {
+    TestLoadBalancerContext context(0);
+    if (GetParam() == 1) {
+      EXPECT_NE(nullptr, lb->chooseHost(&context));
+    } else {
+      // When all hosts are unhealthy, the default behavior of the load balancer is to send
+      // traffic to P=0. In this case, P=0 has no backends so it returns nullptr.
+      EXPECT_EQ(nullptr, lb->chooseHost(&context));
+    }
+  }
+  EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
+}
+
+// Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
+TEST_P(MaglevFailoverTest, BasicFailover) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
+  failover_host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:82")};
+  failover_host_set_.hosts_ = failover_host_set_.healthy_hosts_;
+  init(7);
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
+
+  // Add a healthy host at P=0 and it will be chosen.
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  lb = lb_->factory()->create();
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
+
+  // Remove the healthy host and ensure we fail back over to the failover_host_set_
+  host_set_.healthy_hosts_ = {};
+  host_set_.runCallbacks({}, {});
+  lb = lb_->factory()->create();
+  EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
+
+  // Set up so P=0 gets 70% of the load, and P=1 gets 30%.
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                      makeTestHost(info_, "tcp://127.0.0.1:81")};
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0]};
+  host_set_.runCallbacks({}, {});
+  lb = lb_->factory()->create();
+  EXPECT_CALL(random_, random()).WillOnce(Return(69));
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(71));
+  EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
+}
+
+// Hosts take turns claiming table entries, so their shares of the table differ by at most one.
+TEST_P(MaglevLoadBalancerTest, EvenShares) {
+  hostSet().hosts_ = makeHosts(100);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  init();
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  std::unordered_map<HostConstSharedPtr, uint64_t> entries_per_host;
+  for (uint64_t hash = 0; hash < MaglevTable::DefaultTableSize; hash++) {
+    TestLoadBalancerContext context(hash);
+    entries_per_host[lb->chooseHost(&context)]++;
+  }
+  EXPECT_EQ(100U, entries_per_host.size());
+  for (const auto& entry : entries_per_host) {
+    EXPECT_GE(entry.second, MaglevTable::DefaultTableSize / 100);
+    EXPECT_LE(entry.second, MaglevTable::DefaultTableSize / 100 + 1);
+  }
+}
+
+// Removing a host moves its own entries, and only a small fraction of the other hosts' entries.
+TEST_P(MaglevLoadBalancerTest, MinimalDisruption) {
+  hostSet().hosts_ = makeHosts(100);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  init();
+
+  std::vector<HostConstSharedPtr> before;
+  LoadBalancerPtr lb = lb_->factory()->create();
+  for (uint64_t hash = 0; hash < MaglevTable::DefaultTableSize; hash++) {
+    TestLoadBalancerContext context(hash);
+    before.push_back(lb->chooseHost(&context));
+  }
+
+  const HostSharedPtr removed_host = hostSet().hosts_[50];
+  hostSet().hosts_.erase(hostSet().hosts_.begin() + 50);
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {removed_host});
+
+  uint64_t moved = 0;
+  uint64_t retained = 0;
+  lb = lb_->factory()->create();
+  for (uint64_t hash = 0; hash < MaglevTable::DefaultTableSize; hash++) {
+    TestLoadBalancerContext context(hash);
+    HostConstSharedPtr host = lb->chooseHost(&context);
+    EXPECT_NE(removed_host, host);
+    if (before[hash] != removed_host) {
+      retained++;
+      if (before[hash] != host) {
+        moved++;
+      }
+    }
+  }
+  EXPECT_LT(moved, retained / 50);
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -89,6 +90,18 @@ public:
     }
   }
 
+  void loadRq(std::vector<HostSharedPtr>& hosts, int num_rq, std::chrono::milliseconds time) {
+    for (uint64_t i = 0; i < hosts.size(); i++) {
+      loadRq(hosts[i], num_rq, time);
+    }
+  }
+
+  void loadRq(HostSharedPtr host, int num_rq, std::chrono::milliseconds time) {
+    for (int i = 0; i < num_rq; i++) {
+      host->outlierDetector().putResponseTime(time);
+    }
+  }
+
   NiceMock<MockCluster> cluster_;
   std::vector<HostSharedPtr>& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
   std::vector<HostSharedPtr>& failover_hosts_ = cluster_.prioritySet().getMockHostSet(1)->hosts_;
@@ -134,6 +147,11 @@ TEST_F(OutlierDetectorImplTest, DetectorStaticConfig) {
   EXPECT_EQ(50UL, detector->config().successRateMinimumHosts());
   EXPECT_EQ(200UL, detector->config().successRateRequestVolume());
   EXPECT_EQ(3000UL, detector->config().successRateStdevFactor());
+  EXPECT_EQ(5UL, detector->config().latencyMinimumHosts());
+  EXPECT_EQ(100UL, detector->config().latencyRequestVolume());
+  EXPECT_EQ(990UL, detector->config().latencyQuantile());
+  EXPECT_EQ(3000UL, detector->config().latencyFactor());
+  EXPECT_EQ(0UL, detector->config().enforcingLatency());
 }
 
 TEST_F(OutlierDetectorImplTest, DestroyWithActive) {
@@ -541,6 +559,156 @@ TEST_F(OutlierDetectorImplTest, BasicFlowSuccessRate) {
   EXPECT_EQ(-1, detector->successRateEjectionThreshold());
 }
 
+TEST_F(OutlierDetectorImplTest, BasicFlowLatency) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  ON_CALL(runtime_.snapshot_, featureEnabled("outlier_detection.enforcing_latency", 0))
+      .WillByDefault(Return(true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // Make one host slow. 10ms responses have a bucket of their own, and 100ms responses fall in the
+  // [100, 104) bucket.
+  loadRq(hosts_, 200, std::chrono::milliseconds(10));
+  loadRq(hosts_[4], 200, std::chrono::milliseconds(100));
+
+  EXPECT_CALL(time_source_, currentTime())
+      .Times(2)
+      .WillRepeatedly(Return(MonotonicTime(std::chrono::milliseconds(10000))));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]),
+                                       _, EjectionType::Latency, true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_DOUBLE_EQ(102.94, hosts_[4]->outlierDetector().latencyQuantile());
+  EXPECT_DOUBLE_EQ(10, hosts_[0]->outlierDetector().latencyQuantile());
+  EXPECT_DOUBLE_EQ(10, detector->latencyClusterQuantile());
+  EXPECT_DOUBLE_EQ(30, detector->latencyEjectionThreshold());
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, cluster_.info_->stats_store_.gauge("outlier_detection.ejections_active").value());
+  EXPECT_EQ(1UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_detected_latency")
+                .value());
+  EXPECT_EQ(1UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_enforced_latency")
+                .value());
+
+  // Interval that does bring the host back in.
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(40001))));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_,
+              logUneject(std::static_pointer_cast<const HostDescription>(hosts_[4])));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_FALSE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+
+  // Give 4 hosts enough request volume but not to the 5th. Should not cause an ejection.
+  for (uint64_t i = 0; i < 4; i++) {
+    loadRq(hosts_[i], 100, std::chrono::milliseconds(10));
+  }
+  loadRq(hosts_[4], 25, std::chrono::milliseconds(100));
+
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(50001))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_EQ(0UL, cluster_.info_->stats_store_.gauge("outlier_detection.ejections_active").value());
+  EXPECT_EQ(-1, hosts_[4]->outlierDetector().latencyQuantile());
+  EXPECT_EQ(-1, detector->latencyClusterQuantile());
+  EXPECT_EQ(-1, detector->latencyEjectionThreshold());
+}
+
+TEST_F(OutlierDetectorImplTest, LatencyNotEnforced) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+
+  // Latency outliers are detected by default, but not ejected.
+  loadRq(hosts_, 200, std::chrono::milliseconds(10));
+  loadRq(hosts_[4], 200, std::chrono::milliseconds(100));
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(10000))));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]),
+                                       _, EjectionType::Latency, false));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_DOUBLE_EQ(102.94, hosts_[4]->outlierDetector().latencyQuantile());
+  EXPECT_DOUBLE_EQ(10, detector->latencyClusterQuantile());
+  EXPECT_FALSE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(0UL, cluster_.info_->stats_store_.gauge("outlier_detection.ejections_active").value());
+  EXPECT_EQ(1UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_detected_latency")
+                .value());
+  EXPECT_EQ(0UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_enforced_latency")
+                .value());
+}
+
+TEST_F(OutlierDetectorImplTest, LatencyDetectionDisabled) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  ON_CALL(runtime_.snapshot_, getInteger("outlier_detection.detect_latency", 1))
+      .WillByDefault(Return(0));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_source_, event_logger_));
+
+  // Response times are not recorded while latency detection is disabled.
+  loadRq(hosts_, 200, std::chrono::milliseconds(10));
+  loadRq(hosts_[4], 200, std::chrono::milliseconds(100));
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(10000))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_EQ(-1, hosts_[4]->outlierDetector().latencyQuantile());
+  EXPECT_EQ(-1, detector->latencyClusterQuantile());
+  EXPECT_EQ(0UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_detected_latency")
+                .value());
+
+  // Once it is enabled, recording starts with the next interval.
+  ON_CALL(runtime_.snapshot_, getInteger("outlier_detection.detect_latency", 1))
+      .WillByDefault(Return(1));
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(20000))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+
+  loadRq(hosts_, 200, std::chrono::milliseconds(10));
+  EXPECT_CALL(time_source_, currentTime())
+      .WillOnce(Return(MonotonicTime(std::chrono::milliseconds(30000))));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000)));
+  interval_timer_->callback_();
+  EXPECT_DOUBLE_EQ(10, hosts_[4]->outlierDetector().latencyQuantile());
+  EXPECT_DOUBLE_EQ(10, detector->latencyClusterQuantile());
+}
+
 TEST_F(OutlierDetectorImplTest, RemoveWhileEjected) {
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
   addHosts({"tcp://127.0.0.1:80"});
@@ -804,6 +972,23 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
   event_logger.logEject(host, detector, EjectionType::SuccessRate, false);
   Json::Factory::loadFromString(log3);
 
+  std::string log5;
+  EXPECT_CALL(host->outlier_detector_, lastUnejectionTime()).WillOnce(ReturnRef(monotonic_time));
+  EXPECT_CALL(host->outlier_detector_, latencyQuantile()).WillOnce(Return(120));
+  EXPECT_CALL(detector, latencyClusterQuantile()).WillOnce(Return(20));
+  EXPECT_CALL(detector, latencyEjectionThreshold()).WillOnce(Return(60));
+  EXPECT_CALL(*file, write("{\"time\": \"1970-01-01T00:00:00.000Z\", \"secs_since_last_action\": "
+                           "\"30\", \"cluster\": "
+                           "\"fake_cluster\", \"upstream_url\": \"10.0.0.1:443\", \"action\": "
+                           "\"eject\", \"type\": \"Latency\", \"num_ejections\": \"0\", "
+                           "\"enforced\": \"false\", "
+                           "\"host_latency_quantile\": \"120\", \"cluster_latency_quantile\": "
+                           "\"20\", \"cluster_latency_ejection_threshold\": \"60\""
+                           "}\n"))
+      .WillOnce(SaveArg<0>(&log5));
+  event_logger.logEject(host, detector, EjectionType::Latency, false);
+  Json::Factory::loadFromString(log5);
+
   std::string log4;
   EXPECT_CALL(host->outlier_detector_, lastEjectionTime()).WillOnce(ReturnRef(monotonic_time));
   EXPECT_CALL(*file, write("{\"time\": \"1970-01-01T00:00:00.000Z\", \"secs_since_last_action\": "
@@ -828,6 +1013,50 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(90.0, ejection_pair.success_rate_average_);
 }
 
+TEST(OutlierUtility, LatencyThreshold) {
+  std::vector<HostLatencyPair> data = {
+      HostLatencyPair(nullptr, 200), HostLatencyPair(nullptr, 10), HostLatencyPair(nullptr, 20),
+      HostLatencyPair(nullptr, 12),  HostLatencyPair(nullptr, 15),
+  };
+
+  Utility::LatencyEjectionPair ejection_pair = Utility::latencyEjectionThreshold(data, 3.0);
+  EXPECT_EQ(15.0, ejection_pair.cluster_quantile_);
+  EXPECT_EQ(45.0, ejection_pair.ejection_threshold_);
+
+  data.emplace_back(nullptr, 11);
+  ejection_pair = Utility::latencyEjectionThreshold(data, 3.0);
+  EXPECT_EQ(13.5, ejection_pair.cluster_quantile_);
+  EXPECT_EQ(40.5, ejection_pair.ejection_threshold_);
+}
+
+TEST(LatencyAccumulatorBucket, Index) {
+  EXPECT_EQ(3U, LatencyAccumulatorBucket::index(3));
+  EXPECT_EQ(10U, LatencyAccumulatorBucket::index(10));
+  EXPECT_EQ(Stats::LogLinearBuckets::index(100000), LatencyAccumulatorBucket::index(100000));
+  EXPECT_EQ(LatencyAccumulatorBucket::NumBuckets - 1,
+            LatencyAccumulatorBucket::index(LatencyAccumulatorBucket::MaxResponseTimeMs));
+  EXPECT_EQ(LatencyAccumulatorBucket::NumBuckets - 1,
+            LatencyAccumulatorBucket::index(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(LatencyAccumulator, Quantile) {
+  LatencyAccumulator accumulator;
+  LatencyAccumulatorBucket* bucket = accumulator.updateCurrentWriter();
+  for (uint64_t time = 0; time < 4; time++) {
+    bucket->counts_[LatencyAccumulatorBucket::index(time)] += 25;
+  }
+
+  // Data is only read after the next interval starts.
+  EXPECT_FALSE(accumulator.getLatencyQuantile(100, 0.5).valid());
+  accumulator.updateCurrentWriter();
+  EXPECT_FALSE(accumulator.getLatencyQuantile(101, 0.5).valid());
+  EXPECT_DOUBLE_EQ(1.0, accumulator.getLatencyQuantile(100, 0.5).value());
+  EXPECT_DOUBLE_EQ(3.0, accumulator.getLatencyQuantile(100, 0.99).value());
+
+  accumulator.updateCurrentWriter();
+  EXPECT_FALSE(accumulator.getLatencyQuantile(0, 0.5).valid());
+}
+
 TEST(DetectorHostMonitorImpl, resultToHttpCode) {
   EXPECT_EQ(Http::Code::OK, DetectorHostMonitorImpl::resultToHttpCode(Result::SUCCESS));
   EXPECT_EQ(Http::Code::GatewayTimeout, DetectorHostMonitorImpl::resultToHttpCode(Result::TIMEOUT));
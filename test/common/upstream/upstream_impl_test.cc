@@ -1,6 +1,7 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <map>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -334,6 +335,35 @@ TEST(HostImplTest, Weight) {
   EXPECT_EQ(128U, host->weight());
 }
 
+TEST(HostImplTest, Stats) {
+  MockCluster cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234");
+  HostSharedPtr other_host = makeTestHost(cluster.info_, "tcp://10.0.0.2:1234");
+
+  host->stats().rq_total_.inc();
+  host->stats().cx_active_.set(3);
+  EXPECT_EQ(0U, other_host->stats().rq_total_.value());
+
+  std::map<std::string, uint64_t> counters;
+  for (const Stats::CounterSharedPtr& counter : host->counters()) {
+    counters[counter->name()] = counter->value();
+  }
+  EXPECT_EQ(6U, counters.size());
+  EXPECT_EQ(1U, counters["rq_total"]);
+  EXPECT_EQ(0U, counters["cx_total"]);
+
+  std::map<std::string, uint64_t> gauges;
+  for (const Stats::GaugeSharedPtr& gauge : host->gauges()) {
+    gauges[gauge->name()] = gauge->value();
+  }
+  EXPECT_EQ(2U, gauges.size());
+  EXPECT_EQ(3U, gauges["cx_active"]);
+  EXPECT_EQ(0U, gauges["rq_active"]);
+
+  // The names are shared by all hosts.
+  EXPECT_EQ(&host->stats().rq_total_.name(), &other_host->stats().rq_total_.name());
+}
+
 TEST(HostImplTest, HostnameCanaryAndLocality) {
   MockCluster cluster;
   envoy::api::v2::Metadata metadata;
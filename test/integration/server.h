@@ -35,6 +35,7 @@ public:
   // Server::Options
   uint64_t baseId() override { return 0; }
   uint32_t concurrency() override { return 1; }
+  bool reusePort() override { return false; }
   const std::string& configPath() override { return config_path_; }
   bool v2ConfigOnly() override { return false; }
   const std::string& adminAddressPath() override { return admin_address_path_; }
@@ -162,6 +163,10 @@ public:
     std::unique_lock<std::mutex> lock(lock_);
     return store_.gauges();
   }
+  std::list<ParentHistogramSharedPtr> histograms() const override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.histograms();
+  }
 
   // Stats::StoreRoot
   void addSink(Sink&) override {}
@@ -56,6 +56,7 @@ public:
 
   MOCK_METHOD2(onConfigUpdate, void(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                                     const std::string& version_info));
+  MOCK_METHOD1(onConfigUpdateUnchanged, void(const std::string& version_info));
   MOCK_METHOD1(onConfigUpdateFailed, void(const EnvoyException* e));
 };
 
@@ -13,6 +13,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::AnyNumber;
 using testing::Invoke;
 using testing::Return;
 using testing::ReturnPointee;
@@ -145,7 +146,10 @@ MockFilter::MockFilter() {
 
 MockFilter::~MockFilter() {}
 
-MockListenerCallbacks::MockListenerCallbacks() {}
+MockListenerCallbacks::MockListenerCallbacks() {
+  // Most tests do not care how connections were batched.
+  EXPECT_CALL(*this, onAcceptBatch(_, _)).Times(AnyNumber());
+}
 MockListenerCallbacks::~MockListenerCallbacks() {}
 
 MockDrainDecision::MockDrainDecision() {}
@@ -204,6 +204,7 @@ public:
 
   MOCK_METHOD2(onAccept_, void(ConnectionSocketPtr& socket, bool redirected));
   MOCK_METHOD1(onNewConnection_, void(ConnectionPtr& conn));
+  MOCK_METHOD2(onAcceptBatch, void(uint32_t accepted, std::chrono::microseconds duration));
 };
 
 class MockDrainDecision : public DrainDecision {
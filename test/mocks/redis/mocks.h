@@ -95,6 +95,11 @@ public:
 
   MOCK_METHOD3(makeRequest, PoolRequest*(const std::string& hash_key, const RespValue& request,
                                          PoolCallbacks& callbacks));
+  MOCK_METHOD1(chooseHost, Upstream::HostConstSharedPtr(const std::string& hash_key));
+  MOCK_METHOD1(chooseConnection, uint32_t(const std::string& hash_key));
+  MOCK_METHOD4(makeRequestToHost,
+               PoolRequest*(const Upstream::HostConstSharedPtr& host, uint32_t connection,
+                            const RespValue& request, PoolCallbacks& callbacks));
 };
 
 } // namespace ConnPool
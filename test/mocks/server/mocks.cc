@@ -53,6 +53,10 @@ MockHotRestart::~MockHotRestart() {}
 MockListenerComponentFactory::MockListenerComponentFactory()
     : socket_(std::make_shared<NiceMock<Network::MockListenSocket>>()) {
   ON_CALL(*this, createListenSocket(_, _)).WillByDefault(Return(socket_));
+  ON_CALL(*this, createWorkerListenSockets(_, _))
+      .WillByDefault(Invoke([this](Network::Address::InstanceConstSharedPtr, uint32_t num_workers) {
+        return std::vector<Network::ListenSocketSharedPtr>(num_workers, socket_);
+      }));
 }
 MockListenerComponentFactory::~MockListenerComponentFactory() {}
 
@@ -46,6 +46,7 @@ public:
 
   MOCK_METHOD0(baseId, uint64_t());
   MOCK_METHOD0(concurrency, uint32_t());
+  MOCK_METHOD0(reusePort, bool());
   MOCK_METHOD0(configPath, const std::string&());
   MOCK_METHOD0(v2ConfigOnly, bool());
   MOCK_METHOD0(adminAddressPath, const std::string&());
@@ -128,7 +129,8 @@ public:
 
   // Server::HotRestart
   MOCK_METHOD0(drainParentListeners, void());
-  MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
+  MOCK_METHOD3(duplicateParentListenSocket,
+               int(const std::string& address, uint32_t worker_index, uint32_t num_worker_sockets));
   MOCK_METHOD1(getParentStats, void(GetParentStatsInfo& info));
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(shutdownParentAdmin, void(ShutdownParentAdminInfo& info));
@@ -157,6 +159,9 @@ public:
   MOCK_METHOD2(createListenSocket,
                Network::ListenSocketSharedPtr(Network::Address::InstanceConstSharedPtr address,
                                               bool bind_to_port));
+  MOCK_METHOD2(createWorkerListenSockets,
+               std::vector<Network::ListenSocketSharedPtr>(
+                   Network::Address::InstanceConstSharedPtr address, uint32_t num_workers));
   MOCK_METHOD1(createDrainManager_, DrainManager*(envoy::api::v2::Listener::DrainType drain_type));
   MOCK_METHOD0(nextListenerTag, uint64_t());
 
@@ -170,6 +175,9 @@ public:
 
   MOCK_METHOD2(addOrUpdateListener, bool(const envoy::api::v2::Listener& config, bool modifiable));
   MOCK_METHOD0(listeners, std::vector<std::reference_wrapper<Network::ListenerConfig>>());
+  MOCK_METHOD2(findListenSocket, Network::ListenSocket*(const Network::Address::Instance& address,
+                                                        uint32_t worker_index));
+  MOCK_METHOD1(numWorkerListenSockets, uint32_t(const Network::Address::Instance& address));
   MOCK_METHOD0(numConnections, uint64_t());
   MOCK_METHOD1(removeListener, bool(const std::string& listener_name));
   MOCK_METHOD1(startWorkers, void(GuardDog& guard_dog));
@@ -36,6 +36,14 @@ MockHistogram::MockHistogram() {
 }
 MockHistogram::~MockHistogram() {}
 
+MockParentHistogram::MockParentHistogram() {
+  ON_CALL(*this, tagExtractedName()).WillByDefault(ReturnRef(name_));
+  ON_CALL(*this, tags()).WillByDefault(ReturnRef(tags_));
+  ON_CALL(*this, intervalStatistics()).WillByDefault(ReturnRef(interval_statistics_));
+  ON_CALL(*this, cumulativeStatistics()).WillByDefault(ReturnRef(cumulative_statistics_));
+}
+MockParentHistogram::~MockParentHistogram() {}
+
 MockSink::MockSink() {}
 MockSink::~MockSink() {}
 
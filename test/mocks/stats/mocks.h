@@ -10,6 +10,7 @@
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/stats/histogram_impl.h"
 #include "common/stats/stats_impl.h"
 
 #include "gmock/gmock.h"
@@ -74,6 +75,27 @@ public:
   Store* store_;
 };
 
+class MockParentHistogram : public ParentHistogram {
+public:
+  MockParentHistogram();
+  ~MockParentHistogram();
+
+  const std::string& name() const override { return name_; };
+
+  MOCK_CONST_METHOD0(tagExtractedName, const std::string&());
+  MOCK_CONST_METHOD0(tags, const std::vector<Tag>&());
+  MOCK_METHOD1(recordValue, void(uint64_t value));
+  MOCK_METHOD0(merge, void());
+  MOCK_CONST_METHOD0(intervalStatistics, const HistogramStatistics&());
+  MOCK_CONST_METHOD0(cumulativeStatistics, const HistogramStatistics&());
+  MOCK_CONST_METHOD0(used, bool());
+
+  std::string name_;
+  std::vector<Tag> tags_;
+  HistogramStatisticsImpl interval_statistics_;
+  HistogramStatisticsImpl cumulative_statistics_;
+};
+
 class MockSink : public Sink {
 public:
   MockSink();
@@ -82,6 +104,7 @@ public:
   MOCK_METHOD0(beginFlush, void());
   MOCK_METHOD2(flushCounter, void(const Counter& counter, uint64_t delta));
   MOCK_METHOD2(flushGauge, void(const Gauge& gauge, uint64_t value));
+  MOCK_METHOD1(flushHistogram, void(const ParentHistogram& histogram));
   MOCK_METHOD0(endFlush, void());
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
 };
@@ -100,6 +123,7 @@ public:
   MOCK_METHOD1(gauge, Gauge&(const std::string&));
   MOCK_CONST_METHOD0(gauges, std::list<GaugeSharedPtr>());
   MOCK_METHOD1(histogram, Histogram&(const std::string& name));
+  MOCK_CONST_METHOD0(histograms, std::list<ParentHistogramSharedPtr>());
 
   testing::NiceMock<MockCounter> counter_;
   std::vector<std::unique_ptr<MockHistogram>> histograms_;
@@ -23,7 +23,7 @@ MockLoadBalancerSubsetInfo::MockLoadBalancerSubsetInfo() {
 MockLoadBalancerSubsetInfo::~MockLoadBalancerSubsetInfo() {}
 
 MockClusterInfo::MockClusterInfo()
-    : stats_(ClusterInfoImpl::generateStats(stats_store_)),
+    : stats_(ClusterInfoImpl::generateStats(stats_store_)), code_stats_(stats_store_),
       transport_socket_factory_(new Network::RawBufferSocketFactory),
       load_report_stats_(ClusterInfoImpl::generateLoadReportStats(load_report_stats_store_)),
       resource_manager_(new Upstream::ResourceManagerImpl(runtime_, "fake_key", 1, 1024, 1024, 1)) {
@@ -37,6 +37,7 @@ MockClusterInfo::MockClusterInfo()
   ON_CALL(*this, statsScope()).WillByDefault(ReturnRef(stats_store_));
   ON_CALL(*this, transportSocketFactory()).WillByDefault(ReturnRef(*transport_socket_factory_));
   ON_CALL(*this, loadReportStats()).WillByDefault(ReturnRef(load_report_stats_));
+  ON_CALL(*this, codeStats()).WillByDefault(ReturnRef(code_stats_));
   ON_CALL(*this, sourceAddress()).WillByDefault(ReturnRef(source_address_));
   ON_CALL(*this, resourceManager(_))
       .WillByDefault(Invoke(
@@ -30,6 +30,7 @@ public:
   MOCK_METHOD0(lastUnejectionTime, const Optional<MonotonicTime>&());
   MOCK_CONST_METHOD0(successRate, double());
   MOCK_METHOD1(successRate, void(double new_success_rate));
+  MOCK_CONST_METHOD0(latencyQuantile, double());
 };
 
 class MockEventLogger : public EventLogger {
@@ -56,6 +57,8 @@ public:
   MOCK_METHOD1(addChangedStateCb, void(ChangeStateCb cb));
   MOCK_CONST_METHOD0(successRateAverage, double());
   MOCK_CONST_METHOD0(successRateEjectionThreshold, double());
+  MOCK_CONST_METHOD0(latencyClusterQuantile, double());
+  MOCK_CONST_METHOD0(latencyEjectionThreshold, double());
 
   std::list<ChangeStateCb> callbacks_;
 };
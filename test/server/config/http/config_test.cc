@@ -16,6 +16,7 @@
 #include "server/config/http/grpc_http1_bridge.h"
 #include "server/config/http/grpc_json_transcoder.h"
 #include "server/config/http/grpc_web.h"
+#include "server/config/http/gzip.h"
 #include "server/config/http/ip_tagging.h"
 #include "server/config/http/lua.h"
 #include "server/config/http/ratelimit.h"
@@ -397,6 +398,23 @@ TEST(HttpFilterConfigTest, RouterFilterWithEmptyProtoConfig) {
   cb(filter_callback);
 }
 
+TEST(HttpFilterConfigTest, GzipFilter) {
+  std::string json_string = R"EOF(
+  {
+    "compression_level" : "speed",
+    "content_type" : ["text/html"]
+  }
+  )EOF";
+
+  Json::ObjectSharedPtr json_config = Json::Factory::loadFromString(json_string);
+  NiceMock<MockFactoryContext> context;
+  GzipFilterConfig factory;
+  HttpFilterFactoryCb cb = factory.createFilterFactory(*json_config, "stats", context);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  cb(filter_callback);
+}
+
 TEST(HttpFilterConfigTest, IpTaggingFilter) {
   std::string json_string = R"EOF(
   {
@@ -808,6 +808,60 @@ TEST_F(ListenerManagerImplTest, EarlyShutdown) {
   manager_->stopWorkers();
 }
 
+TEST_F(ListenerManagerImplTest, ReusePortSocketPerWorker) {
+  InSequence s;
+
+  MockWorker* worker1 = new MockWorker();
+  MockWorker* worker2 = new MockWorker();
+  ON_CALL(server_.options_, concurrency()).WillByDefault(Return(2));
+  ON_CALL(server_.options_, reusePort()).WillByDefault(Return(true));
+  EXPECT_CALL(worker_factory_, createWorker_()).WillOnce(Return(worker1));
+  EXPECT_CALL(worker_factory_, createWorker_()).WillOnce(Return(worker2));
+  manager_.reset(new ListenerManagerImpl(server_, listener_factory_, worker_factory_));
+
+  const std::string listener_foo_json = R"EOF(
+  {
+    "name": "foo",
+    "address": "tcp://127.0.0.1:1234",
+    "filters": []
+  }
+  )EOF";
+
+  auto socket1 = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  auto socket2 = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  ListenerHandle* listener_foo = expectListenerCreate(false);
+  EXPECT_CALL(listener_factory_, createWorkerListenSockets(_, 2))
+      .WillOnce(Return(std::vector<Network::ListenSocketSharedPtr>{socket1, socket2}));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromJson(listener_foo_json), true));
+  Network::ListenerConfig& listener = manager_->listeners()[0].get();
+  EXPECT_EQ(socket1.get(), &listener.socket());
+
+  // Each worker listens on its own socket, with the listener's tag.
+  EXPECT_CALL(*worker1, addListener(_, _))
+      .WillOnce(Invoke([&](Network::ListenerConfig& config, Worker::AddListenerCompletion) {
+        EXPECT_EQ(socket1.get(), &config.socket());
+        EXPECT_EQ(listener.listenerTag(), config.listenerTag());
+      }));
+  EXPECT_CALL(*worker1, start(_));
+  EXPECT_CALL(*worker2, addListener(_, _))
+      .WillOnce(Invoke([&](Network::ListenerConfig& config, Worker::AddListenerCompletion) {
+        EXPECT_EQ(socket2.get(), &config.socket());
+        EXPECT_EQ(listener.listenerTag(), config.listenerTag());
+      }));
+  EXPECT_CALL(*worker2, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  // The sockets are handed to a hot restarted child by worker.
+  EXPECT_EQ(socket1.get(), manager_->findListenSocket(*socket1->localAddress(), 0));
+  EXPECT_EQ(socket2.get(), manager_->findListenSocket(*socket1->localAddress(), 1));
+  EXPECT_EQ(nullptr, manager_->findListenSocket(*socket1->localAddress(), 2));
+  // The child checks that it uses as many sockets as the parent.
+  EXPECT_EQ(2U, manager_->numWorkerListenSockets(*socket1->localAddress()));
+  EXPECT_EQ(0U, manager_->numWorkerListenSockets(Network::Address::Ipv4Instance(5678)));
+
+  EXPECT_CALL(*listener_foo, onDestroy());
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, SniWithSingleFilterChain) {
   const std::string yaml = TestEnvironment::substitute(R"EOF(
     address:
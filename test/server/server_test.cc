@@ -13,7 +13,10 @@
 
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::NiceMock;
 using testing::Property;
+using testing::Ref;
+using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
 using testing::_;
@@ -35,7 +38,30 @@ TEST(ServerInstanceUtil, flushHelper) {
 
   std::list<Stats::SinkPtr> sinks;
   sinks.emplace_back(std::move(sink));
-  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store);
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
+TEST(ServerInstanceUtil, flushHelperHistograms) {
+  InSequence s;
+
+  NiceMock<Stats::MockStore> store;
+  auto used_histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  auto unused_histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  std::unique_ptr<Stats::MockSink> sink(new StrictMock<Stats::MockSink>());
+  EXPECT_CALL(*sink, beginFlush());
+  EXPECT_CALL(store, histograms())
+      .WillOnce(Return(std::list<Stats::ParentHistogramSharedPtr>{used_histogram,
+                                                                  unused_histogram}));
+  EXPECT_CALL(*used_histogram, merge());
+  EXPECT_CALL(*used_histogram, used()).WillOnce(Return(true));
+  EXPECT_CALL(*sink, flushHistogram(Ref(*used_histogram)));
+  EXPECT_CALL(*unused_histogram, merge());
+  EXPECT_CALL(*unused_histogram, used()).WillOnce(Return(false));
+  EXPECT_CALL(*sink, endFlush());
+
+  std::list<Stats::SinkPtr> sinks;
+  sinks.emplace_back(std::move(sink));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
 }
 
 class RunHelperTest : public testing::Test {
@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+
+# Builds and runs the *_speed_test benchmark binaries, and collects their results into a single JSON
+# file that can be compared across builds or releases.
+#
+# Run all speed tests and write the results to results.json:
+#   tools/speed_test.py run --output results.json
+#
+# Run a subset of them, passing extra flags to each binary:
+#   tools/speed_test.py run --output results.json \
+#     --targets //test/common/http:header_map_impl_speed_test -- --benchmark_repetitions=5
+#
+# Compare two result files, exiting with status 1 when a benchmark is slower by more than 10%:
+#   tools/speed_test.py compare old.json new.json --threshold 10
+
+from __future__ import print_function
+
+import argparse
+import datetime
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+SPEED_TEST_QUERY = 'attr(name, "_speed_test$", kind(cc_binary, //test/...))'
+
+
+def bazel(args, **kwargs):
+  return subprocess.check_output(["bazel"] + args, **kwargs).decode("utf-8")
+
+
+def findTargets():
+  return sorted(bazel(["query", SPEED_TEST_QUERY]).split())
+
+
+def binaryPath(target):
+  # //test/common/http:foo_speed_test -> bazel-bin/test/common/http/foo_speed_test
+  package, name = target.lstrip("/").split(":")
+  return os.path.join("bazel-bin", package, name)
+
+
+def gitSha():
+  try:
+    return subprocess.check_output(["git", "rev-parse", "HEAD"]).decode("utf-8").strip()
+  except (OSError, subprocess.CalledProcessError):
+    return "unknown"
+
+
+def runTarget(target, benchmark_args):
+  fd, path = tempfile.mkstemp(suffix=".json")
+  os.close(fd)
+  try:
+    subprocess.check_call([binaryPath(target), "--benchmark_out_format=json",
+                           "--benchmark_out=" + path] + benchmark_args)
+    with open(path) as f:
+      return json.load(f)
+  finally:
+    os.remove(path)
+
+
+def run(args):
+  targets = args.targets or findTargets()
+  subprocess.check_call(["bazel", "build", "-c", "opt"] + args.bazel_args + targets)
+
+  results = {
+      "context": {
+          "git_sha": gitSha(),
+          "date": datetime.datetime.utcnow().isoformat() + "Z",
+      },
+      "benchmarks": [],
+  }
+  for target in targets:
+    output = runTarget(target, args.benchmark_args)
+    # The machine description is the same for every binary, so keep the first one.
+    results["context"].setdefault("machine", output["context"])
+    for benchmark in output["benchmarks"]:
+      benchmark["target"] = target
+      results["benchmarks"].append(benchmark)
+
+  with open(args.output, "w") as f:
+    json.dump(results, f, indent=2, sort_keys=True)
+  print("Wrote %d results from %d targets to %s" % (len(results["benchmarks"]), len(targets),
+                                                     args.output))
+
+
+def loadTimes(path):
+  with open(path) as f:
+    results = json.load(f)
+  # Aggregates such as _mean are only present with --benchmark_repetitions, and are compared like
+  # any other benchmark.
+  return {(b["target"], b["name"]): b["cpu_time"] for b in results["benchmarks"]}
+
+
+def compare(args):
+  old_times = loadTimes(args.old)
+  new_times = loadTimes(args.new)
+  regressions = 0
+  for key in sorted(set(old_times) | set(new_times)):
+    target, name = key
+    if key not in old_times or key not in new_times:
+      print("%-70s %s" % (name, "added" if key in new_times else "removed"))
+      continue
+    old_time = old_times[key]
+    new_time = new_times[key]
+    change = (new_time - old_time) * 100.0 / old_time if old_time else 0.0
+    marker = ""
+    if change > args.threshold:
+      marker = " REGRESSION"
+      regressions += 1
+    print("%-70s %12.1f %12.1f %+8.1f%%%s" % (name, old_time, new_time, change, marker))
+
+  if regressions:
+    print("%d benchmarks are more than %.1f%% slower" % (regressions, args.threshold))
+    return 1
+  return 0
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Run and compare the Envoy speed tests.")
+  subparsers = parser.add_subparsers(dest="command")
+
+  run_parser = subparsers.add_parser("run", help="Build and run the speed tests.")
+  run_parser.add_argument("--output", required=True, help="JSON file to write the results to.")
+  run_parser.add_argument("--targets", nargs="+", default=[],
+                          help="Speed test targets to run. Defaults to all of them.")
+  run_parser.add_argument("--bazel_args", nargs="+", default=[],
+                          help="Extra arguments for bazel build.")
+  run_parser.add_argument("benchmark_args", nargs="*",
+                          help="Extra arguments for each benchmark binary, after --.")
+
+  compare_parser = subparsers.add_parser("compare", help="Compare two result files.")
+  compare_parser.add_argument("old", help="JSON results of the baseline.")
+  compare_parser.add_argument("new", help="JSON results to compare against the baseline.")
+  compare_parser.add_argument("--threshold", type=float, default=10.0,
+                              help="CPU time increase, in percent, reported as a regression.")
+
+  args = parser.parse_args()
+  if args.command == "run":
+    run(args)
+    return 0
+  elif args.command == "compare":
+    return compare(args)
+  parser.print_help()
+  return 1
+
+
+if __name__ == "__main__":
+  sys.exit(main())